@@ -15,6 +15,7 @@
 
 #include "hid_report_desc.h"
 #include "config_channel_transport.h"
+#include "hid_report_coalesce.h"
 
 #include "hid_event.h"
 #include <caf/events/ble_common_event.h>
@@ -372,6 +373,33 @@ static void enqueue_hid_report(struct enqueued_reports *enqueued_reports,
 	}
 }
 
+static bool coalesce_hid_report(struct enqueued_reports *enqueued_reports,
+				size_t irep_idx, uint8_t report_id,
+				const uint8_t *data, size_t size)
+{
+	__ASSERT_NO_MSG(irep_idx < ARRAY_SIZE(enqueued_reports->reports));
+
+	sys_snode_t *node = sys_slist_peek_tail(&enqueued_reports->reports[irep_idx].list);
+
+	if (!node) {
+		return false;
+	}
+
+	/* Combine with the newest enqueued report to keep the report order. */
+	struct hid_report_event *report = CONTAINER_OF(node, struct enqueued_report, node)->report;
+
+	__ASSERT_NO_MSG(report->dyndata.size == size + sizeof(report_id));
+	uint8_t *dst = &report->dyndata.data[sizeof(report_id)];
+
+	if ((report_id == REPORT_ID_MOUSE) && (size == REPORT_SIZE_MOUSE)) {
+		return hid_mouse_report_merge(dst, data);
+	} else if ((report_id == REPORT_ID_BOOT_MOUSE) && (size == REPORT_SIZE_MOUSE_BOOT)) {
+		return hid_boot_mouse_report_merge(dst, data);
+	}
+
+	return false;
+}
+
 static void forward_hid_report(struct hids_peripheral *per, uint8_t report_id,
 			       const uint8_t *data, size_t size)
 {
@@ -400,6 +428,11 @@ static void forward_hid_report(struct hids_peripheral *per, uint8_t report_id,
 		return;
 	}
 
+	if (IS_ENABLED(CONFIG_DESKTOP_HID_FORWARD_COALESCE_MOUSE_REPORTS) && sub->busy &&
+	    coalesce_hid_report(&per->enqueued_reports, irep_idx, report_id, data, size)) {
+		return;
+	}
+
 	struct hid_report_event *report = new_hid_report_event(size + sizeof(report_id));
 
 	report->source = per;
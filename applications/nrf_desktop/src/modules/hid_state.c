@@ -30,6 +30,8 @@
 #include "hid_keymap.h"
 #include CONFIG_DESKTOP_HID_STATE_HID_KEYMAP_DEF_PATH
 #include "hid_report_desc.h"
+#include "hid_items.h"
+#include "hid_report_coalesce.h"
 
 #define MODULE hid_state
 #include <caf/events/module_state_event.h>
@@ -75,23 +77,17 @@ enum state {
 
 #define AXIS_COUNT (IS_ENABLED(CONFIG_DESKTOP_HID_REPORT_MOUSE_SUPPORT) * MOUSE_REPORT_AXIS_COUNT)
 
-/**@brief HID state item. */
-struct item {
-	uint16_t usage_id; /**< HID usage ID. */
-	int16_t value; /**< HID value. */
-};
-
 /**@brief Structure keeping state for a single target HID report. */
 struct items {
 	uint8_t item_count_max; /**< Maximal numer of items in this set. */
 	uint8_t item_count; /**< Current number of items in this set. */
-	struct item item[ITEM_COUNT]; /**< Items set. Browse from the end. */
+	struct hid_item item[ITEM_COUNT]; /**< Items set, see @ref hid_items. */
 };
 
 /**@brief Enqueued HID state item. */
 struct item_event {
 	sys_snode_t node; /**< Event queue linked list node. */
-	struct item item; /**< HID state item which has been enqueued. */
+	struct hid_item item; /**< HID state item which has been enqueued. */
 	uint32_t timestamp; /**< HID event timestamp. */
 };
 
@@ -219,15 +215,6 @@ static struct hid_keymap *hid_keymap_get(uint16_t key_id)
 	return map;
 }
 
-/**@brief Compare two usage values. */
-static int usage_id_compare(const void *a, const void *b)
-{
-	const struct item *p_a = a;
-	const struct item *p_b = b;
-
-	return (p_a->usage_id - p_b->usage_id);
-}
-
 static void eventq_reset(struct eventq *eventq)
 {
 	struct item_event *event;
@@ -344,7 +331,7 @@ static void eventq_cleanup(struct eventq *eventq, uint32_t timestamp)
 	sys_snode_t *tmp_safe;
 
 	SYS_SLIST_FOR_EACH_NODE_SAFE(&eventq->root, cur, tmp_safe) {
-		const struct item cur_item =
+		const struct hid_item cur_item =
 			CONTAINER_OF(cur, struct item_event, node)->item;
 
 		if (cur_item.value > 0) {
@@ -363,7 +350,7 @@ static void eventq_cleanup(struct eventq *eventq, uint32_t timestamp)
 					break;
 				}
 
-				const struct item item =
+				const struct hid_item item =
 					CONTAINER_OF(j,
 						     struct item_event,
 						     node)->item;
@@ -407,25 +394,6 @@ static void eventq_cleanup(struct eventq *eventq, uint32_t timestamp)
 	}
 }
 
-static void sort_by_usage_id(struct item items[], size_t array_size)
-{
-	for (size_t k = 0; k < array_size; k++) {
-		size_t id = k;
-
-		for (size_t l = k + 1; l < array_size; l++) {
-			if (items[l].usage_id < items[id].usage_id) {
-				id = l;
-			}
-		}
-		if (id != k) {
-			struct item tmp = items[k];
-
-			items[k] = items[id];
-			items[id] = tmp;
-		}
-	}
-}
-
 static void clear_items(struct items *items)
 {
 	memset(items->item, 0, sizeof(items->item));
@@ -508,70 +476,22 @@ static struct subscriber *get_linked_subscriber(uint8_t report_id)
 
 static bool key_value_set(struct items *items, uint16_t usage_id, int16_t value)
 {
-	const uint8_t prev_item_count = items->item_count;
-
-	bool update_needed = false;
-	struct item *p_item;
-
-	__ASSERT_NO_MSG(usage_id != 0);
 	__ASSERT_NO_MSG(items->item_count_max > 0);
 
-	/* Report equal to zero brings no change. This should never happen. */
-	__ASSERT_NO_MSG(value != 0);
-
-	struct item i = {
-		.usage_id = usage_id,
-	};
-
-	p_item = bsearch(&i,
-			 (uint8_t *)items->item,
-			 ARRAY_SIZE(items->item),
-			 sizeof(items->item[0]),
-			 usage_id_compare);
-
-	if (p_item) {
-		/* Item is present in the array - update its value. */
-		p_item->value += value;
-		if (p_item->value == 0) {
-			__ASSERT_NO_MSG(items->item_count != 0);
-			items->item_count -= 1;
-			p_item->usage_id = 0;
-		}
+	/* For items with absolute value, the value is used as a reference
+	 * counter and must not fall below zero. This could happen if a key up
+	 * event is lost and the state receives an unpaired key down event.
+	 */
+	bool update_needed = hid_items_update(items->item, ARRAY_SIZE(items->item),
+					      &items->item_count, items->item_count_max,
+					      usage_id, value);
 
-		update_needed = true;
-	} else if (value < 0) {
-		/* For items with absolute value, the value is used as
-		 * a reference counter and must not fall below zero. This
-		 * could happen if a key up event is lost and the state
-		 * receives an unpaired key down event.
-		 */
-	} else if (prev_item_count >= items->item_count_max) {
+	if (!update_needed && (value > 0)) {
 		/* Configuration should allow the HID module to hold data
 		 * about the maximum number of simultaneously pressed keys.
 		 * Generate a warning if an item cannot be recorded.
 		 */
 		LOG_WRN("No place on the list to store HID item!");
-	} else {
-		/* After sort operation, free slots (zeros) are stored
-		 * at the beginning of the array.
-		 */
-		size_t const idx = ARRAY_SIZE(items->item) - prev_item_count - 1;
-
-		__ASSERT_NO_MSG(items->item[idx].usage_id == 0);
-
-		/* Record this value change. */
-		items->item[idx].usage_id = usage_id;
-		items->item[idx].value = value;
-		items->item_count += 1;
-
-		update_needed = true;
-	}
-
-	if (prev_item_count != items->item_count) {
-		/* Sort elements on the list. Use simple algorithm
-		 * with small footprint.
-		 */
-		sort_by_usage_id(items->item, ARRAY_SIZE(items->item));
 	}
 
 	return update_needed;
@@ -613,7 +533,7 @@ static void send_report_keyboard(struct report_state *rs, struct report_data *rd
 	const size_t max = ARRAY_SIZE(rd->items.item);
 	size_t cnt = 0;
 	for (size_t i = 0; (i < max) && (cnt < KEYBOARD_REPORT_KEY_COUNT_MAX); i++) {
-		struct item item = rd->items.item[max - i - 1];
+		struct hid_item item = rd->items.item[max - i - 1];
 
 		if (item.usage_id) {
 			__ASSERT_NO_MSG(item.value > 0);
@@ -677,17 +597,17 @@ static void send_report_mouse(struct report_state *rs, struct report_data *rd)
 
 	/* Traverse pressed keys and build mouse buttons bitmask */
 	uint8_t button_bm = 0;
-	for (size_t i = 0; i < ARRAY_SIZE(rd->items.item); i++) {
-		struct item item = rd->items.item[i];
+	for (size_t i = ARRAY_SIZE(rd->items.item) - rd->items.item_count;
+	     i < ARRAY_SIZE(rd->items.item); i++) {
+		struct hid_item item = rd->items.item[i];
 
-		if (item.usage_id) {
-			__ASSERT_NO_MSG(item.usage_id <= 8);
-			__ASSERT_NO_MSG(item.value > 0);
+		__ASSERT_NO_MSG(item.usage_id != 0);
+		__ASSERT_NO_MSG(item.usage_id <= 8);
+		__ASSERT_NO_MSG(item.value > 0);
 
-			uint8_t mask = 1 << (item.usage_id - 1);
+		uint8_t mask = 1 << (item.usage_id - 1);
 
-			button_bm |= mask;
-		}
+		button_bm |= mask;
 	}
 
 
@@ -753,17 +673,17 @@ static void send_report_boot_mouse(struct report_state *rs, struct report_data *
 	}
 	/* Traverse pressed keys and build mouse buttons bitmask */
 	uint8_t button_bm = 0;
-	for (size_t i = 0; i < ARRAY_SIZE(rd->items.item); i++) {
-		struct item item = rd->items.item[i];
+	for (size_t i = ARRAY_SIZE(rd->items.item) - rd->items.item_count;
+	     i < ARRAY_SIZE(rd->items.item); i++) {
+		struct hid_item item = rd->items.item[i];
 
-		if (item.usage_id) {
-			__ASSERT_NO_MSG(item.usage_id <= 8);
-			__ASSERT_NO_MSG(item.value > 0);
+		__ASSERT_NO_MSG(item.usage_id != 0);
+		__ASSERT_NO_MSG(item.usage_id <= 8);
+		__ASSERT_NO_MSG(item.value > 0);
 
-			uint8_t mask = 1 << (item.usage_id - 1);
+		uint8_t mask = 1 << (item.usage_id - 1);
 
-			button_bm |= mask;
-		}
+		button_bm |= mask;
 	}
 
 
@@ -1429,8 +1349,13 @@ static bool handle_motion_event(const struct motion_event *event)
 	struct report_data *rd = get_report_data(REPORT_ID_MOUSE);
 	__ASSERT_NO_MSG(rd != NULL);
 
-	rd->axes.axis[MOUSE_REPORT_AXIS_X] += event->dx;
-	rd->axes.axis[MOUSE_REPORT_AXIS_Y] += event->dy;
+	/* Motion is accumulated until a report can be sent. Saturate instead
+	 * of overflowing if the transport is slower than the sensor.
+	 */
+	rd->axes.axis[MOUSE_REPORT_AXIS_X] = hid_axis_add(rd->axes.axis[MOUSE_REPORT_AXIS_X],
+							  event->dx);
+	rd->axes.axis[MOUSE_REPORT_AXIS_Y] = hid_axis_add(rd->axes.axis[MOUSE_REPORT_AXIS_Y],
+							  event->dy);
 
 	report_send(NULL, rd, true, true);
 
@@ -1446,7 +1371,9 @@ static bool handle_wheel_event(const struct wheel_event *event)
 	struct report_data *rd = get_report_data(REPORT_ID_MOUSE);
 	__ASSERT_NO_MSG(rd != NULL);
 
-	rd->axes.axis[MOUSE_REPORT_AXIS_WHEEL] += event->wheel;
+	int16_t *wheel = &rd->axes.axis[MOUSE_REPORT_AXIS_WHEEL];
+
+	*wheel = hid_axis_add(*wheel, event->wheel);
 
 	report_send(NULL, rd, true, true);
 
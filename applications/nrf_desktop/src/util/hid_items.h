@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HID_ITEMS_H_
+#define _HID_ITEMS_H_
+
+#include <stdbool.h>
+#include <string.h>
+#include <zephyr/types.h>
+#include <zephyr/sys/__assert.h>
+
+/**
+ * @defgroup hid_items HID items
+ * @brief Sorted set of HID items used by the HID state module.
+ *
+ * Items in use are stored at the end of the array, sorted by usage ID.
+ * Free items are zeroed and stored at the beginning of the array. The set is
+ * updated in place, so inserting or removing an item moves only the items
+ * with lower usage IDs.
+ *
+ * @{
+ */
+
+/** @brief HID state item. */
+struct hid_item {
+	uint16_t usage_id; /**< HID usage ID. */
+	int16_t value; /**< HID value. */
+};
+
+/** @brief Find the position of a usage ID.
+ *
+ * @param item		Array of items.
+ * @param size		Size of the array.
+ * @param cnt		Number of items in use.
+ * @param usage_id	HID usage ID.
+ *
+ * @return Index of the first item in use with usage ID that is not lower than
+ *	   @p usage_id, or @p size if there is no such item.
+ */
+static inline size_t hid_items_find(const struct hid_item *item, size_t size, size_t cnt,
+				    uint16_t usage_id)
+{
+	__ASSERT_NO_MSG(cnt <= size);
+
+	size_t lower = size - cnt;
+	size_t upper = size;
+
+	while (lower < upper) {
+		size_t m = lower + (upper - lower) / 2;
+
+		if (item[m].usage_id < usage_id) {
+			lower = m + 1;
+		} else {
+			upper = m;
+		}
+	}
+
+	return lower;
+}
+
+/** @brief Insert an item.
+ *
+ * @param item		Array of items.
+ * @param size		Size of the array.
+ * @param cnt		Number of items in use.
+ * @param pos		Position returned by @ref hid_items_find for @p usage_id.
+ * @param usage_id	HID usage ID. It must not be present in the set.
+ * @param value		HID value.
+ */
+static inline void hid_items_insert(struct hid_item *item, size_t size, size_t cnt, size_t pos,
+				    uint16_t usage_id, int16_t value)
+{
+	size_t first = size - cnt;
+
+	__ASSERT_NO_MSG(cnt < size);
+	__ASSERT_NO_MSG((pos >= first) && (pos <= size));
+
+	/* Move the items with lower usage IDs to the first free slot. */
+	memmove(&item[first - 1], &item[first], (pos - first) * sizeof(item[0]));
+
+	item[pos - 1].usage_id = usage_id;
+	item[pos - 1].value = value;
+}
+
+/** @brief Remove an item.
+ *
+ * @param item		Array of items.
+ * @param size		Size of the array.
+ * @param cnt		Number of items in use.
+ * @param pos		Position of the item to be removed.
+ */
+static inline void hid_items_remove(struct hid_item *item, size_t size, size_t cnt, size_t pos)
+{
+	size_t first = size - cnt;
+
+	__ASSERT_NO_MSG((cnt > 0) && (cnt <= size));
+	__ASSERT_NO_MSG((pos >= first) && (pos < size));
+
+	/* Move the items with lower usage IDs over the removed item. */
+	memmove(&item[first + 1], &item[first], (pos - first) * sizeof(item[0]));
+
+	item[first].usage_id = 0;
+	item[first].value = 0;
+}
+
+/** @brief Add a value to the item with a usage ID.
+ *
+ * The value of an item is used as a reference counter. The item is inserted
+ * when its value becomes positive and removed when its value drops to zero.
+ * A negative value for a usage ID that is not in the set is ignored, as it
+ * can be caused by a lost key down event.
+ *
+ * @param item		Array of items.
+ * @param size		Size of the array.
+ * @param cnt		Number of items in use, updated by the function.
+ * @param cnt_max	Maximum number of items in use.
+ * @param usage_id	HID usage ID.
+ * @param value		Value change. It must not be zero.
+ *
+ * @return True if the set was changed. False for an ignored negative value or
+ *	   if a new item does not fit in the set.
+ */
+static inline bool hid_items_update(struct hid_item *item, size_t size, uint8_t *cnt,
+				    size_t cnt_max, uint16_t usage_id, int16_t value)
+{
+	__ASSERT_NO_MSG(usage_id != 0);
+	__ASSERT_NO_MSG(value != 0);
+
+	size_t pos = hid_items_find(item, size, *cnt, usage_id);
+
+	if ((pos < size) && (item[pos].usage_id == usage_id)) {
+		item[pos].value += value;
+		if (item[pos].value == 0) {
+			hid_items_remove(item, size, *cnt, pos);
+			*cnt -= 1;
+		}
+
+		return true;
+	}
+
+	if ((value < 0) || (*cnt >= cnt_max)) {
+		return false;
+	}
+
+	hid_items_insert(item, size, *cnt, pos, usage_id, value);
+	*cnt += 1;
+
+	return true;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _HID_ITEMS_H_ */
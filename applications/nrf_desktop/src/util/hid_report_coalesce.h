@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef _HID_REPORT_COALESCE_H_
+#define _HID_REPORT_COALESCE_H_
+
+#include <zephyr/types.h>
+#include <zephyr/sys/util.h>
+
+#include "hid_report_mouse.h"
+
+/**
+ * @defgroup hid_report_coalesce HID report coalescing
+ * @brief Helpers used to combine HID mouse data that waits for a transport.
+ *
+ * Relative data (motion and wheel) is summed. Reports are combined only if
+ * no information is lost, that is if the button state is the same and the
+ * summed values fit in the report.
+ *
+ * @{
+ */
+
+/** @brief Add a delta to an accumulated axis value with saturation.
+ *
+ * @param axis		Accumulated axis value.
+ * @param delta		Delta to be added.
+ *
+ * @return Sum limited to the int16_t range.
+ */
+static inline int16_t hid_axis_add(int16_t axis, int32_t delta)
+{
+	return CLAMP((int32_t)axis + delta, INT16_MIN, INT16_MAX);
+}
+
+/** @brief Sign extend a 12-bit value. */
+static inline int16_t hid_mouse_report_xy_get(uint16_t raw)
+{
+	return (int16_t)(raw << 4) >> 4;
+}
+
+/** @brief Combine two mouse reports.
+ *
+ * Both reports use the format described in hid_report_mouse.h, without
+ * the report ID.
+ *
+ * @param dst		Older report, updated with the combined data.
+ * @param src		Newer report.
+ *
+ * @return True if the reports were combined, false otherwise.
+ */
+static inline bool hid_mouse_report_merge(uint8_t *dst, const uint8_t *src)
+{
+	if (dst[0] != src[0]) {
+		/* Button state changed. */
+		return false;
+	}
+
+	int16_t wheel = (int8_t)dst[1] + (int8_t)src[1];
+	int16_t x = hid_mouse_report_xy_get(dst[2] | ((dst[3] & 0x0f) << 8)) +
+		    hid_mouse_report_xy_get(src[2] | ((src[3] & 0x0f) << 8));
+	int16_t y = hid_mouse_report_xy_get((dst[3] >> 4) | (dst[4] << 4)) +
+		    hid_mouse_report_xy_get((src[3] >> 4) | (src[4] << 4));
+
+	if ((wheel < MOUSE_REPORT_WHEEL_MIN) || (wheel > MOUSE_REPORT_WHEEL_MAX) ||
+	    (x < MOUSE_REPORT_XY_MIN) || (x > MOUSE_REPORT_XY_MAX) ||
+	    (y < MOUSE_REPORT_XY_MIN) || (y > MOUSE_REPORT_XY_MAX)) {
+		return false;
+	}
+
+	dst[1] = wheel;
+	dst[2] = x & 0xff;
+	dst[3] = ((y & 0x0f) << 4) | ((x >> 8) & 0x0f);
+	dst[4] = (y >> 4) & 0xff;
+
+	return true;
+}
+
+/** @brief Combine two boot protocol mouse reports.
+ *
+ * @param dst		Older report, updated with the combined data.
+ * @param src		Newer report.
+ *
+ * @return True if the reports were combined, false otherwise.
+ */
+static inline bool hid_boot_mouse_report_merge(uint8_t *dst, const uint8_t *src)
+{
+	if (dst[0] != src[0]) {
+		/* Button state changed. */
+		return false;
+	}
+
+	int16_t x = (int8_t)dst[1] + (int8_t)src[1];
+	int16_t y = (int8_t)dst[2] + (int8_t)src[2];
+
+	if ((x < MOUSE_REPORT_XY_MIN_BOOT) || (x > MOUSE_REPORT_XY_MAX_BOOT) ||
+	    (y < MOUSE_REPORT_XY_MIN_BOOT) || (y > MOUSE_REPORT_XY_MAX_BOOT)) {
+		return false;
+	}
+
+	dst[1] = x;
+	dst[2] = y;
+
+	return true;
+}
+
+/**
+ * @}
+ */
+
+#endif /* _HID_REPORT_COALESCE_H_ */
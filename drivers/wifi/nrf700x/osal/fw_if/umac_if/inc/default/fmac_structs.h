@@ -19,6 +19,7 @@
 #include <stdbool.h>
 
 #include "osal_api.h"
+#include "nbuf_queue.h"
 #include "host_rpu_umac_if.h"
 #include "fmac_structs_common.h"
 
@@ -300,11 +301,17 @@ struct tx_config {
 	/** Coalesce count of TX frames. */
 	unsigned int *send_pkt_coalesce_count_p;
 	/** per-peer/per-AC Queue for frames waiting to be passed to the RPU firmware for TX. */
-	void *data_pending_txq[MAX_SW_PEERS][NRF_WIFI_FMAC_AC_MAX];
-	/** Queue for peers which have woken up from 802.11 power save. */
-	void *wakeup_client_q;
+	struct nrf_wifi_utils_nbuf_q data_pending_txq[MAX_SW_PEERS][NRF_WIFI_FMAC_AC_MAX];
+	/** Bitmap of peers with frames pending in @p data_pending_txq, per AC. */
+	unsigned int pend_peer_bmp[NRF_WIFI_FMAC_AC_MAX];
+	/** Bitmap of peers which are in 802.11 power save. */
+	unsigned int ps_peer_bmp;
+	/** Bitmap of peers which have woken up from 802.11 power save. */
+	unsigned int wakeup_peer_bmp;
 	/** Used to store tx descs(buff pool ids). */
 	unsigned long *buf_pool_bmp_p;
+	/** Per buff pool bucket, the tx descs reserved for each AC followed by the spare ones. */
+	unsigned long *desc_mask_p;
 	/** TX descriptors which have been queued to the RPU firmware. */
 	unsigned int outstanding_descs[NRF_WIFI_FMAC_AC_MAX];
 	/** Peer who will be get the next opportunity for TX. */
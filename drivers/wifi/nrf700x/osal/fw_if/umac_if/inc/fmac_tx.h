@@ -16,6 +16,10 @@
 #include "fmac_structs.h"
 
 #define TX_DESC_BUCKET_BOUND 32
+#define TX_DESC_POOL_CNT(num_tx_tokens) (((num_tx_tokens) / TX_DESC_BUCKET_BOUND) + 1)
+/* Index of the spare tx descs mask, after the per AC reserved tx descs masks. */
+#define TX_DESC_MASK_SPARE NRF_WIFI_FMAC_AC_MAX
+#define TX_DESC_MASK_CNT (NRF_WIFI_FMAC_AC_MAX + 1)
 #define DOT11_WMM_PARAMS_LEN 2
 
 /* 4 bits represent 4 access categories.
@@ -40,7 +44,7 @@ enum nrf_wifi_fmac_tx_status {
 };
 
 struct tx_pkt_info {
-	void *pkt;
+	struct nrf_wifi_utils_nbuf_q pkt;
 	unsigned int peer_id;
 };
 
@@ -64,7 +68,7 @@ enum nrf_wifi_status tx_pending_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_c
 					unsigned int ac);
 
 enum nrf_wifi_status tx_cmd_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
-				 void *txq,
+				 struct nrf_wifi_utils_nbuf_q *txq,
 				 int desc,
 				 int peer_id);
 
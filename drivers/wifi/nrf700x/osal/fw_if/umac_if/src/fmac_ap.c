@@ -11,7 +11,6 @@
 
 #include "fmac_ap.h"
 #include "fmac_peer.h"
-#include "queue.h"
 #include "fmac_tx.h"
 #include "fmac_util.h"
 
@@ -20,7 +19,6 @@ enum nrf_wifi_status sap_client_ps_get_frames(struct nrf_wifi_fmac_dev_ctx *fmac
 {
 	enum nrf_wifi_status status = NRF_WIFI_STATUS_FAIL;
 	struct peers_info *peer = NULL;
-	void *wakeup_client_q = NULL;
 	int id = -1;
 	int ac = 0;
 	int desc = 0;
@@ -57,12 +55,8 @@ enum nrf_wifi_status sap_client_ps_get_frames(struct nrf_wifi_fmac_dev_ctx *fmac
 	peer = &def_dev_ctx->tx_config.peers[id];
 	peer->ps_token_count = config->num_frames;
 
-	wakeup_client_q = def_dev_ctx->tx_config.wakeup_client_q;
-
-	if (wakeup_client_q) {
-		nrf_wifi_utils_q_enqueue(fmac_dev_ctx->fpriv->opriv,
-					 wakeup_client_q,
-					 peer);
+	if (peer->ps_token_count) {
+		def_dev_ctx->tx_config.wakeup_peer_bmp |= (1 << id);
 	}
 
 	for (ac = NRF_WIFI_FMAC_AC_VO; ac >= 0; --ac) {
@@ -87,7 +81,6 @@ enum nrf_wifi_status sap_client_update_pmmode(struct nrf_wifi_fmac_dev_ctx *fmac
 {
 	enum nrf_wifi_status status = NRF_WIFI_STATUS_FAIL;
 	struct peers_info *peer = NULL;
-	void *wakeup_client_q = NULL;
 	int id = -1;
 	int ac = 0;
 	int desc = 0;
@@ -126,13 +119,15 @@ enum nrf_wifi_status sap_client_update_pmmode(struct nrf_wifi_fmac_dev_ctx *fmac
 	peer = &def_dev_ctx->tx_config.peers[id];
 	peer->ps_state = config->sta_ps_state;
 
-	if (peer->ps_state == NRF_WIFI_CLIENT_ACTIVE) {
-		wakeup_client_q = def_dev_ctx->tx_config.wakeup_client_q;
+	if (peer->ps_state == NRF_WIFI_CLIENT_PS_MODE) {
+		def_dev_ctx->tx_config.ps_peer_bmp |= (1 << id);
+	} else {
+		def_dev_ctx->tx_config.ps_peer_bmp &= ~(1 << id);
+	}
 
-		if (wakeup_client_q) {
-			nrf_wifi_utils_q_enqueue(fmac_dev_ctx->fpriv->opriv,
-						 wakeup_client_q,
-						 peer);
+	if (peer->ps_state == NRF_WIFI_CLIENT_ACTIVE) {
+		if (peer->ps_token_count) {
+			def_dev_ctx->tx_config.wakeup_peer_bmp |= (1 << id);
 		}
 
 		for (ac = NRF_WIFI_FMAC_AC_VO; ac >= 0; --ac) {
@@ -117,6 +117,9 @@ void nrf_wifi_fmac_peer_remove(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 			      sizeof(struct peers_info));
 	peer->peer_id = -1;
 
+	def_dev_ctx->tx_config.ps_peer_bmp &= ~(1 << peer_id);
+	def_dev_ctx->tx_config.wakeup_peer_bmp &= ~(1 << peer_id);
+
 	if (vif_ctx->if_type == NRF_WIFI_IFTYPE_AP) {
 		hal_rpu_mem_write(fmac_dev_ctx->hal_dev_ctx,
 				  (RPU_MEM_UMAC_PEND_Q_BMP +
@@ -150,6 +153,9 @@ void nrf_wifi_fmac_peers_flush(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 					      sizeof(struct peers_info));
 			peer->peer_id = -1;
 
+			def_dev_ctx->tx_config.ps_peer_bmp &= ~(1 << i);
+			def_dev_ctx->tx_config.wakeup_peer_bmp &= ~(1 << i);
+
 			if (vif_ctx->if_type == NRF_WIFI_IFTYPE_AP) {
 				hal_rpu_mem_write(fmac_dev_ctx->hal_dev_ctx,
 						  (RPU_MEM_UMAC_PEND_Q_BMP +
@@ -9,8 +9,8 @@
  * FMAC IF Layer of the Wi-Fi driver.
  */
 
-#include "list.h"
 #include "queue.h"
+#include "nbuf_queue.h"
 #include "hal_api.h"
 #include "fmac_tx.h"
 #include "fmac_api.h"
@@ -118,14 +118,14 @@ int pending_frames_count(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 {
 	int count = 0;
 	int ac = 0;
-	void *queue = NULL;
+	struct nrf_wifi_utils_nbuf_q *queue = NULL;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 
 	def_dev_ctx = wifi_dev_priv(fmac_dev_ctx);
 
 	for (ac = NRF_WIFI_FMAC_AC_VO; ac >= 0; --ac) {
-		queue = def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
-		count += nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv, queue);
+		queue = &def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
+		count += nrf_wifi_utils_nbuf_q_len(queue);
 	}
 
 	return count;
@@ -138,7 +138,7 @@ enum nrf_wifi_status update_pend_q_bmp(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ct
 {
 	enum nrf_wifi_status status = NRF_WIFI_STATUS_FAIL;
 	struct nrf_wifi_fmac_vif_ctx *vif_ctx = NULL;
-	void *pend_pkt_q = NULL;
+	struct nrf_wifi_utils_nbuf_q *pend_pkt_q = NULL;
 	int len = 0;
 	unsigned char vif_id = 0;
 	unsigned char *bmp = NULL;
@@ -150,15 +150,22 @@ enum nrf_wifi_status update_pend_q_bmp(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ct
 		goto out;
 	}
 
+	pend_pkt_q = &def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
+
+	if (nrf_wifi_utils_nbuf_q_len(pend_pkt_q)) {
+		def_dev_ctx->tx_config.pend_peer_bmp[ac] |= (1 << peer_id);
+	} else {
+		def_dev_ctx->tx_config.pend_peer_bmp[ac] &= ~(1 << peer_id);
+	}
+
 	vif_id = def_dev_ctx->tx_config.peers[peer_id].if_idx;
 	vif_ctx = def_dev_ctx->vif_ctx[vif_id];
 
 	if (vif_ctx->if_type == NRF_WIFI_IFTYPE_AP &&
 	    peer_id < MAX_PEERS) {
 		bmp = &def_dev_ctx->tx_config.peers[peer_id].pend_q_bmp;
-		pend_pkt_q = def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
 
-		len = nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv, pend_pkt_q);
+		len = nrf_wifi_utils_nbuf_q_len(pend_pkt_q);
 
 		if (len == 0) {
 			*bmp = *bmp & ~(1 << ac);
@@ -198,11 +205,11 @@ void tx_desc_free(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	bit = (desc % TX_DESC_BUCKET_BOUND);
 	pool_id = (desc / TX_DESC_BUCKET_BOUND);
 
-	if (!(def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] & (1 << bit))) {
+	if (!(def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] & (1UL << bit))) {
 		return;
 	}
 
-	def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] &= (~(1 << bit));
+	def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] &= (~(1UL << bit));
 
 	def_dev_ctx->tx_config.outstanding_descs[queue]--;
 
@@ -213,77 +220,73 @@ void tx_desc_free(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 }
 
 
+static unsigned int tx_desc_find_free(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+				      unsigned int mask_id)
+{
+	unsigned long free_descs = 0;
+	unsigned int pool_id = 0;
+	struct nrf_wifi_fmac_priv_def *def_priv = NULL;
+	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
+
+	def_dev_ctx = wifi_dev_priv(fmac_dev_ctx);
+	def_priv = wifi_fmac_priv(fmac_dev_ctx->fpriv);
+
+	for (pool_id = 0; pool_id < TX_DESC_POOL_CNT(def_priv->num_tx_tokens); pool_id++) {
+		free_descs = def_dev_ctx->tx_config.desc_mask_p[(pool_id * TX_DESC_MASK_CNT) +
+								 mask_id];
+		free_descs &= ~def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id];
+
+		if (free_descs) {
+			return (pool_id * TX_DESC_BUCKET_BOUND) + __builtin_ctzl(free_descs);
+		}
+	}
+
+	return def_priv->num_tx_tokens;
+}
+
+
 unsigned int tx_desc_get(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 			 int queue)
 {
-	struct nrf_wifi_fmac_priv *fpriv = NULL;
-	unsigned int cnt = 0;
-	int curr_bit = 0;
 	unsigned int desc = 0;
-	int pool_id = 0;
 	struct nrf_wifi_fmac_priv_def *def_priv = NULL;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 
-	fpriv = fmac_dev_ctx->fpriv;
 	def_dev_ctx = wifi_dev_priv(fmac_dev_ctx);
-	def_priv = wifi_fmac_priv(fpriv);
-
-	desc = def_priv->num_tx_tokens;
+	def_priv = wifi_fmac_priv(fmac_dev_ctx->fpriv);
 
 	/* First search for a reserved desc */
-
-	for (cnt = 0; cnt < def_priv->num_tx_tokens_per_ac; cnt++) {
-		curr_bit = ((queue + (NRF_WIFI_FMAC_AC_MAX * cnt)));
-		curr_bit = ((queue + (NRF_WIFI_FMAC_AC_MAX * cnt)) % TX_DESC_BUCKET_BOUND);
-		pool_id = ((queue + (NRF_WIFI_FMAC_AC_MAX * cnt)) / TX_DESC_BUCKET_BOUND);
-
-		if ((((def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] >>
-		       curr_bit)) & 1)) {
-			continue;
-		} else {
-			def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] |=
-				(1 << curr_bit);
-			desc = queue + (NRF_WIFI_FMAC_AC_MAX * cnt);
-			def_dev_ctx->tx_config.outstanding_descs[queue]++;
-			break;
-		}
-	}
+	desc = tx_desc_find_free(fmac_dev_ctx, queue);
 
 	/* If reserved desc is not found search for a spare desc
 	 * (only for non beacon queues)
 	 */
-	if (cnt == def_priv->num_tx_tokens_per_ac) {
-		for (desc = def_priv->num_tx_tokens_per_ac * NRF_WIFI_FMAC_AC_MAX;
-		     desc < def_priv->num_tx_tokens;
-		     desc++) {
-			curr_bit = (desc % TX_DESC_BUCKET_BOUND);
-			pool_id = (desc / TX_DESC_BUCKET_BOUND);
-
-			if ((def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] >> curr_bit) & 1) {
-				continue;
-			} else {
-				def_dev_ctx->tx_config.buf_pool_bmp_p[pool_id] |=
-					(1 << curr_bit);
-				def_dev_ctx->tx_config.outstanding_descs[queue]++;
-				/* Keep a note which queue has been assigned the
-				 * spare desc. Need for processing of TX_DONE
-				 * event as queue number is not being provided
-				 * by UMAC.
-				 * First nibble epresent first spare desc
-				 * (B3B2B1B0: VO-VI-BE-BK)
-				 * Second nibble represent second spare desc
-				 * (B7B6B5B4 : V0-VI-BE-BK)
-				 * Third nibble represent second spare desc
-				 * (B11B10B9B8 : V0-VI-BE-BK)
-				 * Fourth nibble represent second spare desc
-				 * (B15B14B13B12 : V0-VI-BE-BK)
-				 */
-				set_spare_desc_q_map(fmac_dev_ctx, desc, queue);
-				break;
-			}
+	if (desc == def_priv->num_tx_tokens) {
+		desc = tx_desc_find_free(fmac_dev_ctx, TX_DESC_MASK_SPARE);
+
+		if (desc == def_priv->num_tx_tokens) {
+			return desc;
 		}
+
+		/* Keep a note which queue has been assigned the
+		 * spare desc. Need for processing of TX_DONE
+		 * event as queue number is not being provided
+		 * by UMAC.
+		 * First nibble epresent first spare desc
+		 * (B3B2B1B0: VO-VI-BE-BK)
+		 * Second nibble represent second spare desc
+		 * (B7B6B5B4 : V0-VI-BE-BK)
+		 * Third nibble represent second spare desc
+		 * (B11B10B9B8 : V0-VI-BE-BK)
+		 * Fourth nibble represent second spare desc
+		 * (B15B14B13B12 : V0-VI-BE-BK)
+		 */
+		set_spare_desc_q_map(fmac_dev_ctx, desc, queue);
 	}
 
+	def_dev_ctx->tx_config.buf_pool_bmp_p[desc / TX_DESC_BUCKET_BOUND] |=
+		(1UL << (desc % TX_DESC_BUCKET_BOUND));
+	def_dev_ctx->tx_config.outstanding_descs[queue]++;
 
 	return desc;
 }
@@ -295,7 +298,7 @@ int tx_aggr_check(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 		  int peer)
 {
 	void *nwb = NULL;
-	void *pending_pkt_queue = NULL;
+	struct nrf_wifi_utils_nbuf_q *pending_pkt_queue = NULL;
 	bool aggr = true;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 
@@ -305,15 +308,13 @@ int tx_aggr_check(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 		return false;
 	}
 
-	pending_pkt_queue = def_dev_ctx->tx_config.data_pending_txq[peer][ac];
+	pending_pkt_queue = &def_dev_ctx->tx_config.data_pending_txq[peer][ac];
 
-	if (nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-				 pending_pkt_queue) == 0) {
+	if (nrf_wifi_utils_nbuf_q_len(pending_pkt_queue) == 0) {
 		return false;
 	}
 
-	nwb = nrf_wifi_utils_q_peek(fmac_dev_ctx->fpriv->opriv,
-				    pending_pkt_queue);
+	nwb = nrf_wifi_utils_nbuf_q_peek(pending_pkt_queue);
 
 	if (nwb) {
 		if (!nrf_wifi_util_ether_addr_equal(nrf_wifi_util_get_dest(fmac_dev_ctx,
@@ -341,37 +342,25 @@ int get_peer_from_wakeup_q(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 {
 	int peer_id = -1;
 	struct peers_info *peer = NULL;
-	void *pend_q = NULL;
-	unsigned int pend_q_len;
-	void *client_q = NULL;
-	void *list_node = NULL;
+	unsigned int peer_bmp = 0;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 
 	def_dev_ctx = wifi_dev_priv(fmac_dev_ctx);
 
-	client_q = def_dev_ctx->tx_config.wakeup_client_q;
-
-	list_node = nrf_wifi_osal_llist_get_node_head(fmac_dev_ctx->fpriv->opriv,
-						      client_q);
+	peer_bmp = def_dev_ctx->tx_config.wakeup_peer_bmp &
+		def_dev_ctx->tx_config.pend_peer_bmp[ac];
 
-	while (list_node) {
-		peer = nrf_wifi_osal_llist_node_data_get(fmac_dev_ctx->fpriv->opriv,
-							 list_node);
-
-		if (peer != NULL && peer->ps_token_count) {
+	if (!peer_bmp) {
+		return peer_id;
+	}
 
-			pend_q = def_dev_ctx->tx_config.data_pending_txq[peer->peer_id][ac];
-			pend_q_len = nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv, pend_q);
+	peer_id = __builtin_ctz(peer_bmp);
+	peer = &def_dev_ctx->tx_config.peers[peer_id];
 
-			if (pend_q_len) {
-				peer->ps_token_count--;
-				return peer->peer_id;
-			}
-		}
+	peer->ps_token_count--;
 
-		list_node = nrf_wifi_osal_llist_get_node_nxt(fmac_dev_ctx->fpriv->opriv,
-							     client_q,
-							     list_node);
+	if (peer->ps_token_count == 0) {
+		def_dev_ctx->tx_config.wakeup_peer_bmp &= ~(1 << peer_id);
 	}
 
 	return peer_id;
@@ -381,13 +370,9 @@ int get_peer_from_wakeup_q(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 int tx_curr_peer_opp_get(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 			 unsigned int ac)
 {
-	unsigned int i = 0;
-	unsigned int curr_peer_opp = 0;
-	unsigned int init_peer_opp = 0;
-	unsigned int pend_q_len;
-	void *pend_q = NULL;
+	unsigned int peer_bmp = 0;
+	unsigned int next_peer_bmp = 0;
 	int peer_id = -1;
-	unsigned char ps_state = 0;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 
 	def_dev_ctx = wifi_dev_priv(fmac_dev_ctx);
@@ -402,31 +387,25 @@ int tx_curr_peer_opp_get(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 		return peer_id;
 	}
 
-	init_peer_opp = def_dev_ctx->tx_config.curr_peer_opp[ac];
-
-	for (i = 0; i < MAX_PEERS; i++) {
-		curr_peer_opp = (init_peer_opp + i) % MAX_PEERS;
-
-		ps_state = def_dev_ctx->tx_config.peers[curr_peer_opp].ps_state;
+	/* Peers with pending frames which are not in power save */
+	peer_bmp = def_dev_ctx->tx_config.pend_peer_bmp[ac] &
+		~def_dev_ctx->tx_config.ps_peer_bmp &
+		((1 << MAX_PEERS) - 1);
 
-		if (ps_state == NRF_WIFI_CLIENT_PS_MODE) {
-			continue;
-		}
+	if (!peer_bmp) {
+		return peer_id;
+	}
 
-		pend_q = def_dev_ctx->tx_config.data_pending_txq[curr_peer_opp][ac];
-		pend_q_len = nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-						  pend_q);
+	/* Round robin, starting from the peer which has the opportunity */
+	next_peer_bmp = peer_bmp & (~0U << def_dev_ctx->tx_config.curr_peer_opp[ac]);
 
-		if (pend_q_len) {
-			def_dev_ctx->tx_config.curr_peer_opp[ac] =
-				(curr_peer_opp + 1) % MAX_PEERS;
-			break;
-		}
+	if (next_peer_bmp) {
+		peer_id = __builtin_ctz(next_peer_bmp);
+	} else {
+		peer_id = __builtin_ctz(peer_bmp);
 	}
 
-	if (i != MAX_PEERS) {
-		peer_id = curr_peer_opp;
-	}
+	def_dev_ctx->tx_config.curr_peer_opp[ac] = (peer_id + 1) % MAX_PEERS;
 
 	return peer_id;
 }
@@ -436,8 +415,8 @@ size_t _tx_pending_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 			unsigned int ac)
 {
 	int len = 0;
-	void *pend_pkt_q = NULL;
-	void *txq = NULL;
+	struct nrf_wifi_utils_nbuf_q *pend_pkt_q = NULL;
+	struct nrf_wifi_utils_nbuf_q *txq = NULL;
 	struct tx_pkt_info *pkt_info = NULL;
 	int peer_id = -1;
 	void *nwb = NULL;
@@ -461,29 +440,24 @@ size_t _tx_pending_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 		return 0;
 	}
 
-	pend_pkt_q = def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
+	pend_pkt_q = &def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
 
-	if (nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-				 pend_pkt_q) == 0) {
+	if (nrf_wifi_utils_nbuf_q_len(pend_pkt_q) == 0) {
 		return 0;
 	}
 
 	pkt_info = &def_dev_ctx->tx_config.pkt_info_p[desc];
-	txq = pkt_info->pkt;
+	txq = &pkt_info->pkt;
 
 	/* Aggregate Only MPDU's with same RA, same Rate,
 	 * same Rate flags, same Tx Info flags
 	 */
-	if (nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-				 pend_pkt_q)) {
-		first_nwb = nrf_wifi_utils_q_peek(fmac_dev_ctx->fpriv->opriv,
-						  pend_pkt_q);
+	if (nrf_wifi_utils_nbuf_q_len(pend_pkt_q)) {
+		first_nwb = nrf_wifi_utils_nbuf_q_peek(pend_pkt_q);
 	}
 
-	while (nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-				    pend_pkt_q)) {
-		nwb = nrf_wifi_utils_q_peek(fmac_dev_ctx->fpriv->opriv,
-					    pend_pkt_q);
+	while (nrf_wifi_utils_nbuf_q_len(pend_pkt_q)) {
+		nwb = nrf_wifi_utils_nbuf_q_peek(pend_pkt_q);
 
 		ampdu_len += TX_BUF_HEADROOM +
 			nrf_wifi_osal_nbuf_data_size(fmac_dev_ctx->fpriv->opriv,
@@ -495,36 +469,36 @@ size_t _tx_pending_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 
 		if (!can_xmit(fmac_dev_ctx, nwb) ||
 			(!tx_aggr_check(fmac_dev_ctx, first_nwb, ac, peer_id)) ||
-			(nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-					      txq) >= max_txq_len)) {
+			(nrf_wifi_utils_nbuf_q_len(txq) >= max_txq_len)) {
 			break;
 		}
 
-		nwb = nrf_wifi_utils_q_dequeue(fmac_dev_ctx->fpriv->opriv,
-					       pend_pkt_q);
+		nwb = nrf_wifi_utils_nbuf_q_dequeue(fmac_dev_ctx->fpriv->opriv,
+						    pend_pkt_q);
 
-		nrf_wifi_utils_list_add_tail(fmac_dev_ctx->fpriv->opriv,
-					     txq,
-					     nwb);
+		nrf_wifi_utils_nbuf_q_enqueue(fmac_dev_ctx->fpriv->opriv,
+					      txq,
+					      nwb);
 	}
 
 	/* If our criterion rejects all pending frames, or
 	 * pend_q is empty, send only 1
 	 */
-	if (!nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv, txq)) {
-		nwb = nrf_wifi_utils_q_dequeue(fmac_dev_ctx->fpriv->opriv,
-					       pend_pkt_q);
+	if (!nrf_wifi_utils_nbuf_q_len(txq)) {
+		nwb = nrf_wifi_utils_nbuf_q_dequeue(fmac_dev_ctx->fpriv->opriv,
+						    pend_pkt_q);
 
 		if (!can_xmit(fmac_dev_ctx, nwb)) {
+			update_pend_q_bmp(fmac_dev_ctx, ac, peer_id);
 			return 0;
 		}
 
-		nrf_wifi_utils_list_add_tail(fmac_dev_ctx->fpriv->opriv,
-					     txq,
-					     nwb);
+		nrf_wifi_utils_nbuf_q_enqueue(fmac_dev_ctx->fpriv->opriv,
+					      txq,
+					      nwb);
 	}
 
-	len = nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv, txq);
+	len = nrf_wifi_utils_nbuf_q_len(txq);
 
 	if (len > 0) {
 		def_dev_ctx->tx_config.pkt_info_p[desc].peer_id = peer_id;
@@ -618,7 +592,7 @@ out:
 enum nrf_wifi_status tx_cmd_prepare(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 		   struct host_rpu_msg *umac_cmd,
 		   int desc,
-		   void *txq,
+		   struct nrf_wifi_utils_nbuf_q *txq,
 		   int peer_id)
 {
 	struct nrf_wifi_tx_buff *config = NULL;
@@ -640,8 +614,7 @@ enum nrf_wifi_status tx_cmd_prepare(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	vif_id = def_dev_ctx->tx_config.peers[peer_id].if_idx;
 	vif_ctx = def_dev_ctx->vif_ctx[vif_id];
 
-	txq_len = nrf_wifi_utils_list_len(fmac_dev_ctx->fpriv->opriv,
-					  txq);
+	txq_len = nrf_wifi_utils_nbuf_q_len(txq);
 
 	if (txq_len == 0) {
 		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
@@ -651,8 +624,7 @@ enum nrf_wifi_status tx_cmd_prepare(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 		goto err;
 	}
 
-	nwb = nrf_wifi_utils_list_peek(fmac_dev_ctx->fpriv->opriv,
-				       txq);
+	nwb = nrf_wifi_utils_nbuf_q_peek(txq);
 
 	def_dev_ctx->tx_config.send_pkt_coalesce_count_p[desc] = txq_len;
 
@@ -699,10 +671,10 @@ enum nrf_wifi_status tx_cmd_prepare(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	info.fmac_dev_ctx = fmac_dev_ctx;
 	info.config = config;
 
-	status = nrf_wifi_utils_list_traverse(fmac_dev_ctx->fpriv->opriv,
-					      txq,
-					      &info,
-					      tx_cmd_prep_callbk_fn);
+	status = nrf_wifi_utils_nbuf_q_traverse(fmac_dev_ctx->fpriv->opriv,
+						txq,
+						&info,
+						tx_cmd_prep_callbk_fn);
 
 	if (status != NRF_WIFI_STATUS_SUCCESS) {
 		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
@@ -722,9 +694,7 @@ enum nrf_wifi_status tx_cmd_prepare(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	}
 
 	if (def_dev_ctx->tx_config.peers[peer_id].ps_token_count == 0) {
-		nrf_wifi_utils_list_del_node(fmac_dev_ctx->fpriv->opriv,
-					     def_dev_ctx->tx_config.wakeup_client_q,
-					     &def_dev_ctx->tx_config.peers[peer_id]);
+		def_dev_ctx->tx_config.wakeup_peer_bmp &= ~(1 << peer_id);
 
 		config->mac_hdr_info.eosp = 1;
 
@@ -741,7 +711,7 @@ err:
 
 
 enum nrf_wifi_status tx_cmd_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
-				 void *txq,
+				 struct nrf_wifi_utils_nbuf_q *txq,
 				 int desc,
 				 int peer_id)
 {
@@ -750,7 +720,7 @@ enum nrf_wifi_status tx_cmd_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	unsigned int len = 0;
 
 	len += sizeof(struct nrf_wifi_tx_buff_info);
-	len *= nrf_wifi_utils_list_len(fmac_dev_ctx->fpriv->opriv, txq);
+	len *= nrf_wifi_utils_nbuf_q_len(txq);
 
 	len += sizeof(struct nrf_wifi_tx_buff);
 
@@ -804,7 +774,7 @@ enum nrf_wifi_status tx_pending_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_c
 
 	if (_tx_pending_process(fmac_dev_ctx, desc, ac)) {
 		status = tx_cmd_init(fmac_dev_ctx,
-				     def_dev_ctx->tx_config.pkt_info_p[desc].pkt,
+				     &def_dev_ctx->tx_config.pkt_info_p[desc].pkt,
 				     desc,
 				     def_dev_ctx->tx_config.pkt_info_p[desc].peer_id);
 	} else {
@@ -826,7 +796,7 @@ enum nrf_wifi_status tx_enqueue(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 				unsigned int peer_id)
 {
 	enum nrf_wifi_status status = NRF_WIFI_STATUS_FAIL;
-	void *queue = NULL;
+	struct nrf_wifi_utils_nbuf_q *queue = NULL;
 	int qlen = 0;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 
@@ -839,22 +809,22 @@ enum nrf_wifi_status tx_enqueue(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 		goto out;
 	}
 
-	queue = def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
+	queue = &def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
 
-	qlen = nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv, queue);
+	qlen = nrf_wifi_utils_nbuf_q_len(queue);
 
 	if (qlen >= CONFIG_NRF700X_MAX_TX_PENDING_QLEN) {
 		goto out;
 	}
 
 	if (is_twt_emergency_pkt(fmac_dev_ctx->fpriv->opriv, nwb)) {
-		nrf_wifi_utils_q_enqueue_head(fmac_dev_ctx->fpriv->opriv,
+		nrf_wifi_utils_nbuf_q_enqueue_head(fmac_dev_ctx->fpriv->opriv,
+						   queue,
+						   nwb);
+	} else {
+		nrf_wifi_utils_nbuf_q_enqueue(fmac_dev_ctx->fpriv->opriv,
 					      queue,
 					      nwb);
-	} else {
-		nrf_wifi_utils_q_enqueue(fmac_dev_ctx->fpriv->opriv,
-					 queue,
-					 nwb);
 	}
 
 	status = update_pend_q_bmp(fmac_dev_ctx, ac, peer_id);
@@ -874,7 +844,7 @@ enum nrf_wifi_fmac_tx_status tx_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_c
 	struct nrf_wifi_fmac_priv *fpriv = NULL;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 	struct nrf_wifi_fmac_priv_def *def_priv = NULL;
-	void *pend_pkt_q = NULL;
+	struct nrf_wifi_utils_nbuf_q *pend_pkt_q = NULL;
 	void *first_nwb = NULL;
 	unsigned char ps_state = 0;
 	bool aggr_status = false;
@@ -899,7 +869,7 @@ enum nrf_wifi_fmac_tx_status tx_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_c
 		goto out;
 	}
 
-	pend_pkt_q = def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
+	pend_pkt_q = &def_dev_ctx->tx_config.data_pending_txq[peer_id][ac];
 
 	/* If outstanding_descs for a particular
 	 * access category >= NUM_TX_DESCS_PER_AC means there are already
@@ -909,10 +879,8 @@ enum nrf_wifi_fmac_tx_status tx_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_c
 	 */
 
 	if ((def_dev_ctx->tx_config.outstanding_descs[ac]) >= def_priv->num_tx_tokens_per_ac) {
-		if (nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-					 pend_pkt_q)) {
-			first_nwb = nrf_wifi_utils_q_peek(fmac_dev_ctx->fpriv->opriv,
-							  pend_pkt_q);
+		if (nrf_wifi_utils_nbuf_q_len(pend_pkt_q)) {
+			first_nwb = nrf_wifi_utils_nbuf_q_peek(pend_pkt_q);
 
 			aggr_status = true;
 
@@ -934,8 +902,7 @@ enum nrf_wifi_fmac_tx_status tx_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_c
 		if (aggr_status) {
 			max_cmds = def_priv->data_config.max_tx_aggregation;
 
-			if (nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv,
-						 pend_pkt_q) < max_cmds) {
+			if (nrf_wifi_utils_nbuf_q_len(pend_pkt_q) < max_cmds) {
 				goto out;
 			}
 		}
@@ -1028,7 +995,7 @@ enum nrf_wifi_status tx_done_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	enum nrf_wifi_status status = NRF_WIFI_STATUS_FAIL;
 	struct nrf_wifi_fmac_priv *fpriv = NULL;
 	void *nwb = NULL;
-	void *nwb_list = NULL;
+	struct nrf_wifi_utils_nbuf_q *nwb_list = NULL;
 	unsigned int desc = 0;
 	unsigned int frame = 0;
 	unsigned int desc_id = 0;
@@ -1038,7 +1005,7 @@ enum nrf_wifi_status tx_done_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	unsigned int pkt = 0;
 	unsigned int pkts_pending = 0;
 	unsigned char queue = 0;
-	void *txq = NULL;
+	struct nrf_wifi_utils_nbuf_q *txq = NULL;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 	struct nrf_wifi_fmac_priv_def *def_priv = NULL;
 
@@ -1056,7 +1023,7 @@ enum nrf_wifi_status tx_done_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 	}
 
 	pkt_info = &def_dev_ctx->tx_config.pkt_info_p[desc];
-	nwb_list = pkt_info->pkt;
+	nwb_list = &pkt_info->pkt;
 
 	for (frame = 0;
 	     frame < def_dev_ctx->tx_config.send_pkt_coalesce_count_p[desc];
@@ -1094,10 +1061,9 @@ enum nrf_wifi_status tx_done_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 
 	pkt = 0;
 
-	while (nrf_wifi_utils_q_len(fpriv->opriv,
-				    nwb_list)) {
-		nwb = nrf_wifi_utils_q_dequeue(fpriv->opriv,
-					       nwb_list);
+	while (nrf_wifi_utils_nbuf_q_len(nwb_list)) {
+		nwb = nrf_wifi_utils_nbuf_q_dequeue(fpriv->opriv,
+						    nwb_list);
 
 		if (!nwb) {
 			continue;
@@ -1118,7 +1084,7 @@ enum nrf_wifi_status tx_done_process(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
 
 			pkt_info = &def_dev_ctx->tx_config.pkt_info_p[desc];
 
-			txq = pkt_info->pkt;
+			txq = &pkt_info->pkt;
 
 			status = tx_cmd_init(fmac_dev_ctx,
 					     txq,
@@ -1262,7 +1228,6 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 	struct nrf_wifi_fmac_priv *fpriv = NULL;
 	struct nrf_wifi_fmac_priv_def *def_priv = NULL;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
-	void *q_ptr = NULL;
 	unsigned int i = 0;
 	unsigned int j = 0;
 
@@ -1288,20 +1253,16 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 
 	for (i = 0; i < NRF_WIFI_FMAC_AC_MAX; i++) {
 		for (j = 0; j < MAX_SW_PEERS; j++) {
-			def_dev_ctx->tx_config.data_pending_txq[j][i] =
-				nrf_wifi_utils_q_alloc(fpriv->opriv);
-
-			if (!def_dev_ctx->tx_config.data_pending_txq[j][i]) {
-				nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
-						      "%s: Unable to allocate data_pending_txq\n",
-						      __func__);
-				goto coal_q_free;
-			}
+			nrf_wifi_utils_nbuf_q_init(&def_dev_ctx->tx_config.data_pending_txq[j][i]);
 		}
 
 		def_dev_ctx->tx_config.outstanding_descs[i] = 0;
+		def_dev_ctx->tx_config.pend_peer_bmp[i] = 0;
 	}
 
+	def_dev_ctx->tx_config.ps_peer_bmp = 0;
+	def_dev_ctx->tx_config.wakeup_peer_bmp = 0;
+
 	/* Used to store the address of tx'ed skb and len of 802.11 hdr
 	 * it will be used in tx complete.
 	 */
@@ -1313,18 +1274,11 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
 				      "%s: Unable to allocate pkt_info_p\n",
 				      __func__);
-		goto tx_q_free;
+		goto coal_q_free;
 	}
 
 	for (i = 0; i < def_priv->num_tx_tokens; i++) {
-		def_dev_ctx->tx_config.pkt_info_p[i].pkt = nrf_wifi_utils_list_alloc(fpriv->opriv);
-
-		if (!def_dev_ctx->tx_config.pkt_info_p[i].pkt) {
-			nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
-					      "%s: Unable to allocate pkt list\n",
-					      __func__);
-			goto tx_q_setup_free;
-		}
+		nrf_wifi_utils_nbuf_q_init(&def_dev_ctx->tx_config.pkt_info_p[i].pkt);
 	}
 
 	for (j = 0; j < NRF_WIFI_FMAC_AC_MAX; j++) {
@@ -1334,7 +1288,7 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 	def_dev_ctx->tx_config.buf_pool_bmp_p =
 		nrf_wifi_osal_mem_zalloc(fmac_dev_ctx->fpriv->opriv,
 					 (sizeof(unsigned long) *
-					  (def_priv->num_tx_tokens/TX_DESC_BUCKET_BOUND) + 1));
+					  TX_DESC_POOL_CNT(def_priv->num_tx_tokens)));
 
 	if (!def_dev_ctx->tx_config.buf_pool_bmp_p) {
 		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
@@ -1348,6 +1302,35 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 			      0,
 			      sizeof(long)*((def_priv->num_tx_tokens/TX_DESC_BUCKET_BOUND) + 1));
 
+	/* Reserved descs of an AC are strided by NRF_WIFI_FMAC_AC_MAX, which is
+	 * not a power of two, so precompute per bucket which descs each AC may
+	 * use to have tx_desc_get() pick a free one with a single bit scan.
+	 */
+	def_dev_ctx->tx_config.desc_mask_p =
+		nrf_wifi_osal_mem_zalloc(fmac_dev_ctx->fpriv->opriv,
+					 (sizeof(unsigned long) *
+					  TX_DESC_POOL_CNT(def_priv->num_tx_tokens) *
+					  TX_DESC_MASK_CNT));
+
+	if (!def_dev_ctx->tx_config.desc_mask_p) {
+		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
+				      "%s: Unable to allocate desc_mask_p\n",
+				      __func__);
+		goto tx_buff_map_free;
+	}
+
+	for (i = 0; i < def_priv->num_tx_tokens; i++) {
+		if (i < (def_priv->num_tx_tokens_per_ac * NRF_WIFI_FMAC_AC_MAX)) {
+			j = i % NRF_WIFI_FMAC_AC_MAX;
+		} else {
+			j = TX_DESC_MASK_SPARE;
+		}
+
+		def_dev_ctx->tx_config.desc_mask_p[((i / TX_DESC_BUCKET_BOUND) *
+						    TX_DESC_MASK_CNT) + j] |=
+			(1UL << (i % TX_DESC_BUCKET_BOUND));
+	}
+
 	for (i = 0; i < MAX_PEERS; i++) {
 		def_dev_ctx->tx_config.peers[i].peer_id = -1;
 	}
@@ -1358,21 +1341,12 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
 				      "%s: Unable to allocate TX lock\n",
 				      __func__);
-		goto tx_buff_map_free;
+		goto tx_desc_mask_free;
 	}
 
 	nrf_wifi_osal_spinlock_init(fmac_dev_ctx->fpriv->opriv,
 				    def_dev_ctx->tx_config.tx_lock);
 
-	def_dev_ctx->tx_config.wakeup_client_q = nrf_wifi_utils_q_alloc(fpriv->opriv);
-
-	if (!def_dev_ctx->tx_config.wakeup_client_q) {
-		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
-				      "%s: Unable to allocate Wakeup Client List\n",
-				      __func__);
-		goto tx_spin_lock_free;
-	}
-
 	def_dev_ctx->twt_sleep_status = NRF_WIFI_FMAC_TWT_STATE_AWAKE;
 
 #ifdef CONFIG_NRF700X_TX_DONE_WQ_ENABLED
@@ -1382,7 +1356,7 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 		nrf_wifi_osal_log_err(fmac_dev_ctx->fpriv->opriv,
 				      "%s: Unable to allocate tx_done_tasklet\n",
 				      __func__);
-		goto wakeup_client_q_free;
+		goto tx_spin_lock_free;
 	}
 	def_dev_ctx->tx_config.tx_done_tasklet_event_q = nrf_wifi_utils_q_alloc(fpriv->opriv);
 	if (!def_dev_ctx->tx_config.tx_done_tasklet_event_q) {
@@ -1402,32 +1376,19 @@ enum nrf_wifi_status tx_init(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 tx_done_tasklet_free:
 	nrf_wifi_osal_tasklet_free(fpriv->opriv,
 				   def_dev_ctx->tx_done_tasklet);
-wakeup_client_q_free:
-	nrf_wifi_utils_q_free(fpriv->opriv, def_dev_ctx->tx_config.wakeup_client_q);
-#endif /* CONFIG_NRF700X_TX_DONE_WQ_ENABLED */
 tx_spin_lock_free:
 	nrf_wifi_osal_spinlock_free(fmac_dev_ctx->fpriv->opriv,
 					def_dev_ctx->tx_config.tx_lock);
+#endif /* CONFIG_NRF700X_TX_DONE_WQ_ENABLED */
+tx_desc_mask_free:
+	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
+					def_dev_ctx->tx_config.desc_mask_p);
 tx_buff_map_free:
 	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
 					def_dev_ctx->tx_config.buf_pool_bmp_p);
 tx_pkt_info_free:
-	for (i = 0; i < def_priv->num_tx_tokens; i++) {
-		nrf_wifi_utils_list_free(fpriv->opriv,
-						def_dev_ctx->tx_config.pkt_info_p[i].pkt);
-	}
-tx_q_setup_free:
 	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
 							def_dev_ctx->tx_config.pkt_info_p);
-tx_q_free:
-	for (i = 0; i < NRF_WIFI_FMAC_AC_MAX; i++) {
-		for (j = 0; j < MAX_SW_PEERS; j++) {
-			q_ptr = def_dev_ctx->tx_config.data_pending_txq[j][i];
-
-			nrf_wifi_utils_q_free(fpriv->opriv,
-							q_ptr);
-		}
-	}
 coal_q_free:
 	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
 					def_dev_ctx->tx_config.send_pkt_coalesce_count_p);
@@ -1440,13 +1401,9 @@ void tx_deinit(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 {
 	struct nrf_wifi_fmac_priv *fpriv = NULL;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
-	struct nrf_wifi_fmac_priv_def *def_priv = NULL;
-	unsigned int i = 0;
-	unsigned int j = 0;
 
 	fpriv = fmac_dev_ctx->fpriv;
 
-	def_priv = wifi_fmac_priv(fpriv);
 	def_dev_ctx = wifi_dev_priv(fmac_dev_ctx);
 
 #ifdef CONFIG_NRF700X_TX_DONE_WQ_ENABLED
@@ -1456,32 +1413,18 @@ void tx_deinit(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx)
 	nrf_wifi_utils_q_free(fpriv->opriv,
 			      def_dev_ctx->tx_config.tx_done_tasklet_event_q);
 #endif /* CONFIG_NRF700X_TX_DONE_WQ_ENABLED */
-	nrf_wifi_utils_q_free(fpriv->opriv,
-			      def_dev_ctx->tx_config.wakeup_client_q);
-
 	nrf_wifi_osal_spinlock_free(fmac_dev_ctx->fpriv->opriv,
 				    def_dev_ctx->tx_config.tx_lock);
 
 	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
-			       def_dev_ctx->tx_config.buf_pool_bmp_p);
+			       def_dev_ctx->tx_config.desc_mask_p);
 
-	for (i = 0; i < def_priv->num_tx_tokens; i++) {
-		if (def_dev_ctx->tx_config.pkt_info_p) {
-			nrf_wifi_utils_list_free(fpriv->opriv,
-						 def_dev_ctx->tx_config.pkt_info_p[i].pkt);
-		}
-	}
+	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
+			       def_dev_ctx->tx_config.buf_pool_bmp_p);
 
 	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
 			       def_dev_ctx->tx_config.pkt_info_p);
 
-	for (i = 0; i < NRF_WIFI_FMAC_AC_MAX; i++) {
-		for (j = 0; j < MAX_SW_PEERS; j++) {
-			nrf_wifi_utils_q_free(fpriv->opriv,
-					      def_dev_ctx->tx_config.data_pending_txq[j][i]);
-		}
-	}
-
 	nrf_wifi_osal_mem_free(fmac_dev_ctx->fpriv->opriv,
 			       def_dev_ctx->tx_config.send_pkt_coalesce_count_p);
 
@@ -721,6 +721,39 @@ void *nrf_wifi_osal_nbuf_data_pull(struct nrf_wifi_osal_priv *opriv,
  */
 unsigned char nrf_wifi_osal_nbuf_get_priority(struct nrf_wifi_osal_priv *opriv,
 					       void *nbuf);
+
+
+/**
+ * nrf_wifi_osal_nbuf_next_get() - Get the next network buffer in a queue.
+ *
+ * @opriv: Pointer to the OSAL context returned by the @nrf_wifi_osal_init API.
+ * @nbuf: Pointer to a network buffer.
+ *
+ * Gets the network buffer linked after a network buffer(@nbuf) using
+ * @nrf_wifi_osal_nbuf_next_set.
+ *
+ * Return: Pointer to the next network buffer, NULL if there is none.
+ */
+void *nrf_wifi_osal_nbuf_next_get(struct nrf_wifi_osal_priv *opriv,
+				  void *nbuf);
+
+
+/**
+ * nrf_wifi_osal_nbuf_next_set() - Set the next network buffer in a queue.
+ *
+ * @opriv: Pointer to the OSAL context returned by the @nrf_wifi_osal_init API.
+ * @nbuf: Pointer to a network buffer.
+ * @next: Pointer to the network buffer to be linked after @nbuf, or NULL.
+ *
+ * Links a network buffer(@next) after a network buffer(@nbuf). The link is
+ * stored in the network buffer itself, so queueing network buffers does not
+ * need any memory allocation.
+ *
+ * Return: None.
+ */
+void nrf_wifi_osal_nbuf_next_set(struct nrf_wifi_osal_priv *opriv,
+				 void *nbuf,
+				 void *next);
 /**
  * nrf_wifi_osal_tasklet_alloc() - Allocate a tasklet.
  * @opriv: Pointer to the OSAL context returned by the @nrf_wifi_osal_init API.
@@ -104,6 +104,10 @@
  *                  bytes at the start of the area and return the pointer to the
  *                  beginning of the data area.
  * @nbuf_get_priority: Get the priority of a network buffer(@nbuf).
+ * @nbuf_next_get: Get the network buffer linked after a network buffer(@nbuf)
+ *                 in a queue.
+ * @nbuf_next_set: Link a network buffer(@next) after a network buffer(@nbuf)
+ *                 in a queue.
  *
  * @tasklet_alloc: Allocate a tasklet structure and return a pointer to it.
  * @tasklet_free: Free a tasklet structure that had been allocated using
@@ -241,6 +245,8 @@ struct nrf_wifi_osal_ops {
 	void *(*nbuf_data_push)(void *nbuf, unsigned int size);
 	void *(*nbuf_data_pull)(void *nbuf, unsigned int size);
 	unsigned char (*nbuf_get_priority)(void *nbuf);
+	void *(*nbuf_next_get)(void *nbuf);
+	void (*nbuf_next_set)(void *nbuf, void *next);
 
 	void *(*tasklet_alloc)(int type);
 	void (*tasklet_free)(void *tasklet);
@@ -432,6 +432,22 @@ unsigned char nrf_wifi_osal_nbuf_get_priority(struct nrf_wifi_osal_priv *opriv,
 }
 
 
+void *nrf_wifi_osal_nbuf_next_get(struct nrf_wifi_osal_priv *opriv,
+				  void *nbuf)
+{
+	return opriv->ops->nbuf_next_get(nbuf);
+}
+
+
+void nrf_wifi_osal_nbuf_next_set(struct nrf_wifi_osal_priv *opriv,
+				 void *nbuf,
+				 void *next)
+{
+	opriv->ops->nbuf_next_set(nbuf,
+				  next);
+}
+
+
 void *nrf_wifi_osal_tasklet_alloc(struct nrf_wifi_osal_priv *opriv, int type)
 {
 	return opriv->ops->tasklet_alloc(type);
@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @brief Header containing network buffer queue specific declarations
+ * for the Wi-Fi driver.
+ */
+
+#ifndef __NBUF_QUEUE_H__
+#define __NBUF_QUEUE_H__
+
+#include <stddef.h>
+#include "osal_api.h"
+
+/**
+ * struct nrf_wifi_utils_nbuf_q - Queue of network buffers.
+ * @head: First network buffer in the queue.
+ * @tail: Last network buffer in the queue.
+ * @len: Number of network buffers in the queue.
+ *
+ * The network buffers are linked through the link stored in their header
+ * (see @nrf_wifi_osal_nbuf_next_get), so no memory is allocated when
+ * queueing them. A network buffer can be in only one queue at a time.
+ */
+struct nrf_wifi_utils_nbuf_q {
+	void *head;
+	void *tail;
+	unsigned int len;
+};
+
+void nrf_wifi_utils_nbuf_q_init(struct nrf_wifi_utils_nbuf_q *q);
+
+void nrf_wifi_utils_nbuf_q_enqueue(struct nrf_wifi_osal_priv *opriv,
+				   struct nrf_wifi_utils_nbuf_q *q,
+				   void *nbuf);
+
+void nrf_wifi_utils_nbuf_q_enqueue_head(struct nrf_wifi_osal_priv *opriv,
+					struct nrf_wifi_utils_nbuf_q *q,
+					void *nbuf);
+
+void *nrf_wifi_utils_nbuf_q_dequeue(struct nrf_wifi_osal_priv *opriv,
+				    struct nrf_wifi_utils_nbuf_q *q);
+
+void *nrf_wifi_utils_nbuf_q_peek(struct nrf_wifi_utils_nbuf_q *q);
+
+unsigned int nrf_wifi_utils_nbuf_q_len(struct nrf_wifi_utils_nbuf_q *q);
+
+enum nrf_wifi_status
+nrf_wifi_utils_nbuf_q_traverse(struct nrf_wifi_osal_priv *opriv,
+			       struct nrf_wifi_utils_nbuf_q *q,
+			       void *callbk_data,
+			       enum nrf_wifi_status (*callbk_func)(void *callbk_data,
+								   void *nbuf));
+#endif /* __NBUF_QUEUE_H__ */
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @brief File containing network buffer queue specific definitions
+ * for the Wi-Fi driver.
+ */
+
+#include "nbuf_queue.h"
+
+void nrf_wifi_utils_nbuf_q_init(struct nrf_wifi_utils_nbuf_q *q)
+{
+	q->head = NULL;
+	q->tail = NULL;
+	q->len = 0;
+}
+
+
+void nrf_wifi_utils_nbuf_q_enqueue(struct nrf_wifi_osal_priv *opriv,
+				   struct nrf_wifi_utils_nbuf_q *q,
+				   void *nbuf)
+{
+	nrf_wifi_osal_nbuf_next_set(opriv,
+				    nbuf,
+				    NULL);
+
+	if (q->tail) {
+		nrf_wifi_osal_nbuf_next_set(opriv,
+					    q->tail,
+					    nbuf);
+	} else {
+		q->head = nbuf;
+	}
+
+	q->tail = nbuf;
+	q->len++;
+}
+
+
+void nrf_wifi_utils_nbuf_q_enqueue_head(struct nrf_wifi_osal_priv *opriv,
+					struct nrf_wifi_utils_nbuf_q *q,
+					void *nbuf)
+{
+	nrf_wifi_osal_nbuf_next_set(opriv,
+				    nbuf,
+				    q->head);
+
+	if (!q->tail) {
+		q->tail = nbuf;
+	}
+
+	q->head = nbuf;
+	q->len++;
+}
+
+
+void *nrf_wifi_utils_nbuf_q_dequeue(struct nrf_wifi_osal_priv *opriv,
+				    struct nrf_wifi_utils_nbuf_q *q)
+{
+	void *nbuf = q->head;
+
+	if (!nbuf) {
+		goto out;
+	}
+
+	q->head = nrf_wifi_osal_nbuf_next_get(opriv,
+					      nbuf);
+
+	if (!q->head) {
+		q->tail = NULL;
+	}
+
+	nrf_wifi_osal_nbuf_next_set(opriv,
+				    nbuf,
+				    NULL);
+	q->len--;
+
+out:
+	return nbuf;
+}
+
+
+void *nrf_wifi_utils_nbuf_q_peek(struct nrf_wifi_utils_nbuf_q *q)
+{
+	return q->head;
+}
+
+
+unsigned int nrf_wifi_utils_nbuf_q_len(struct nrf_wifi_utils_nbuf_q *q)
+{
+	return q->len;
+}
+
+
+enum nrf_wifi_status
+nrf_wifi_utils_nbuf_q_traverse(struct nrf_wifi_osal_priv *opriv,
+			       struct nrf_wifi_utils_nbuf_q *q,
+			       void *callbk_data,
+			       enum nrf_wifi_status (*callbk_func)(void *callbk_data,
+								   void *nbuf))
+{
+	enum nrf_wifi_status status = NRF_WIFI_STATUS_FAIL;
+	void *nbuf = q->head;
+
+	while (nbuf) {
+		status = callbk_func(callbk_data,
+				     nbuf);
+
+		if (status != NRF_WIFI_STATUS_SUCCESS) {
+			goto out;
+		}
+
+		nbuf = nrf_wifi_osal_nbuf_next_get(opriv,
+						   nbuf);
+	}
+out:
+	return status;
+}
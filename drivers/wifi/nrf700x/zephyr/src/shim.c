@@ -194,182 +194,6 @@ static int zep_shim_pr_err(const char *fmt, va_list args)
 	return 0;
 }
 
-struct nwb {
-	unsigned char *data;
-	unsigned char *tail;
-	int len;
-	int headroom;
-	void *next;
-	void *priv;
-	int iftype;
-	void *ifaddr;
-	void *dev;
-	int hostbuffer;
-	void *cleanup_ctx;
-	void (*cleanup_cb)();
-	unsigned char priority;
-};
-
-static void *zep_shim_nbuf_alloc(unsigned int size)
-{
-	struct nwb *nwb;
-
-	nwb = (struct nwb *)k_calloc(sizeof(struct nwb), sizeof(char));
-
-	if (!nwb)
-		return NULL;
-
-	nwb->priv = k_calloc(size, sizeof(char));
-
-	if (!nwb->priv) {
-		k_free(nwb);
-		return NULL;
-	}
-
-	nwb->data = (unsigned char *)nwb->priv;
-	nwb->tail = nwb->data;
-	nwb->len = 0;
-	nwb->headroom = 0;
-	nwb->next = NULL;
-
-	return nwb;
-}
-
-static void zep_shim_nbuf_free(void *nbuf)
-{
-	struct nwb *nwb;
-
-	nwb = nbuf;
-
-	k_free(((struct nwb *)nbuf)->priv);
-
-	k_free(nbuf);
-}
-
-static void zep_shim_nbuf_headroom_res(void *nbuf, unsigned int size)
-{
-	struct nwb *nwb = (struct nwb *)nbuf;
-
-	nwb->data += size;
-	nwb->tail += size;
-	nwb->headroom += size;
-}
-
-static unsigned int zep_shim_nbuf_headroom_get(void *nbuf)
-{
-	return ((struct nwb *)nbuf)->headroom;
-}
-
-static unsigned int zep_shim_nbuf_data_size(void *nbuf)
-{
-	return ((struct nwb *)nbuf)->len;
-}
-
-static void *zep_shim_nbuf_data_get(void *nbuf)
-{
-	return ((struct nwb *)nbuf)->data;
-}
-
-static void *zep_shim_nbuf_data_put(void *nbuf, unsigned int size)
-{
-	struct nwb *nwb = (struct nwb *)nbuf;
-	unsigned char *data = nwb->tail;
-
-	nwb->tail += size;
-	nwb->len += size;
-
-	return data;
-}
-
-static void *zep_shim_nbuf_data_push(void *nbuf, unsigned int size)
-{
-	struct nwb *nwb = (struct nwb *)nbuf;
-
-	nwb->data -= size;
-	nwb->headroom -= size;
-	nwb->len += size;
-
-	return nwb->data;
-}
-
-static void *zep_shim_nbuf_data_pull(void *nbuf, unsigned int size)
-{
-	struct nwb *nwb = (struct nwb *)nbuf;
-
-	nwb->data += size;
-	nwb->headroom += size;
-	nwb->len -= size;
-
-	return nwb->data;
-}
-
-static unsigned char zep_shim_nbuf_get_priority(void *nbuf)
-{
-	struct nwb *nwb = (struct nwb *)nbuf;
-
-	return nwb->priority;
-}
-
-#include <zephyr/net/ethernet.h>
-#include <zephyr/net/net_core.h>
-
-void *net_pkt_to_nbuf(struct net_pkt *pkt)
-{
-	struct nwb *nwb;
-	unsigned char *data;
-	unsigned int len;
-
-	len = net_pkt_get_len(pkt);
-
-	nwb = zep_shim_nbuf_alloc(len + 100);
-
-	if (!nwb) {
-		return NULL;
-	}
-
-	zep_shim_nbuf_headroom_res(nwb, 100);
-
-	data = zep_shim_nbuf_data_put(nwb, len);
-
-	net_pkt_read(pkt, data, len);
-
-	nwb->priority = net_pkt_priority(pkt);
-
-	return nwb;
-}
-
-void *net_pkt_from_nbuf(void *iface, void *frm)
-{
-	struct net_pkt *pkt = NULL;
-	unsigned char *data;
-	unsigned int len;
-	struct nwb *nwb = frm;
-
-	if (!nwb) {
-		return NULL;
-	}
-
-	len = zep_shim_nbuf_data_size(nwb);
-
-	data = zep_shim_nbuf_data_get(nwb);
-
-	pkt = net_pkt_rx_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_MSEC(100));
-
-	if (!pkt) {
-		goto out;
-	}
-
-	if (net_pkt_write(pkt, data, len)) {
-		net_pkt_unref(pkt);
-		pkt = NULL;
-		goto out;
-	}
-
-out:
-	zep_shim_nbuf_free(nwb);
-	return pkt;
-}
-
 static void *zep_shim_llist_node_alloc(void)
 {
 	struct zep_shim_llist_node *llist_node = NULL;
@@ -846,6 +670,8 @@ static const struct nrf_wifi_osal_ops nrf_wifi_os_zep_ops = {
 	.nbuf_data_push = zep_shim_nbuf_data_push,
 	.nbuf_data_pull = zep_shim_nbuf_data_pull,
 	.nbuf_get_priority = zep_shim_nbuf_get_priority,
+	.nbuf_next_get = zep_shim_nbuf_next_get,
+	.nbuf_next_set = zep_shim_nbuf_next_set,
 
 	.tasklet_alloc = zep_shim_work_alloc,
 	.tasklet_free = zep_shim_work_free,
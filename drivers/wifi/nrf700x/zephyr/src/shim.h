@@ -16,6 +16,8 @@
 #include <zephyr/drivers/gpio.h>
 #include <zephyr/net/net_pkt.h>
 
+#include "zephyr_nbuf.h"
+
 /**
  * struct zep_shim_bus_qspi_priv - Structure to hold context information for the Linux OS
  *                        shim.
@@ -55,7 +57,4 @@ struct zep_shim_llist {
 	unsigned int len;
 };
 
-void *net_pkt_to_nbuf(struct net_pkt *pkt);
-void *net_pkt_from_nbuf(void *iface, void *frm);
-
 #endif /* __SHIM_H__ */
@@ -0,0 +1,338 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @brief File containing network buffer specific definitions for the
+ * Zephyr OS layer of the Wi-Fi driver.
+ */
+
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/net/net_pkt.h>
+#include <zephyr/net/buf.h>
+
+#include "fmac_rx.h"
+#include "zephyr_nbuf.h"
+
+struct nwb {
+	unsigned char *data;
+	unsigned char *tail;
+	int len;
+	int headroom;
+	void *next;
+	void *priv;
+	int iftype;
+	void *ifaddr;
+	void *dev;
+	int hostbuffer;
+	void *cleanup_ctx;
+	void (*cleanup_cb)();
+	unsigned char priority;
+	/* Pool buffer holding the data, with this structure in its user data. */
+	struct net_buf *buf;
+	/* Packet holding the data, if it is transmitted without copying. */
+	struct net_pkt *pkt;
+};
+
+#ifdef CONFIG_NRF700X_NET_BUF_POOL
+/* The HAL copies TX frames to the RPU rounded up to a multiple of 4 bytes. */
+#define TX_ALIGN_TAILROOM 3
+
+#define NBUF_POOL_DATA_SIZE \
+	ROUND_UP(MAX(CONFIG_NRF700X_RX_MAX_DATA_SIZE + RX_BUF_HEADROOM, \
+		     CONFIG_NRF700X_TX_MAX_DATA_SIZE + TX_ALIGN_TAILROOM), 4)
+
+NET_BUF_POOL_FIXED_DEFINE(nbuf_pool, CONFIG_NRF700X_NET_BUF_POOL_CNT, NBUF_POOL_DATA_SIZE,
+			  sizeof(struct nwb), NULL);
+
+K_MEM_SLAB_DEFINE_STATIC(nwb_slab, sizeof(struct nwb), CONFIG_NRF700X_NET_BUF_TX_WRAP_CNT,
+			 __alignof__(struct nwb));
+
+static struct nwb *nbuf_pool_alloc(unsigned int size)
+{
+	struct net_buf *buf;
+	struct nwb *nwb;
+
+	if (size > NBUF_POOL_DATA_SIZE) {
+		return NULL;
+	}
+
+	buf = net_buf_alloc(&nbuf_pool, K_NO_WAIT);
+
+	if (!buf) {
+		return NULL;
+	}
+
+	nwb = net_buf_user_data(buf);
+
+	memset(nwb, 0, sizeof(*nwb));
+
+	nwb->data = buf->data;
+	nwb->tail = nwb->data;
+	nwb->buf = buf;
+
+	return nwb;
+}
+
+static struct nwb *nbuf_pkt_wrap(struct net_pkt *pkt, unsigned int len)
+{
+	struct net_buf *buf = pkt->buffer;
+	struct nwb *nwb;
+
+	/* The FMAC needs the frame in contiguous memory. */
+	if (!buf || buf->frags || (buf->len != len) ||
+	    (net_buf_tailroom(buf) < TX_ALIGN_TAILROOM)) {
+		return NULL;
+	}
+
+	if (k_mem_slab_alloc(&nwb_slab, (void **)&nwb, K_NO_WAIT)) {
+		return NULL;
+	}
+
+	memset(nwb, 0, sizeof(*nwb));
+
+	nwb->data = buf->data;
+	nwb->tail = buf->data + len;
+	nwb->len = len;
+	nwb->headroom = net_buf_headroom(buf);
+	nwb->priority = net_pkt_priority(pkt);
+	nwb->pkt = net_pkt_ref(pkt);
+
+	return nwb;
+}
+
+static struct net_pkt *nbuf_pool_to_pkt(struct net_if *iface, struct nwb *nwb)
+{
+	struct net_buf *buf = nwb->buf;
+	size_t offset = nwb->data - buf->__buf;
+	size_t len = nwb->len;
+	struct net_pkt *pkt;
+
+	pkt = net_pkt_rx_alloc_on_iface(iface, K_MSEC(100));
+
+	if (!pkt) {
+		net_buf_unref(buf);
+		return NULL;
+	}
+
+	/* The buffer is passed to the networking stack, overwriting the
+	 * network buffer structure in its user data is fine from now on.
+	 */
+	net_buf_reserve(buf, offset);
+	net_buf_add(buf, len);
+	net_pkt_append_buffer(pkt, buf);
+
+	return pkt;
+}
+#endif /* CONFIG_NRF700X_NET_BUF_POOL */
+
+void *zep_shim_nbuf_alloc(unsigned int size)
+{
+	struct nwb *nwb;
+
+#ifdef CONFIG_NRF700X_NET_BUF_POOL
+	nwb = nbuf_pool_alloc(size);
+
+	if (nwb) {
+		return nwb;
+	}
+#endif /* CONFIG_NRF700X_NET_BUF_POOL */
+
+	nwb = (struct nwb *)k_calloc(sizeof(struct nwb), sizeof(char));
+
+	if (!nwb)
+		return NULL;
+
+	nwb->priv = k_calloc(size, sizeof(char));
+
+	if (!nwb->priv) {
+		k_free(nwb);
+		return NULL;
+	}
+
+	nwb->data = (unsigned char *)nwb->priv;
+	nwb->tail = nwb->data;
+	nwb->len = 0;
+	nwb->headroom = 0;
+	nwb->next = NULL;
+
+	return nwb;
+}
+
+void zep_shim_nbuf_free(void *nbuf)
+{
+	struct nwb *nwb;
+
+	nwb = nbuf;
+
+#ifdef CONFIG_NRF700X_NET_BUF_POOL
+	if (nwb->buf) {
+		net_buf_unref(nwb->buf);
+		return;
+	}
+
+	if (nwb->pkt) {
+		net_pkt_unref(nwb->pkt);
+		k_mem_slab_free(&nwb_slab, (void *)nwb);
+		return;
+	}
+#endif /* CONFIG_NRF700X_NET_BUF_POOL */
+
+	k_free(nwb->priv);
+
+	k_free(nwb);
+}
+
+void zep_shim_nbuf_headroom_res(void *nbuf, unsigned int size)
+{
+	struct nwb *nwb = (struct nwb *)nbuf;
+
+	nwb->data += size;
+	nwb->tail += size;
+	nwb->headroom += size;
+}
+
+unsigned int zep_shim_nbuf_headroom_get(void *nbuf)
+{
+	return ((struct nwb *)nbuf)->headroom;
+}
+
+unsigned int zep_shim_nbuf_data_size(void *nbuf)
+{
+	return ((struct nwb *)nbuf)->len;
+}
+
+void *zep_shim_nbuf_data_get(void *nbuf)
+{
+	return ((struct nwb *)nbuf)->data;
+}
+
+void *zep_shim_nbuf_data_put(void *nbuf, unsigned int size)
+{
+	struct nwb *nwb = (struct nwb *)nbuf;
+	unsigned char *data = nwb->tail;
+
+	nwb->tail += size;
+	nwb->len += size;
+
+	return data;
+}
+
+void *zep_shim_nbuf_data_push(void *nbuf, unsigned int size)
+{
+	struct nwb *nwb = (struct nwb *)nbuf;
+
+	nwb->data -= size;
+	nwb->headroom -= size;
+	nwb->len += size;
+
+	return nwb->data;
+}
+
+void *zep_shim_nbuf_data_pull(void *nbuf, unsigned int size)
+{
+	struct nwb *nwb = (struct nwb *)nbuf;
+
+	nwb->data += size;
+	nwb->headroom += size;
+	nwb->len -= size;
+
+	return nwb->data;
+}
+
+unsigned char zep_shim_nbuf_get_priority(void *nbuf)
+{
+	struct nwb *nwb = (struct nwb *)nbuf;
+
+	return nwb->priority;
+}
+
+void *zep_shim_nbuf_next_get(void *nbuf)
+{
+	return ((struct nwb *)nbuf)->next;
+}
+
+void zep_shim_nbuf_next_set(void *nbuf, void *next)
+{
+	((struct nwb *)nbuf)->next = next;
+}
+
+void *net_pkt_to_nbuf(struct net_pkt *pkt)
+{
+	struct nwb *nwb = NULL;
+	unsigned char *data;
+	unsigned int len;
+
+	len = net_pkt_get_len(pkt);
+
+#ifdef CONFIG_NRF700X_NET_BUF_POOL
+	nwb = nbuf_pkt_wrap(pkt, len);
+
+	if (nwb) {
+		return nwb;
+	}
+
+	/* The FMAC does not add headers to TX frames, no headroom is needed. */
+	nwb = nbuf_pool_alloc(len);
+#endif /* CONFIG_NRF700X_NET_BUF_POOL */
+
+	if (!nwb) {
+		nwb = zep_shim_nbuf_alloc(len + 100);
+
+		if (!nwb) {
+			return NULL;
+		}
+
+		zep_shim_nbuf_headroom_res(nwb, 100);
+	}
+
+	data = zep_shim_nbuf_data_put(nwb, len);
+
+	net_pkt_read(pkt, data, len);
+
+	nwb->priority = net_pkt_priority(pkt);
+
+	return nwb;
+}
+
+void *net_pkt_from_nbuf(void *iface, void *frm)
+{
+	struct net_pkt *pkt = NULL;
+	unsigned char *data;
+	unsigned int len;
+	struct nwb *nwb = frm;
+
+	if (!nwb) {
+		return NULL;
+	}
+
+#ifdef CONFIG_NRF700X_NET_BUF_POOL
+	if (nwb->buf) {
+		return nbuf_pool_to_pkt(iface, nwb);
+	}
+#endif /* CONFIG_NRF700X_NET_BUF_POOL */
+
+	len = zep_shim_nbuf_data_size(nwb);
+
+	data = zep_shim_nbuf_data_get(nwb);
+
+	pkt = net_pkt_rx_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_MSEC(100));
+
+	if (!pkt) {
+		goto out;
+	}
+
+	if (net_pkt_write(pkt, data, len)) {
+		net_pkt_unref(pkt);
+		pkt = NULL;
+		goto out;
+	}
+
+out:
+	zep_shim_nbuf_free(nwb);
+	return pkt;
+}
@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @brief Header containing network buffer specific declarations for the
+ * Zephyr OS layer of the Wi-Fi driver.
+ */
+
+#ifndef __ZEPHYR_NBUF_H__
+#define __ZEPHYR_NBUF_H__
+
+#include <zephyr/net/net_pkt.h>
+
+void *zep_shim_nbuf_alloc(unsigned int size);
+
+void zep_shim_nbuf_free(void *nbuf);
+
+void zep_shim_nbuf_headroom_res(void *nbuf, unsigned int size);
+
+unsigned int zep_shim_nbuf_headroom_get(void *nbuf);
+
+unsigned int zep_shim_nbuf_data_size(void *nbuf);
+
+void *zep_shim_nbuf_data_get(void *nbuf);
+
+void *zep_shim_nbuf_data_put(void *nbuf, unsigned int size);
+
+void *zep_shim_nbuf_data_push(void *nbuf, unsigned int size);
+
+void *zep_shim_nbuf_data_pull(void *nbuf, unsigned int size);
+
+unsigned char zep_shim_nbuf_get_priority(void *nbuf);
+
+void *zep_shim_nbuf_next_get(void *nbuf);
+
+void zep_shim_nbuf_next_set(void *nbuf, void *next);
+
+/**
+ * net_pkt_to_nbuf() - Get a network buffer for transmitting a packet.
+ * @pkt: Packet to be transmitted.
+ *
+ * With CONFIG_NRF700X_NET_BUF_POOL, a packet with the data in a single
+ * fragment is referenced by the network buffer instead of being copied.
+ *
+ * Return: Network buffer, or NULL if it could not be allocated.
+ */
+void *net_pkt_to_nbuf(struct net_pkt *pkt);
+
+/**
+ * net_pkt_from_nbuf() - Get a packet with a received frame.
+ * @iface: Network interface.
+ * @frm: Network buffer with the frame, freed by this function.
+ *
+ * With CONFIG_NRF700X_NET_BUF_POOL, a network buffer allocated from the pool
+ * is passed to the networking stack as the packet data instead of being
+ * copied.
+ *
+ * Return: Packet, or NULL if it could not be allocated.
+ */
+void *net_pkt_from_nbuf(void *iface, void *frm);
+
+#endif /* __ZEPHYR_NBUF_H__ */
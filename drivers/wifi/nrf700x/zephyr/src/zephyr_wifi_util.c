@@ -310,7 +310,7 @@ static int nrf_wifi_util_tx_stats(const struct shell *shell,
 	int peer_index = 0;
 	int max_vif_index = MAX(MAX_NUM_APS, MAX_NUM_STAS);
 	struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx = NULL;
-	void *queue = NULL;
+	struct nrf_wifi_utils_nbuf_q *queue = NULL;
 	unsigned int tx_pending_pkts = 0;
 	struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx = NULL;
 
@@ -334,8 +334,8 @@ static int nrf_wifi_util_tx_stats(const struct shell *shell,
 		vif_index);
 
 	for (int i = 0; i < NRF_WIFI_FMAC_AC_MAX ; i++) {
-		queue = def_dev_ctx->tx_config.data_pending_txq[peer_index][i];
-		tx_pending_pkts = nrf_wifi_utils_q_len(fmac_dev_ctx->fpriv->opriv, queue);
+		queue = &def_dev_ctx->tx_config.data_pending_txq[peer_index][i];
+		tx_pending_pkts = nrf_wifi_utils_nbuf_q_len(queue);
 
 		shell_fprintf(
 			shell,
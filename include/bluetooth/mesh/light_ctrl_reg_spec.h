@@ -33,14 +33,42 @@ extern "C" {
 		}                                                              \
 	}
 
+/** @cond INTERNAL_HIDDEN */
+struct bt_mesh_light_ctrl_reg_spec_q_cfg {
+	int64_t ki_up;
+	int64_t ki_down;
+	int64_t kp_up;
+	int64_t kp_down;
+	int64_t accuracy;
+};
+
+struct bt_mesh_light_ctrl_reg_spec_q_input {
+	/* Bit pattern of the float value the fixed-point value was converted from. */
+	uint32_t bits;
+	int64_t q;
+};
+/** @endcond */
+
 /** Specification-defined illuminance regulator context. */
 struct bt_mesh_light_ctrl_reg_spec {
 	/** Common regulator context. */
 	struct bt_mesh_light_ctrl_reg reg;
 	/** Regulator step timer. */
 	struct k_work_delayable timer;
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+	/** Internal integral sum, in Q16.16 fixed-point format. */
+	int64_t i;
+	/** @cond INTERNAL_HIDDEN */
+	/* Regulator configuration the fixed-point coefficients were derived from. */
+	struct bt_mesh_light_ctrl_reg_cfg cfg;
+	struct bt_mesh_light_ctrl_reg_spec_q_cfg cfg_q;
+	struct bt_mesh_light_ctrl_reg_spec_q_input target_q;
+	struct bt_mesh_light_ctrl_reg_spec_q_input measured_q;
+	/** @endcond */
+#else
 	/** Internal integral sum. */
 	float i;
+#endif
 	/** Regulator enabled flag. */
 	bool enabled;
 	/* If true, internal integral sum can be negative until it becomes positive. */
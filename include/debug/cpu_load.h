@@ -6,6 +6,7 @@
 #ifndef __CPU_LOAD_H
 #define __CPU_LOAD_H
 
+#include <zephyr/kernel.h>
 #include <zephyr/types.h>
 
 #ifdef __cplusplus
@@ -21,8 +22,8 @@ extern "C" {
 
 /** @brief Initialize the CPU load measurement module.
  *
- * The TIMER driver and PPI channels are allocated during the initialization of
- * this module.
+ * With the TIMER backend, the TIMER driver and PPI channels are allocated
+ * during the initialization of this module.
  *
  * @retval 0 The initialization is successful.
  * @retval -ENODEV PPI channels could not be allocated.
@@ -32,8 +33,8 @@ int cpu_load_init(void);
 
 /** @brief Reset measurement.
  *
- * Measurement must be reset at least every 4294 seconds. If not, results are
- * invalid.
+ * With the TIMER backend, measurement must be reset at least every 4294
+ * seconds. If not, results are invalid.
  */
 void cpu_load_reset(void);
 
@@ -46,6 +47,46 @@ void cpu_load_reset(void);
  */
 uint32_t cpu_load_get(void);
 
+/** @brief Get the CPU load of a thread.
+ *
+ * The load is the share of the time since the last reset during which the
+ * thread was running, in the same units as @ref cpu_load_get.
+ *
+ * Supported only by the kernel thread usage backend with
+ * CONFIG_CPU_LOAD_THREADS enabled.
+ *
+ * @param thread Thread.
+ * @param load Pointer to the load value.
+ *
+ * @retval 0 The load is provided.
+ * @retval -ENOMEM The thread existed on the reset, but its reference point
+ *		   could not be stored. See CONFIG_CPU_LOAD_THREADS_MAX.
+ * @retval -ENOTSUP The backend does not support per-thread load.
+ * @retval -EINVAL Invalid thread.
+ */
+int cpu_load_thread_get(k_tid_t thread, uint32_t *load);
+
+/** @brief Get the CPU load histogram.
+ *
+ * The CPU load is measured in consecutive windows of
+ * CONFIG_CPU_LOAD_HISTOGRAM_WINDOW milliseconds and the results of the last
+ * CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS windows are kept. The function provides the
+ * number of these windows for each of @p bucket_cnt equal load ranges, where
+ * the last range includes the 100% load. The histogram is not affected by
+ * @ref cpu_load_reset.
+ *
+ * Supported only by the kernel thread usage backend with
+ * CONFIG_CPU_LOAD_HISTOGRAM enabled.
+ *
+ * @param buckets Array to be filled with the number of windows in each range.
+ * @param bucket_cnt Number of elements in @p buckets.
+ *
+ * @return Number of windows in the histogram or a negative error code.
+ * @retval -EINVAL Invalid parameters.
+ * @retval -ENOTSUP The backend does not support the histogram.
+ */
+int cpu_load_histogram_get(uint32_t *buckets, size_t bucket_cnt);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -143,6 +143,10 @@ int emds_store(void);
  * called before the @ref emds_prepare function which will delete all the
  * previously stored data.
  *
+ * If CONFIG_EMDS_INCREMENTAL is enabled, the latest stored copy of each entry
+ * is loaded, and the @ref emds_prepare function keeps the previously stored
+ * data.
+ *
  * @retval 0 Success
  * @retval -ERRNO errno code if error
  */
@@ -180,6 +184,12 @@ int emds_prepare(void);
  * registered in the entries. This value is dependent on the chip used, and
  * should be checked against the chip datasheet.
  *
+ * If CONFIG_EMDS_INCREMENTAL is enabled and the storage is prepared, only the
+ * entries that differ from their latest stored copy are included in the write
+ * time, and the time to compare every entry with its latest stored copy is
+ * added. The estimate is for the entry data at the time of the call, so it
+ * must be obtained again after the entries change.
+ *
  * @return Time needed to store all data (in microseconds).
  */
 uint32_t emds_store_time_get(void);
@@ -190,6 +200,9 @@ uint32_t emds_store_time_get(void);
  * Calculates the size it takes to store all dynamic and static data registered
  * in the entries.
  *
+ * If CONFIG_EMDS_INCREMENTAL is enabled and the storage is prepared, only the
+ * entries that differ from their latest stored copy are included.
+ *
  * @return Byte size that is needed to store all data.
  */
 uint32_t emds_store_size_get(void);
@@ -297,14 +297,57 @@ bool esb_is_idle(void);
  *  module is in PRX mode, the payload is queued for when a packet is received
  *  that requires an acknowledgement with payload.
  *
+ *  This function can be called from several threads and interrupts, including
+ *  the event handler. The calls are serialized, so they do not fail because of
+ *  each other.
+ *
  *  @param[in]   payload     The payload.
  *
  * @retval 0 If successful.
+ * @retval -EBUSY If a payload is claimed with @ref esb_write_payload_claim.
+ * @retval -ENOMEM If the TX FIFO is full.
  *           Otherwise, a (negative) error code is returned.
  */
 int esb_write_payload(const struct esb_payload *payload);
 
+/** @brief Claim a payload buffer for transmission or acknowledgement.
+ *
+ *  This function gives direct access to the next free entry of the TX FIFO,
+ *  so the payload can be prepared in place without copying. The entry is
+ *  queued when it is passed to @ref esb_write_payload_commit.
+ *
+ *  Only one payload can be claimed at a time. While a payload is claimed,
+ *  another claim and @ref esb_write_payload return -EBUSY. If the payloads
+ *  are written from several contexts, either use only @ref esb_write_payload
+ *  or serialize the claim and commit calls in the application.
+ *
+ *  @param[out]  payload     Pointer to the claimed payload buffer.
+ *
+ * @retval 0 If successful.
+ * @retval -EBUSY If a payload is already claimed.
+ * @retval -ENOMEM If the TX FIFO is full.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int esb_write_payload_claim(struct esb_payload **payload);
+
+/** @brief Queue a claimed payload.
+ *
+ *  The payload length and pipe must be set. The packet ID is assigned by the
+ *  module. If the payload is invalid, the claimed buffer is released and an
+ *  error is returned.
+ *
+ *  @param[in]   payload     Payload returned by @ref esb_write_payload_claim.
+ *
+ * @retval 0 If successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int esb_write_payload_commit(struct esb_payload *payload);
+
 /** @brief Read a payload.
+ *
+ *  The RX FIFO has a single consumer. Calls of this function are serialized
+ *  with each other, but they must not be made while payloads are claimed
+ *  with @ref esb_read_rx_payloads_claim from another context.
  *
  *  @param[in,out] payload	The payload to be received.
  *
@@ -313,6 +356,32 @@ int esb_write_payload(const struct esb_payload *payload);
  */
 int esb_read_rx_payload(struct esb_payload *payload);
 
+/** @brief Get the received payloads without copying them.
+ *
+ *  This function provides pointers to the oldest payloads in the RX FIFO,
+ *  so several packets can be processed in one call. The payloads stay in the
+ *  RX FIFO until they are released with @ref esb_read_rx_payloads_release.
+ *  Both functions must be called from the same context, and no other context
+ *  may read the RX FIFO in the meantime, as the RX FIFO has a single consumer.
+ *
+ *  @param[out]  payloads    Array to be filled with pointers to the payloads,
+ *                           ordered from the oldest one.
+ *  @param[in]   count       Size of the array.
+ *
+ * @return Number of payloads if successful, -ENODATA if the RX FIFO is empty.
+ *         Otherwise, a (negative) error code is returned.
+ */
+int esb_read_rx_payloads_claim(const struct esb_payload **payloads, size_t count);
+
+/** @brief Release the oldest received payloads.
+ *
+ *  @param[in]   count       Number of payloads to be released.
+ *
+ * @retval 0 If successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int esb_read_rx_payloads_release(size_t count);
+
 /** @brief Start transmitting data.
  *
  * @retval 0 If successful.
@@ -344,6 +413,8 @@ int esb_stop_rx(void);
 int esb_flush_tx(void);
 
 /** @brief Pop the first item from the TX buffer.
+ *
+ * In PRX mode, the first ACK payload queued on the lowest pipe is removed.
  *
  * @retval 0 If successful.
  *           Otherwise, a (negative) error code is returned.
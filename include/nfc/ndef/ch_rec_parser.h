@@ -16,6 +16,7 @@
  */
 
 #include <nfc/ndef/ch.h>
+#include <nfc/ndef/msg_parser.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -38,6 +39,26 @@ enum nfc_ndef_ch_rec_type {
 	NFC_NDEF_CH_REC_TYPE_HANDOVER_MEDIATION
 };
 
+/**
+ * @brief Connection Handover Record iterator.
+ *
+ * Provides access to the nested local records without copying them.
+ */
+struct nfc_ndef_ch_rec_iter {
+	/** Major version number of the supported
+	 *  Connection Handover specification.
+	 */
+	uint8_t major_version;
+
+	/** Minor version number of the supported
+	 *  Connection Handover specification.
+	 */
+	uint8_t minor_version;
+
+	/** Iterator over the local records. */
+	struct nfc_ndef_msg_iter local_records;
+};
+
 /** @brief Check if an NDEF Record is the Alternative Carrier Record.
  *
  *  @param[in] rec_desc General NDEF Record descriptor.
@@ -109,6 +130,22 @@ bool nfc_ndef_ch_rec_check(const struct nfc_ndef_record_desc *rec_desc,
 int nfc_ndef_ch_rec_parse(const struct nfc_ndef_record_desc *rec_desc,
 			  uint8_t *result_buf, uint32_t *result_buf_len);
 
+/** @brief Parse the header of the fallowing NDEF Connection Handover Records:
+ *	- Handover Select Record
+ *	- Handover Request Record
+ *	- Handover Mediation Record
+ *	- Handover Initiate Record
+ *  Unlike @ref nfc_ndef_ch_rec_parse, this function does not store the local
+ *  records. They are parsed one by one with @ref nfc_ndef_msg_iter_next
+ *  called for the local records iterator of @p iter.
+ *  @param[in]  rec_desc General NDEF Record descriptor.
+ *  @param[out] iter     Connection Handover Record iterator.
+ *  @retval 0 If the operation was successful.
+ *            Otherwise, a (negative) error code is returned.
+ */
+int nfc_ndef_ch_rec_iter_init(const struct nfc_ndef_record_desc *rec_desc,
+			      struct nfc_ndef_ch_rec_iter *iter);
+
 /** @brief Parse an NDEF Alternative Carrier Record.
  *
  *  This function only parses NDEF Record descriptors with Alternative Carrier
@@ -15,6 +15,7 @@
  */
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <zephyr/types.h>
 #include <nfc/ndef/record_parser.h>
 #include <nfc/ndef/msg.h>
@@ -86,6 +87,94 @@ int nfc_ndef_msg_parse(uint8_t  *result_buf,
 		       const uint8_t *raw_data,
 		       uint32_t *raw_data_len);
 
+/** @brief NDEF message iterator.
+ *
+ *  The iterator parses the records of an NDEF message one by one, directly
+ *  from the raw data, so the memory required does not depend on the number
+ *  of records in the message. The returned record descriptors point to the
+ *  raw data, which must be available as long as the records are used.
+ */
+struct nfc_ndef_msg_iter {
+	/** Pointer to the next record to be parsed. */
+	const uint8_t *data;
+
+	/** Length of the data that was not parsed yet. */
+	uint32_t data_len;
+
+	/** Length of the parsed records. */
+	uint32_t parsed_len;
+
+	/** Number of returned records. */
+	uint32_t record_count;
+
+	/** The last record of the message was returned. */
+	bool complete;
+};
+
+/** @brief Visitor function called for every record of an NDEF message.
+ *
+ *  @param[in] rec_desc Descriptor of the record. It is valid only during the
+ *                      call, but the data it points to is a part of the raw
+ *                      NDEF message.
+ *  @param[in] index Index of the record in the message.
+ *  @param[in] user_data User data.
+ *
+ *  @retval 0 To continue parsing the message.
+ *            Otherwise, parsing is stopped and the value is returned by
+ *            @ref nfc_ndef_msg_visit.
+ */
+typedef int (*nfc_ndef_msg_record_visitor_t)(const struct nfc_ndef_record_desc *rec_desc,
+					     uint32_t index, void *user_data);
+
+/** @brief Initialize an NDEF message iterator.
+ *
+ *  @param[out] iter Iterator.
+ *  @param[in] raw_data Pointer to the data to be parsed.
+ *  @param[in] raw_data_len Size of the data to be parsed.
+ */
+void nfc_ndef_msg_iter_init(struct nfc_ndef_msg_iter *iter,
+			    const uint8_t *raw_data,
+			    uint32_t raw_data_len);
+
+/** @brief Parse the next record of an NDEF message.
+ *
+ *  The record descriptor uses the binary payload descriptor, in the same way
+ *  as the records parsed by @ref nfc_ndef_msg_parse.
+ *
+ *  @param[in,out] iter Iterator.
+ *  @param[out] rec_desc Record descriptor to be filled.
+ *  @param[out] bin_pay_desc Binary payload descriptor to be filled and
+ *                           referenced by @p rec_desc.
+ *
+ *  @retval 0 If a record was parsed.
+ *  @retval -ENOENT If the last record of the message was already returned.
+ *            Otherwise, a (negative) error code is returned.
+ */
+int nfc_ndef_msg_iter_next(struct nfc_ndef_msg_iter *iter,
+			   struct nfc_ndef_record_desc *rec_desc,
+			   struct nfc_ndef_bin_payload_desc *bin_pay_desc);
+
+/** @brief Parse an NDEF message record by record.
+ *
+ *  This function calls @p visitor for every record of the message, without
+ *  storing the record descriptors.
+ *
+ *  @param[in] raw_data Pointer to the data to be parsed.
+ *  @param[in,out] raw_data_len As input: size of the NFC data in
+ *                 the @p raw_data buffer. As output: size of the
+ *                 parsed message.
+ *  @param[in] visitor Function called for every record.
+ *  @param[in] user_data User data passed to @p visitor.
+ *
+ *  @retval 0 If the operation was successful.
+ *            Otherwise, a (negative) error code or the non-zero value
+ *            returned by @p visitor is returned.
+ */
+int nfc_ndef_msg_visit(const uint8_t *raw_data,
+		       uint32_t *raw_data_len,
+		       nfc_ndef_msg_record_visitor_t visitor,
+		       void *user_data);
+
 /** @brief Print the parsed contents of an NDEF message.
  *
  *  @param[in] msg_desc Pointer to the descriptor of the message that should
@@ -130,6 +130,20 @@ struct nfc_ndef_bin_payload_desc {
 	uint32_t payload_length; /**< Length of data in bytes. */
 };
 
+/**
+ * @brief Scatter-gather descriptor containing the payload for the record.
+ *
+ * The payload is a concatenation of the segments. Each segment is copied
+ * directly to the payload field of the record, so the payload does not need
+ * to be assembled in a separate buffer.
+ */
+struct nfc_ndef_bin_payload_sg_desc {
+	/** Pointer to the array of segments. */
+	const struct nfc_ndef_bin_payload_desc *segment;
+	/** Number of segments. */
+	uint32_t segment_cnt;
+};
+
 /**
  * @brief Macro for creating and initializing an NFC NDEF record descriptor for
  * a generic record.
@@ -240,6 +254,67 @@ struct nfc_ndef_bin_payload_desc {
  */
 #define NFC_NDEF_BIN_PAYLOAD_DESC(name) (name##_nfc_ndef_bin_payload_desc)
 
+/**
+ * @brief Macro for creating and initializing an NFC NDEF record descriptor for
+ * a record with binary payload stored in multiple segments.
+ *
+ * This macro creates and initializes an instance of type nfc_ndef_record_desc
+ * and a scatter-gather descriptor of the payload data.
+ *
+ * Use the macro @ref NFC_NDEF_RECORD_BIN_DATA_SG to access the NDEF record
+ * descriptor instance.
+ *
+ * @note The record descriptor is declared as automatic variable, which implies
+ * that the NDEF record encoding must be done in the same variable scope.
+ *
+ * @param name Name of the created descriptor instance.
+ * @param tnf_arg Type Name Format (TNF) value for the record.
+ * @param id_arg Pointer to the ID string.
+ * @param id_len Length of the ID string.
+ * @param type_arg Pointer to the type string.
+ * @param type_len Length of the type string.
+ * @param segment_arg Pointer to the array of @ref nfc_ndef_bin_payload_desc
+ * segments that will be copied to the payload field one after another.
+ * @param segment_cnt_arg Number of segments.
+ */
+#define NFC_NDEF_RECORD_BIN_DATA_SG_DEF(name,				    \
+					tnf_arg,			    \
+					id_arg,				    \
+					id_len,				    \
+					type_arg,			    \
+					type_len,			    \
+					segment_arg,			    \
+					segment_cnt_arg)		    \
+	struct nfc_ndef_bin_payload_sg_desc				    \
+		name##_nfc_ndef_bin_payload_sg_desc =			    \
+	{								    \
+		.segment = segment_arg,					    \
+		.segment_cnt = segment_cnt_arg				    \
+	};								    \
+									    \
+	struct nfc_ndef_record_desc name##_nfc_ndef_bin_sg_record_desc =   \
+	{								    \
+		.tnf = tnf_arg,						    \
+		.id_length = id_len,					    \
+		.id = id_arg,						    \
+		.type_length = type_len,				    \
+		.type = type_arg,					    \
+		.payload_constructor  =					    \
+		    (payload_constructor_t) nfc_ndef_bin_payload_sg_memcopy, \
+		.payload_descriptor =					    \
+		    (void *) &name##_nfc_ndef_bin_payload_sg_desc	    \
+	}
+
+/** @brief Macro for accessing the NFC NDEF record descriptor instance
+ *  that you created with @ref NFC_NDEF_RECORD_BIN_DATA_SG_DEF.
+ */
+#define NFC_NDEF_RECORD_BIN_DATA_SG(name) (name##_nfc_ndef_bin_sg_record_desc)
+
+/** @brief Macro for accessing the scatter-gather descriptor of the payload of
+ *  the record that you created with @ref NFC_NDEF_RECORD_BIN_DATA_SG_DEF.
+ */
+#define NFC_NDEF_BIN_PAYLOAD_SG_DESC(name) (name##_nfc_ndef_bin_payload_sg_desc)
+
 /**
  * @brief Encode an NDEF record.
  *
@@ -282,6 +357,28 @@ int nfc_ndef_bin_payload_memcopy(
 			uint8_t *buffer,
 			uint32_t *len);
 
+/**
+ * @brief Construct the payload for an NFC NDEF record from binary data
+ * segments.
+ *
+ * This function copies the segments one after another directly to the payload
+ * field of the NFC NDEF record.
+ *
+ * @param payload_descriptor Pointer to the scatter-gather descriptor of the
+ * binary data.
+ * @param buffer Pointer to the payload destination. If NULL, function will
+ * calculate the expected size of the record payload.
+ * @param len Size of the available memory for the payload as input. Size of
+ * the copied payload as output.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int nfc_ndef_bin_payload_sg_memcopy(
+			struct nfc_ndef_bin_payload_sg_desc *payload_descriptor,
+			uint8_t *buffer,
+			uint32_t *len);
+
 /**
  * @}
  */
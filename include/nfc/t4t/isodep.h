@@ -244,6 +244,28 @@ int nfc_t4t_isodep_init(uint8_t *tx_buf, size_t tx_size,
 			uint8_t *rx_buf, size_t rx_size,
 			const struct nfc_t4t_isodep_cb *cb);
 
+/**@brief Get the size of the ISO-DEP RX buffer.
+ *
+ * The data received in chained I-blocks is collected in the RX buffer,
+ * so its size limits the length of a single response from the tag.
+ * Upper layers can use it to request the largest response that fits.
+ *
+ * @return Size of the RX buffer in bytes, 0 if the ISO-DEP protocol
+ *         is not initialized.
+ */
+size_t nfc_t4t_isodep_rx_buf_size_get(void);
+
+/**@brief Get the maximum data size of a single frame from the tag.
+ *
+ * The size is derived from the frame size for the Reader/Writer (FSD)
+ * sent in the RATS command. Responses longer than this are split by
+ * the tag into chained I-blocks, each of them acknowledged separately.
+ *
+ * @return Maximum INF field size of an I-block from the tag in bytes,
+ *         0 if the RATS command was not sent.
+ */
+size_t nfc_t4t_isodep_rx_frame_data_size_get(void);
+
 #ifdef __cplusplus
 }
 #endif
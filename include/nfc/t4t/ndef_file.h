@@ -16,6 +16,7 @@
  */
 
 #include <zephyr/types.h>
+#include <nfc/ndef/msg.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -54,6 +55,24 @@ extern "C" {
  */
 int nfc_t4t_ndef_file_encode(uint8_t *file_buf, uint32_t *size);
 
+/**@brief Encode an NDEF Message directly into the NFC NDEF File.
+ *
+ * The records are encoded in place, after the NLEN field, which is set when
+ * the message is encoded. No intermediate buffer for the NDEF Message is
+ * needed. An empty message is encoded as NDEF File with NLEN set to zero.
+ *
+ * @param[in] msg Pointer to the NDEF Message descriptor. Can be NULL
+ *                to encode an empty NDEF File.
+ * @param[in] file_buf Pointer to the NFC NDEF File buffer.
+ * @param[in, out] size Size of the NFC NDEF File buffer as input.
+ *                      Size of the generated NDEF File as output.
+ *
+ * @retval 0 If the operation was successful.
+ *           Otherwise, a (negative) error code is returned.
+ */
+int nfc_t4t_ndef_file_msg_encode(const struct nfc_ndef_msg_desc *msg,
+				 uint8_t *file_buf, uint32_t *size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -311,6 +311,20 @@ static inline void nrf_profiler_log_send(struct log_event_buf *buf,
 #endif
 
 
+/** @brief Get the number of dropped events.
+ *
+ * Events are dropped when there is no space left in the nRF Profiler
+ * ring buffer, because the backend does not keep up with the profiled events.
+ *
+ * @return Number of events dropped since the Profiler was initialized.
+ */
+#ifdef CONFIG_NRF_PROFILER
+uint32_t nrf_profiler_dropped_count_get(void);
+#else
+static inline uint32_t nrf_profiler_dropped_count_get(void) {return 0; }
+#endif
+
+
 /**
  * @}
  */
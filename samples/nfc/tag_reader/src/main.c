@@ -25,7 +25,6 @@
 #define NFCA_BD 128
 #define BITS_IN_BYTE 8
 #define MAX_TLV_BLOCKS 10
-#define MAX_NDEF_RECORDS 10
 #define NFCA_T2T_BUFFER_SIZE 1024
 #define NFCA_LAST_BIT_MASK 0x80
 #define NFCA_FDT_ALIGN_84 84
@@ -186,30 +185,30 @@ static void ndef_le_oob_rec_analyze(const struct nfc_ndef_record_desc *le_oob_re
 static void ndef_ch_rec_analyze(const struct nfc_ndef_record_desc *ndef_rec_desc)
 {
 	int err;
-	uint8_t hs_buf[NFC_NDEF_REC_PARSER_BUFF_SIZE];
-	uint32_t hs_buf_len = sizeof(hs_buf);
 	uint8_t ac_buf[NFC_NDEF_REC_PARSER_BUFF_SIZE];
-	uint32_t ac_buf_len = sizeof(ac_buf);
-	struct nfc_ndef_ch_rec *ch_rec;
+	uint32_t ac_buf_len;
+	struct nfc_ndef_ch_rec_iter ch_rec;
+	struct nfc_ndef_record_desc local_rec;
+	struct nfc_ndef_bin_payload_desc local_rec_payload;
 	struct nfc_ndef_ch_ac_rec *ac_rec;
 
-	err = nfc_ndef_ch_rec_parse(ndef_rec_desc, hs_buf, &hs_buf_len);
+	err = nfc_ndef_ch_rec_iter_init(ndef_rec_desc, &ch_rec);
 	if (err) {
 		printk("Error during parsing Handover Select record: %d\n",
 		       err);
 		return;
 	}
 
-	ch_rec = (struct nfc_ndef_ch_rec *)hs_buf;
+	printk("Handover Select Record payload\n");
+	printk("\tConnection Handover version: %d.%d\n",
+	       ch_rec.major_version, ch_rec.minor_version);
 
-	printk("Handover Select Record payload");
-
-	nfc_ndef_ch_rec_printout(ch_rec);
-
-	for (size_t i = 0; i < ch_rec->local_records->record_count; i++) {
-		if (nfc_ndef_ch_ac_rec_check(ch_rec->local_records->record[i])) {
-			err = nfc_ndef_ch_ac_rec_parse(ch_rec->local_records->record[i],
-						       ac_buf, &ac_buf_len);
+	/* Local records are parsed one by one from the record payload. */
+	while ((err = nfc_ndef_msg_iter_next(&ch_rec.local_records, &local_rec,
+					     &local_rec_payload)) == 0) {
+		if (nfc_ndef_ch_ac_rec_check(&local_rec)) {
+			ac_buf_len = sizeof(ac_buf);
+			err = nfc_ndef_ch_ac_rec_parse(&local_rec, ac_buf, &ac_buf_len);
 			if (err) {
 				printk("Error during parsing AC record: %d\n",
 				       err);
@@ -221,6 +220,10 @@ static void ndef_ch_rec_analyze(const struct nfc_ndef_record_desc *ndef_rec_desc
 			nfc_ndef_ac_rec_printout(ac_rec);
 		}
 	}
+
+	if (err != -ENOENT) {
+		printk("Error during parsing local records: %d\n", err);
+	}
 }
 /** .. include_endpoint_ch_rec_parser_rst */
 
@@ -237,28 +240,28 @@ static void ndef_rec_analyze(const struct nfc_ndef_record_desc *ndef_rec_desc)
 	}
 }
 
+static int ndef_rec_visit(const struct nfc_ndef_record_desc *ndef_rec_desc,
+			  uint32_t index, void *user_data)
+{
+	ARG_UNUSED(user_data);
+
+	nfc_ndef_record_printout(index, ndef_rec_desc);
+	ndef_rec_analyze(ndef_rec_desc);
+
+	return 0;
+}
+
 static void ndef_data_analyze(const uint8_t *ndef_msg_buff, size_t nfc_data_len)
 {
 	int  err;
-	struct nfc_ndef_msg_desc *ndef_msg_desc;
-	uint8_t desc_buf[NFC_NDEF_PARSER_REQUIRED_MEM(MAX_NDEF_RECORDS)];
-	size_t desc_buf_len = sizeof(desc_buf);
-
-	err = nfc_ndef_msg_parse(desc_buf,
-				 &desc_buf_len,
-				 ndef_msg_buff,
-				 &nfc_data_len);
+	uint32_t msg_len = nfc_data_len;
+
+	/* Records are analyzed while the message is parsed, so no memory is
+	 * needed for the descriptors of all records.
+	 */
+	err = nfc_ndef_msg_visit(ndef_msg_buff, &msg_len, ndef_rec_visit, NULL);
 	if (err) {
 		printk("Error during parsing a NDEF message, err: %d.\n", err);
-		return;
-	}
-
-	ndef_msg_desc = (struct nfc_ndef_msg_desc *) desc_buf;
-
-	nfc_ndef_msg_printout(ndef_msg_desc);
-
-	for (size_t i = 0; i < ndef_msg_desc->record_count; i++) {
-		ndef_rec_analyze(ndef_msg_desc->record[i]);
 	}
 }
 
@@ -0,0 +1,108 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+from processed_events import ProcessedEvents, EM_MEM_ADDRESS_DATA_DESC
+from events import EventType
+from stream import CompactCodec, CompactDecoder
+from rtt_nordic_config import RttNordicConfig
+
+import argparse
+import sys
+import time
+
+RAW_SIZES = {
+    'u8': (1, False),
+    's8': (1, True),
+    'u16': (2, False),
+    's16': (2, True),
+    'u32': (4, False),
+    's32': (4, True),
+    't': (4, False),
+}
+
+def encode_raw(type_id, timestamp, data_types, data):
+    buf = bytearray([type_id])
+    buf += timestamp.to_bytes(4, byteorder=RttNordicConfig['byteorder'])
+    for data_type, value in zip(data_types, data):
+        if data_type == 's':
+            encoded = value.encode()[:255]
+            buf.append(len(encoded))
+            buf += encoded
+        else:
+            size, signed = RAW_SIZES[data_type]
+            buf += value.to_bytes(size, byteorder=RttNordicConfig['byteorder'], signed=signed)
+    return bytes(buf)
+
+def recreate_trace(processed_events):
+    # Recreates the event stream sent by the device from the tracked events of the dataset.
+    event_types = dict(processed_events.registered_events_types)
+    start_id = max(event_types) + 1
+    end_id = start_id + 1
+    event_types[start_id] = EventType('event_processing_start', ['u32'],
+                                      [EM_MEM_ADDRESS_DATA_DESC])
+    event_types[end_id] = EventType('event_processing_end', ['u32'],
+                                    [EM_MEM_ADDRESS_DATA_DESC])
+
+    def ticks(timestamp):
+        return round(timestamp * 1000 / RttNordicConfig['ms_per_timestamp_tick']) & \
+            (RttNordicConfig['timestamp_raw_max'] - 1)
+
+    trace = []
+    for ev in processed_events.tracked_events:
+        submit = ev.submit
+        trace.append((submit.timestamp, encode_raw(submit.type_id, ticks(submit.timestamp),
+                      event_types[submit.type_id].data_types, submit.data)))
+        for event_id, timestamp in ((start_id, ev.proc_start_time),
+                                    (end_id, ev.proc_end_time)):
+            if timestamp is not None:
+                trace.append((timestamp, encode_raw(event_id, ticks(timestamp), ['u32'],
+                                                    submit.data[:1])))
+
+    trace.sort(key=lambda x: x[0])
+    return event_types, [raw for _, raw in trace]
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Comparing the default and the compact event encoding on a dataset.',
+        allow_abbrev=False)
+    parser.add_argument('dataset_name', help='Name of dataset')
+    parser.add_argument('--bandwidth', type=int, default=11520,
+                        help='Link bandwidth [B/s], default is UART at 115200 baud')
+    args = parser.parse_args()
+
+    pe = ProcessedEvents()
+    pe.read_data_from_files(args.dataset_name + ".csv", args.dataset_name + ".json")
+    event_types, trace = recreate_trace(pe)
+    if len(trace) == 0:
+        print("No events in the dataset")
+        sys.exit()
+
+    raw_stream = b''.join(trace)
+    encoder = CompactCodec(event_types)
+    compact_stream = b''.join(encoder.encode(raw) for raw in trace)
+
+    decoder = CompactDecoder(event_types)
+    start = time.perf_counter()
+    decoded = bytearray()
+    # Feed the decoder in chunks that are not aligned to event boundaries.
+    chunk_size = 61
+    for pos in range(0, len(compact_stream), chunk_size):
+        decoded += decoder.decode(compact_stream[pos:pos + chunk_size])
+    decode_time = time.perf_counter() - start
+
+    if bytes(decoded) != raw_stream:
+        print("Decoded stream does not match the default encoding")
+        sys.exit(1)
+
+    for name, stream in (("default", raw_stream), ("compact", compact_stream)):
+        print("{} encoding: {} bytes, {:.2f} bytes/event, {:.0f} events/s at {} B/s".format(
+              name, len(stream), len(stream) / len(trace),
+              args.bandwidth * len(trace) / len(stream), args.bandwidth))
+    print("Events: {}, compression ratio: {:.2f}".format(len(trace),
+                                                         len(raw_stream) / len(compact_stream)))
+    print("Host decoding: {:.0f} events/s".format(len(trace) / decode_time))
+
+if __name__ == "__main__":
+    main()
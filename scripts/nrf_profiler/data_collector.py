@@ -17,10 +17,18 @@ def signal_handler(sig, frame):
     global is_waiting
     is_waiting = False
 
-def rtt2stream(stream, event, event_close, log_lvl_number):
+def rtt2stream(stream, event, event_close, log_lvl_number, uart_port=None, files=None):
     signal.signal(signal.SIGINT, signal.SIG_IGN)
     try:
-        rtt2s = Rtt2Stream(stream, event_close, log_lvl=log_lvl_number)
+        if uart_port is not None:
+            from uart2stream import Uart2Stream
+            rtt2s = Uart2Stream(stream, event_close, uart_port, log_lvl=log_lvl_number)
+        elif files is not None:
+            from file2stream import File2Stream
+            rtt2s = File2Stream(stream, event_close, files[0], files[1],
+                                log_lvl=log_lvl_number)
+        else:
+            rtt2s = Rtt2Stream(stream, event_close, log_lvl=log_lvl_number)
         event.wait()
         rtt2s.read_and_transmit_data()
     except Exception as e:
@@ -50,6 +58,11 @@ def main():
     parser.add_argument('time', type=int, help='Time of collecting data [s]')
     parser.add_argument('dataset_name', help='Name of dataset')
     parser.add_argument('--log', help='Log level')
+    backend = parser.add_mutually_exclusive_group()
+    backend.add_argument('--uart', metavar='PORT',
+                         help='Receive data over UART instead of RTT')
+    backend.add_argument('--files', nargs=2, metavar=('DATA', 'INFO'),
+                         help='Read data and event descriptions written by the native board')
     args = parser.parse_args()
 
     if args.log is not None:
@@ -67,7 +80,8 @@ def main():
 
     processes = []
     processes.append((Process(target=rtt2stream,
-                                args=(streams[0], event, event_close_rtt2stream, log_lvl_number),
+                                args=(streams[0], event, event_close_rtt2stream, log_lvl_number,
+                                      args.uart, args.files),
                                 daemon=True),
                         event_close_rtt2stream))
     processes.append((Process(target=model_creator,
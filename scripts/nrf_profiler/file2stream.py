@@ -0,0 +1,87 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import sys
+import logging
+import time
+from stream import StreamError
+
+FileNordicConfig = {
+    'read_chunk_size': 8192,
+    'read_sleep_time': 0.01, # In seconds.
+    'info_timeout': 20, # In seconds.
+}
+
+class File2Stream:
+    # Reads the files written by the nRF Profiler file backend on the native board.
+    def __init__(self, out_stream, event_close, data_path, info_path, config=FileNordicConfig,
+                 log_lvl=logging.INFO):
+        self.config = config
+
+        self.out_stream = out_stream
+
+        self.event_close = event_close
+
+        self.data_path = data_path
+        self.info_path = info_path
+
+        self.logger = logging.getLogger('Profiler file to stream')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter('[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+    def _read_all_events_descriptions(self):
+        start_time = time.time()
+        # Empty field is sent after last event description
+        while True:
+            if self.event_close.is_set() or \
+               time.time() - start_time > self.config['info_timeout']:
+                self.logger.info("Module closed before receiving event descriptions.")
+                sys.exit()
+
+            try:
+                with open(self.info_path, 'rb') as f:
+                    desc_buf = f.read()
+            except OSError:
+                desc_buf = bytes()
+
+            if desc_buf[-2:] == bytes('\n\n', 'utf-8'):
+                return desc_buf
+            time.sleep(0.1)
+
+    def read_and_transmit_data(self):
+        desc_buf = self._read_all_events_descriptions()
+        try:
+            self.out_stream.send_desc(desc_buf)
+        except StreamError as err:
+            self.logger.error("Error: {}. Unable to send data".format(err))
+            sys.exit()
+
+        try:
+            data_file = open(self.data_path, 'rb')
+        except OSError as err:
+            self.logger.error("Cannot open {}: {}".format(self.data_path, err))
+            sys.exit()
+
+        with data_file:
+            while True:
+                buf = data_file.read(self.config['read_chunk_size'])
+
+                if len(buf) > 0:
+                    try:
+                        self.out_stream.send_ev(buf)
+                    except StreamError as err:
+                        self.logger.error("Error: {}. Unable to send data".format(err))
+                        sys.exit()
+                elif self.event_close.is_set():
+                    self.close()
+                else:
+                    time.sleep(self.config['read_sleep_time'])
+
+    def close(self):
+        self.logger.info("Real time transmission closed")
+        sys.exit()
@@ -10,7 +10,7 @@ import json
 from rtt_nordic_config import RttNordicConfig
 from events import Event, EventType, TrackedEvent, EventsData
 from processed_events import ProcessedEvents
-from stream import StreamError
+from stream import StreamError, CompactDecoder
 from io import StringIO
 import csv
 
@@ -20,6 +20,7 @@ class Command(Enum):
     INFO = 3
 
 NRF_PROFILER_FATAL_ERROR_EVENT_NAME = "_nrf_profiler_fatal_error_event_"
+NRF_PROFILER_DROP_EVENT_NAME = "_nrf_profiler_drop_event_"
 
 class ModelCreator:
 
@@ -60,6 +61,7 @@ class ModelCreator:
 
         self.bufs = list()
         self.bcnt = 0
+        self.decoder = None
 
         self.logger = logging.getLogger('Profiler model creator')
         self.logger_console = logging.StreamHandler()
@@ -101,6 +103,8 @@ class ModelCreator:
                     continue
                 self.logger.error("Receiving error: {}".format(err))
                 self.close()
+            if self.decoder is not None:
+                buf = self.decoder.decode(buf)
             if len(buf) > 0:
                 self.bufs.append(buf)
                 self.bcnt += len(buf)
@@ -146,6 +150,9 @@ class ModelCreator:
         self.event_processing_end_id = \
             self.raw_data.get_event_type_id('event_processing_end')
 
+        if self.raw_data.get_event_type_id(CompactDecoder.EVENT_NAME) is not None:
+            self.decoder = CompactDecoder(self.raw_data.registered_events_types)
+
         if self.sending:
             event_types_dict = dict((k, v.serialize())
                     for k, v in self.processed_events.registered_events_types.items())
@@ -256,6 +263,9 @@ class ModelCreator:
             if self.raw_data.registered_events_types[event.type_id].name == NRF_PROFILER_FATAL_ERROR_EVENT_NAME:
                 self.logger.error("Fatal error of Profiler on device! Event has been dropped. "
                                   "Data buffer has overflown. No more events will be received.")
+            elif self.raw_data.registered_events_types[event.type_id].name == NRF_PROFILER_DROP_EVENT_NAME:
+                self.logger.warning("Profiler data buffer on device has overflown. "
+                                    "Events dropped so far: {}".format(event.data[0]))
 
             if event.type_id == self.event_processing_start_id:
                 self.start_event = event
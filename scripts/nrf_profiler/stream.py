@@ -90,3 +90,164 @@ class Stream():
 
     def recv_ev(self):
         return self._receive(self.pipe_recv_ev, self.timeouts['events'])
+
+
+class CompactCodec():
+    # Compact event encoding enabled with CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING.
+    #
+    # Every event starts with the event type ID byte, followed by the unsigned
+    # LEB128 varint of the difference from the previous event timestamp.
+    # 32-bit values (u32, s32, t) are sent as the zigzag varint of the
+    # difference from the previous 32-bit value at the same data field index,
+    # 16-bit values as varints (zigzag for s16), 8-bit values and strings are
+    # not changed.
+    # The device registers an event type with the following name to signal
+    # that the encoding is used. The device also sends the event, after which
+    # both sides reset the state, so that the host gets in sync with a device
+    # that sent events before the host connected.
+    EVENT_NAME = "_nrf_profiler_compact_encoding_"
+    VALUE_MASK = 0xffffffff
+
+    def __init__(self, registered_events_types):
+        self.registered_events_types = registered_events_types
+        self.sync_type_id = None
+        for type_id, event_type in registered_events_types.items():
+            if event_type.name == CompactCodec.EVENT_NAME:
+                self.sync_type_id = type_id
+        self.reset()
+
+    def reset(self):
+        self.prev_timestamp = 0
+        self.prev_values = {}
+
+    @staticmethod
+    def _zigzag(value):
+        value = value & CompactCodec.VALUE_MASK
+        if value & 0x80000000:
+            value -= 2**32
+        return ((value << 1) ^ (value >> 31)) & CompactCodec.VALUE_MASK
+
+    @staticmethod
+    def _unzigzag(value):
+        return (value >> 1) ^ -(value & 1)
+
+    @staticmethod
+    def _varint_put(value):
+        buf = bytearray()
+        while value >= 0x80:
+            buf.append((value & 0x7f) | 0x80)
+            value >>= 7
+        buf.append(value)
+        return buf
+
+    @staticmethod
+    def _varint_get(buf, pos):
+        value = 0
+        shift = 0
+        while True:
+            # IndexError is raised if the varint is not complete.
+            byte = buf[pos]
+            pos += 1
+            value |= (byte & 0x7f) << shift
+            if not byte & 0x80:
+                return value, pos
+            shift += 7
+
+    def encode(self, raw):
+        # Encodes a single event in the default format.
+        type_id = raw[0]
+        timestamp = int.from_bytes(raw[1:5], byteorder='little', signed=False)
+        pos = 5
+        buf = bytearray([type_id])
+        buf += self._varint_put((timestamp - self.prev_timestamp) & CompactCodec.VALUE_MASK)
+        self.prev_timestamp = timestamp
+
+        data_types = self.registered_events_types[type_id].data_types
+        for idx, data_type in enumerate(data_types):
+            if data_type in ('u32', 's32', 't'):
+                value = int.from_bytes(raw[pos:pos + 4], byteorder='little', signed=False)
+                pos += 4
+                buf += self._varint_put(self._zigzag(value - self.prev_values.get(idx, 0)))
+                self.prev_values[idx] = value
+            elif data_type == 'u16':
+                buf += self._varint_put(int.from_bytes(raw[pos:pos + 2], byteorder='little',
+                                                       signed=False))
+                pos += 2
+            elif data_type == 's16':
+                buf += self._varint_put(self._zigzag(int.from_bytes(raw[pos:pos + 2],
+                                                                    byteorder='little',
+                                                                    signed=True)))
+                pos += 2
+            elif data_type in ('u8', 's8'):
+                buf.append(raw[pos])
+                pos += 1
+            elif data_type == 's':
+                buf += raw[pos:pos + 1 + raw[pos]]
+                pos += 1 + raw[pos]
+
+        if type_id == self.sync_type_id:
+            self.reset()
+        return bytes(buf)
+
+    def _decode_event(self, buf, pos):
+        type_id = buf[pos]
+        pos += 1
+        out = bytearray([type_id])
+        delta, pos = self._varint_get(buf, pos)
+        timestamp = (self.prev_timestamp + delta) & CompactCodec.VALUE_MASK
+        out += timestamp.to_bytes(4, byteorder='little')
+        values = {}
+
+        data_types = self.registered_events_types[type_id].data_types
+        for idx, data_type in enumerate(data_types):
+            if data_type in ('u32', 's32', 't'):
+                delta, pos = self._varint_get(buf, pos)
+                value = (self.prev_values.get(idx, 0) + self._unzigzag(delta)) & \
+                    CompactCodec.VALUE_MASK
+                values[idx] = value
+                out += value.to_bytes(4, byteorder='little')
+            elif data_type == 'u16':
+                value16, pos = self._varint_get(buf, pos)
+                out += value16.to_bytes(2, byteorder='little')
+            elif data_type == 's16':
+                value16, pos = self._varint_get(buf, pos)
+                out += (self._unzigzag(value16) & 0xffff).to_bytes(2, byteorder='little')
+            elif data_type in ('u8', 's8'):
+                out.append(buf[pos])
+                pos += 1
+            elif data_type == 's':
+                end = pos + 1 + buf[pos]
+                if end > len(buf):
+                    raise IndexError
+                out += buf[pos:end]
+                pos = end
+
+        # The state is updated only after the whole event is received.
+        if type_id == self.sync_type_id:
+            self.reset()
+        else:
+            self.prev_timestamp = timestamp
+            self.prev_values.update(values)
+        return out, pos
+
+
+class CompactDecoder(CompactCodec):
+    # Converts the compact event stream back to the default format.
+    # Received data does not have to be aligned to event boundaries.
+    def __init__(self, registered_events_types):
+        super().__init__(registered_events_types)
+        self.pending = bytearray()
+
+    def decode(self, buf):
+        self.pending.extend(buf)
+        out = bytearray()
+        pos = 0
+        while pos < len(self.pending):
+            try:
+                event, pos_next = self._decode_event(self.pending, pos)
+            except IndexError:
+                break
+            out += event
+            pos = pos_next
+        del self.pending[:pos]
+        return bytes(out)
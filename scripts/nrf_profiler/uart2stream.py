@@ -0,0 +1,123 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import sys
+import logging
+import time
+import serial
+from enum import Enum
+from stream import StreamError
+
+class Command(Enum):
+    START = 1
+    STOP = 2
+    INFO = 3
+
+UartNordicConfig = {
+    'baudrate': 115200,
+    'read_chunk_size': 8192,
+    'read_timeout': 0.01, # In seconds.
+    'stop_drain_time': 0.5, # In seconds.
+    'info_timeout': 20, # In seconds.
+}
+
+class Uart2Stream:
+    # Event type descriptions and events share the same UART stream.
+    # Logging is stopped before requesting the descriptions to separate them.
+    def __init__(self, out_stream, event_close, port, config=UartNordicConfig,
+                 log_lvl=logging.INFO):
+        self.config = config
+
+        self.out_stream = out_stream
+
+        self.event_close = event_close
+
+        self.logger = logging.getLogger('Profiler UART to stream')
+        self.logger_console = logging.StreamHandler()
+        self.logger.setLevel(log_lvl)
+        self.log_format = logging.Formatter('[%(levelname)s] %(name)s: %(message)s')
+        self.logger_console.setFormatter(self.log_format)
+        self.logger.addHandler(self.logger_console)
+
+        try:
+            self.uart = serial.Serial(port, self.config['baudrate'],
+                                      timeout=self.config['read_timeout'])
+        except serial.SerialException as err:
+            self.logger.error("Cannot open {}: {}".format(port, err))
+            sys.exit()
+
+        self.logger.info("Connected to device via UART")
+
+    def _read_bytes(self):
+        try:
+            return self.uart.read(self.config['read_chunk_size'])
+        except serial.SerialException:
+            self.logger.error("Problem with reading UART data")
+            self.uart.close()
+            sys.exit()
+
+    def _send_command(self, command_type):
+        try:
+            self.uart.write(bytes([command_type.value]))
+        except serial.SerialException:
+            self.logger.error("Problem with writing UART data")
+
+    def _read_all_events_descriptions(self):
+        self._send_command(Command.STOP)
+        time.sleep(self.config['stop_drain_time'])
+        self.uart.reset_input_buffer()
+
+        self._send_command(Command.INFO)
+        desc_buf = bytearray()
+        start_time = time.time()
+        # Empty field is sent after last event description
+        while desc_buf[-2:] != bytearray('\n\n', 'utf-8'):
+            if self.event_close.is_set() or \
+               time.time() - start_time > self.config['info_timeout']:
+                self.logger.info("Module closed before receiving event descriptions.")
+                self.uart.close()
+                sys.exit()
+
+            desc_buf.extend(self._read_bytes())
+
+        return desc_buf
+
+    def read_and_transmit_data(self):
+        desc_buf = self._read_all_events_descriptions()
+        try:
+            self.out_stream.send_desc(desc_buf)
+        except StreamError as err:
+            self.logger.error("Error: {}. Unable to send data".format(err))
+            self.uart.close()
+            sys.exit()
+
+        self._send_command(Command.START)
+        while True:
+            if self.event_close.is_set():
+                self.close()
+
+            buf = self._read_bytes()
+
+            if len(buf) > 0:
+                try:
+                    self.out_stream.send_ev(buf)
+                except StreamError as err:
+                    self.logger.error("Error: {}. Unable to send data".format(err))
+                    self.uart.close()
+                    sys.exit()
+
+    def close(self):
+        self.logger.info("Real time transmission closed")
+        self._send_command(Command.STOP)
+        buf = self._read_bytes()
+        while len(buf) > 0:
+            try:
+                self.out_stream.send_ev(buf)
+            except StreamError as err:
+                self.logger.error("Error: {}. Unable to send remaining data".format(err))
+                break
+            buf = self._read_bytes()
+        self.uart.close()
+        sys.exit()
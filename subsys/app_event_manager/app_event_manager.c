@@ -5,6 +5,7 @@
  */
 
 #include <stdio.h>
+#include <string.h>
 #include <zephyr/kernel.h>
 #include <zephyr/spinlock.h>
 #include <zephyr/sys/slist.h>
@@ -23,6 +24,61 @@ static K_WORK_DEFINE(event_processor, event_processor_fn);
 static sys_slist_t eventq = SYS_SLIST_STATIC_INIT(&eventq);
 static struct k_spinlock lock;
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+static struct app_event_manager_stats
+	subscriber_stats[CONFIG_APP_EVENT_MANAGER_STATS_MAX_SUBSCRIBERS];
+struct app_event_manager_stats
+	_app_event_manager_queue_stats[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+static atomic_t stats_reset_req;
+
+static void stats_update(struct app_event_manager_stats *stats, uint32_t cycles)
+{
+	uint32_t us = k_cyc_to_us_floor32(cycles);
+	size_t bucket = (us > 0) ? (31 - __builtin_clz(us)) : 0;
+
+	if ((stats->count == 0) || (cycles < stats->min)) {
+		stats->min = cycles;
+	}
+	if (cycles > stats->max) {
+		stats->max = cycles;
+	}
+	stats->count++;
+	stats->total += cycles;
+	stats->histogram[MIN(bucket, ARRAY_SIZE(stats->histogram) - 1)]++;
+}
+
+static void stats_reset_process(void)
+{
+	/* Statistics are updated only by the event processor, so they are
+	 * also cleared here to avoid racing with the update.
+	 */
+	if (atomic_cas(&stats_reset_req, 1, 0)) {
+		memset(subscriber_stats, 0, sizeof(subscriber_stats));
+		memset(_app_event_manager_queue_stats, 0,
+		       sizeof(_app_event_manager_queue_stats));
+	}
+}
+
+struct app_event_manager_stats *
+	_app_event_manager_subscriber_stats_get(const struct event_subscriber *es)
+{
+	size_t idx = es - __start_event_subscribers_all;
+
+	/* The number of subscribers is known only after linking. */
+	if (idx >= ARRAY_SIZE(subscriber_stats)) {
+		return NULL;
+	}
+
+	return &subscriber_stats[idx];
+}
+
+void _app_event_manager_stats_reset(void)
+{
+	atomic_set(&stats_reset_req, 1);
+	k_work_submit(&event_processor);
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_STATS */
+
 static bool log_is_event_displayed(const struct event_type *et)
 {
 	size_t idx = et - _event_type_list_start;
@@ -141,6 +197,10 @@ static void event_processor_fn(struct k_work *work)
 {
 	sys_slist_t events = SYS_SLIST_STATIC_INIT(&events);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+	stats_reset_process();
+#endif
+
 	/* Make current event list local. */
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
@@ -172,6 +232,11 @@ static void event_processor_fn(struct k_work *work)
 
 		log_event(aeh);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+		stats_update(&_app_event_manager_queue_stats[et - _event_type_list_start],
+			     k_cycle_get_32() - aeh->timestamp);
+#endif
+
 		bool consumed = false;
 
 		for (const struct event_subscriber *es = et->subs_start;
@@ -187,7 +252,18 @@ static void event_processor_fn(struct k_work *work)
 
 			log_event_progress(et, el);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+			struct app_event_manager_stats *stats =
+				_app_event_manager_subscriber_stats_get(es);
+			uint32_t start = k_cycle_get_32();
+
 			consumed = el->notification(aeh);
+			if (stats) {
+				stats_update(stats, k_cycle_get_32() - start);
+			}
+#else
+			consumed = el->notification(aeh);
+#endif
 
 			if (consumed) {
 				log_event_consumed(et);
@@ -209,6 +285,10 @@ void _event_submit(struct app_event_header *aeh)
 	__ASSERT_NO_MSG(aeh);
 	APP_EVENT_ASSERT_ID(aeh->type_id);
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+	aeh->timestamp = k_cycle_get_32();
+#endif
+
 	k_spinlock_key_t key = k_spin_lock(&lock);
 
 	if (IS_ENABLED(CONFIG_APP_EVENT_MANAGER_SUBMIT_HOOKS)) {
@@ -228,6 +308,15 @@ int app_event_manager_init(void)
 
 	__ASSERT_NO_MSG(_event_type_list_end - _event_type_list_start <=
 			CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT);
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+	size_t subs_cnt = __stop_event_subscribers_all - __start_event_subscribers_all;
+
+	if (subs_cnt > CONFIG_APP_EVENT_MANAGER_STATS_MAX_SUBSCRIBERS) {
+		LOG_WRN("No statistics for %zu of %zu event subscribers, increase "
+			"CONFIG_APP_EVENT_MANAGER_STATS_MAX_SUBSCRIBERS",
+			subs_cnt - CONFIG_APP_EVENT_MANAGER_STATS_MAX_SUBSCRIBERS, subs_cnt);
+	}
+#endif
 
 	log_event_init();
 
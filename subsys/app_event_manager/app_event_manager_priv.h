@@ -230,6 +230,11 @@ struct app_event_header {
 
 	/** Pointer to the event type object. */
 	const struct event_type *type_id;
+
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+	/** Cycle counter value captured when the event was submitted. */
+	uint32_t timestamp;
+#endif
 };
 
 /** Function to log data from this event. */
@@ -326,6 +331,48 @@ struct app_event_manager_event_display_bm {
 
 extern struct app_event_manager_event_display_bm _app_event_manager_event_display_bm;
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+/**
+ * @brief Time statistics.
+ *
+ * Times are stored in hardware cycles.
+ */
+struct app_event_manager_stats {
+	/** Number of measurements. */
+	uint32_t count;
+
+	/** Shortest measured time. */
+	uint32_t min;
+
+	/** Longest measured time. */
+	uint32_t max;
+
+	/** Sum of the measured times. */
+	uint64_t total;
+
+	/** Log-scale histogram of the measured times in microseconds. */
+	uint32_t histogram[CONFIG_APP_EVENT_MANAGER_STATS_HISTOGRAM_SIZE];
+};
+
+/* Queueing delay statistics, indexed by the event type ID. */
+extern struct app_event_manager_stats
+	_app_event_manager_queue_stats[CONFIG_APP_EVENT_MANAGER_MAX_EVENT_CNT];
+
+struct event_subscriber;
+
+/* Get the notification time statistics of a subscriber. Returns NULL for
+ * the subscribers above CONFIG_APP_EVENT_MANAGER_STATS_MAX_SUBSCRIBERS,
+ * which are not measured.
+ */
+struct app_event_manager_stats *
+	_app_event_manager_subscriber_stats_get(const struct event_subscriber *es);
+
+/* Request clearing the statistics. The statistics are cleared by the event
+ * processor before the next event is processed.
+ */
+void _app_event_manager_stats_reset(void);
+#endif
+
 
 /* Event hooks subscribers */
 #define _APP_EVENT_HOOK_REGISTER(section, hook_fn, prio)           \
@@ -397,6 +444,12 @@ struct event_subscriber {
 	const struct event_listener *listener;
 };
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+/* Boundaries of the array of all subscribers, defined by the linker script. */
+extern const struct event_subscriber __start_event_subscribers_all[];
+extern const struct event_subscriber __stop_event_subscribers_all[];
+#endif
+
 
 /** @brief Structure used to register Application Event Manager initialization hook
  */
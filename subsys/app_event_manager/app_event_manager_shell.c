@@ -81,6 +81,77 @@ static int show_subscribers(const struct shell *shell, size_t argc,
 	return 0;
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+static void print_stats(const struct shell *shell,
+			const struct app_event_manager_stats *stats)
+{
+	shell_fprintf(shell, SHELL_NORMAL,
+		      "\t\tcnt: %u, min: %u us, max: %u us, mean: %u us\n",
+		      stats->count,
+		      k_cyc_to_us_floor32(stats->min),
+		      k_cyc_to_us_floor32(stats->max),
+		      k_cyc_to_us_floor32((uint32_t)(stats->total / stats->count)));
+
+	shell_fprintf(shell, SHELL_NORMAL, "\t\thist:");
+	for (size_t i = 0; i < ARRAY_SIZE(stats->histogram) - 1; i++) {
+		shell_fprintf(shell, SHELL_NORMAL, " <%u: %u", (1U << (i + 1)),
+			      stats->histogram[i]);
+	}
+	shell_fprintf(shell, SHELL_NORMAL, " >=%u: %u\n",
+		      (1U << (ARRAY_SIZE(stats->histogram) - 1)),
+		      stats->histogram[ARRAY_SIZE(stats->histogram) - 1]);
+}
+
+static int show_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	shell_fprintf(shell, SHELL_NORMAL, "Queueing delay:\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		const struct app_event_manager_stats *stats =
+			&_app_event_manager_queue_stats[et - _event_type_list_start];
+
+		if (stats->count == 0) {
+			continue;
+		}
+
+		shell_fprintf(shell, SHELL_NORMAL, "|\t[E:%s]\n", et->name);
+		print_stats(shell, stats);
+	}
+
+	shell_fprintf(shell, SHELL_NORMAL, "Notification time:\n");
+
+	STRUCT_SECTION_FOREACH(event_type, et) {
+		for (const struct event_subscriber *es = et->subs_start;
+		     es != et->subs_stop;
+		     es++) {
+			const struct app_event_manager_stats *stats =
+				_app_event_manager_subscriber_stats_get(es);
+
+			if (!stats || (stats->count == 0)) {
+				continue;
+			}
+
+			shell_fprintf(shell, SHELL_NORMAL,
+				      "|\t[E:%s] -> [L:%s]\n",
+				      et->name, es->listener->name);
+			print_stats(shell, stats);
+		}
+	}
+
+	return 0;
+}
+
+static int reset_stats(const struct shell *shell, size_t argc,
+		char **argv)
+{
+	_app_event_manager_stats_reset();
+	shell_fprintf(shell, SHELL_NORMAL, "Statistics reset requested\n");
+
+	return 0;
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_STATS */
+
 static void set_event_displaying(const struct shell *shell, size_t argc,
 				 char **argv, bool enable)
 {
@@ -155,6 +226,12 @@ SHELL_STATIC_SUBCMD_SET_CREATE(sub_app_event_manager,
 	SHELL_CMD_ARG(show_subscribers, NULL, "Show subscribers",
 		      show_subscribers, 0, 0),
 	SHELL_CMD_ARG(show_events, NULL, "Show events", show_events, 0, 0),
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+	SHELL_CMD_ARG(show_stats, NULL, "Show event processing statistics",
+		      show_stats, 0, 0),
+	SHELL_CMD_ARG(reset_stats, NULL, "Reset event processing statistics",
+		      reset_stats, 0, 0),
+#endif
 	SHELL_CMD_ARG(disable, NULL, "Disable displaying event with given ID",
 		      disable_event_displaying, 0,
 		      sizeof(_app_event_manager_event_display_bm) * 8 - 1),
@@ -4,52 +4,53 @@
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
 
+#include <string.h>
 #include <bluetooth/mesh/light_ctrl_reg_spec.h>
+#include "light_ctrl_reg_spec_internal.h"
 
-#define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+static const struct bt_mesh_light_ctrl_reg_spec_q_cfg *
+cfg_q_get(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+{
+	/* The configuration may be changed at any time by the server. Only
+	 * convert it when it actually changes, to keep the regulator step free
+	 * of floating point arithmetic as far as possible.
+	 */
+	if (memcmp(&spec_reg->cfg, &spec_reg->reg.cfg, sizeof(spec_reg->cfg))) {
+		spec_reg->cfg = spec_reg->reg.cfg;
+		reg_q_cfg_set(&spec_reg->cfg_q, &spec_reg->cfg);
+	}
 
-struct reg_terms {
-	float i;
-	float p;
-};
+	return &spec_reg->cfg_q;
+}
 
-static struct reg_terms reg_terms_calc(struct bt_mesh_light_ctrl_reg_spec *spec_reg)
+/* The target and the measured illuminance only change on a transition or a
+ * sensor report, so the previous conversion is reused as long as the bit
+ * pattern of the input is the same. Comparing the bits needs no floating
+ * point.
+ */
+static int64_t input_q_get(struct bt_mesh_light_ctrl_reg_spec_q_input *input, float val)
 {
-	float target = bt_mesh_light_ctrl_reg_target_get(&spec_reg->reg);
-	float error = target - spec_reg->reg.measured;
-	/* Accuracy should be in percent and both up and down: */
-	float accuracy = (spec_reg->reg.cfg.accuracy * target) / (2 * 100.0f);
-	float input;
-	float kp, ki;
-
-	if (error > accuracy) {
-		input = error - accuracy;
-	} else if (error < -accuracy) {
-		input = error + accuracy;
-	} else {
-		input = 0.0f;
-	}
+	uint32_t bits;
 
-	if (input >= 0) {
-		kp = spec_reg->reg.cfg.kp.up;
-		ki = spec_reg->reg.cfg.ki.up;
-	} else {
-		kp = spec_reg->reg.cfg.kp.down;
-		ki = spec_reg->reg.cfg.ki.down;
+	memcpy(&bits, &val, sizeof(bits));
+
+	if (bits != input->bits) {
+		input->bits = bits;
+		input->q = reg_q_from_float(val);
 	}
 
-	return (struct reg_terms){
-		.i = ((input) * (ki) * ((float)REG_INT / (float)MSEC_PER_SEC)),
-		.p = input * kp,
-	};
+	return input->q;
 }
+#endif
 
 static void reg_step(struct k_work *work)
 {
 	struct k_work_delayable *dwork = k_work_delayable_from_work(work);
 	struct bt_mesh_light_ctrl_reg_spec *spec_reg = CONTAINER_OF(
 		dwork, struct bt_mesh_light_ctrl_reg_spec, timer);
-	struct reg_terms reg_terms;
+	float target;
+	float output;
 
 	if (!spec_reg->enabled) {
 		/* The regulator might be disabled asynchronously. */
@@ -58,33 +59,47 @@ static void reg_step(struct k_work *work)
 
 	k_work_reschedule(&spec_reg->timer, K_MSEC(REG_INT));
 
-	reg_terms = reg_terms_calc(spec_reg);
-	spec_reg->i += reg_terms.i;
+	target = bt_mesh_light_ctrl_reg_target_get(&spec_reg->reg);
 
-	if (spec_reg->i >= 0) {
-		/* Drop the negative flag as soon as the internal sum becomes positive. */
-		spec_reg->neg = false;
-	}
-
-	if (!spec_reg->neg) {
-		spec_reg->i = CLAMP(spec_reg->i, 0, UINT16_MAX);
-	}
-
-	float output = spec_reg->i + reg_terms.p;
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+	/* The common regulator interface, shared with custom regulators,
+	 * passes the target, the measured illuminance and the output as float.
+	 * The inputs are only converted when they change, the output is
+	 * converted once per step.
+	 */
+	output = reg_q_to_float(reg_iterate_q(&spec_reg->i, &spec_reg->neg,
+					      input_q_get(&spec_reg->target_q, target),
+					      input_q_get(&spec_reg->measured_q,
+							  spec_reg->reg.measured),
+					      cfg_q_get(spec_reg)));
+#else
+	output = reg_iterate(&spec_reg->i, &spec_reg->neg, target, spec_reg->reg.measured,
+			     &spec_reg->reg.cfg);
+#endif
 
 	spec_reg->reg.updated(&spec_reg->reg, output);
 }
 
 static void internal_sum_recover(struct bt_mesh_light_ctrl_reg_spec *spec_reg, uint16_t lightness)
 {
-	struct reg_terms reg_terms;
-
-	reg_terms = reg_terms_calc(spec_reg);
+	float target = bt_mesh_light_ctrl_reg_target_get(&spec_reg->reg);
 
 	/* Recalculate the internal sum so that it is equal to the passed lightness level at the
 	 * next regulator step.
 	 */
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+	struct reg_terms_q reg_terms =
+		reg_terms_calc_q(input_q_get(&spec_reg->target_q, target),
+				 input_q_get(&spec_reg->measured_q, spec_reg->reg.measured),
+				 cfg_q_get(spec_reg));
+
+	spec_reg->i = lightness * REG_Q_ONE - reg_terms.i;
+#else
+	struct reg_terms reg_terms = reg_terms_calc(target, spec_reg->reg.measured,
+						    &spec_reg->reg.cfg);
+
 	spec_reg->i = lightness - reg_terms.i;
+#endif
 	/* Allow the internal sum to be negative until it becomes positive. */
 	spec_reg->neg = true;
 }
@@ -112,4 +127,11 @@ void bt_mesh_light_ctrl_reg_spec_init(struct bt_mesh_light_ctrl_reg *reg)
 	struct bt_mesh_light_ctrl_reg_spec *spec_reg = CONTAINER_OF(
 		reg, struct bt_mesh_light_ctrl_reg_spec, reg);
 	k_work_init_delayable(&spec_reg->timer, reg_step);
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+	spec_reg->cfg = reg->cfg;
+	reg_q_cfg_set(&spec_reg->cfg_q, &spec_reg->cfg);
+	/* The all-zero bit pattern is 0.0f, which converts to 0. */
+	memset(&spec_reg->target_q, 0, sizeof(spec_reg->target_q));
+	memset(&spec_reg->measured_q, 0, sizeof(spec_reg->measured_q));
+#endif
 }
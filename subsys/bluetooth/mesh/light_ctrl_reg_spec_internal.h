@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/**
+ * @file
+ * @brief Specification-defined illuminance regulator arithmetic.
+ *
+ * The regulator step is implemented both in single precision floating point
+ * and in Q16.16 fixed point. Only one of them is used by the regulator,
+ * depending on @kconfig{CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT}, but
+ * both are kept available so that they can be compared side by side.
+ */
+
+#ifndef LIGHT_CTRL_REG_SPEC_INTERNAL_H__
+#define LIGHT_CTRL_REG_SPEC_INTERNAL_H__
+
+#include <bluetooth/mesh/light_ctrl_reg_spec.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define REG_INT CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_INTERVAL
+
+/** Number of fractional bits in the fixed-point representation. */
+#define REG_Q_SHIFT 16
+/** Fixed-point representation of 1. */
+#define REG_Q_ONE ((int64_t)1 << REG_Q_SHIFT)
+
+struct reg_terms {
+	float i;
+	float p;
+};
+
+struct reg_terms_q {
+	int64_t i;
+	int64_t p;
+};
+
+static inline int64_t reg_q_from_float(float val)
+{
+	/* Round to nearest to keep the conversion error within half an LSB. */
+	return (int64_t)(val * (float)REG_Q_ONE + (val < 0.0f ? -0.5f : 0.5f));
+}
+
+static inline float reg_q_to_float(int64_t val)
+{
+	return (float)val / (float)REG_Q_ONE;
+}
+
+static inline void reg_q_cfg_set(struct bt_mesh_light_ctrl_reg_spec_q_cfg *cfg_q,
+				 const struct bt_mesh_light_ctrl_reg_cfg *cfg)
+{
+	cfg_q->ki_up = reg_q_from_float(cfg->ki.up);
+	cfg_q->ki_down = reg_q_from_float(cfg->ki.down);
+	cfg_q->kp_up = reg_q_from_float(cfg->kp.up);
+	cfg_q->kp_down = reg_q_from_float(cfg->kp.down);
+	cfg_q->accuracy = reg_q_from_float(cfg->accuracy);
+}
+
+static inline struct reg_terms reg_terms_calc(float target, float measured,
+					      const struct bt_mesh_light_ctrl_reg_cfg *cfg)
+{
+	float error = target - measured;
+	/* Accuracy should be in percent and both up and down: */
+	float accuracy = (cfg->accuracy * target) / (2 * 100.0f);
+	float input;
+	float kp, ki;
+
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0.0f;
+	}
+
+	if (input >= 0) {
+		kp = cfg->kp.up;
+		ki = cfg->ki.up;
+	} else {
+		kp = cfg->kp.down;
+		ki = cfg->ki.down;
+	}
+
+	return (struct reg_terms){
+		.i = ((input) * (ki) * ((float)REG_INT / (float)MSEC_PER_SEC)),
+		.p = input * kp,
+	};
+}
+
+/* All values are Q16.16. The coefficients are bounded by 1000 and the
+ * illuminance by 167772.16 lux, so no intermediate product exceeds 2^60.
+ */
+static inline struct reg_terms_q
+reg_terms_calc_q(int64_t target, int64_t measured,
+		 const struct bt_mesh_light_ctrl_reg_spec_q_cfg *cfg)
+{
+	int64_t error = target - measured;
+	/* Accuracy should be in percent and both up and down: */
+	int64_t accuracy = (cfg->accuracy * target) / (2 * 100 * REG_Q_ONE);
+	int64_t input;
+	int64_t kp, ki;
+
+	if (error > accuracy) {
+		input = error - accuracy;
+	} else if (error < -accuracy) {
+		input = error + accuracy;
+	} else {
+		input = 0;
+	}
+
+	if (input >= 0) {
+		kp = cfg->kp_up;
+		ki = cfg->ki_up;
+	} else {
+		kp = cfg->kp_down;
+		ki = cfg->ki_down;
+	}
+
+	return (struct reg_terms_q){
+		.i = ((input * ki) / REG_Q_ONE) * REG_INT / MSEC_PER_SEC,
+		.p = (input * kp) / REG_Q_ONE,
+	};
+}
+
+/** @brief Run a single floating point regulator iteration.
+ *
+ *  @param[in,out] i   Internal integral sum.
+ *  @param[in,out] neg Whether the internal sum is allowed to be negative.
+ *  @param[in] target   Target illuminance.
+ *  @param[in] measured Measured illuminance.
+ *  @param[in] cfg      Regulator configuration.
+ *
+ *  @return Regulator output.
+ */
+static inline float reg_iterate(float *i, bool *neg, float target, float measured,
+				const struct bt_mesh_light_ctrl_reg_cfg *cfg)
+{
+	struct reg_terms reg_terms = reg_terms_calc(target, measured, cfg);
+
+	*i += reg_terms.i;
+
+	if (*i >= 0) {
+		/* Drop the negative flag as soon as the internal sum becomes positive. */
+		*neg = false;
+	}
+
+	if (!*neg) {
+		*i = CLAMP(*i, 0, UINT16_MAX);
+	}
+
+	return *i + reg_terms.p;
+}
+
+/** @brief Run a single fixed-point regulator iteration.
+ *
+ *  Equivalent to @ref reg_iterate, with all values in Q16.16 format.
+ *
+ *  Every input is rounded to the nearest 2^-16 and every product is
+ *  truncated, so the error of the returned output, compared to an exact
+ *  evaluation, is bounded by
+ *  (kp + ki * REG_INT / 1000 + 2) * 2^-15 + |input| * 2^-16 + 2^-15
+ *  per iteration, and the integral error grows by at most
+ *  (ki * REG_INT / 1000 + 2) * 2^-15 + |input| * 2^-16 per iteration.
+ *  In comparison, the floating point internal sum alone loses up to 2^-9
+ *  per iteration when it is close to the top of the lightness range.
+ *
+ *  @return Regulator output in Q16.16 format.
+ */
+static inline int64_t reg_iterate_q(int64_t *i, bool *neg, int64_t target, int64_t measured,
+				    const struct bt_mesh_light_ctrl_reg_spec_q_cfg *cfg)
+{
+	struct reg_terms_q reg_terms = reg_terms_calc_q(target, measured, cfg);
+
+	*i += reg_terms.i;
+
+	if (*i >= 0) {
+		/* Drop the negative flag as soon as the internal sum becomes positive. */
+		*neg = false;
+	}
+
+	if (!*neg) {
+		*i = CLAMP(*i, 0, UINT16_MAX * REG_Q_ONE);
+	}
+
+	return *i + reg_terms.p;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIGHT_CTRL_REG_SPEC_INTERNAL_H__ */
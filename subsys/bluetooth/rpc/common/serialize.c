@@ -370,6 +370,24 @@ error_exit:
 	return NULL;
 }
 
+void *ser_decode_buffer_ref(struct ser_scratchpad *scratchpad, size_t *len)
+{
+	const void *result;
+	size_t size = 0;
+
+	if (!IS_ENABLED(CONFIG_BT_RPC_ZERO_COPY)) {
+		return ser_decode_buffer_into_scratchpad(scratchpad, len);
+	}
+
+	result = ser_decode_buffer_ptr_and_size(scratchpad->ctx, &size);
+
+	if (len != NULL) {
+		*len = size;
+	}
+
+	return (void *)result;
+}
+
 void *ser_decode_callback_call(struct nrf_rpc_cbor_ctx *ctx)
 {
 	int slot = ser_decode_uint(ctx);
@@ -425,6 +443,22 @@ bool ser_decoding_done_and_check(const struct nrf_rpc_group *group, struct nrf_r
 	return !is_decoder_invalid(ctx);
 }
 
+bool ser_decoding_check_ref(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx)
+{
+	if (!IS_ENABLED(CONFIG_BT_RPC_ZERO_COPY) || is_decoder_invalid(ctx)) {
+		return ser_decoding_done_and_check(group, ctx);
+	}
+
+	return true;
+}
+
+void ser_decoding_release(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx)
+{
+	if (IS_ENABLED(CONFIG_BT_RPC_ZERO_COPY)) {
+		nrf_rpc_cbor_decoding_done(group, ctx);
+	}
+}
+
 void ser_rsp_decode_i32(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx,
 			void *handler_data)
 {
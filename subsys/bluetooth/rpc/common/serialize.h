@@ -264,6 +264,20 @@ const void *ser_decode_buffer_ptr_and_size(struct nrf_rpc_cbor_ctx *ctx, size_t
  */
 void *ser_decode_buffer_into_scratchpad(struct ser_scratchpad *scratchpad, size_t *len);
 
+/** @brief Decode buffer by reference if zero-copy is enabled.
+ *
+ * If @kconfig{CONFIG_BT_RPC_ZERO_COPY} is enabled, the returned pointer points to the
+ * data within the received packet. The data is not aligned and it is valid until
+ * @ref ser_decoding_release is called. Otherwise, the buffer is decoded into
+ * the scratchpad like with the @ref ser_decode_buffer_into_scratchpad function.
+ *
+ * @param[in] scratchpad Pointer to the scratchpad.
+ * @param[out] len length of decoded buffer in bytes.
+ *
+ * @retval Pointer to a decoded buffer data.
+ */
+void *ser_decode_buffer_ref(struct ser_scratchpad *scratchpad, size_t *len);
+
 /** @brief Decode a callback.
  *
  * This function will use callback proxy module to associate decoded integer
@@ -318,6 +332,32 @@ bool ser_decode_valid(const struct nrf_rpc_cbor_ctx *ctx);
  */
 bool ser_decoding_done_and_check(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx);
 
+/** @brief Check decoding of a packet with buffers decoded by @ref ser_decode_buffer_ref.
+ *
+ * If @kconfig{CONFIG_BT_RPC_ZERO_COPY} is enabled and decoding finished with success,
+ * the received packet is kept, and @ref ser_decoding_release must be called after
+ * the last use of the referenced buffers. Otherwise, this function is equivalent to
+ * @ref ser_decoding_done_and_check.
+ *
+ * The transport may not receive further packets while a packet is kept, so the
+ * handler must not call application callbacks or send nRF RPC commands before
+ * @ref ser_decoding_release is called.
+ *
+ * @param[in] group nRF RPC group.
+ * @param[in,out] ctx CBOR decoding context.
+ *
+ * @retval True if decoding finshed with success.
+ *         Otherwise, false will be returned.
+ */
+bool ser_decoding_check_ref(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx);
+
+/** @brief Release the packet kept by @ref ser_decoding_check_ref.
+ *
+ * @param[in] group nRF RPC group.
+ * @param[in,out] ctx CBOR decoding context.
+ */
+void ser_decoding_release(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx);
+
 /** @brief Decode a command response as a boolean value.
  *
  * @param[in] group nRF RPC group.
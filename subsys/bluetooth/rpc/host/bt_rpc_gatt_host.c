@@ -675,14 +675,17 @@ static void bt_rpc_gatt_send_desc_attr_rpc_handler(const struct nrf_rpc_group *g
 	special_attr = ser_decode_uint(ctx);
 	param = ser_decode_uint(ctx);
 	size = ser_decode_uint(ctx);
-	buffer = ser_decode_buffer_into_scratchpad(&scratchpad, NULL);
+	buffer = ser_decode_buffer_ref(&scratchpad, NULL);
 
-	if (!ser_decoding_done_and_check(group, ctx)) {
+	if (!ser_decoding_check_ref(group, ctx)) {
 		goto decoding_error;
 	}
 
+	/* The descriptor value is copied into the GATT buffer, no callback runs here. */
 	result = bt_rpc_gatt_send_desc_attr(special_attr, param, buffer, size);
 
+	ser_decoding_release(group, ctx);
+
 	ser_rsp_send_int(group, result);
 
 	return;
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef CPU_LOAD_BACKEND_H__
+#define CPU_LOAD_BACKEND_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Initialize the measurement backend.
+ *
+ * Called once by @ref cpu_load_init. The backend also implements
+ * @ref cpu_load_reset, @ref cpu_load_get, @ref cpu_load_thread_get and
+ * @ref cpu_load_histogram_get.
+ *
+ * @return 0 on success, negative error code otherwise.
+ */
+int cpu_load_backend_init(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CPU_LOAD_BACKEND_H__ */
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <string.h>
+#include <debug/cpu_load.h>
+#include <zephyr/kernel.h>
+#include <zephyr/spinlock.h>
+
+#include "cpu_load_backend.h"
+
+#define FULL_LOAD 100000
+
+/* Cycles accounted by the kernel to all threads and to the idle threads. */
+struct cycles {
+	uint64_t exec;
+	uint64_t idle;
+};
+
+struct thread_ref {
+	k_tid_t thread;
+	uint64_t exec;
+};
+
+static struct k_spinlock lock;
+static struct cycles ref;
+
+#ifdef CONFIG_CPU_LOAD_THREADS
+static struct thread_ref thread_ref[CONFIG_CPU_LOAD_THREADS_MAX];
+static size_t thread_ref_cnt;
+static bool thread_ref_overflow;
+#endif
+
+#ifdef CONFIG_CPU_LOAD_HISTOGRAM
+static struct {
+	struct k_work_delayable work;
+	struct cycles start;
+	uint32_t load[CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS];
+	size_t cnt;
+	size_t next;
+} histogram;
+#endif
+
+static void cycles_get(struct cycles *cycles)
+{
+	k_thread_runtime_stats_t stats;
+
+	k_thread_runtime_stats_all_get(&stats);
+
+	cycles->exec = stats.execution_cycles;
+	cycles->idle = stats.idle_cycles;
+}
+
+static uint32_t load_calc(uint64_t busy, uint64_t total)
+{
+	if (total == 0) {
+		return 0;
+	}
+
+	return (uint32_t)((MIN(busy, total) * FULL_LOAD) / total);
+}
+
+static uint32_t cycles_load(const struct cycles *from, const struct cycles *to)
+{
+	uint64_t total = to->exec - from->exec;
+	uint64_t idle = to->idle - from->idle;
+
+	return load_calc((total > idle) ? (total - idle) : 0, total);
+}
+
+#ifdef CONFIG_CPU_LOAD_THREADS
+static void thread_ref_add(const struct k_thread *thread, void *user_data)
+{
+	k_thread_runtime_stats_t stats;
+
+	if (thread_ref_cnt >= ARRAY_SIZE(thread_ref)) {
+		thread_ref_overflow = true;
+		return;
+	}
+
+	if (k_thread_runtime_stats_get((k_tid_t)thread, &stats)) {
+		return;
+	}
+
+	thread_ref[thread_ref_cnt].thread = (k_tid_t)thread;
+	thread_ref[thread_ref_cnt].exec = stats.execution_cycles;
+	thread_ref_cnt++;
+}
+
+int cpu_load_thread_get(k_tid_t thread, uint32_t *load)
+{
+	k_thread_runtime_stats_t stats;
+	k_spinlock_key_t key;
+	struct cycles now;
+	uint64_t exec_ref = 0;
+	bool found = false;
+	int err;
+
+	key = k_spin_lock(&lock);
+
+	cycles_get(&now);
+
+	err = k_thread_runtime_stats_get(thread, &stats);
+	if (err) {
+		k_spin_unlock(&lock, key);
+		return err;
+	}
+
+	for (size_t i = 0; i < thread_ref_cnt; i++) {
+		if (thread_ref[i].thread == thread) {
+			exec_ref = thread_ref[i].exec;
+			found = true;
+			break;
+		}
+	}
+
+	/* A thread without a reference point has been created after the reset,
+	 * unless some threads did not fit in the reference table.
+	 */
+	if (!found && thread_ref_overflow) {
+		k_spin_unlock(&lock, key);
+		return -ENOMEM;
+	}
+
+	/* Fewer cycles than at the reset mean that the thread has been
+	 * recreated in the same memory.
+	 */
+	if (stats.execution_cycles < exec_ref) {
+		exec_ref = 0;
+	}
+
+	*load = load_calc(stats.execution_cycles - exec_ref, now.exec - ref.exec);
+
+	k_spin_unlock(&lock, key);
+
+	return 0;
+}
+#else
+int cpu_load_thread_get(k_tid_t thread, uint32_t *load)
+{
+	return -ENOTSUP;
+}
+#endif /* CONFIG_CPU_LOAD_THREADS */
+
+#ifdef CONFIG_CPU_LOAD_HISTOGRAM
+static void histogram_work_fn(struct k_work *work)
+{
+	k_spinlock_key_t key;
+	struct cycles now;
+
+	key = k_spin_lock(&lock);
+
+	cycles_get(&now);
+
+	histogram.load[histogram.next] = cycles_load(&histogram.start, &now);
+	histogram.next = (histogram.next + 1) % ARRAY_SIZE(histogram.load);
+	histogram.cnt = MIN(histogram.cnt + 1, ARRAY_SIZE(histogram.load));
+	histogram.start = now;
+
+	k_spin_unlock(&lock, key);
+
+	k_work_schedule(&histogram.work, K_MSEC(CONFIG_CPU_LOAD_HISTOGRAM_WINDOW));
+}
+
+int cpu_load_histogram_get(uint32_t *buckets, size_t bucket_cnt)
+{
+	k_spinlock_key_t key;
+	size_t cnt;
+
+	if ((buckets == NULL) || (bucket_cnt == 0)) {
+		return -EINVAL;
+	}
+
+	memset(buckets, 0, bucket_cnt * sizeof(*buckets));
+
+	key = k_spin_lock(&lock);
+
+	cnt = histogram.cnt;
+	for (size_t i = 0; i < cnt; i++) {
+		uint64_t idx = ((uint64_t)histogram.load[i] * bucket_cnt) / FULL_LOAD;
+
+		buckets[MIN(idx, bucket_cnt - 1)]++;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return cnt;
+}
+#else
+int cpu_load_histogram_get(uint32_t *buckets, size_t bucket_cnt)
+{
+	return -ENOTSUP;
+}
+#endif /* CONFIG_CPU_LOAD_HISTOGRAM */
+
+int cpu_load_backend_init(void)
+{
+#ifdef CONFIG_CPU_LOAD_HISTOGRAM
+	cycles_get(&histogram.start);
+	k_work_init_delayable(&histogram.work, histogram_work_fn);
+	k_work_schedule(&histogram.work, K_MSEC(CONFIG_CPU_LOAD_HISTOGRAM_WINDOW));
+#endif
+
+	return 0;
+}
+
+void cpu_load_reset(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	cycles_get(&ref);
+
+#ifdef CONFIG_CPU_LOAD_THREADS
+	thread_ref_cnt = 0;
+	thread_ref_overflow = false;
+	k_thread_foreach(thread_ref_add, NULL);
+#endif
+
+	k_spin_unlock(&lock, key);
+}
+
+uint32_t cpu_load_get(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	struct cycles now;
+	uint32_t load;
+
+	cycles_get(&now);
+	load = cycles_load(&ref, &now);
+
+	k_spin_unlock(&lock, key);
+
+	return load;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file dfu_target_mcuboot_hash.h
+ *
+ * @brief Verification of the SHA-256 hash of an MCUboot image while it is
+ *	  being downloaded.
+ *
+ * The image is passed to the module as it is written to flash. The hash of the
+ * image header, body and protected TLVs is computed, and the expected hash is
+ * taken from the SHA-256 TLV of the image, so that the image does not need to
+ * be read again from flash to be verified.
+ */
+
+#ifndef DFU_TARGET_MCUBOOT_HASH_H__
+#define DFU_TARGET_MCUBOOT_HASH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Start the hash computation of a new image.
+ *
+ * @retval 0 If successful, negative errno otherwise.
+ */
+int dfu_target_mcuboot_hash_init(void);
+
+/**
+ * @brief Process the next chunk of the image.
+ *
+ * @param[in] buf Pointer to the chunk.
+ * @param[in] len Length of the chunk.
+ *
+ * @retval 0 If successful, negative errno otherwise.
+ */
+int dfu_target_mcuboot_hash_update(const uint8_t *buf, size_t len);
+
+/**
+ * @brief Verify the hash of the image once all its data has been processed.
+ *
+ * @retval 0 If the hash of the image matches its SHA-256 TLV.
+ * @retval -ENOTSUP If the image is encrypted, so that its hash can only be
+ *		    verified after decryption, by MCUboot.
+ * @retval -EBADMSG If the image is incomplete, malformed or its hash does not
+ *		    match.
+ */
+int dfu_target_mcuboot_hash_verify(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DFU_TARGET_MCUBOOT_HASH_H__ */
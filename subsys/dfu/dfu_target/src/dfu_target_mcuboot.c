@@ -23,6 +23,11 @@
 #include <dfu/dfu_target.h>
 #include <dfu/dfu_target_stream.h>
 #include <zephyr/devicetree.h>
+#include <zephyr/drivers/flash.h>
+
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH
+#include "dfu_target_mcuboot_hash.h"
+#endif
 
 LOG_MODULE_REGISTER(dfu_target_mcuboot, CONFIG_DFU_TARGET_LOG_LEVEL);
 
@@ -88,6 +93,48 @@ static size_t stream_buf_len;
 static size_t stream_buf_bytes;
 static uint8_t curr_sec_img;
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH
+/**
+ * @brief Start the hash computation of the image, including the part of the
+ *	  image already written to flash if the download is resumed.
+ */
+static int hash_init(const struct device *flash_dev, int img_num)
+{
+	int err;
+	size_t offset;
+	size_t written;
+
+	err = dfu_target_mcuboot_hash_init();
+	if (err != 0) {
+		return err;
+	}
+
+	err = dfu_target_stream_offset_get(&written);
+	if (err != 0) {
+		return err;
+	}
+
+	/* The stream buffer is empty right after initialization. */
+	for (offset = 0; offset < written; offset += stream_buf_len) {
+		size_t len = MIN(stream_buf_len, written - offset);
+
+		err = flash_read(flash_dev, secondary_address[img_num] + offset,
+				 stream_buf, len);
+		if (err != 0) {
+			LOG_ERR("flash_read error %d", err);
+			return err;
+		}
+
+		err = dfu_target_mcuboot_hash_update(stream_buf, len);
+		if (err != 0) {
+			return err;
+		}
+	}
+
+	return 0;
+}
+#endif /* CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH */
+
 bool dfu_target_mcuboot_identify(const void *const buf)
 {
 	/* MCUBoot headers starts with 4 byte magic word */
@@ -149,6 +196,15 @@ int dfu_target_mcuboot_init(size_t file_size, int img_num, dfu_target_callback_t
 		return err;
 	}
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH
+	err = hash_init(flash_dev, img_num);
+	if (err != 0) {
+		LOG_ERR("Unable to start image hash computation: %d", err);
+		dfu_target_stream_done(false);
+		return err;
+	}
+#endif
+
 	curr_sec_img = img_num;
 	return 0;
 }
@@ -167,11 +223,48 @@ int dfu_target_mcuboot_offset_get(size_t *out)
 
 int dfu_target_mcuboot_write(const void *const buf, size_t len)
 {
+	int err;
+
 	stream_buf_bytes = (stream_buf_bytes + len) % stream_buf_len;
 
-	return dfu_target_stream_write(buf, len);
+	err = dfu_target_stream_write(buf, len);
+
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH
+	if (err == 0) {
+		err = dfu_target_mcuboot_hash_update(buf, len);
+	}
+#endif
+
+	return err;
 }
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH
+/**
+ * @brief Erase the flash page with the image header.
+ *
+ * The page is erased directly, because the stream flash skips erasing the
+ * page it has erased last, which may be the header page for a small image.
+ */
+static int header_erase(void)
+{
+	const struct device *flash_dev = secondary_dev[curr_sec_img];
+	struct flash_pages_info page;
+	int err;
+
+	err = flash_get_page_info_by_offs(flash_dev, secondary_address[curr_sec_img], &page);
+	if (err != 0) {
+		return err;
+	}
+
+	err = flash_erase(flash_dev, page.start_offset, page.size);
+	if (err != 0) {
+		LOG_ERR("Unable to erase the image header: %d", err);
+	}
+
+	return err;
+}
+#endif /* CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH */
+
 int dfu_target_mcuboot_done(bool successful)
 {
 	int err = 0;
@@ -185,6 +278,19 @@ int dfu_target_mcuboot_done(bool successful)
 	if (successful) {
 		stream_buf_bytes = 0;
 
+#ifdef CONFIG_DFU_TARGET_MCUBOOT_VERIFY_HASH
+		err = dfu_target_mcuboot_hash_verify();
+		if (err == -ENOTSUP) {
+			err = 0;
+		} else if (err != 0) {
+			/* Erase the image header so that the image is not
+			 * booted even if the update is scheduled.
+			 */
+			(void)header_erase();
+			return err;
+		}
+#endif
+
 		err = stream_flash_erase_page(dfu_target_stream_get_stream(),
 					secondary_last_address[curr_sec_img]);
 		if (err != 0) {
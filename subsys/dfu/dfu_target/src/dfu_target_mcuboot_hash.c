@@ -0,0 +1,288 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/byteorder.h>
+#include <mbedtls/sha256.h>
+
+#include "dfu_target_mcuboot_hash.h"
+
+LOG_MODULE_REGISTER(dfu_target_mcuboot_hash, CONFIG_DFU_TARGET_LOG_LEVEL);
+
+/* MCUboot image format, see bootutil/image.h in MCUboot. */
+#define IMAGE_MAGIC			0x96f3b83d
+#define IMAGE_HEADER_SIZE		32
+#define IMAGE_HEADER_HDR_SIZE_OFFSET	8
+#define IMAGE_HEADER_PROT_TLV_OFFSET	10
+#define IMAGE_HEADER_IMG_SIZE_OFFSET	12
+#define IMAGE_HEADER_FLAGS_OFFSET	16
+#define IMAGE_F_ENCRYPTED_AES128	0x00000004
+#define IMAGE_F_ENCRYPTED_AES256	0x00000008
+#define IMAGE_TLV_INFO_MAGIC		0x6907
+#define IMAGE_TLV_INFO_SIZE		4
+#define IMAGE_TLV_SIZE			4
+#define IMAGE_TLV_SHA256		0x10
+#define IMAGE_HASH_SIZE			32
+
+enum hash_state {
+	/* Collecting the image header. */
+	STATE_HEADER,
+	/* Hashing the rest of the header, the body and the protected TLVs. */
+	STATE_BODY,
+	/* Collecting the information header of the unprotected TLVs. */
+	STATE_TLV_INFO,
+	/* Collecting the type and length of a TLV. */
+	STATE_TLV,
+	/* Collecting the value of the SHA-256 TLV. */
+	STATE_TLV_HASH,
+	/* Skipping the value of another TLV. */
+	STATE_TLV_SKIP,
+	/* All TLVs have been parsed, ignoring any padding. */
+	STATE_DONE,
+	/* The hash of an encrypted image cannot be verified. */
+	STATE_ENCRYPTED,
+	/* The image is malformed. */
+	STATE_INVALID,
+};
+
+static struct {
+	mbedtls_sha256_context sha256_ctx;
+	enum hash_state state;
+	/* Number of bytes of the image processed. */
+	size_t offset;
+	/* Number of bytes of the image covered by the hash. */
+	size_t hash_len;
+	/* Start and end of the item (header, TLV or TLV value) being processed. */
+	size_t item_start;
+	size_t item_end;
+	/* End of the unprotected TLV area. */
+	size_t tlv_end;
+	uint8_t item[IMAGE_HEADER_SIZE];
+	uint8_t expected_hash[IMAGE_HASH_SIZE];
+	bool expected_hash_found;
+} ctx;
+
+BUILD_ASSERT(IMAGE_HASH_SIZE <= sizeof(ctx.item));
+
+static void state_set(enum hash_state state, size_t item_len)
+{
+	ctx.state = state;
+	ctx.item_start = ctx.offset;
+	ctx.item_end = ctx.offset + item_len;
+}
+
+static void parse_header(void)
+{
+	uint32_t flags = sys_get_le32(&ctx.item[IMAGE_HEADER_FLAGS_OFFSET]);
+	uint16_t hdr_size = sys_get_le16(&ctx.item[IMAGE_HEADER_HDR_SIZE_OFFSET]);
+	uint16_t prot_tlv_size = sys_get_le16(&ctx.item[IMAGE_HEADER_PROT_TLV_OFFSET]);
+	uint32_t img_size = sys_get_le32(&ctx.item[IMAGE_HEADER_IMG_SIZE_OFFSET]);
+
+	if (sys_get_le32(ctx.item) != IMAGE_MAGIC || hdr_size < IMAGE_HEADER_SIZE ||
+	    img_size > SIZE_MAX - hdr_size - prot_tlv_size - UINT16_MAX) {
+		LOG_ERR("Invalid image header");
+		state_set(STATE_INVALID, 0);
+		return;
+	}
+
+	if (flags & (IMAGE_F_ENCRYPTED_AES128 | IMAGE_F_ENCRYPTED_AES256)) {
+		LOG_INF("Encrypted image, hash is verified by MCUboot");
+		state_set(STATE_ENCRYPTED, 0);
+		return;
+	}
+
+	ctx.hash_len = hdr_size + img_size + prot_tlv_size;
+
+	state_set(STATE_BODY, ctx.hash_len - ctx.offset);
+}
+
+static void next_tlv(void)
+{
+	if (ctx.offset == ctx.tlv_end) {
+		state_set(STATE_DONE, 0);
+	} else {
+		state_set(STATE_TLV, IMAGE_TLV_SIZE);
+	}
+}
+
+static void parse_tlv_info(void)
+{
+	uint16_t tlv_tot = sys_get_le16(&ctx.item[2]);
+
+	if (sys_get_le16(ctx.item) != IMAGE_TLV_INFO_MAGIC || tlv_tot < IMAGE_TLV_INFO_SIZE) {
+		LOG_ERR("Invalid TLV area");
+		state_set(STATE_INVALID, 0);
+		return;
+	}
+
+	ctx.tlv_end = ctx.offset - IMAGE_TLV_INFO_SIZE + tlv_tot;
+
+	next_tlv();
+}
+
+static void parse_tlv(void)
+{
+	uint16_t type = sys_get_le16(ctx.item);
+	uint16_t len = sys_get_le16(&ctx.item[2]);
+
+	if (len > ctx.tlv_end - ctx.offset) {
+		LOG_ERR("Invalid TLV 0x%x", type);
+		state_set(STATE_INVALID, 0);
+	} else if (type == IMAGE_TLV_SHA256) {
+		if (len != IMAGE_HASH_SIZE) {
+			LOG_ERR("Invalid SHA-256 TLV length %u", len);
+			state_set(STATE_INVALID, 0);
+		} else {
+			state_set(STATE_TLV_HASH, len);
+		}
+	} else {
+		state_set(STATE_TLV_SKIP, len);
+	}
+}
+
+/**
+ * @brief Process bytes of the current item, and move on to the next item
+ *	  when the current one is complete.
+ *
+ * @return The number of bytes processed.
+ */
+static size_t process(const uint8_t *buf, size_t len)
+{
+	size_t item_offset = ctx.offset - ctx.item_start;
+
+	len = MIN(len, ctx.item_end - ctx.offset);
+
+	switch (ctx.state) {
+	case STATE_HEADER:
+	case STATE_TLV_INFO:
+	case STATE_TLV:
+		memcpy(&ctx.item[item_offset], buf, len);
+		break;
+	case STATE_TLV_HASH:
+		memcpy(&ctx.expected_hash[item_offset], buf, len);
+		break;
+	default:
+		break;
+	}
+
+	ctx.offset += len;
+
+	if (ctx.offset != ctx.item_end) {
+		return len;
+	}
+
+	switch (ctx.state) {
+	case STATE_HEADER:
+		parse_header();
+		break;
+	case STATE_BODY:
+		state_set(STATE_TLV_INFO, IMAGE_TLV_INFO_SIZE);
+		break;
+	case STATE_TLV_INFO:
+		parse_tlv_info();
+		break;
+	case STATE_TLV:
+		parse_tlv();
+		break;
+	case STATE_TLV_HASH:
+		ctx.expected_hash_found = true;
+		next_tlv();
+		break;
+	case STATE_TLV_SKIP:
+		next_tlv();
+		break;
+	default:
+		break;
+	}
+
+	return len;
+}
+
+int dfu_target_mcuboot_hash_init(void)
+{
+	int err;
+
+	mbedtls_sha256_free(&ctx.sha256_ctx);
+	memset(&ctx, 0, sizeof(ctx));
+
+	mbedtls_sha256_init(&ctx.sha256_ctx);
+
+	err = mbedtls_sha256_starts(&ctx.sha256_ctx, false);
+	if (err) {
+		LOG_ERR("mbedtls_sha256_starts error %d", err);
+		return -EFAULT;
+	}
+
+	/* The image size is not known before the header is parsed. */
+	ctx.hash_len = SIZE_MAX;
+	state_set(STATE_HEADER, IMAGE_HEADER_SIZE);
+
+	return 0;
+}
+
+int dfu_target_mcuboot_hash_update(const uint8_t *buf, size_t len)
+{
+	int err;
+
+	while (len > 0 && ctx.state < STATE_DONE) {
+		size_t start = ctx.offset;
+		size_t processed = process(buf, len);
+
+		/* The size of the hashed area is known once the header, which
+		 * is itself hashed, has been parsed.
+		 */
+		if (start < ctx.hash_len) {
+			err = mbedtls_sha256_update(&ctx.sha256_ctx, buf,
+						    MIN(processed, ctx.hash_len - start));
+			if (err) {
+				LOG_ERR("mbedtls_sha256_update error %d", err);
+				return -EFAULT;
+			}
+		}
+
+		buf += processed;
+		len -= processed;
+	}
+
+	return 0;
+}
+
+int dfu_target_mcuboot_hash_verify(void)
+{
+	int err;
+	uint8_t hash[IMAGE_HASH_SIZE];
+
+	if (ctx.state == STATE_ENCRYPTED) {
+		return -ENOTSUP;
+	}
+
+	if (ctx.state != STATE_DONE || !ctx.expected_hash_found) {
+		LOG_ERR("Image incomplete or malformed");
+		return -EBADMSG;
+	}
+
+	err = mbedtls_sha256_finish(&ctx.sha256_ctx, hash);
+	if (err) {
+		LOG_ERR("mbedtls_sha256_finish error %d", err);
+		return -EFAULT;
+	}
+
+	/* Another call to verify fails until the next image is started. */
+	ctx.state = STATE_INVALID;
+
+	if (memcmp(hash, ctx.expected_hash, sizeof(hash)) != 0) {
+		LOG_ERR("Image hash mismatch");
+		return -EBADMSG;
+	}
+
+	LOG_INF("Image hash verified");
+
+	return 0;
+}
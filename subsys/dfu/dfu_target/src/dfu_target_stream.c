@@ -24,15 +24,15 @@ static const char *current_id;
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 
 static char current_name_key[32];
+static size_t stored_progress;
 
 /**
  * @brief Store the information stored in the stream_flash instance so that it
  *        can be restored from flash in case of a power failure, reboot etc.
  */
-static int store_progress(void)
+static int store_progress(size_t bytes_written)
 {
 	int err;
-	size_t bytes_written = stream_flash_bytes_written(&stream);
 
 	err = settings_save_one(current_name_key, &bytes_written,
 				sizeof(bytes_written));
@@ -42,9 +42,72 @@ static int store_progress(void)
 		return err;
 	}
 
+	stored_progress = bytes_written;
+
 	return 0;
 }
 
+/**
+ * @brief Get the progress to resume from if the write is interrupted, that is
+ *	  the start of the flash page being written.
+ *
+ *	  The page is erased again when resuming from its start, so that no
+ *	  part of the flash is programmed twice.
+ */
+static int progress_checkpoint_get(size_t *checkpoint)
+{
+	int err;
+	off_t absolute_offset;
+	struct flash_pages_info page;
+	size_t bytes_written = stream_flash_bytes_written(&stream);
+
+	if (bytes_written == 0) {
+		*checkpoint = 0;
+		return 0;
+	}
+
+	absolute_offset = stream.offset + bytes_written - 1;
+
+	err = flash_get_page_info_by_offs(stream.fdev, absolute_offset, &page);
+	if (err != 0) {
+		LOG_ERR("Error %d while getting page info", err);
+		return err;
+	}
+
+	if (absolute_offset == page.start_offset + page.size - 1) {
+		/* The page has been written completely. */
+		*checkpoint = bytes_written;
+	} else if (page.start_offset > stream.offset) {
+		*checkpoint = page.start_offset - stream.offset;
+	} else {
+		*checkpoint = 0;
+	}
+
+	return 0;
+}
+
+/**
+ * @brief Store the progress when a new checkpoint is reached, instead of on
+ *	  every write, to limit the wear of the settings storage.
+ */
+static int store_progress_checkpoint(void)
+{
+	int err;
+	size_t checkpoint;
+
+	err = progress_checkpoint_get(&checkpoint);
+	if (err != 0) {
+		return err;
+	}
+
+	if (checkpoint <= stored_progress ||
+	    checkpoint - stored_progress < CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS_INTERVAL) {
+		return 0;
+	}
+
+	return store_progress(checkpoint);
+}
+
 /**
  * @brief Function used by settings_load() to restore the stream_flash ctx.
  *	  See the Zephyr documentation of the settings subsystem for more
@@ -65,6 +128,10 @@ static int settings_set(const char *key, size_t len_rd,
 			return len;
 		}
 
+		/* Data buffered after the stored progress is written again. */
+		stream.buf_bytes = 0;
+		stored_progress = stream.bytes_written;
+
 		/* Zero bytes written - set last erased page to its default. */
 		if (stream.bytes_written == 0) {
 			stream.last_erased_page_start_offset = -1;
@@ -138,6 +205,8 @@ int dfu_target_stream_init(const struct dfu_target_stream_init *init)
 		return err;
 	}
 
+	stored_progress = 0;
+
 	err = settings_register(&sh);
 	if (err && err != -EEXIST) {
 		LOG_ERR("setting_register failed: (err %d)", err);
@@ -171,7 +240,7 @@ int dfu_target_stream_write(const uint8_t *buf, size_t len)
 	}
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
-	err = store_progress();
+	err = store_progress_checkpoint();
 	if (err != 0) {
 		/* Failing to store progress is not a critical error you'll just
 		 * be left to download a bit more if you fail and resume.
@@ -205,7 +274,7 @@ int dfu_target_stream_done(bool successful)
 		/* The stream has not completed, store the progress so that
 		 * a new call to 'init' will pick up where we left off.
 		 */
-		err = store_progress();
+		err = store_progress(stream_flash_bytes_written(&stream));
 		if (err != 0) {
 			LOG_ERR("Unable to reset write progress: %d", err);
 		}
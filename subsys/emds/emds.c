@@ -21,6 +21,86 @@ static sys_slist_t emds_dynamic_entries;
 static struct emds_fs emds_flash;
 static emds_store_cb_t app_store_cb;
 
+static bool emds_entry_unchanged(uint16_t id, const uint8_t *data, size_t len)
+{
+	/* In incremental mode, entries identical to their latest stored copy
+	 * are skipped when storing.
+	 */
+	return IS_ENABLED(CONFIG_EMDS_INCREMENTAL) && emds_ready &&
+	       emds_flash_entry_is_stored(&emds_flash, id, data, len);
+}
+
+#if defined(CONFIG_EMDS_FAST_STORE)
+static struct emds_flash_slot emds_slots[CONFIG_EMDS_FAST_STORE_ENTRY_COUNT];
+static size_t emds_slot_cnt;
+
+static int emds_slots_plan(void)
+{
+	size_t cnt = 0;
+
+	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		if (cnt == ARRAY_SIZE(emds_slots)) {
+			return -ENOMEM;
+		}
+
+		emds_slots[cnt].id = ch->id;
+		emds_slots[cnt].data = ch->data;
+		emds_slots[cnt].len = ch->len;
+		cnt++;
+	}
+
+	struct emds_dynamic_entry *ch;
+
+	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		if (cnt == ARRAY_SIZE(emds_slots)) {
+			return -ENOMEM;
+		}
+
+		emds_slots[cnt].id = ch->entry.id;
+		emds_slots[cnt].data = ch->entry.data;
+		emds_slots[cnt].len = ch->entry.len;
+		cnt++;
+	}
+
+	emds_slot_cnt = cnt;
+
+	return emds_flash_slots_plan(&emds_flash, emds_slots, emds_slot_cnt);
+}
+
+static void emds_slots_write(void)
+{
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL)) {
+		size_t cnt = 0;
+
+		for (size_t i = 0; i < emds_slot_cnt; i++) {
+			if (!emds_entry_unchanged(emds_slots[i].id, emds_slots[i].data,
+						  emds_slots[i].len)) {
+				emds_slots[cnt++] = emds_slots[i];
+			}
+		}
+
+		/* Move the changed entries into the space planned for the skipped ones, to
+		 * keep the allocation table contiguous.
+		 */
+		if (cnt != emds_slot_cnt &&
+		    emds_flash_slots_plan(&emds_flash, emds_slots, cnt)) {
+			LOG_ERR("Unable to plan the changed entries");
+			return;
+		}
+
+		emds_slot_cnt = cnt;
+	}
+
+	for (size_t i = 0; i < emds_slot_cnt; i++) {
+		ssize_t len = emds_flash_slot_write(&emds_flash, &emds_slots[i]);
+
+		if (len < 0) {
+			LOG_ERR("Write entry: (%d) error (%d)", emds_slots[i].id, len);
+		}
+	}
+}
+#endif
+
 static int emds_fs_init(void)
 {
 	int rc;
@@ -67,7 +147,7 @@ static int emds_fs_init(void)
 }
 
 
-static int emds_entries_size(uint32_t *size)
+static int emds_entries_size(uint32_t *size, bool changed_only)
 {
 	size_t block_size = emds_flash.flash_params->write_block_size;
 	int entries = 0;
@@ -75,6 +155,10 @@ static int emds_entries_size(uint32_t *size)
 	*size = 0;
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		if (changed_only && emds_entry_unchanged(ch->id, ch->data, ch->len)) {
+			continue;
+		}
+
 		*size += NRFX_CEIL_DIV(ch->len, block_size) * block_size;
 		*size += NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
 		entries++;
@@ -83,6 +167,11 @@ static int emds_entries_size(uint32_t *size)
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		if (changed_only &&
+		    emds_entry_unchanged(ch->entry.id, ch->entry.data, ch->entry.len)) {
+			continue;
+		}
+
 		*size += NRFX_CEIL_DIV(ch->entry.len, block_size) * block_size;
 		*size += NRFX_CEIL_DIV(emds_flash.ate_size, block_size) * block_size;
 		entries++;
@@ -151,7 +240,14 @@ int emds_store(void)
 	/* Start the emergency data storage process. */
 	LOG_DBG("Emergency Data Storeage released");
 
+#if defined(CONFIG_EMDS_FAST_STORE)
+	emds_slots_write();
+#else
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
+		if (emds_entry_unchanged(ch->id, ch->data, ch->len)) {
+			continue;
+		}
+
 		ssize_t len = emds_flash_write(&emds_flash,
 					       ch->id, ch->data, ch->len);
 		if (len < 0) {
@@ -166,6 +262,10 @@ int emds_store(void)
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
+		if (emds_entry_unchanged(ch->entry.id, ch->entry.data, ch->entry.len)) {
+			continue;
+		}
+
 		ssize_t len = emds_flash_write(&emds_flash,
 					       ch->entry.id, ch->entry.data, ch->entry.len);
 		if (len < 0) {
@@ -177,6 +277,7 @@ int emds_store(void)
 				ch->entry.id, ch->entry.len, len);
 		}
 	}
+#endif
 
 	emds_ready = false;
 
@@ -250,40 +351,69 @@ int emds_prepare(void)
 		return -ECANCELED;
 	}
 
-	(void)emds_entries_size(&size);
+	/* Reserve space for all entries, as any of them may change before the store. */
+	(void)emds_entries_size(&size, false);
 
 	rc = emds_flash_prepare(&emds_flash, size);
 	if (rc) {
 		return rc;
 	}
 
+#if defined(CONFIG_EMDS_FAST_STORE)
+	rc = emds_slots_plan();
+	if (rc) {
+		LOG_ERR("Unable to plan the store layout (%d)", rc);
+		return rc;
+	}
+#endif
+
 	emds_ready = true;
 
 	return 0;
 }
 
-uint32_t emds_store_time_get(void)
+static uint32_t emds_entry_store_time_get(uint16_t id, const uint8_t *data, size_t len)
 {
 	size_t block_size = emds_flash.flash_params->write_block_size;
-	uint32_t store_time_us = CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
+	uint32_t store_time_us = 0;
+
+#if defined(CONFIG_EMDS_INCREMENTAL)
+	/* Every entry is compared with its latest stored copy when storing,
+	 * whether it has changed or not.
+	 */
+	store_time_us += CONFIG_EMDS_FLASH_TIME_ENTRY_COMPARE_OVERHEAD_US
+		       + NRFX_CEIL_DIV(len, block_size) *
+				CONFIG_EMDS_FLASH_TIME_COMPARE_ONE_WORD_US;
+#if defined(CONFIG_EMDS_FAST_STORE)
+	/* The changed entries may have to be planned again. */
+	store_time_us += CONFIG_EMDS_FLASH_TIME_ENTRY_PLAN_US;
+#endif
+#endif
+
+	if (emds_entry_unchanged(id, data, len)) {
+		return store_time_us;
+	}
+
+	return store_time_us
+	       + NRFX_CEIL_DIV(len, block_size) * CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
+	       + NRFX_CEIL_DIV(emds_flash.ate_size, block_size) *
+			CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
+	       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+}
 
+uint32_t emds_store_time_get(void)
+{
+	uint32_t store_time_us = CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
 
 	STRUCT_SECTION_FOREACH(emds_entry, ch) {
-		store_time_us += NRFX_CEIL_DIV(ch->len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + NRFX_CEIL_DIV(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+		store_time_us += emds_entry_store_time_get(ch->id, ch->data, ch->len);
 	}
 
 	struct emds_dynamic_entry *ch;
 
 	SYS_SLIST_FOR_EACH_CONTAINER(&emds_dynamic_entries, ch, node) {
-		store_time_us += NRFX_CEIL_DIV(ch->entry.len, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + NRFX_CEIL_DIV(emds_flash.ate_size, block_size) *
-					CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US
-			       + CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US;
+		store_time_us += emds_entry_store_time_get(ch->entry.id, ch->entry.data,
+							   ch->entry.len);
 	}
 
 	return store_time_us;
@@ -293,7 +423,7 @@ uint32_t emds_store_size_get(void)
 {
 	uint32_t store_size;
 
-	(void)emds_entries_size(&store_size);
+	(void)emds_entries_size(&store_size, true);
 
 	return store_size;
 }
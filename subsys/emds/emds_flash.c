@@ -184,23 +184,14 @@ static int ate_wrt(struct emds_fs *fs, const struct emds_ate *entry)
 	return 0;
 }
 
-static int data_wrt(struct emds_fs *fs, const void *data, size_t len)
+static int data_wrt_at(struct emds_fs *fs, off_t offset, const void *data, size_t len)
 {
 	const uint8_t *data8 = (const uint8_t *)data;
 	int rc;
-	off_t offset;
 	size_t blen;
 	size_t temp_len = len;
 	uint8_t buf[EMDS_FLASH_BLOCK_SIZE];
 
-	if (!temp_len) {
-		/* Nothing to write, avoid changing the flash protection */
-		return 0;
-	}
-
-	offset = fs->offset;
-	offset += fs->data_wra_offset & ADDR_OFFS_MASK;
-
 	blen = temp_len & ~(fs->flash_params->write_block_size - 1U);
 	/* Writes multiples of 4 bytes to flash */
 	if (blen > 0) {
@@ -225,10 +216,85 @@ static int data_wrt(struct emds_fs *fs, const void *data, size_t len)
 		}
 	}
 
+	return 0;
+}
+
+static int data_wrt(struct emds_fs *fs, const void *data, size_t len)
+{
+	int rc;
+	off_t offset;
+
+	if (!len) {
+		/* Nothing to write, avoid changing the flash protection */
+		return 0;
+	}
+
+	offset = fs->offset;
+	offset += fs->data_wra_offset & ADDR_OFFS_MASK;
+
+	rc = data_wrt_at(fs, offset, data, len);
+	if (rc) {
+		return rc;
+	}
+
 	fs->data_wra_offset += align_size(fs, len);
 	return 0;
 }
 
+#if defined(CONFIG_EMDS_FAST_STORE)
+static void index_reset(struct emds_fs *fs)
+{
+	fs->index_cnt = 0;
+	fs->index_overflow = false;
+}
+
+static void index_update(struct emds_fs *fs, const struct emds_ate *entry)
+{
+	struct emds_flash_index_entry *idx = NULL;
+
+	for (int i = 0; i < fs->index_cnt; i++) {
+		if (fs->index[i].id == entry->id) {
+			idx = &fs->index[i];
+			break;
+		}
+	}
+
+	if (!idx) {
+		if (fs->index_cnt == ARRAY_SIZE(fs->index)) {
+			LOG_WRN("Index full, falling back to flash lookups");
+			fs->index_overflow = true;
+			return;
+		}
+
+		idx = &fs->index[fs->index_cnt++];
+	}
+
+	idx->id = entry->id;
+	idx->offset = entry->offset;
+	idx->len = entry->len;
+	idx->crc8_data = entry->crc8_data;
+}
+
+static const struct emds_flash_index_entry *index_find(struct emds_fs *fs, uint16_t id)
+{
+	for (int i = 0; i < fs->index_cnt; i++) {
+		if (fs->index[i].id == id) {
+			return &fs->index[i];
+		}
+	}
+
+	return NULL;
+}
+#else
+static inline void index_reset(struct emds_fs *fs)
+{
+}
+
+static inline void index_update(struct emds_fs *fs, const struct emds_ate *entry)
+{
+}
+#endif
+
 static int check_erased(struct emds_fs *fs, uint32_t addr, size_t len)
 {
 	size_t bytes_to_cmp;
@@ -277,6 +343,8 @@ static int entry_wrt(struct emds_fs *fs, uint16_t id, const void *data, size_t l
 		return rc;
 	}
 
+	index_update(fs, &entry);
+
 	return 0;
 }
 
@@ -314,6 +382,7 @@ static int ate_last_recover(struct emds_fs *fs)
 
 	fs->ate_wra = fs->offset + fs->sector_cnt * fs->sector_size - fs->ate_size;
 	fs->data_wra_offset = 0;
+	index_reset(fs);
 	while (type != ATE_TYPE_ERASED) {
 		/* Ate wra has reached the start of the data area */
 		if (fs->ate_wra < fs->offset) {
@@ -332,6 +401,7 @@ static int ate_last_recover(struct emds_fs *fs)
 
 		switch (type) {
 		case ATE_TYPE_VALID:
+			index_update(fs, &end_ate);
 			fs->data_wra_offset = align_size(fs, end_ate.offset + end_ate.len);
 			fs->ate_wra -= fs->ate_size;
 			expect_field = ATE_TYPE_VALID | ATE_TYPE_ERASED;
@@ -379,9 +449,49 @@ static int old_entries_invalidate(struct emds_fs *fs)
 		addr += fs->ate_size;
 	}
 
+	index_reset(fs);
+
 	return 0;
 }
 
+static int ate_find(struct emds_fs *fs, uint16_t id, struct emds_ate *entry)
+{
+	int rc;
+	uint32_t wlk_addr = fs->ate_wra;
+
+#if defined(CONFIG_EMDS_FAST_STORE)
+	if (!fs->index_overflow) {
+		const struct emds_flash_index_entry *idx = index_find(fs, id);
+
+		if (!idx) {
+			return -ENXIO;
+		}
+
+		entry->id = idx->id;
+		entry->offset = idx->offset;
+		entry->len = idx->len;
+		entry->crc8_data = idx->crc8_data;
+		return 0;
+	}
+#endif
+
+	while (true) {
+		rc = flash_read(fs->flash_dev, wlk_addr, entry, sizeof(struct emds_ate));
+		if (rc) {
+			return rc;
+		}
+
+		if ((entry->id == id) && (is_ate_valid(entry))) {
+			return 0;
+		}
+
+		wlk_addr += fs->ate_size;
+		if (wlk_addr >= fs->offset + fs->sector_cnt * fs->sector_size) {
+			return -ENXIO;
+		}
+	}
+}
+
 int emds_flash_init(struct emds_fs *fs)
 {
 	if (fs->is_initialized) {
@@ -485,23 +595,11 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
 	}
 
 	int rc;
-	uint32_t wlk_addr = fs->ate_wra;
 	struct emds_ate wlk_ate;
 
-	while (true) {
-		rc = flash_read(fs->flash_dev, wlk_addr, &wlk_ate, sizeof(struct emds_ate));
-		if (rc) {
-			return rc;
-		}
-
-		if ((wlk_ate.id == id) && (is_ate_valid(&wlk_ate))) {
-			break;
-		}
-
-		wlk_addr += fs->ate_size;
-		if (wlk_addr >= fs->offset + fs->sector_cnt * fs->sector_size) {
-			return -ENXIO;
-		}
+	rc = ate_find(fs, id, &wlk_ate);
+	if (rc) {
+		return rc;
 	}
 
 	if (len < wlk_ate.len) {
@@ -531,10 +629,15 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 		return -ENOMEM;
 	}
 
-	int rc = old_entries_invalidate(fs);
+	/* In incremental mode, the previously stored entries remain valid, and only entries that
+	 * change are appended on top of them.
+	 */
+	if (!IS_ENABLED(CONFIG_EMDS_INCREMENTAL)) {
+		int rc = old_entries_invalidate(fs);
 
-	if (rc) {
-		return rc;
+		if (rc) {
+			return rc;
+		}
 	}
 
 	if (fs->force_erase || (byte_size > emds_flash_free_space_get(fs))) {
@@ -546,6 +649,108 @@ int emds_flash_prepare(struct emds_fs *fs, int byte_size)
 	return 0;
 }
 
+bool emds_flash_entry_is_stored(struct emds_fs *fs, uint16_t id, const void *data, size_t len)
+{
+	const uint8_t *data8 = (const uint8_t *)data;
+	uint8_t buf[4 * EMDS_FLASH_BLOCK_SIZE];
+	struct emds_ate entry;
+	off_t addr;
+
+	if (!fs->is_initialized || ate_find(fs, id, &entry) || entry.len != len) {
+		return false;
+	}
+
+	addr = fs->offset + entry.offset;
+
+	while (len) {
+		size_t bytes_to_cmp = MIN(sizeof(buf), len);
+
+		if (flash_read(fs->flash_dev, addr, buf, bytes_to_cmp) ||
+		    memcmp(data8, buf, bytes_to_cmp)) {
+			return false;
+		}
+
+		len -= bytes_to_cmp;
+		addr += bytes_to_cmp;
+		data8 += bytes_to_cmp;
+	}
+
+	return true;
+}
+
+int emds_flash_slots_plan(struct emds_fs *fs, struct emds_flash_slot *slots, size_t count)
+{
+	uint32_t ate_wra = fs->ate_wra;
+	uint32_t data_wra_offset = fs->data_wra_offset;
+
+	if (!fs->is_initialized || !fs->is_prepeared) {
+		LOG_ERR("EMDS flash not initialized or not ready for write");
+		return -EACCES;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		struct emds_flash_slot *slot = &slots[i];
+		struct emds_ate entry;
+
+		if (slot->len == 0) {
+			/* Empty entries are not written, see emds_flash_write. */
+			continue;
+		}
+
+		if (ate_wra < fs->offset + data_wra_offset + fs->ate_size +
+				      align_size(fs, slot->len)) {
+			return -ENOMEM;
+		}
+
+		slot->data_addr = fs->offset + data_wra_offset;
+		slot->ate_addr = ate_wra;
+		slot->offset = data_wra_offset;
+
+		entry.id = slot->id;
+		entry.offset = slot->offset;
+		entry.len = slot->len;
+		slot->ate_crc = crc8_ccitt(0xff, &entry, offsetof(struct emds_ate, crc8_data));
+
+		data_wra_offset += align_size(fs, slot->len);
+		ate_wra -= fs->ate_size;
+	}
+
+	return 0;
+}
+
+ssize_t emds_flash_slot_write(struct emds_fs *fs, const struct emds_flash_slot *slot)
+{
+	struct emds_ate entry;
+	int rc;
+
+	if (slot->len == 0) {
+		return 0;
+	}
+
+	entry.id = slot->id;
+	entry.offset = slot->offset;
+	entry.len = slot->len;
+	entry.crc8_data = crc8_ccitt(0xff, slot->data, slot->len);
+	/* Continue the precomputed crc with the only field that depends on the data. */
+	entry.crc8 = crc8_ccitt(slot->ate_crc, &entry.crc8_data, sizeof(entry.crc8_data));
+
+	rc = data_wrt_at(fs, slot->data_addr, slot->data, slot->len);
+	if (rc) {
+		return rc;
+	}
+
+	rc = flash_direct_write(fs->flash_dev, slot->ate_addr, &entry, sizeof(struct emds_ate));
+	if (rc) {
+		return rc;
+	}
+
+	fs->data_wra_offset = slot->offset + align_size(fs, slot->len);
+	fs->ate_wra = slot->ate_addr - fs->ate_size;
+	index_update(fs, &entry);
+
+	return slot->len;
+}
+
 ssize_t emds_flash_free_space_get(struct emds_fs *fs)
 {
 	ssize_t space = fs->ate_wra - (fs->data_wra_offset + fs->offset);
@@ -15,6 +15,45 @@
 extern "C" {
 #endif
 
+/**
+ * @brief Location of an entry in the emergency data storage file system.
+ *
+ * @param id Id of the entry
+ * @param offset Data offset from the start of the file system
+ * @param len Data length
+ * @param crc8_data crc8 check of the data
+ */
+struct emds_flash_index_entry {
+	uint16_t id;
+	uint16_t offset;
+	uint16_t len;
+	uint8_t crc8_data;
+};
+
+/**
+ * @brief Precomputed write of an entry to the emergency data storage file system.
+ *
+ * Slots are planned by @ref emds_flash_slots_plan when the file system is prepared, and written
+ * by @ref emds_flash_slot_write in the order they were planned.
+ *
+ * @param data Pointer to the data to be written
+ * @param data_addr Flash address of the data
+ * @param ate_addr Flash address of the allocation table entry
+ * @param id Id of the entry
+ * @param offset Data offset from the start of the file system
+ * @param len Number of bytes to be written
+ * @param ate_crc crc8 of the allocation table entry fields that are known in advance
+ */
+struct emds_flash_slot {
+	const void *data;
+	uint32_t data_addr;
+	uint32_t ate_addr;
+	uint16_t id;
+	uint16_t offset;
+	uint16_t len;
+	uint8_t ate_crc;
+};
+
 /**
  * @brief Emergency data storage file system structure
  *
@@ -31,6 +70,10 @@ extern "C" {
  * @param flash_dev Pointer to flash device runtime structure
  * @param flash_params Pointer to flash memory parameters structure
  * @param force_erase Force erase flag
+ * @param index RAM index of the valid entries, used with CONFIG_EMDS_FAST_STORE
+ * @param index_cnt Number of entries in the RAM index
+ * @param index_overflow The RAM index could not hold all entries, and reads fall back to walking
+ * the allocation table in flash
  */
 struct emds_fs {
 	off_t offset;
@@ -45,6 +88,11 @@ struct emds_fs {
 	const struct device *flash_dev;
 	const struct flash_parameters *flash_params;
 	bool force_erase;
+#if defined(CONFIG_EMDS_FAST_STORE)
+	struct emds_flash_index_entry index[CONFIG_EMDS_FAST_STORE_ENTRY_COUNT];
+	uint16_t index_cnt;
+	bool index_overflow;
+#endif
 };
 
 /**
@@ -104,7 +152,8 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
  *
  * This function should be called at the moment when the user has restored the desired data
  * entries from flash. It will invalidate all prior entries, and potentially clear the flash
- * area.
+ * area. With CONFIG_EMDS_INCREMENTAL, prior entries are kept valid, and the flash area is only
+ * cleared if there is not enough space left to store all entries again.
  *
  * @note Calling this function will make any subsequent read attempts fail. Be sure to
  * restore all necessary entries before using this function.
@@ -118,6 +167,49 @@ ssize_t emds_flash_read(struct emds_fs *fs, uint16_t id, void *data, size_t len)
  */
 int emds_flash_prepare(struct emds_fs *fs, int byte_size);
 
+/**
+ * @brief Check whether the latest stored copy of an entry is identical to the given data.
+ *
+ * @param fs Pointer to file system
+ * @param id Id of the entry
+ * @param data Pointer to the data to compare
+ * @param len Number of bytes to compare
+ *
+ * @retval true if the latest valid entry with the given id holds exactly the given data
+ */
+bool emds_flash_entry_is_stored(struct emds_fs *fs, uint16_t id, const void *data, size_t len);
+
+/**
+ * @brief Plan the location of entries to be written to the EMDS file system.
+ *
+ * Assigns flash addresses to the given slots, starting at the current write position of the file
+ * system, and precomputes as much of each allocation table entry as possible. The @c id,
+ * @c data and @c len fields of each slot must be set by the caller. The file system is not
+ * modified, so the slots may be planned again if the entries change.
+ *
+ * @param fs Pointer to file system
+ * @param slots Slots to plan
+ * @param count Number of slots
+ *
+ * @retval 0 on success or negative error code
+ */
+int emds_flash_slots_plan(struct emds_fs *fs, struct emds_flash_slot *slots, size_t count);
+
+/**
+ * @brief Write a planned entry to the EMDS file system.
+ *
+ * Writes the data and allocation table entry of a slot planned by @ref emds_flash_slots_plan,
+ * without any further space checks. Slots must be written in the order they were planned, and
+ * the file system must not be written to in any other way in between.
+ *
+ * @param fs Pointer to file system
+ * @param slot Slot to write
+ *
+ * @return Number of bytes written. On error, returns negative value of errno.h defined error
+ * codes.
+ */
+ssize_t emds_flash_slot_write(struct emds_fs *fs, const struct emds_flash_slot *slot);
+
 /**
  * @brief Get remaining raw space on the flash device.
  *
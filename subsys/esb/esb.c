@@ -26,6 +26,7 @@
 
 #include <mpsl_fem_protocol_api.h>
 
+#include "esb_fifo.h"
 #include "esb_peripherals.h"
 #include "esb_ppi_api.h"
 
@@ -118,32 +119,12 @@ struct pipe_info {
 struct payload_wrap {
 	/* Pointer to the ACK payload. */
 	struct esb_payload  *p_payload;
-	/* Value used to determine if the current payload pointer is used. */
-	bool in_use;
-	/* Pointer to the next ACK payload queued on the same pipe. */
+	/* Pointer to the next ACK payload queued on the same pipe or to the
+	 * next free ACK payload.
+	 */
 	struct payload_wrap *p_next;
 };
 
-/* First-in, first-out queue of payloads to be transmitted. */
-struct payload_tx_fifo {
-	 /* Payload queue */
-	struct esb_payload *payload[CONFIG_ESB_TX_FIFO_SIZE];
-
-	uint32_t back;	/* Back of the queue (last in). */
-	uint32_t front;	/* Front of queue (first out). */
-	uint32_t count;	/* Number of elements in the queue. */
-};
-
-/* First-in, first-out queue of received payloads. */
-struct payload_rx_fifo {
-	 /* Payload queue */
-	struct esb_payload *payload[CONFIG_ESB_RX_FIFO_SIZE];
-
-	uint32_t back;	/* Back of the queue (last in). */
-	uint32_t front;	/* Front of queue (first out). */
-	uint32_t count;	/* Number of elements in the queue. */
-};
-
 /* Fixed radio PDU header definition. */
 struct esb_radio_fixed_pdu {
 	/* Packet ID of the last received packet. Used to detect retransmits. */
@@ -229,17 +210,27 @@ static esb_event_handler event_handler;
 static struct esb_payload *current_payload;
 
 /* FIFOs and buffers */
-static struct payload_tx_fifo tx_fifo;
-static struct payload_rx_fifo rx_fifo;
+static struct esb_payload tx_payload[CONFIG_ESB_TX_FIFO_SIZE];
+static struct esb_payload rx_payload[CONFIG_ESB_RX_FIFO_SIZE];
+static struct esb_fifo tx_fifo;
+static struct esb_fifo rx_fifo;
+
+/* Payload claimed by the application with esb_write_payload_claim. */
+static struct esb_payload *tx_claimed;
+static atomic_t tx_claim_busy;
 
 static uint8_t tx_payload_buffer[CONFIG_ESB_MAX_PAYLOAD_LENGTH +
 				 sizeof(struct esb_radio_pdu)];
 static uint8_t rx_payload_buffer[CONFIG_ESB_MAX_PAYLOAD_LENGTH +
 				 sizeof(struct esb_radio_pdu)];
 
-/* Random access buffer variables for ACK payload handling */
-struct payload_wrap ack_pl_wrap[CONFIG_ESB_TX_FIFO_SIZE];
-struct payload_wrap *ack_pl_wrap_pipe[CONFIG_ESB_PIPE_COUNT];
+/* ACK payload handling. Each pipe has its own queue with head and tail
+ * pointers, and unused ACK payloads are kept on a free list.
+ */
+static struct payload_wrap ack_pl_wrap[CONFIG_ESB_TX_FIFO_SIZE];
+static struct payload_wrap *ack_pl_wrap_pipe[CONFIG_ESB_PIPE_COUNT];
+static struct payload_wrap *ack_pl_wrap_pipe_tail[CONFIG_ESB_PIPE_COUNT];
+static struct payload_wrap *ack_pl_wrap_free;
 
 /* Run time variables */
 static uint8_t pids[CONFIG_ESB_PIPE_COUNT];
@@ -688,57 +679,56 @@ static bool update_radio_parameters(void)
 	return params_valid;
 }
 
-static void reset_fifos(void)
+static void ack_pl_wrap_reset(void)
 {
-	tx_fifo.back = 0;
-	tx_fifo.front = 0;
-	tx_fifo.count = 0;
-
-	rx_fifo.back = 0;
-	rx_fifo.front = 0;
-	rx_fifo.count = 0;
-}
-
-static void initialize_fifos(void)
-{
-	static struct esb_payload rx_payload[CONFIG_ESB_RX_FIFO_SIZE];
-	static struct esb_payload tx_payload[CONFIG_ESB_TX_FIFO_SIZE];
-
-	reset_fifos();
-
-	for (size_t i = 0; i < CONFIG_ESB_TX_FIFO_SIZE; i++) {
-		tx_fifo.payload[i] = &tx_payload[i];
-	}
-
-	for (size_t i = 0; i < CONFIG_ESB_RX_FIFO_SIZE; i++) {
-		rx_fifo.payload[i] = &rx_payload[i];
-	}
+	ack_pl_wrap_free = NULL;
 
 	for (size_t i = 0; i < CONFIG_ESB_TX_FIFO_SIZE; i++) {
 		ack_pl_wrap[i].p_payload = &tx_payload[i];
-		ack_pl_wrap[i].in_use = false;
-		ack_pl_wrap[i].p_next = 0;
+		ack_pl_wrap[i].p_next = ack_pl_wrap_free;
+		ack_pl_wrap_free = &ack_pl_wrap[i];
 	}
 
 	for (size_t i = 0; i < CONFIG_ESB_PIPE_COUNT; i++) {
-		ack_pl_wrap_pipe[i] = 0;
+		ack_pl_wrap_pipe[i] = NULL;
+		ack_pl_wrap_pipe_tail[i] = NULL;
 	}
 }
 
+static void reset_fifos(void)
+{
+	esb_fifo_init(&tx_fifo, CONFIG_ESB_TX_FIFO_SIZE);
+	esb_fifo_init(&rx_fifo, CONFIG_ESB_RX_FIFO_SIZE);
+
+	ack_pl_wrap_reset();
+
+	tx_claimed = NULL;
+	atomic_clear(&tx_claim_busy);
+}
+
 static void tx_fifo_remove_last(void)
 {
-	if (tx_fifo.count == 0) {
+	if (esb_fifo_is_empty(&tx_fifo)) {
 		return;
 	}
 
-	unsigned int key = irq_lock();
+	esb_fifo_release(&tx_fifo, 1);
+}
 
-	tx_fifo.count--;
-	if (++tx_fifo.front >= CONFIG_ESB_TX_FIFO_SIZE) {
-		tx_fifo.front = 0;
+/* Remove the first ACK payload queued on a pipe and return it to the free
+ * list. Must be called from the radio interrupt or with interrupts locked.
+ */
+static void ack_pl_wrap_pipe_pop(uint32_t pipe)
+{
+	struct payload_wrap *pl = ack_pl_wrap_pipe[pipe];
+
+	ack_pl_wrap_pipe[pipe] = pl->p_next;
+	if (ack_pl_wrap_pipe[pipe] == NULL) {
+		ack_pl_wrap_pipe_tail[pipe] = NULL;
 	}
 
-	irq_unlock(key);
+	pl->p_next = ack_pl_wrap_free;
+	ack_pl_wrap_free = pl;
 }
 
 /*  Function to push the content of the rx_buffer to the RX FIFO.
@@ -756,36 +746,36 @@ static void tx_fifo_remove_last(void)
 static bool rx_fifo_push_rfbuf(uint8_t pipe, uint8_t pid)
 {
 	struct esb_radio_pdu *rx_pdu = (struct esb_radio_pdu *)rx_payload_buffer;
+	struct esb_payload *payload;
+	int slot = esb_fifo_claim(&rx_fifo);
 
-	if (rx_fifo.count >= CONFIG_ESB_RX_FIFO_SIZE) {
+	if (slot < 0) {
 		return false;
 	}
 
+	payload = &rx_payload[slot];
+
 	if (esb_cfg.protocol == ESB_PROTOCOL_ESB_DPL) {
 		if (rx_pdu->type.dpl_pdu.length > CONFIG_ESB_MAX_PAYLOAD_LENGTH) {
 			return false;
 		}
 
-		rx_fifo.payload[rx_fifo.back]->length = rx_pdu->type.dpl_pdu.length;
+		payload->length = rx_pdu->type.dpl_pdu.length;
 	} else if (esb_cfg.mode == ESB_MODE_PTX) {
 		/* Received packet is an acknowledgment */
-		rx_fifo.payload[rx_fifo.back]->length = 0;
+		payload->length = 0;
 	} else {
-		rx_fifo.payload[rx_fifo.back]->length = esb_cfg.payload_length;
+		payload->length = esb_cfg.payload_length;
 	}
 
-	memcpy(rx_fifo.payload[rx_fifo.back]->data, rx_pdu->data,
-	       rx_fifo.payload[rx_fifo.back]->length);
+	memcpy(payload->data, rx_pdu->data, payload->length);
 
-	rx_fifo.payload[rx_fifo.back]->pipe = pipe;
-	rx_fifo.payload[rx_fifo.back]->rssi = nrf_radio_rssi_sample_get(NRF_RADIO);
-	rx_fifo.payload[rx_fifo.back]->pid = pid;
-	rx_fifo.payload[rx_fifo.back]->noack = !rx_pdu->type.dpl_pdu.no_ack;
+	payload->pipe = pipe;
+	payload->rssi = nrf_radio_rssi_sample_get(NRF_RADIO);
+	payload->pid = pid;
+	payload->noack = !rx_pdu->type.dpl_pdu.no_ack;
 
-	if (++rx_fifo.back >= CONFIG_ESB_RX_FIFO_SIZE) {
-		rx_fifo.back = 0;
-	}
-	rx_fifo.count++;
+	esb_fifo_commit(&rx_fifo, 1);
 
 	return true;
 }
@@ -830,7 +820,7 @@ static void start_tx_transaction(void)
 	struct esb_radio_pdu *pdu = (struct esb_radio_pdu *)tx_payload_buffer;
 	last_tx_attempts = 1;
 	/* Prepare the payload */
-	current_payload = tx_fifo.payload[tx_fifo.front];
+	current_payload = &tx_payload[esb_fifo_peek(&tx_fifo, 0)];
 
 	switch (esb_cfg.protocol) {
 	case ESB_PROTOCOL_ESB:
@@ -944,7 +934,7 @@ static void on_radio_end_tx_noack(void)
 	interrupt_flags |= INT_TX_SUCCESS_MSK;
 	tx_fifo_remove_last();
 
-	if (tx_fifo.count == 0) {
+	if (esb_fifo_is_empty(&tx_fifo)) {
 		esb_state = ESB_STATE_PTX_TXIDLE;
 		NVIC_SetPendingIRQ(ESB_EVT_IRQ);
 	} else {
@@ -961,7 +951,7 @@ static void on_radio_disabled_tx_noack(void)
 	interrupt_flags |= INT_TX_SUCCESS_MSK;
 	tx_fifo_remove_last();
 
-	if (tx_fifo.count == 0) {
+	if (esb_fifo_is_empty(&tx_fifo)) {
 		esb_state = ESB_STATE_IDLE;
 		NVIC_SetPendingIRQ(ESB_EVT_IRQ);
 	} else {
@@ -1043,7 +1033,7 @@ static void on_radio_disabled_tx_wait_for_ack(void)
 			}
 		}
 
-		if ((tx_fifo.count == 0) || (esb_cfg.tx_mode == ESB_TXMODE_MANUAL)) {
+		if (esb_fifo_is_empty(&tx_fifo) || (esb_cfg.tx_mode == ESB_TXMODE_MANUAL)) {
 			esb_state = ESB_STATE_IDLE;
 			NVIC_SetPendingIRQ(ESB_EVT_IRQ);
 		} else {
@@ -1149,16 +1139,14 @@ static void on_radio_disabled_rx_dpl(bool retransmit_payload,
 
 	uint32_t pipe = nrf_radio_rxmatch_get(NRF_RADIO);
 
-	if (tx_fifo.count > 0 && ack_pl_wrap_pipe[pipe] != 0) {
+	if (ack_pl_wrap_pipe[pipe] != NULL) {
 		current_payload = ack_pl_wrap_pipe[pipe]->p_payload;
 
 		/* Pipe stays in ACK with payload until TX FIFO is empty */
 		/* Do not report TX success on first ack payload or retransmit */
 		if (pipe_info->ack_payload == true && !retransmit_payload) {
-			ack_pl_wrap_pipe[pipe]->in_use = false;
-			ack_pl_wrap_pipe[pipe] = ack_pl_wrap_pipe[pipe]->p_next;
-			tx_fifo.count--;
-			if (tx_fifo.count > 0 && ack_pl_wrap_pipe[pipe] != 0) {
+			ack_pl_wrap_pipe_pop(pipe);
+			if (ack_pl_wrap_pipe[pipe] != NULL) {
 				current_payload = ack_pl_wrap_pipe[pipe]->p_payload;
 			} else {
 				current_payload = 0;
@@ -1203,7 +1191,7 @@ static void on_radio_disabled_rx(void)
 		return;
 	}
 
-	if (rx_fifo.count >= CONFIG_ESB_RX_FIFO_SIZE) {
+	if (esb_fifo_is_full(&rx_fifo)) {
 		clear_events_restart_rx();
 		return;
 	}
@@ -1420,7 +1408,7 @@ int esb_init(const struct esb_config *config)
 	nrf_radio_prefix0_set(NRF_RADIO, 0x23C343E7);
 	nrf_radio_prefix1_set(NRF_RADIO, 0x13E363A3);
 
-	initialize_fifos();
+	reset_fifos();
 
 	err = sys_timer_init();
 	if (err) {
@@ -1526,18 +1514,38 @@ bool esb_is_idle(void)
 	return (esb_state == ESB_STATE_IDLE);
 }
 
-static struct payload_wrap *find_free_payload_cont(void)
+static int payload_check(const struct esb_payload *payload)
 {
-	for (int i = 0; i < CONFIG_ESB_TX_FIFO_SIZE; i++) {
-		if (!ack_pl_wrap[i].in_use) {
-			return &ack_pl_wrap[i];
-		}
+	if ((payload->length == 0) || (payload->length > CONFIG_ESB_MAX_PAYLOAD_LENGTH) ||
+	    ((esb_cfg.protocol == ESB_PROTOCOL_ESB) &&
+	     (payload->length > esb_cfg.payload_length))) {
+		return -EMSGSIZE;
+	}
+
+	if (payload->pipe >= CONFIG_ESB_PIPE_COUNT) {
+		return -EINVAL;
 	}
 
 	return 0;
 }
 
-int esb_write_payload(const struct esb_payload *payload)
+static void tx_claim_release(void)
+{
+	if (esb_cfg.mode != ESB_MODE_PTX) {
+		struct payload_wrap *pl = &ack_pl_wrap[tx_claimed - tx_payload];
+		unsigned int key = irq_lock();
+
+		pl->p_next = ack_pl_wrap_free;
+		ack_pl_wrap_free = pl;
+
+		irq_unlock(key);
+	}
+
+	tx_claimed = NULL;
+	atomic_clear(&tx_claim_busy);
+}
+
+int esb_write_payload_claim(struct esb_payload **payload)
 {
 	if (!esb_initialized) {
 		return -EACCES;
@@ -1547,112 +1555,221 @@ int esb_write_payload(const struct esb_payload *payload)
 		return -EINVAL;
 	}
 
-	if ((payload->length == 0) || (payload->length > CONFIG_ESB_MAX_PAYLOAD_LENGTH) ||
-	    ((esb_cfg.protocol == ESB_PROTOCOL_ESB) &&
-	     (payload->length > esb_cfg.payload_length))) {
-		return -EMSGSIZE;
+	if (!atomic_cas(&tx_claim_busy, 0, 1)) {
+		return -EBUSY;
 	}
 
-	if (tx_fifo.count >= CONFIG_ESB_TX_FIFO_SIZE) {
-		return -ENOMEM;
-	}
+	if (esb_cfg.mode == ESB_MODE_PTX) {
+		int slot = esb_fifo_claim(&tx_fifo);
 
-	if (payload->pipe >= CONFIG_ESB_PIPE_COUNT) {
-		return -EINVAL;
+		if (slot >= 0) {
+			tx_claimed = &tx_payload[slot];
+		}
+	} else {
+		/* The free list is also updated by the radio interrupt. */
+		unsigned int key = irq_lock();
+		struct payload_wrap *pl = ack_pl_wrap_free;
+
+		if (pl != NULL) {
+			ack_pl_wrap_free = pl->p_next;
+			pl->p_next = NULL;
+			tx_claimed = pl->p_payload;
+		}
+
+		irq_unlock(key);
 	}
 
-	unsigned int key = irq_lock();
+	if (tx_claimed == NULL) {
+		atomic_clear(&tx_claim_busy);
+		return -ENOMEM;
+	}
 
-	if (esb_cfg.mode == ESB_MODE_PTX) {
-		memcpy(tx_fifo.payload[tx_fifo.back], payload, sizeof(struct esb_payload));
+	*payload = tx_claimed;
 
-		pids[payload->pipe] = (pids[payload->pipe] + 1) % (PID_MAX + 1);
-		tx_fifo.payload[tx_fifo.back]->pid = pids[payload->pipe];
+	return 0;
+}
 
-		if (++tx_fifo.back >= CONFIG_ESB_TX_FIFO_SIZE) {
-			tx_fifo.back = 0;
-		}
+static int tx_claim_commit(struct esb_payload *payload)
+{
+	int err;
 
-		tx_fifo.count++;
-	} else {
-		struct payload_wrap *new_ack_payload = find_free_payload_cont();
+	if ((payload == NULL) || (payload != tx_claimed)) {
+		return -EINVAL;
+	}
 
-		if (new_ack_payload != 0) {
-			new_ack_payload->in_use = true;
-			new_ack_payload->p_next = 0;
-			memcpy(new_ack_payload->p_payload, payload, sizeof(struct esb_payload));
+	err = payload_check(payload);
+	if (err) {
+		tx_claim_release();
+		return err;
+	}
 
-			pids[payload->pipe] = (pids[payload->pipe] + 1) % (PID_MAX + 1);
-			new_ack_payload->p_payload->pid = pids[payload->pipe];
+	pids[payload->pipe] = (pids[payload->pipe] + 1) % (PID_MAX + 1);
+	payload->pid = pids[payload->pipe];
 
-			if (ack_pl_wrap_pipe[payload->pipe] == 0) {
-				ack_pl_wrap_pipe[payload->pipe] = new_ack_payload;
-			} else {
-				struct payload_wrap *pl = ack_pl_wrap_pipe[payload->pipe];
+	if (esb_cfg.mode == ESB_MODE_PTX) {
+		esb_fifo_commit(&tx_fifo, 1);
+	} else {
+		struct payload_wrap *pl = &ack_pl_wrap[payload - tx_payload];
+		unsigned int key = irq_lock();
 
-				while (pl->p_next != 0) {
-					pl = (struct payload_wrap *)pl->p_next;
-				}
-				pl->p_next = (struct payload_wrap *)new_ack_payload;
-			}
-			tx_fifo.count++;
+		if (ack_pl_wrap_pipe_tail[payload->pipe] == NULL) {
+			ack_pl_wrap_pipe[payload->pipe] = pl;
+		} else {
+			ack_pl_wrap_pipe_tail[payload->pipe]->p_next = pl;
 		}
+		ack_pl_wrap_pipe_tail[payload->pipe] = pl;
+
+		irq_unlock(key);
 	}
 
-	irq_unlock(key);
+	tx_claimed = NULL;
+	atomic_clear(&tx_claim_busy);
 
+	return 0;
+}
+
+static void tx_auto_start(void)
+{
 	if (esb_cfg.mode == ESB_MODE_PTX &&
 	    esb_cfg.tx_mode == ESB_TXMODE_AUTO &&
+	    !esb_fifo_is_empty(&tx_fifo) &&
 	    (esb_state == ESB_STATE_IDLE ||
 	     (IS_ENABLED(CONFIG_ESB_NEVER_DISABLE_TX) ?
 	      esb_state == ESB_STATE_PTX_TXIDLE : 0))) {
 		start_tx_transaction();
 	}
+}
+
+int esb_write_payload_commit(struct esb_payload *payload)
+{
+	int err;
+
+	if (!esb_initialized) {
+		return -EACCES;
+	}
+
+	err = tx_claim_commit(payload);
+	if (err) {
+		return err;
+	}
+
+	tx_auto_start();
 
 	return 0;
 }
 
-int esb_read_rx_payload(struct esb_payload *payload)
+int esb_write_payload(const struct esb_payload *payload)
 {
+	struct esb_payload *tx;
+	int err;
+
 	if (!esb_initialized) {
 		return -EACCES;
 	}
+
 	if (payload == NULL) {
 		return -EINVAL;
 	}
 
-	if (rx_fifo.count == 0) {
-		return -ENODATA;
+	err = payload_check(payload);
+	if (err) {
+		return err;
 	}
 
+	/* Writers are serialized, so that the function can be called from
+	 * several threads and interrupts without failing on a claimed payload.
+	 */
 	unsigned int key = irq_lock();
 
-	payload->length = rx_fifo.payload[rx_fifo.front]->length;
-	payload->pipe = rx_fifo.payload[rx_fifo.front]->pipe;
-	payload->rssi = rx_fifo.payload[rx_fifo.front]->rssi;
-	payload->pid = rx_fifo.payload[rx_fifo.front]->pid;
-	payload->noack = rx_fifo.payload[rx_fifo.front]->noack;
-	memcpy(payload->data, rx_fifo.payload[rx_fifo.front]->data,
-	       payload->length);
+	err = esb_write_payload_claim(&tx);
+	if (!err) {
+		memcpy(tx, payload, offsetof(struct esb_payload, data) + payload->length);
+		err = tx_claim_commit(tx);
+	}
+
+	irq_unlock(key);
 
-	if (++rx_fifo.front >= CONFIG_ESB_RX_FIFO_SIZE) {
-		rx_fifo.front = 0;
+	if (err) {
+		return err;
 	}
 
-	rx_fifo.count--;
+	tx_auto_start();
 
-	irq_unlock(key);
+	return 0;
+}
+
+int esb_read_rx_payloads_claim(const struct esb_payload **payloads, size_t count)
+{
+	uint32_t cnt;
+
+	if (!esb_initialized) {
+		return -EACCES;
+	}
+
+	if ((payloads == NULL) || (count == 0)) {
+		return -EINVAL;
+	}
+
+	cnt = MIN(esb_fifo_count(&rx_fifo), count);
+	if (cnt == 0) {
+		return -ENODATA;
+	}
+
+	for (uint32_t i = 0; i < cnt; i++) {
+		payloads[i] = &rx_payload[esb_fifo_peek(&rx_fifo, i)];
+	}
+
+	return cnt;
+}
+
+int esb_read_rx_payloads_release(size_t count)
+{
+	if (!esb_initialized) {
+		return -EACCES;
+	}
+
+	if (count > esb_fifo_count(&rx_fifo)) {
+		return -EINVAL;
+	}
+
+	esb_fifo_release(&rx_fifo, count);
 
 	return 0;
 }
 
+int esb_read_rx_payload(struct esb_payload *payload)
+{
+	const struct esb_payload *rx;
+	int err;
+
+	if (!esb_initialized) {
+		return -EACCES;
+	}
+	if (payload == NULL) {
+		return -EINVAL;
+	}
+
+	/* Readers using this function are serialized with each other. */
+	unsigned int key = irq_lock();
+
+	err = esb_read_rx_payloads_claim(&rx, 1);
+	if (err >= 0) {
+		memcpy(payload, rx, offsetof(struct esb_payload, data) + rx->length);
+		esb_fifo_release(&rx_fifo, 1);
+	}
+
+	irq_unlock(key);
+
+	return (err < 0) ? err : 0;
+}
+
 int esb_start_tx(void)
 {
 	if (esb_state != ESB_STATE_IDLE) {
 		return -EBUSY;
 	}
 
-	if (tx_fifo.count == 0) {
+	if (esb_fifo_is_empty(&tx_fifo)) {
 		return -ENODATA;
 	}
 
@@ -1732,9 +1849,13 @@ int esb_flush_tx(void)
 
 	unsigned int key = irq_lock();
 
-	tx_fifo.count = 0;
-	tx_fifo.back = 0;
-	tx_fifo.front = 0;
+	esb_fifo_release(&tx_fifo, esb_fifo_count(&tx_fifo));
+
+	for (size_t i = 0; i < CONFIG_ESB_PIPE_COUNT; i++) {
+		while (ack_pl_wrap_pipe[i] != NULL) {
+			ack_pl_wrap_pipe_pop(i);
+		}
+	}
 
 	irq_unlock(key);
 
@@ -1743,28 +1864,39 @@ int esb_flush_tx(void)
 
 int esb_pop_tx(void)
 {
+	int err = -ENODATA;
+
 	if (!esb_initialized) {
 		return -EACCES;
 	}
-	if (tx_fifo.count == 0) {
-		return -ENODATA;
-	}
 
 	unsigned int key = irq_lock();
 
-	if (++tx_fifo.back >= CONFIG_ESB_TX_FIFO_SIZE) {
-		tx_fifo.back = 0;
+	if (!esb_fifo_is_empty(&tx_fifo)) {
+		esb_fifo_release(&tx_fifo, 1);
+		err = 0;
+	} else {
+		for (size_t i = 0; i < CONFIG_ESB_PIPE_COUNT; i++) {
+			if (ack_pl_wrap_pipe[i] != NULL) {
+				ack_pl_wrap_pipe_pop(i);
+				err = 0;
+				break;
+			}
+		}
 	}
-	tx_fifo.count--;
 
 	irq_unlock(key);
 
-	return 0;
+	return err;
 }
 
 bool esb_tx_full(void)
 {
-	return tx_fifo.count >= CONFIG_ESB_TX_FIFO_SIZE;
+	if (esb_cfg.mode == ESB_MODE_PTX) {
+		return esb_fifo_is_full(&tx_fifo);
+	}
+
+	return ack_pl_wrap_free == NULL;
 }
 
 int esb_flush_rx(void)
@@ -1775,9 +1907,7 @@ int esb_flush_rx(void)
 
 	unsigned int key = irq_lock();
 
-	rx_fifo.count = 0;
-	rx_fifo.back = 0;
-	rx_fifo.front = 0;
+	esb_fifo_release(&rx_fifo, esb_fifo_count(&rx_fifo));
 
 	memset(rx_pipe_info, 0, sizeof(rx_pipe_info));
 
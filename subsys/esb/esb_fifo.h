@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef ESB_FIFO_H__
+#define ESB_FIFO_H__
+
+#include <errno.h>
+#include <zephyr/types.h>
+#include <zephyr/sys/atomic.h>
+#include <zephyr/sys/__assert.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @file
+ * @brief Single-producer, single-consumer FIFO used by the ESB module.
+ *
+ * The FIFO manages only the slot indices. The elements are stored by the
+ * user in an array of the FIFO size, so the producer can fill a slot in place
+ * before it is committed and the consumer can access a slot in place before
+ * it is released.
+ *
+ * The head index is changed only by the producer and the tail index only by
+ * the consumer, so no locking is needed if there is exactly one producer
+ * context and one consumer context, for example the radio interrupt and
+ * a thread. The indices run over twice the FIFO size to distinguish between
+ * a full and an empty FIFO without a shared element counter.
+ */
+
+/** @brief ESB FIFO. */
+struct esb_fifo {
+	atomic_t head;	/**< Next index to be written, changed by the producer. */
+	atomic_t tail;	/**< Next index to be read, changed by the consumer. */
+	uint32_t size;	/**< Number of slots. */
+};
+
+static inline uint32_t esb_fifo_index_add(const struct esb_fifo *fifo, uint32_t idx, uint32_t n)
+{
+	idx += n;
+
+	return (idx >= 2 * fifo->size) ? (idx - 2 * fifo->size) : idx;
+}
+
+static inline uint32_t esb_fifo_index_to_slot(const struct esb_fifo *fifo, uint32_t idx)
+{
+	return (idx >= fifo->size) ? (idx - fifo->size) : idx;
+}
+
+/** @brief Initialize or reset a FIFO.
+ *
+ * The function must not be called while the FIFO is accessed by the producer
+ * or the consumer.
+ *
+ * @param fifo	FIFO.
+ * @param size	Number of slots.
+ */
+static inline void esb_fifo_init(struct esb_fifo *fifo, uint32_t size)
+{
+	__ASSERT_NO_MSG((size > 0) && (size <= (UINT32_MAX / 2)));
+
+	fifo->size = size;
+	atomic_set(&fifo->head, 0);
+	atomic_set(&fifo->tail, 0);
+}
+
+/** @brief Get the number of committed elements.
+ *
+ * @param fifo	FIFO.
+ *
+ * @return Number of elements that can be accessed by the consumer.
+ */
+static inline uint32_t esb_fifo_count(const struct esb_fifo *fifo)
+{
+	uint32_t head = atomic_get(&fifo->head);
+	uint32_t tail = atomic_get(&fifo->tail);
+
+	return (head >= tail) ? (head - tail) : (head + 2 * fifo->size - tail);
+}
+
+/** @brief Check if a FIFO is empty. */
+static inline bool esb_fifo_is_empty(const struct esb_fifo *fifo)
+{
+	return atomic_get(&fifo->head) == atomic_get(&fifo->tail);
+}
+
+/** @brief Check if a FIFO is full. */
+static inline bool esb_fifo_is_full(const struct esb_fifo *fifo)
+{
+	return esb_fifo_count(fifo) >= fifo->size;
+}
+
+/** @brief Claim the next free slot (producer).
+ *
+ * The slot is not visible to the consumer until @ref esb_fifo_commit is
+ * called. Claiming again without committing returns the same slot.
+ *
+ * @param fifo	FIFO.
+ *
+ * @return Slot index if successful, -ENOMEM if the FIFO is full.
+ */
+static inline int esb_fifo_claim(const struct esb_fifo *fifo)
+{
+	if (esb_fifo_is_full(fifo)) {
+		return -ENOMEM;
+	}
+
+	return esb_fifo_index_to_slot(fifo, atomic_get(&fifo->head));
+}
+
+/** @brief Pass claimed slots to the consumer (producer).
+ *
+ * @param fifo	FIFO.
+ * @param cnt	Number of slots filled after the last commit.
+ */
+static inline void esb_fifo_commit(struct esb_fifo *fifo, uint32_t cnt)
+{
+	__ASSERT_NO_MSG(cnt <= (fifo->size - esb_fifo_count(fifo)));
+
+	atomic_set(&fifo->head, esb_fifo_index_add(fifo, atomic_get(&fifo->head), cnt));
+}
+
+/** @brief Get the slot of a committed element (consumer).
+ *
+ * @param fifo	FIFO.
+ * @param n	Position of the element, 0 is the oldest one. It must be lower
+ *		than the value returned by @ref esb_fifo_count.
+ *
+ * @return Slot index.
+ */
+static inline uint32_t esb_fifo_peek(const struct esb_fifo *fifo, uint32_t n)
+{
+	__ASSERT_NO_MSG(n < esb_fifo_count(fifo));
+
+	return esb_fifo_index_to_slot(fifo,
+				      esb_fifo_index_add(fifo, atomic_get(&fifo->tail), n));
+}
+
+/** @brief Free the oldest elements (consumer).
+ *
+ * @param fifo	FIFO.
+ * @param cnt	Number of elements to be freed.
+ */
+static inline void esb_fifo_release(struct esb_fifo *fifo, uint32_t cnt)
+{
+	__ASSERT_NO_MSG(cnt <= esb_fifo_count(fifo));
+
+	atomic_set(&fifo->tail, esb_fifo_index_add(fifo, atomic_get(&fifo->tail), cnt));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ESB_FIFO_H__ */
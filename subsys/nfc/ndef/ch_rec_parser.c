@@ -78,7 +78,7 @@ static int hc_rec_payload_parse(struct nfc_ndef_bin_payload_desc *payload_desc,
 		return -EINVAL;
 	}
 
-	hc_rec->ctf = (enum nfc_ndef_record_tnf)payload_buf;
+	hc_rec->ctf = (enum nfc_ndef_record_tnf)(*payload_buf & NDEF_RECORD_TNF_MASK);
 	payload_buf++;
 	payload_len--;
 
@@ -213,7 +213,7 @@ static int ac_rec_payload_parse(struct nfc_ndef_bin_payload_desc *payload_desc,
 
 	ac_rec->aux_data_ref = (struct nfc_ndef_ch_ac_rec_ref *)
 		memory_allocate(&buf, ac_rec->aux_data_ref_cnt * sizeof(*ac_rec->aux_data_ref));
-	if (ac_rec->aux_data_ref) {
+	if (!ac_rec->aux_data_ref) {
 		return -ENOMEM;
 	}
 
@@ -231,13 +231,32 @@ static int ac_rec_payload_parse(struct nfc_ndef_bin_payload_desc *payload_desc,
 	return 0;
 }
 
+static int ch_rec_header_parse(struct nfc_ndef_bin_payload_desc *payload_desc,
+			       struct nfc_ndef_ch_rec_iter *iter)
+{
+	const uint8_t *payload_buf = payload_desc->payload;
+	uint32_t payload_len = payload_desc->payload_length;
+
+	if (payload_len < 1) {
+		return -EINVAL;
+	}
+
+	iter->major_version = ((*payload_buf) >> 4) & 0x0F;
+	iter->minor_version = (*payload_buf) & 0x0F;
+	payload_buf++;
+	payload_len--;
+
+	nfc_ndef_msg_iter_init(&iter->local_records, payload_buf, payload_len);
+
+	return 0;
+}
+
 static int ch_rec_payload_parse(struct nfc_ndef_bin_payload_desc *payload_desc,
 				uint8_t *result_buf, uint32_t *result_buf_len)
 {
 	int err;
 	const uint32_t buf_size = *result_buf_len;
-	const uint8_t *payload_buf = payload_desc->payload;
-	uint32_t payload_len = payload_desc->payload_length;
+	struct nfc_ndef_ch_rec_iter iter;
 	uint32_t local_msg_size;
 	uint8_t *local_msg;
 	struct nfc_ndef_ch_rec *ch_rec;
@@ -255,14 +274,13 @@ static int ch_rec_payload_parse(struct nfc_ndef_bin_payload_desc *payload_desc,
 
 	memset(ch_rec, 0, sizeof(*ch_rec));
 
-	if (payload_len < 1) {
-		return -EINVAL;
+	err = ch_rec_header_parse(payload_desc, &iter);
+	if (err) {
+		return err;
 	}
 
-	ch_rec->major_version = ((*payload_buf) >> 4) & 0x0F;
-	ch_rec->minor_version = (*payload_buf) & 0x0F;
-	payload_buf++;
-	payload_len--;
+	ch_rec->major_version = iter.major_version;
+	ch_rec->minor_version = iter.minor_version;
 
 	local_msg_size = net_buf_simple_tailroom(&buf);
 
@@ -272,7 +290,8 @@ static int ch_rec_payload_parse(struct nfc_ndef_bin_payload_desc *payload_desc,
 	}
 
 	err = nfc_ndef_msg_parse(local_msg, &local_msg_size,
-				 payload_buf, &payload_len);
+				 iter.local_records.data,
+				 &iter.local_records.data_len);
 	if (err) {
 		return err;
 	}
@@ -443,6 +462,30 @@ int nfc_ndef_ch_ac_rec_parse(const struct nfc_ndef_record_desc *rec_desc,
 				    result_buf, result_buf_len);
 }
 
+int nfc_ndef_ch_rec_iter_init(const struct nfc_ndef_record_desc *rec_desc,
+			      struct nfc_ndef_ch_rec_iter *iter)
+{
+	struct nfc_ndef_bin_payload_desc *payload_desc;
+
+	if (!rec_desc || !iter) {
+		return -EINVAL;
+	}
+
+	if (!ch_rec_check(rec_desc)) {
+		return -EINVAL;
+	}
+
+	if (rec_desc->payload_constructor !=
+		(payload_constructor_t) nfc_ndef_bin_payload_memcopy) {
+		return -ENOTSUP;
+	}
+
+	payload_desc = (struct nfc_ndef_bin_payload_desc *)
+		rec_desc->payload_descriptor;
+
+	return ch_rec_header_parse(payload_desc, iter);
+}
+
 int nfc_ndef_ch_rec_parse(const struct nfc_ndef_record_desc *rec_desc,
 			  uint8_t *result_buf, uint32_t *result_buf_len)
 {
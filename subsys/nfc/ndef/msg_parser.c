@@ -3,8 +3,10 @@
  *
  * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
  */
+#include <errno.h>
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
+#include <nfc/ndef/msg_parser.h>
 #include "msg_parser_local.h"
 
 LOG_MODULE_REGISTER(nfc_ndef_parser, CONFIG_NFC_NDEF_PARSER_LOG_LEVEL);
@@ -35,6 +37,97 @@ int nfc_ndef_msg_parse(uint8_t *result_buf,
 	return err;
 }
 
+void nfc_ndef_msg_iter_init(struct nfc_ndef_msg_iter *iter,
+			    const uint8_t *raw_data,
+			    uint32_t raw_data_len)
+{
+	__ASSERT_NO_MSG(iter);
+
+	iter->data = raw_data;
+	iter->data_len = raw_data_len;
+	iter->parsed_len = 0;
+	iter->record_count = 0;
+	iter->complete = false;
+}
+
+int nfc_ndef_msg_iter_next(struct nfc_ndef_msg_iter *iter,
+			   struct nfc_ndef_record_desc *rec_desc,
+			   struct nfc_ndef_bin_payload_desc *bin_pay_desc)
+{
+	int err;
+	enum nfc_ndef_record_location record_location;
+	uint32_t rec_len = iter->data_len;
+
+	if (iter->complete) {
+		return -ENOENT;
+	}
+
+	/* Message without the last record. */
+	if (iter->data_len == 0) {
+		return -EFAULT;
+	}
+
+	err = nfc_ndef_record_parse(bin_pay_desc, rec_desc, &record_location,
+				    iter->data, &rec_len);
+	if (err) {
+		return err;
+	}
+
+	/* Verify the records location flags. */
+	if (iter->record_count == 0) {
+		if ((record_location != NDEF_FIRST_RECORD) &&
+		    (record_location != NDEF_LONE_RECORD)) {
+			return -EFAULT;
+		}
+	} else {
+		if ((record_location != NDEF_MIDDLE_RECORD) &&
+		    (record_location != NDEF_LAST_RECORD)) {
+			return -EFAULT;
+		}
+	}
+
+	iter->data += rec_len;
+	iter->data_len -= rec_len;
+	iter->parsed_len += rec_len;
+	iter->record_count++;
+	iter->complete = ((record_location == NDEF_LAST_RECORD) ||
+			  (record_location == NDEF_LONE_RECORD));
+
+	return 0;
+}
+
+int nfc_ndef_msg_visit(const uint8_t *raw_data,
+		       uint32_t *raw_data_len,
+		       nfc_ndef_msg_record_visitor_t visitor,
+		       void *user_data)
+{
+	int err;
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_desc rec_desc;
+	struct nfc_ndef_bin_payload_desc bin_pay_desc;
+
+	if (!raw_data || !raw_data_len || !visitor) {
+		return -EINVAL;
+	}
+
+	nfc_ndef_msg_iter_init(&iter, raw_data, *raw_data_len);
+
+	do {
+		err = nfc_ndef_msg_iter_next(&iter, &rec_desc, &bin_pay_desc);
+		if (err) {
+			return err;
+		}
+
+		err = visitor(&rec_desc, iter.record_count - 1, user_data);
+		if (err) {
+			return err;
+		}
+	} while (!iter.complete);
+
+	*raw_data_len = iter.parsed_len;
+
+	return 0;
+}
 
 void nfc_ndef_msg_printout(const struct nfc_ndef_msg_desc *msg_desc)
 {
@@ -11,69 +11,40 @@ int nfc_ndef_msg_parser_internal(struct nfc_ndef_parser_memo_desc *parser_memo_d
 				 const uint8_t *nfc_data,
 				 uint32_t *nfc_data_len)
 {
-	enum nfc_ndef_record_location record_location;
-
 	int err;
-
-	uint32_t nfc_data_left = *nfc_data_len;
-	uint32_t temp_nfc_data_len = 0;
+	struct nfc_ndef_msg_iter iter;
 
 	/* Want to modify -> use local copy. */
 	struct nfc_ndef_bin_payload_desc *bin_pay_desc =
 		parser_memo_desc->bin_pay_desc;
 	struct nfc_ndef_record_desc *rec_desc = parser_memo_desc->rec_desc;
 
+	nfc_ndef_msg_iter_init(&iter, nfc_data, *nfc_data_len);
 
-	while (nfc_data_left > 0) {
-		temp_nfc_data_len = nfc_data_left;
+	do {
+		if (parser_memo_desc->msg_desc->record_count ==
+		    parser_memo_desc->msg_desc->max_record_count) {
+			return -ENOMEM;
+		}
 
-		err = nfc_ndef_record_parse(bin_pay_desc,
-					    rec_desc,
-					    &record_location,
-					    nfc_data,
-					    &temp_nfc_data_len);
+		err = nfc_ndef_msg_iter_next(&iter, rec_desc, bin_pay_desc);
 		if (err != 0) {
 			return err;
 		}
 
-		/* Verify the records location flags. */
-		if (parser_memo_desc->msg_desc->record_count == 0) {
-			if ((record_location != NDEF_FIRST_RECORD) &&
-			    (record_location != NDEF_LONE_RECORD)) {
-				return -EFAULT;
-			}
-		} else {
-			if ((record_location != NDEF_MIDDLE_RECORD) &&
-			    (record_location != NDEF_LAST_RECORD)) {
-				return -EFAULT;
-			}
-		}
-
 		err = nfc_ndef_msg_record_add(parser_memo_desc->msg_desc,
 					      rec_desc);
 		if (err != 0) {
 			return err;
 		}
 
-		nfc_data_left -= temp_nfc_data_len;
-
-		if ((record_location == NDEF_LAST_RECORD) ||
-		    (record_location == NDEF_LONE_RECORD)) {
-			*nfc_data_len = *nfc_data_len - nfc_data_left;
-			return 0;
-		} else {
-			if (parser_memo_desc->msg_desc->record_count ==
-			    parser_memo_desc->msg_desc->max_record_count) {
-				return -ENOMEM;
-			}
-
-			nfc_data += temp_nfc_data_len;
-			bin_pay_desc++;
-			rec_desc++;
-		}
-	}
+		bin_pay_desc++;
+		rec_desc++;
+	} while (!iter.complete);
 
-	return -EFAULT;
+	*nfc_data_len = iter.parsed_len;
+
+	return 0;
 }
 
 
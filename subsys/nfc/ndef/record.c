@@ -114,7 +114,7 @@ int nfc_ndef_record_encode(struct nfc_ndef_record_desc const *ndef_record_desc,
 
 	if (record_buffer) {
 		/* PAYLOAD LENGTH */
-		*(uint32_t *)payload_len = sys_cpu_to_be32(record_payload_len);
+		sys_put_be32(record_payload_len, payload_len);
 	}
 
 	*record_len = record_header_len + record_payload_len;
@@ -141,3 +141,36 @@ int nfc_ndef_bin_payload_memcopy(
 
 	return 0;
 }
+
+int nfc_ndef_bin_payload_sg_memcopy(
+			struct nfc_ndef_bin_payload_sg_desc *payload_descriptor,
+			uint8_t *buffer,
+			uint32_t *len)
+{
+	uint32_t payload_len = 0;
+
+	if (!payload_descriptor->segment && payload_descriptor->segment_cnt) {
+		return -EINVAL;
+	}
+
+	for (uint32_t i = 0; i < payload_descriptor->segment_cnt; i++) {
+		const struct nfc_ndef_bin_payload_desc *segment =
+			&payload_descriptor->segment[i];
+
+		if (buffer && (segment->payload_length > 0)) {
+			if ((*len - payload_len) < segment->payload_length) {
+				return -ENOSR;
+			}
+
+			memcpy(&buffer[payload_len],
+			       segment->payload,
+			       segment->payload_length);
+		}
+
+		payload_len += segment->payload_length;
+	}
+
+	*len = payload_len;
+
+	return 0;
+}
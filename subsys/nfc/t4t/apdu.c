@@ -19,6 +19,7 @@ LOG_MODULE_REGISTER(nfc_t4t_apdu, CONFIG_NFC_T4T_APDU_LOG_LEVEL);
 #define LC_LONG_FORMAT_SIZE 3U
 #define LE_SHORT_FORMAT_SIZE 1U
 #define LE_LONG_FORMAT_SIZE 2U
+#define LE_LONG_FORMAT_NO_LC_SIZE 3U
 
 /** @brief Values used to encode Lc field in C-APDU.
  */
@@ -28,18 +29,29 @@ LOG_MODULE_REGISTER(nfc_t4t_apdu, CONFIG_NFC_T4T_APDU_LOG_LEVEL);
 /** @brief Values used to encode Le field in C-APDU.
  */
 #define LE_FIELD_ABSENT 0U
+#define LE_LONG_FORMAT_TOKEN 0x00
 #define LE_LONG_FORMAT_THR 0x0100
 #define LE_ENCODED_VAL_256 0x00
 
 /* Size of Status field contained in R-APDU. */
 #define STATUS_SIZE 2U
 
-static uint16_t nfc_t4t_apdu_comm_size_calc(const struct nfc_t4t_apdu_comm *cmd_apdu)
+/* Lc and Le fields are both coded in the long format if one of them does not
+ * fit in the short format. ISO/IEC 7816-4 5.1.
+ */
+static bool nfc_t4t_apdu_comm_is_extended(const struct nfc_t4t_apdu_comm *cmd_apdu)
+{
+	return (cmd_apdu->data.len > LC_LONG_FORMAT_THR) ||
+	       (cmd_apdu->resp_len > LE_LONG_FORMAT_THR);
+}
+
+static uint32_t nfc_t4t_apdu_comm_size_calc(const struct nfc_t4t_apdu_comm *cmd_apdu)
 {
-	uint16_t res = CLASS_TYPE_SIZE + INSTRUCTION_TYPE_SIZE + PARAMETER_SIZE;
+	uint32_t res = CLASS_TYPE_SIZE + INSTRUCTION_TYPE_SIZE + PARAMETER_SIZE;
+	bool extended = nfc_t4t_apdu_comm_is_extended(cmd_apdu);
 
 	if (cmd_apdu->data.buff) {
-		if (cmd_apdu->data.len > LC_LONG_FORMAT_THR) {
+		if (extended) {
 			res += LC_LONG_FORMAT_SIZE;
 		} else {
 			res += LC_SHORT_FORMAT_SIZE;
@@ -49,10 +61,12 @@ static uint16_t nfc_t4t_apdu_comm_size_calc(const struct nfc_t4t_apdu_comm *cmd_
 	res += cmd_apdu->data.len;
 
 	if (cmd_apdu->resp_len != LE_FIELD_ABSENT) {
-		if (cmd_apdu->resp_len > LE_LONG_FORMAT_THR) {
+		if (!extended) {
+			res += LE_SHORT_FORMAT_SIZE;
+		} else if (cmd_apdu->data.buff) {
 			res += LE_LONG_FORMAT_SIZE;
 		} else {
-			res += LE_SHORT_FORMAT_SIZE;
+			res += LE_LONG_FORMAT_NO_LC_SIZE;
 		}
 	}
 
@@ -87,7 +101,8 @@ int nfc_t4t_apdu_comm_encode(const struct nfc_t4t_apdu_comm *cmd_apdu,
 	/* Check if there is enough memory in the provided buffer to store
 	 * described C-APDU.
 	 */
-	uint16_t comm_apdu_len = nfc_t4t_apdu_comm_size_calc(cmd_apdu);
+	uint32_t comm_apdu_len = nfc_t4t_apdu_comm_size_calc(cmd_apdu);
+	bool extended = nfc_t4t_apdu_comm_is_extended(cmd_apdu);
 
 	if (comm_apdu_len > *len) {
 		return -ENOMEM;
@@ -105,7 +120,7 @@ int nfc_t4t_apdu_comm_encode(const struct nfc_t4t_apdu_comm *cmd_apdu,
 	/* Check if optional data field should be included. */
 	if (cmd_apdu->data.buff) {
 		/* Use long data length encoding. */
-		if (cmd_apdu->data.len > LC_LONG_FORMAT_THR) {
+		if (extended) {
 			*raw_data++ = LC_LONG_FORMAT_TOKEN;
 
 			sys_put_be16(cmd_apdu->data.len, raw_data);
@@ -124,7 +139,14 @@ int nfc_t4t_apdu_comm_encode(const struct nfc_t4t_apdu_comm *cmd_apdu,
 	 */
 	if (cmd_apdu->resp_len != LE_FIELD_ABSENT) {
 		/* Use long response length encoding. */
-		if (cmd_apdu->resp_len > LE_LONG_FORMAT_THR) {
+		if (extended) {
+			/* Without Lc field, long Le field starts with
+			 * the token.
+			 */
+			if (!cmd_apdu->data.buff) {
+				*raw_data++ = LE_LONG_FORMAT_TOKEN;
+			}
+
 			sys_put_be16(cmd_apdu->resp_len, raw_data);
 			raw_data += sizeof(uint16_t);
 		} else {
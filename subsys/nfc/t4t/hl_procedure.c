@@ -26,6 +26,9 @@ LOG_MODULE_REGISTER(nfc_t4t_hl_procedure,
 #define NFC_T4T_APDU_SELECT_DATA {0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01}
 #define APDU_LE_MAP_2_MAX_VALUE 0xFF
 #define NFC_T4T_APDU_RSP_ALL 256
+#define CAPDU_SHORT_HEADER_SIZE 5
+#define CAPDU_EXTENDED_HEADER_SIZE 7
+#define T4T_EXTENDED_APDU_MAJOR_VERSION 3
 
 enum nfc_t4t_hl_transaction_type {
 	NFC_T4T_HL_SELECT,
@@ -79,6 +82,60 @@ static int t4t_hl_data_exchange(struct nfc_t4t_apdu_comm *comm)
 	return nfc_t4t_isodep_transmit(t4t_hl.apdu_buff, apdu_len);
 }
 
+/* Extended-length APDUs are used only with tags that comply with
+ * the Type 4 Tag specification 3.0 or later.
+ */
+static bool extended_apdu_supported(const struct nfc_t4t_cc_file *cc)
+{
+	return cc->major_version >= T4T_EXTENDED_APDU_MAJOR_VERSION;
+}
+
+/* Get the largest R-APDU data field that the tag can send and that fits in
+ * the ISO-DEP RX buffer together with the status word. The R-APDU is aligned
+ * to whole ISO-DEP frames, because a partly filled frame costs the same
+ * R(ACK) exchange as a full one.
+ */
+static uint16_t rapdu_data_max_len(const struct nfc_t4t_cc_file *cc, bool extended)
+{
+	size_t rx_size = nfc_t4t_isodep_rx_buf_size_get();
+	size_t frame_size = nfc_t4t_isodep_rx_frame_data_size_get();
+	size_t len = cc->max_rapdu_size;
+
+	if (!extended || !extended_apdu_supported(cc)) {
+		len = MIN(len, NFC_T4T_APDU_RSP_ALL);
+	}
+
+	if (rx_size <= RAPDU_MIN_LEN) {
+		return 0;
+	}
+
+	len = MIN(len, rx_size - RAPDU_MIN_LEN);
+
+	if ((frame_size > RAPDU_MIN_LEN) && ((len + RAPDU_MIN_LEN) > frame_size)) {
+		len = ((len + RAPDU_MIN_LEN) / frame_size) * frame_size - RAPDU_MIN_LEN;
+	}
+
+	return len;
+}
+
+/* Get the largest C-APDU data field that the tag can receive and that fits in
+ * the APDU buffer together with the command header.
+ */
+static uint16_t capdu_data_max_len(const struct nfc_t4t_cc_file *cc)
+{
+	uint16_t len;
+
+	len = MIN(MIN(cc->max_capdu_size, APDU_LE_MAP_2_MAX_VALUE),
+		  sizeof(t4t_hl.apdu_buff) - CAPDU_SHORT_HEADER_SIZE);
+
+	if (extended_apdu_supported(cc)) {
+		len = MAX(len, MIN(cc->max_capdu_size,
+				   sizeof(t4t_hl.apdu_buff) - CAPDU_EXTENDED_HEADER_SIZE));
+	}
+
+	return len;
+}
+
 static int on_cc_read(const struct nfc_t4t_apdu_resp *resp)
 {
 	__ASSERT_NO_MSG(resp);
@@ -134,13 +191,21 @@ static int on_ndef_nlen_read(const struct nfc_t4t_apdu_resp *resp)
 	const uint8_t *data = resp->data.buff;
 	uint16_t len = resp->data.len;
 
-	if (len != NDEF_FILE_NLEN_SIZE) {
-		LOG_ERR("NDEF NLEN response is to long");
+	/* The response contains the NLEN field followed by the first part
+	 * of the NDEF message.
+	 */
+	if (len < NDEF_FILE_NLEN_SIZE) {
+		LOG_ERR("NDEF NLEN response is too short");
 		return -EINVAL;
 	}
 
 	t4t_hl.ndef.nlen = sys_get_be16(data);
 
+	if ((t4t_hl.ndef.nlen + NDEF_FILE_NLEN_SIZE) > t4t_hl.ndef.buff_size) {
+		LOG_ERR("NDEF message does not fit in the buffer");
+		return -ENOMEM;
+	}
+
 	return 0;
 }
 
@@ -164,7 +229,11 @@ static int ndef_file_chunk_read(const struct nfc_t4t_apdu_resp *resp)
 	uint16_t file_id;
 	struct nfc_t4t_apdu_comm apdu_comm;
 	const uint8_t *data = resp->data.buff;
-	uint16_t len = resp->data.len;
+	uint16_t ndef_file_len = t4t_hl.ndef.nlen + NDEF_FILE_NLEN_SIZE;
+	uint16_t len;
+
+	/* The response can contain data after the end of the NDEF message. */
+	len = MIN(resp->data.len, ndef_file_len - t4t_hl.file_offset);
 
 	if (t4t_hl.ndef.buff_size < t4t_hl.file_offset + len) {
 		return -ENOMEM;
@@ -174,13 +243,18 @@ static int ndef_file_chunk_read(const struct nfc_t4t_apdu_resp *resp)
 
 	t4t_hl.file_offset += len;
 
-	if (t4t_hl.file_offset < (t4t_hl.ndef.nlen + NDEF_FILE_NLEN_SIZE)) {
+	if (t4t_hl.file_offset < ndef_file_len) {
+		/* The tag has no more data to send. */
+		if (len == 0) {
+			return -EIO;
+		}
+
 		nfc_t4t_apdu_comm_clear(&apdu_comm);
 
 		apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_READ;
 		apdu_comm.parameter = t4t_hl.file_offset;
-		apdu_comm.resp_len = MIN(t4t_hl.ndef.nlen - (t4t_hl.file_offset - NDEF_FILE_NLEN_SIZE),
-				MIN(APDU_LE_MAP_2_MAX_VALUE, t4t_hl.ndef.cc->max_rapdu_size));
+		apdu_comm.resp_len = MIN(ndef_file_len - t4t_hl.file_offset,
+					 rapdu_data_max_len(t4t_hl.ndef.cc, true));
 
 		t4t_hl.transaction_type = NFC_T4T_HL_NDEF_READ;
 
@@ -215,7 +289,7 @@ static int ndef_file_chunk_update(void)
 		apdu_comm.parameter = t4t_hl.file_offset;
 		apdu_comm.data.buff = t4t_hl.ndef.buff + t4t_hl.file_offset;
 		apdu_comm.data.len = MIN(t4t_hl.ndef.buff_size - t4t_hl.file_offset,
-				MIN(APDU_LE_MAP_2_MAX_VALUE, t4t_hl.ndef.cc->max_capdu_size));
+					 capdu_data_max_len(t4t_hl.ndef.cc));
 
 		t4t_hl.file_offset += apdu_comm.data.len;
 		t4t_hl.transaction_type = NFC_T4T_HL_NDEF_UPDATE;
@@ -404,18 +478,31 @@ int nfc_t4t_hl_procedure_ndef_read(struct nfc_t4t_cc_file *cc,
 				   uint16_t ndef_len)
 {
 	struct nfc_t4t_apdu_comm apdu_comm;
+	struct nfc_t4t_tlv_block *tlv_block;
+	uint32_t file_len = NDEF_FILE_NLEN_SIZE;
 
 	t4t_hl.file_offset = 0;
 
-	if (!cc || !ndef_buff || !ndef_len) {
+	if (!cc || !ndef_buff || (ndef_len < NDEF_FILE_NLEN_SIZE)) {
 		return -EINVAL;
 	}
 
+	/* Read the NLEN field together with the first part of the message,
+	 * within the maximum NDEF File size declared in the CC file.
+	 */
+	tlv_block = nfc_t4t_cc_file_content_get(cc, sys_get_be16(t4t_hl.ndef.file_id));
+	if (tlv_block) {
+		file_len = MAX(file_len, MIN(tlv_block->value.max_file_size, ndef_len));
+	}
+
+	file_len = MIN(file_len, CONFIG_NFC_T4T_HL_PROCEDURE_NDEF_FIRST_READ_SIZE);
+
 	nfc_t4t_apdu_comm_clear(&apdu_comm);
 
 	apdu_comm.instruction = NFC_T4T_APDU_COMM_INS_READ;
 	apdu_comm.parameter = 0;
-	apdu_comm.resp_len = NDEF_FILE_NLEN_SIZE;
+	apdu_comm.resp_len = MIN(file_len, MAX(rapdu_data_max_len(cc, false),
+					       NDEF_FILE_NLEN_SIZE));
 
 	t4t_hl.ndef.buff = ndef_buff;
 	t4t_hl.ndef.buff_size = ndef_len;
@@ -740,6 +740,31 @@ int nfc_t4t_isodep_init(uint8_t *tx_buf, size_t size_tx,
 	return 0;
 }
 
+size_t nfc_t4t_isodep_rx_buf_size_get(void)
+{
+	if (atomic_get(&t4t_isodep.state) == ISODEP_STATE_UNINITIALIZED) {
+		return 0;
+	}
+
+	return t4t_isodep.rx_data.buf_size;
+}
+
+size_t nfc_t4t_isodep_rx_frame_data_size_get(void)
+{
+	/* PCB byte and optional DID field. */
+	size_t prologue = 1;
+
+	if (t4t_isodep.tag.did_supported && (t4t_isodep.tag.did != 0)) {
+		prologue++;
+	}
+
+	if (t4t_isodep.fsd <= (prologue + ISODEP_CRC_LENGTH)) {
+		return 0;
+	}
+
+	return t4t_isodep.fsd - prologue - ISODEP_CRC_LENGTH;
+}
+
 void nfc_t4t_isodep_on_timeout(void)
 {
 	isodep_error_handle(true);
@@ -909,8 +934,11 @@ int nfc_t4t_isodep_transmit(const uint8_t *data, size_t data_len)
 		t4t_isodep.first_transfer = false;
 		spent_time = k_uptime_delta(&ats_received_time);
 
-		if (spent_time < T4T_FWT_TO_MS(t4t_isodep.tag.fwt)) {
-			delay = T4T_FWT_TO_MS(t4t_isodep.tag.fwt) - spent_time;
+		/* The Listener is ready to receive the first I-block after
+		 * SFGT. NFC Forum Digital Specification 2.0 14.8.2.
+		 */
+		if (spent_time < T4T_FWT_TO_MS(t4t_isodep.tag.sfgt)) {
+			delay = T4T_FWT_TO_MS(t4t_isodep.tag.sfgt) - spent_time;
 
 			LOG_DBG("Wait %d ms before sending first frame after ATS Response",
 				delay);
@@ -7,6 +7,7 @@
 #include <errno.h>
 #include <stddef.h>
 #include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/util.h>
 #include <nfc/t4t/ndef_file.h>
 
 int nfc_t4t_ndef_file_encode(uint8_t *file_buf, uint32_t *size)
@@ -19,8 +20,40 @@ int nfc_t4t_ndef_file_encode(uint8_t *file_buf, uint32_t *size)
 		return -ENOTSUP;
 	}
 
-	*(uint16_t *)file_buf = sys_cpu_to_be16(*size);
+	sys_put_be16(*size, file_buf);
 	*size += NFC_NDEF_FILE_NLEN_FIELD_SIZE;
 
 	return 0;
 }
+
+int nfc_t4t_ndef_file_msg_encode(const struct nfc_ndef_msg_desc *msg,
+				 uint8_t *file_buf, uint32_t *size)
+{
+	int err;
+	uint32_t msg_len = 0;
+
+	if (!IS_ENABLED(CONFIG_NFC_NDEF_MSG)) {
+		return -ENOTSUP;
+	}
+
+	if (!file_buf || !size || (*size < NFC_NDEF_FILE_NLEN_FIELD_SIZE)) {
+		return -EINVAL;
+	}
+
+	if (msg && (msg->record_count > 0)) {
+		/* NLEN field limits the message size. */
+		msg_len = MIN(nfc_t4t_ndef_file_msg_size_get(*size), UINT16_MAX);
+
+		err = nfc_ndef_msg_encode(msg, nfc_t4t_ndef_file_msg_get(file_buf),
+					  &msg_len);
+		if (err) {
+			return err;
+		}
+	}
+
+	/* NLEN is known only after the records are encoded. */
+	sys_put_be16(msg_len, file_buf);
+	*size = msg_len + NFC_NDEF_FILE_NLEN_FIELD_SIZE;
+
+	return 0;
+}
@@ -47,33 +47,6 @@ static uint8_t *memory_allocate(struct net_buf_simple *buf,
 	return net_buf_simple_add(buf, alloc_size);
 }
 
-static int handover_rec_parse(const struct nfc_ndef_ch_rec **ch_rec,
-			      const struct nfc_ndef_record_desc *rec,
-			      struct net_buf_simple *buf)
-{
-	int err;
-	uint8_t *rec_data;
-	size_t rec_data_size;
-
-	rec_data_size = sizeof(struct nfc_ndef_ch_rec) +
-		NFC_NDEF_PARSER_REQUIRED_MEM(CONFIG_NFC_TNEP_CH_MAX_LOCAL_RECORD_COUNT);
-
-	rec_data = memory_allocate(buf, rec_data_size);
-	if (!rec_data) {
-		return -ENOMEM;
-	}
-
-	err = nfc_ndef_ch_rec_parse(rec, rec_data,
-				    &rec_data_size);
-	if (err) {
-		return err;
-	}
-
-	*ch_rec = (struct nfc_ndef_ch_rec *)rec_data;
-
-	return 0;
-}
-
 static int cr_rec_parse(const struct nfc_ndef_ch_cr_rec **cr_rec,
 			const struct nfc_ndef_record_desc *rec,
 			struct net_buf_simple *buf)
@@ -131,20 +104,25 @@ static int ac_rec_parse(const struct nfc_ndef_ch_ac_rec **ac_rec,
 	return 0;
 }
 
-static int ac_rec_get(const struct nfc_ndef_record_desc **local_rec,
+static int ac_rec_get(struct nfc_ndef_msg_iter *local_records,
 		      struct nfc_tnep_ch_record *ch_data,
-		      struct net_buf_simple *buf,
-		      uint32_t rec_count)
+		      struct net_buf_simple *buf)
 {
 	int err;
+	struct nfc_ndef_record_desc rec;
+	struct nfc_ndef_bin_payload_desc bin_pay_desc;
+
+	while ((err = nfc_ndef_msg_iter_next(local_records, &rec,
+					     &bin_pay_desc)) == 0) {
+		if (local_records->record_count >
+		    CONFIG_NFC_TNEP_CH_MAX_LOCAL_RECORD_COUNT) {
+			return -ENOMEM;
+		}
 
-	for (size_t i = 0; i < rec_count; i++) {
-		const struct nfc_ndef_record_desc *rec =
-					local_rec[i];
-		if (nfc_ndef_ch_ac_rec_check(rec)) {
+		if (nfc_ndef_ch_ac_rec_check(&rec)) {
 			const struct nfc_ndef_ch_ac_rec *ac_rec;
 
-			err = ac_rec_parse(&ac_rec, rec, buf);
+			err = ac_rec_parse(&ac_rec, &rec, buf);
 			if (err) {
 				return err;
 			}
@@ -161,7 +139,7 @@ static int ac_rec_get(const struct nfc_ndef_record_desc **local_rec,
 		}
 	}
 
-	return 0;
+	return (err == -ENOENT) ? 0 : err;
 }
 
 int nfc_tnep_ch_hc_rec_parse(const struct nfc_ndef_ch_hc_rec **hc_rec,
@@ -200,28 +178,34 @@ int nfc_tnep_ch_request_msg_parse(const struct nfc_ndef_msg_desc *msg,
 				  struct net_buf_simple *buf)
 {
 	int err;
-	const struct nfc_ndef_ch_rec *ch_rec;
+	struct nfc_ndef_ch_rec_iter ch_rec;
+	struct nfc_ndef_record_desc local_rec;
+	struct nfc_ndef_bin_payload_desc bin_pay_desc;
 	const struct nfc_ndef_record_desc **rec;
-	const struct nfc_ndef_record_desc **local_rec;
 
 	memset(ch_req, 0, sizeof(*ch_req));
 
 	rec = msg->record;
 
-	err = handover_rec_parse(&ch_rec, *rec, buf);
+	err = nfc_ndef_ch_rec_iter_init(*rec, &ch_rec);
 	if (err) {
 		return err;
 	}
 
-	ch_req->ch_record.major_ver = ch_rec->major_version;
-	ch_req->ch_record.minor_ver = ch_rec->minor_version;
+	ch_req->ch_record.major_ver = ch_rec.major_version;
+	ch_req->ch_record.minor_ver = ch_rec.minor_version;
 
-	local_rec = ch_rec->local_records->record;
 	rec++;
 
+	err = nfc_ndef_msg_iter_next(&ch_rec.local_records, &local_rec,
+				     &bin_pay_desc);
+	if (err) {
+		return err;
+	}
+
 	/* Get collision resolution value */
-	if (nfc_ndef_ch_cr_rec_check(*local_rec)) {
-		err = cr_rec_parse(&ch_req->cr, *local_rec, buf);
+	if (nfc_ndef_ch_cr_rec_check(&local_rec)) {
+		err = cr_rec_parse(&ch_req->cr, &local_rec, buf);
 		if (err) {
 			return err;
 		}
@@ -229,10 +213,7 @@ int nfc_tnep_ch_request_msg_parse(const struct nfc_ndef_msg_desc *msg,
 		return -EFAULT;
 	}
 
-	local_rec++;
-
-	err = ac_rec_get(local_rec, &ch_req->ch_record,
-			 buf, (ch_rec->local_records->record_count - 1));
+	err = ac_rec_get(&ch_rec.local_records, &ch_req->ch_record, buf);
 	if (err) {
 		return err;
 	}
@@ -247,80 +228,55 @@ int nfc_tnep_ch_request_msg_parse(const struct nfc_ndef_msg_desc *msg,
 	return 0;
 }
 
-int nfc_tnep_ch_select_msg_parse(const struct nfc_ndef_msg_desc *msg,
-				 struct nfc_tnep_ch_record *ch_select,
-				 struct net_buf_simple *buf)
+static int ch_record_msg_parse(const struct nfc_ndef_msg_desc *msg,
+			       struct nfc_tnep_ch_record *ch_record,
+			       struct net_buf_simple *buf)
 {
 	int err;
-	const struct nfc_ndef_ch_rec *ch_rec;
+	struct nfc_ndef_ch_rec_iter ch_rec;
 	const struct nfc_ndef_record_desc **rec;
 
-	memset(ch_select, 0, sizeof(*ch_select));
+	memset(ch_record, 0, sizeof(*ch_record));
 
 	rec = msg->record;
 
-	err = handover_rec_parse(&ch_rec, *rec, buf);
+	err = nfc_ndef_ch_rec_iter_init(*rec, &ch_rec);
 	if (err) {
 		return err;
 	}
 
-	ch_select->major_ver = ch_rec->major_version;
-	ch_select->minor_ver = ch_rec->minor_version;
+	ch_record->major_ver = ch_rec.major_version;
+	ch_record->minor_ver = ch_rec.minor_version;
 
 	rec++;
 
-	err = ac_rec_get(ch_rec->local_records->record, ch_select,
-			 buf, ch_rec->local_records->record_count);
+	err = ac_rec_get(&ch_rec.local_records, ch_record, buf);
 	if (err) {
 		return err;
 	}
 
-	if (ch_select->count !=
+	if (ch_record->count !=
 	    (msg->record_count - NFC_TNEP_CH_NON_CARRIER_REC_CNT)) {
 		return -EFAULT;
 	}
 
-	ch_select->carrier = rec;
+	ch_record->carrier = rec;
 
 	return 0;
 }
 
+int nfc_tnep_ch_select_msg_parse(const struct nfc_ndef_msg_desc *msg,
+				 struct nfc_tnep_ch_record *ch_select,
+				 struct net_buf_simple *buf)
+{
+	return ch_record_msg_parse(msg, ch_select, buf);
+}
+
 int nfc_tnep_ch_initiate_msg_parse(const struct nfc_ndef_msg_desc *msg,
 				   struct nfc_tnep_ch_record *ch_init,
 				   struct net_buf_simple *buf)
 {
-	int err;
-	const struct nfc_ndef_ch_rec *ch_rec;
-	const struct nfc_ndef_record_desc **rec;
-
-	memset(ch_init, 0, sizeof(*ch_init));
-
-	rec = msg->record;
-
-	err = handover_rec_parse(&ch_rec, *rec, buf);
-	if (err) {
-		return err;
-	}
-
-	ch_init->major_ver = ch_rec->major_version;
-	ch_init->minor_ver = ch_rec->minor_version;
-
-	rec++;
-
-	err = ac_rec_get(ch_rec->local_records->record, ch_init,
-			 buf, ch_rec->local_records->record_count);
-	if (err) {
-		return err;
-	}
-
-	if (ch_init->count !=
-	    (msg->record_count - NFC_TNEP_CH_NON_CARRIER_REC_CNT)) {
-		return -EFAULT;
-	}
-
-	ch_init->carrier = rec;
-
-	return 0;
+	return ch_record_msg_parse(msg, ch_init, buf);
 }
 
 int nfc_tnep_ch_request_msg_prepare(const struct nfc_ndef_ch_msg_records *records)
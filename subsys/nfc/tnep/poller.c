@@ -126,33 +126,27 @@ static int tnep_tag_update_prepare(const struct nfc_ndef_msg_desc *msg,
 	__ASSERT(tnep.api->ndef_update, "No provided API for writing NDEF");
 
 	int err;
-	size_t len = tnep.tx->size;
-	uint8_t *data = tnep.tx->data;
+	uint32_t len = tnep.tx->size;
 
 	*tx_len = 0;
 
 	if (tnep.type == NFC_TNEP_TAG_TYPE_T4T) {
-		data = nfc_t4t_ndef_file_msg_get(data);
-
-		/* Subtract NDEF NLEN field, to calculate
-		 * available space for NDEF Message correctly.
-		 */
-		len = nfc_t4t_ndef_file_msg_size_get(len);
+		/* Encode NDEF Message directly into the NDEF File. */
+		err = nfc_t4t_ndef_file_msg_encode(msg,
+						   tnep.tx->data,
+						   &len);
+	} else {
+		/* Encode NDEF Message into raw buffer. */
+		err = nfc_ndef_msg_encode(msg,
+					  tnep.tx->data,
+					  &len);
 	}
 
-	/* Encode NDEF Message into raw buffer. */
-	err = nfc_ndef_msg_encode(msg,
-				  data,
-				  &len);
 	if (err) {
 		LOG_ERR("NDEF message encoding error");
 		return err;
 	}
 
-	if (tnep.type == NFC_TNEP_TAG_TYPE_T4T) {
-		nfc_t4t_ndef_file_encode(tnep.tx->data, &len);
-	}
-
 	*tx_len = len;
 
 	return 0;
@@ -110,8 +110,7 @@ static int tnep_tx_msg_encode(struct nfc_ndef_msg_desc *msg)
 {
 	int err = 0;
 	unsigned int key;
-	size_t len;
-	uint8_t *data;
+	uint32_t len;
 
 
 	if (tnep.current_buff == tnep.tx.data) {
@@ -123,23 +122,20 @@ static int tnep_tx_msg_encode(struct nfc_ndef_msg_desc *msg)
 	memset(tnep.current_buff, 0, tnep.tx.len);
 
 	len = tnep.tx.len;
-	data = tnep.current_buff;
 
 	if (IS_ENABLED(CONFIG_NFC_T4T_NRFXLIB)) {
-		len = nfc_t4t_ndef_file_msg_size_get(len);
-		data = nfc_t4t_ndef_file_msg_get(data);
-	}
-
-	if (msg && (msg->record_count > 0)) {
+		/* Encode records directly into the NDEF File. An empty
+		 * message results in the NLEN field set to zero.
+		 */
+		err = nfc_t4t_ndef_file_msg_encode(msg,
+						   tnep.current_buff,
+						   &len);
+	} else if (msg && (msg->record_count > 0)) {
 		err = nfc_ndef_msg_encode(msg,
-					  data,
+					  tnep.current_buff,
 					  &len);
 	}
 
-	if (IS_ENABLED(CONFIG_NFC_T4T_NRFXLIB)) {
-		nfc_t4t_ndef_file_encode(tnep.current_buff, &len);
-	}
-
 	key = irq_lock();
 
 	__ASSERT_NO_MSG(tnep.data_set);
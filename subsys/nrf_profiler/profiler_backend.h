@@ -0,0 +1,73 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/* nRF Profiler transport backend private header.
+ *
+ * Profiled events are first stored in a RAM ring buffer and then moved to
+ * the backend by the nRF Profiler thread. Backend functions are called
+ * only from the nRF Profiler thread, or from nrf_profiler_init().
+ */
+
+#ifndef _PROFILER_BACKEND_H_
+#define _PROFILER_BACKEND_H_
+
+#include <stddef.h>
+#include <zephyr/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct nrf_profiler_backend_api {
+	/** Initialize the backend.
+	 *
+	 * @return 0 on success, negative error code otherwise.
+	 */
+	int (*init)(void);
+
+	/** Write a single event without blocking.
+	 *
+	 * An event is either written as a whole or not written at all.
+	 *
+	 * @return True if the event was written, false if there is no space in
+	 *         the backend at the moment.
+	 */
+	bool (*data_write)(const uint8_t *data, size_t len);
+
+	/** Start a new description of the event types.
+	 *
+	 * Optional, called before the event type descriptions are written.
+	 */
+	void (*info_start)(void);
+
+	/** Write a part of the event type descriptions.
+	 *
+	 * This function is allowed to block.
+	 *
+	 * @return 0 on success, negative error code otherwise.
+	 */
+	int (*info_write)(const char *data, size_t len);
+
+	/** Read a command from the host without blocking.
+	 *
+	 * Optional, backends without a command channel are expected to
+	 * be used with @kconfig{CONFIG_NRF_PROFILER_NORDIC_START_LOGGING_ON_SYSTEM_START}.
+	 * Event type descriptions are then sent every time a new event type is
+	 * registered.
+	 *
+	 * @return True if a command was read, false otherwise.
+	 */
+	bool (*command_read)(uint8_t *command);
+};
+
+/** Backend selected with the Kconfig choice. */
+extern const struct nrf_profiler_backend_api nrf_profiler_backend;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _PROFILER_BACKEND_H_ */
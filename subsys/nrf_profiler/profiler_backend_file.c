@@ -0,0 +1,63 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdio.h>
+#include <zephyr/kernel.h>
+#include "profiler_backend.h"
+
+/* The native build uses the host C library, so the nRF Profiler data can be
+ * written directly to files on the host.
+ */
+static FILE *data_file;
+static FILE *info_file;
+
+static int file_init(void)
+{
+	data_file = fopen(CONFIG_NRF_PROFILER_NORDIC_FILE_DATA_PATH, "wb");
+	if (!data_file) {
+		return -EIO;
+	}
+
+	info_file = fopen(CONFIG_NRF_PROFILER_NORDIC_FILE_INFO_PATH, "w");
+	if (!info_file) {
+		fclose(data_file);
+		data_file = NULL;
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static bool file_data_write(const uint8_t *data, size_t len)
+{
+	if (fwrite(data, 1, len, data_file) != len) {
+		return false;
+	}
+
+	return (fflush(data_file) == 0);
+}
+
+static void file_info_start(void)
+{
+	/* Descriptions are rewritten as a whole every time. */
+	info_file = freopen(CONFIG_NRF_PROFILER_NORDIC_FILE_INFO_PATH, "w", info_file);
+}
+
+static int file_info_write(const char *data, size_t len)
+{
+	if (!info_file || (fwrite(data, 1, len, info_file) != len)) {
+		return -EIO;
+	}
+
+	return (fflush(info_file) == 0) ? 0 : -EIO;
+}
+
+const struct nrf_profiler_backend_api nrf_profiler_backend = {
+	.init = file_init,
+	.data_write = file_data_write,
+	.info_start = file_info_start,
+	.info_write = file_info_write,
+};
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/uart.h>
+#include "profiler_backend.h"
+
+/* UART device used to send the nRF Profiler data. Event type descriptions and
+ * events share the same stream, so the host requests the descriptions while
+ * the logging is stopped.
+ */
+static const struct device *uart_dev = DEVICE_DT_GET(DT_CHOSEN(ncs_nrf_profiler_uart));
+
+static void uart_write(const uint8_t *data, size_t len)
+{
+	for (size_t i = 0; i < len; i++) {
+		uart_poll_out(uart_dev, data[i]);
+	}
+}
+
+static int uart_init(void)
+{
+	if (!device_is_ready(uart_dev)) {
+		return -ENODEV;
+	}
+
+	return 0;
+}
+
+static bool uart_data_write(const uint8_t *data, size_t len)
+{
+	uart_write(data, len);
+
+	return true;
+}
+
+static int uart_info_write(const char *data, size_t len)
+{
+	uart_write((const uint8_t *)data, len);
+
+	return 0;
+}
+
+static bool uart_command_read(uint8_t *command)
+{
+	return (uart_poll_in(uart_dev, command) == 0);
+}
+
+const struct nrf_profiler_backend_api nrf_profiler_backend = {
+	.init = uart_init,
+	.data_write = uart_data_write,
+	.info_write = uart_info_write,
+	.command_read = uart_command_read,
+};
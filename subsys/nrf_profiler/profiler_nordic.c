@@ -8,11 +8,11 @@
 #include <zephyr/kernel_structs.h>
 #include <zephyr/sys/util.h>
 #include <zephyr/sys/byteorder.h>
+#include <zephyr/sys/barrier.h>
 #include <zephyr/kernel.h>
-#include <SEGGER_RTT.h>
 #include <nrf_profiler.h>
 #include <string.h>
-#include <nrfx.h>
+#include "profiler_backend.h"
 
 
 enum state {
@@ -26,9 +26,10 @@ enum state {
 struct nrf_profiler_event_enabled_bm _nrf_profiler_event_enabled_bm;
 
 static K_SEM_DEFINE(nrf_profiler_sem, 0, 1);
+/* Wakes up the nRF Profiler thread when there is something to send. */
+static K_SEM_DEFINE(nrf_profiler_wake_sem, 0, 1);
 static atomic_t nrf_profiler_state;
-static uint16_t fatal_error_event_id;
-static struct k_spinlock lock;
+static uint16_t drop_event_id;
 
 enum nordic_command {
 	NORDIC_COMMAND_START	= 1,
@@ -51,9 +52,130 @@ static char *arg_types_encodings[] = {
 
 uint8_t nrf_profiler_num_events;
 
-static uint8_t buffer_data[CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE];
-static uint8_t buffer_info[CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE];
-static uint8_t buffer_commands[CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE];
+/* Profiled events are stored in a lock-free multi-producer, single-consumer
+ * ring buffer, so that they can be logged from any context without waiting
+ * for the backend. Every event is stored as a record made of a 32-bit header
+ * and the event data padded to a multiple of 4 bytes. A producer reserves
+ * space for the record by moving the head with compare-and-swap, copies
+ * the data and then commits the record by writing its header. The nRF Profiler
+ * thread moves the committed records to the backend in order, clears them and
+ * moves the tail. If a record does not fit before the end of the buffer,
+ * the remaining space is filled with a padding record.
+ */
+#define RING_SIZE CONFIG_NRF_PROFILER_NORDIC_RING_BUFFER_SIZE
+#define RING_MASK (RING_SIZE - 1)
+
+#define RECORD_HDR_SIZE sizeof(uint32_t)
+#define RECORD_HDR_COMMITTED BIT(0)
+#define RECORD_HDR_PADDING BIT(1)
+#define RECORD_HDR_LEN_POS 2
+#define RECORD_SIZE(len) (RECORD_HDR_SIZE + ROUND_UP(len, sizeof(uint32_t)))
+
+BUILD_ASSERT(IS_POWER_OF_TWO(RING_SIZE), "Ring buffer size must be a power of two");
+BUILD_ASSERT(RING_SIZE >= 2 * RECORD_SIZE(CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN),
+	     "Ring buffer must fit at least two events of maximum length");
+
+static uint8_t ring_buf[RING_SIZE] __aligned(sizeof(uint32_t));
+static atomic_t ring_head;
+static atomic_t ring_tail;
+static atomic_t dropped_cnt;
+
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+/* In the compact encoding, the timestamp is sent as the unsigned LEB128
+ * varint of the difference from the timestamp of the previous event, and
+ * 32-bit values as the zigzag varint of the difference from the previous
+ * 32-bit value at the same data field index. The first field of Application
+ * Event Manager events is the event address, so it is predicted well.
+ * Other values are sent as varints (16-bit) or unchanged (8-bit and strings).
+ * The encoding is done in the stream order when the events are moved from
+ * the ring buffer to the backend. Both sides reset the state after the
+ * _nrf_profiler_compact_encoding_ event, which is sent when the host starts
+ * the logging or reads the descriptions while events are being sent, so that
+ * a host that connects to a running device gets in sync.
+ */
+struct compact_state {
+	uint32_t timestamp;
+	uint32_t value[CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING_MAX_ARGS];
+};
+
+static struct compact_state compact_state;
+static int compact_sync_event_id = -1;
+static bool compact_sync_pending;
+static uint8_t compact_buf[2 * CONFIG_NRF_PROFILER_CUSTOM_EVENT_BUF_LEN];
+static uint8_t event_arg_cnt[NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS];
+static uint8_t event_arg_types[NRF_PROFILER_MAX_NUMBER_OF_APPLICATION_AND_INTERNAL_EVENTS]
+			      [CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING_MAX_ARGS];
+
+static size_t varint_put(uint8_t *out, uint32_t value)
+{
+	size_t len = 0;
+
+	while (value >= BIT(7)) {
+		out[len++] = (value & BIT_MASK(7)) | BIT(7);
+		value >>= 7;
+	}
+	out[len++] = value;
+
+	return len;
+}
+
+static uint32_t zigzag(int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static size_t compact_encode(const uint8_t *data, struct compact_state *state)
+{
+	uint8_t id = data[0];
+	uint32_t timestamp = sys_get_le32(&data[1]);
+	size_t pos = sizeof(uint8_t) + sizeof(uint32_t);
+	size_t len = 0;
+
+	compact_buf[len++] = id;
+	len += varint_put(&compact_buf[len], timestamp - state->timestamp);
+	state->timestamp = timestamp;
+
+	for (size_t t = 0; t < event_arg_cnt[id]; t++) {
+		uint32_t value;
+
+		switch (event_arg_types[id][t]) {
+		case NRF_PROFILER_ARG_U32:
+		case NRF_PROFILER_ARG_S32:
+		case NRF_PROFILER_ARG_TIMESTAMP:
+			value = sys_get_le32(&data[pos]);
+			pos += sizeof(uint32_t);
+			len += varint_put(&compact_buf[len],
+					  zigzag((int32_t)(value - state->value[t])));
+			state->value[t] = value;
+			break;
+		case NRF_PROFILER_ARG_U16:
+			len += varint_put(&compact_buf[len], sys_get_le16(&data[pos]));
+			pos += sizeof(uint16_t);
+			break;
+		case NRF_PROFILER_ARG_S16:
+			len += varint_put(&compact_buf[len],
+					  zigzag((int16_t)sys_get_le16(&data[pos])));
+			pos += sizeof(uint16_t);
+			break;
+		case NRF_PROFILER_ARG_U8:
+		case NRF_PROFILER_ARG_S8:
+			compact_buf[len++] = data[pos++];
+			break;
+		case NRF_PROFILER_ARG_STRING:
+			/* Length byte followed by the characters. */
+			memcpy(&compact_buf[len], &data[pos], data[pos] + 1);
+			len += data[pos] + 1;
+			pos += data[pos] + 1;
+			break;
+		default:
+			__ASSERT_NO_MSG(false);
+			break;
+		}
+	}
+
+	return len;
+}
+#endif /* CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING */
 
 static k_tid_t protocol_thread_id;
 
@@ -61,48 +183,180 @@ static K_THREAD_STACK_DEFINE(nrf_profiler_nordic_stack,
 			     CONFIG_NRF_PROFILER_NORDIC_STACK_SIZE);
 static struct k_thread nrf_profiler_nordic_thread;
 
-static int send_info_data(const char *data, size_t data_len)
+static void ring_record_commit(uint32_t off, uint32_t len, uint32_t flags)
+{
+	/* Make sure that the record data is visible before the header. */
+	barrier_dmem_fence_full();
+	*(volatile uint32_t *)&ring_buf[off] =
+		(len << RECORD_HDR_LEN_POS) | flags | RECORD_HDR_COMMITTED;
+}
+
+static bool ring_put(const uint8_t *data, size_t len)
 {
-	uint8_t retry_cnt = 0;
-	static const uint8_t retry_cnt_max = 100;
-
-	size_t num_bytes_send;
-
-	num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  data, data_len);
-
-	while (num_bytes_send != data_len) {
-		/* Give host time to read the data and free some space
-		 * in the buffer. */
-		k_sleep(K_MSEC(100));
-		num_bytes_send = SEGGER_RTT_WriteNoLock(
-				  CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-				  data, data_len);
-
-		/* Avoid being blocked in while loop if host does not read
-		 * the RTT data.
-		 */
-		retry_cnt++;
-		if (retry_cnt > retry_cnt_max) {
-			return -ENOBUFS;
+	uint32_t size = RECORD_SIZE(len);
+	uint32_t head;
+	uint32_t tail;
+	uint32_t off;
+	uint32_t pad;
+
+	do {
+		/* Tail must be read first, it never gets past the head. */
+		tail = (uint32_t)atomic_get(&ring_tail);
+		head = (uint32_t)atomic_get(&ring_head);
+		off = head & RING_MASK;
+		pad = (RING_SIZE - off < size) ? (RING_SIZE - off) : 0;
+
+		if (head + pad + size - tail > RING_SIZE) {
+			atomic_inc(&dropped_cnt);
+			return false;
 		}
+	} while (!atomic_cas(&ring_head, (atomic_val_t)head,
+			     (atomic_val_t)(uint32_t)(head + pad + size)));
+
+	if (pad) {
+		ring_record_commit(off, pad, RECORD_HDR_PADDING);
+		off = 0;
 	}
 
-	return 0;
+	memcpy(&ring_buf[off + RECORD_HDR_SIZE], data, len);
+	ring_record_commit(off, len, 0);
+
+	if (head == tail) {
+		/* The thread only waits for new records when the ring buffer is empty. */
+		k_sem_give(&nrf_profiler_wake_sem);
+	}
+
+	return true;
+}
+
+static bool record_write(const uint8_t *data, size_t len)
+{
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+	struct compact_state state = compact_state;
+
+	len = compact_encode(data, &state);
+	if (!nrf_profiler_backend.data_write(compact_buf, len)) {
+		return false;
+	}
+
+	/* Differences are calculated from the last event received by the host. */
+	if (data[0] == compact_sync_event_id) {
+		memset(&compact_state, 0, sizeof(compact_state));
+	} else {
+		compact_state = state;
+	}
+	return true;
+#else
+	return nrf_profiler_backend.data_write(data, len);
+#endif
+}
+
+static void ring_flush(void)
+{
+	uint32_t tail = (uint32_t)atomic_get(&ring_tail);
+
+	while (tail != (uint32_t)atomic_get(&ring_head)) {
+		uint32_t off = tail & RING_MASK;
+		uint32_t hdr = *(volatile uint32_t *)&ring_buf[off];
+		uint32_t len = hdr >> RECORD_HDR_LEN_POS;
+		uint32_t size;
+
+		if (!(hdr & RECORD_HDR_COMMITTED)) {
+			/* The producer has not finished writing the record yet. */
+			break;
+		}
+
+		/* Make sure that the record data is read after the header. */
+		barrier_dmem_fence_full();
+
+		if (hdr & RECORD_HDR_PADDING) {
+			size = len;
+		} else {
+			if (!record_write(&ring_buf[off + RECORD_HDR_SIZE], len)) {
+				/* Retry when the backend frees some space. */
+				break;
+			}
+			size = RECORD_SIZE(len);
+		}
+
+		/* Producers expect the uncommitted records to have zero headers. */
+		memset(&ring_buf[off], 0, size);
+		barrier_dmem_fence_full();
+
+		tail += size;
+		atomic_set(&ring_tail, (atomic_val_t)tail);
+	}
+}
+
+static void report_dropped(void)
+{
+	static uint32_t reported_cnt;
+	uint32_t cnt = (uint32_t)atomic_get(&dropped_cnt);
+	struct log_event_buf buf;
+
+	if ((cnt == reported_cnt) || (atomic_get(&nrf_profiler_state) != STATE_ACTIVE)) {
+		return;
+	}
+
+	nrf_profiler_log_start(&buf);
+	nrf_profiler_log_encode_uint32(&buf, cnt);
+	buf.payload_start[0] = (uint8_t)drop_event_id;
+
+	if (ring_put(buf.payload_start, buf.payload - buf.payload_start)) {
+		reported_cnt = cnt;
+	}
+}
+
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+static void compact_sync(void)
+{
+	if (atomic_get(&nrf_profiler_state) == STATE_ACTIVE) {
+		/* The state is reset in the stream order, after the sync event. */
+		compact_sync_pending = true;
+	} else {
+		/* The host starts decoding from the first event after the START command. */
+		ring_flush();
+		memset(&compact_state, 0, sizeof(compact_state));
+	}
+}
+
+static void compact_sync_send(void)
+{
+	struct log_event_buf buf;
+
+	if (!compact_sync_pending) {
+		return;
+	}
+
+	nrf_profiler_log_start(&buf);
+	buf.payload_start[0] = (uint8_t)compact_sync_event_id;
+
+	if (ring_put(buf.payload_start, buf.payload - buf.payload_start)) {
+		compact_sync_pending = false;
+	}
+}
+#endif /* CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING */
+
+static int send_info_data(const char *data, size_t data_len)
+{
+	return nrf_profiler_backend.info_write(data, data_len);
 }
 
 static void send_system_description(void)
 {
+	uint8_t ne = nrf_profiler_num_events;
+
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
-	uint8_t ne = nrf_profiler_num_events;
-
-	__DMB();
+	barrier_dmem_fence_full();
 	char end_line = '\n';
 	int err = 0;
 
+	if (nrf_profiler_backend.info_start) {
+		nrf_profiler_backend.info_start();
+	}
+
 	for (size_t t = 0; ((t < ne) && !err); t++) {
 		err = send_info_data(descr[t], strlen(descr[t]));
 		if (!err) {
@@ -114,33 +368,68 @@ static void send_system_description(void)
 	}
 }
 
+static void handle_command(enum nordic_command command)
+{
+	switch (command) {
+	case NORDIC_COMMAND_START:
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+		compact_sync();
+#endif
+		atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE);
+		break;
+	case NORDIC_COMMAND_STOP:
+		atomic_cas(&nrf_profiler_state, STATE_ACTIVE, STATE_INACTIVE);
+		break;
+	case NORDIC_COMMAND_INFO:
+		send_system_description();
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+		compact_sync();
+#endif
+		break;
+	default:
+		__ASSERT_NO_MSG(false);
+		break;
+	}
+}
+
 static void nrf_profiler_nordic_thread_fn(void)
 {
+	uint8_t described_events = 0;
+
 	while (atomic_get(&nrf_profiler_state) != STATE_TERMINATED) {
 		uint8_t read_data;
-		enum nordic_command command;
-
-		if (SEGGER_RTT_Read(
-		     CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		     &read_data, sizeof(read_data))) {
-			command = (enum nordic_command)read_data;
-			switch (command) {
-			case NORDIC_COMMAND_START:
-				atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE);
-				break;
-			case NORDIC_COMMAND_STOP:
-				atomic_cas(&nrf_profiler_state, STATE_ACTIVE, STATE_INACTIVE);
-				break;
-			case NORDIC_COMMAND_INFO:
-				send_system_description();
-				break;
-			default:
-				__ASSERT_NO_MSG(false);
-				break;
+		k_timeout_t timeout;
+
+		if (nrf_profiler_backend.command_read) {
+			if (nrf_profiler_backend.command_read(&read_data)) {
+				handle_command((enum nordic_command)read_data);
 			}
+		} else if (described_events != nrf_profiler_num_events) {
+			/* No host commands, describe every newly registered event type. */
+			described_events = nrf_profiler_num_events;
+			send_system_description();
 		}
-		k_sleep(K_MSEC(500));
+
+		report_dropped();
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+		compact_sync_send();
+#endif
+		ring_flush();
+
+		if (atomic_get(&ring_tail) != atomic_get(&ring_head)) {
+			/* A record is being written, or the backend is full. */
+			timeout = K_MSEC(CONFIG_NRF_PROFILER_NORDIC_FLUSH_PERIOD);
+		} else if (nrf_profiler_backend.command_read) {
+			/* The backends do not signal the host commands. */
+			timeout = K_MSEC(CONFIG_NRF_PROFILER_NORDIC_COMMAND_POLL_PERIOD);
+		} else {
+			timeout = K_FOREVER;
+		}
+
+		(void)k_sem_take(&nrf_profiler_wake_sem, timeout);
 	}
+
+	ring_flush();
 	k_sem_give(&nrf_profiler_sem);
 }
 
@@ -164,31 +453,13 @@ int nrf_profiler_init(void)
 		atomic_cas(&nrf_profiler_state, STATE_INACTIVE, STATE_ACTIVE);
 	}
 
-	int ret;
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-		"Nordic nrf_profiler data",
-		buffer_data,
-		CONFIG_NRF_PROFILER_NORDIC_DATA_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigUpBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_INFO,
-		"Nordic nrf_profiler info",
-		buffer_info,
-		CONFIG_NRF_PROFILER_NORDIC_INFO_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
-
-	ret = SEGGER_RTT_ConfigDownBuffer(
-		CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_COMMANDS,
-		"Nordic nrf_profiler command",
-		buffer_commands,
-		CONFIG_NRF_PROFILER_NORDIC_COMMAND_BUFFER_SIZE,
-		SEGGER_RTT_MODE_NO_BLOCK_SKIP);
-	__ASSERT_NO_MSG(ret >= 0);
+	int ret = nrf_profiler_backend.init();
+
+	if (ret) {
+		atomic_set(&nrf_profiler_state, STATE_DISABLED);
+		k_sched_unlock();
+		return ret;
+	}
 
 	protocol_thread_id =  k_thread_create(&nrf_profiler_nordic_thread,
 			nrf_profiler_nordic_stack,
@@ -197,9 +468,21 @@ int nrf_profiler_init(void)
 			NULL, NULL, NULL,
 			CONFIG_NRF_PROFILER_NORDIC_THREAD_PRIORITY, 0, K_NO_WAIT);
 
-	/* Registering fatal error event */
-	fatal_error_event_id = nrf_profiler_register_event_type("_nrf_profiler_fatal_error_event_",
-							    NULL, NULL, 0);
+	/* Registering dropped events report */
+	static const char * const drop_event_args[] = {"dropped"};
+	static const enum nrf_profiler_arg drop_event_types[] = {NRF_PROFILER_ARG_U32};
+
+	drop_event_id = nrf_profiler_register_event_type("_nrf_profiler_drop_event_",
+							 drop_event_args, drop_event_types,
+							 ARRAY_SIZE(drop_event_args));
+
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+	/* Informs the host that the events use the compact encoding. The event is
+	 * also sent to reset the encoding state.
+	 */
+	compact_sync_event_id = nrf_profiler_register_event_type("_nrf_profiler_compact_encoding_",
+								 NULL, NULL, 0);
+#endif
 
 	k_sched_unlock();
 	return 0;
@@ -212,7 +495,7 @@ void nrf_profiler_term(void)
 		return;
 	}
 
-	k_wakeup(protocol_thread_id);
+	k_sem_give(&nrf_profiler_wake_sem);
 	k_sem_take(&nrf_profiler_sem, K_FOREVER);
 }
 
@@ -259,13 +542,25 @@ uint16_t nrf_profiler_register_event_type(const char *name, const char * const *
 		  (pos < CONFIG_NRF_PROFILER_MAX_LENGTH_OF_CUSTOM_EVENTS_DESCRIPTIONS)
 		   && (temp > 0));
 	}
+
+#if defined(CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING)
+	__ASSERT_NO_MSG(arg_cnt <= CONFIG_NRF_PROFILER_NORDIC_COMPACT_ENCODING_MAX_ARGS);
+	event_arg_cnt[ne] = arg_cnt;
+	for (size_t t = 0; t < arg_cnt; t++) {
+		event_arg_types[ne][t] = arg_types[t];
+	}
+#endif
+
 	/* Memory barrier to make sure that data is visible
 	 * before being accessed
 	 */
-	__DMB();
+	barrier_dmem_fence_full();
 	nrf_profiler_num_events++;
 	k_sched_unlock();
 
+	/* Without host commands, the thread describes the new event type. */
+	k_sem_give(&nrf_profiler_wake_sem);
+
 	return ne;
 }
 
@@ -340,29 +635,9 @@ void nrf_profiler_log_add_mem_address(struct log_event_buf *buf,
 	nrf_profiler_log_encode_uint32(buf, (uint32_t)mem_address);
 }
 
-static bool nrf_profiler_RTT_send(struct log_event_buf *buf, uint8_t type_id)
-{
-	buf->payload_start[0] = type_id;
-	size_t data_len = buf->payload - buf->payload_start;
-
-	size_t num_bytes_send = SEGGER_RTT_WriteNoLock(
-			CONFIG_NRF_PROFILER_NORDIC_RTT_CHANNEL_DATA,
-			buf->payload_start, data_len);
-	return (num_bytes_send == data_len);
-}
-
-static void nrf_profiler_fatal_error(void)
+uint32_t nrf_profiler_dropped_count_get(void)
 {
-	struct log_event_buf buf;
-
-	nrf_profiler_log_start(&buf);
-	while (true) {
-		/* Sending Fatal Error event */
-		if (nrf_profiler_RTT_send(&buf, (uint8_t)fatal_error_event_id)) {
-			break;
-		}
-	}
-	k_oops();
+	return (uint32_t)atomic_get(&dropped_cnt);
 }
 
 void nrf_profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
@@ -370,13 +645,7 @@ void nrf_profiler_log_send(struct log_event_buf *buf, uint16_t event_type_id)
 	__ASSERT_NO_MSG(event_type_id <= UINT8_MAX);
 
 	if (atomic_get(&nrf_profiler_state) == STATE_ACTIVE) {
-		uint8_t type_id = event_type_id & UINT8_MAX;
-
-		k_spinlock_key_t key = k_spin_lock(&lock);
-
-		if (!nrf_profiler_RTT_send(buf, type_id)) {
-			nrf_profiler_fatal_error();
-		}
-		k_spin_unlock(&lock, key);
+		buf->payload_start[0] = event_type_id & UINT8_MAX;
+		(void)ring_put(buf->payload_start, buf->payload - buf->payload_start);
 	}
 }
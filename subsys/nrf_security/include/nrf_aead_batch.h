@@ -0,0 +1,112 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file nrf_aead_batch.h
+ *
+ * @brief Batched AEAD operations on many small messages with a single key.
+ *
+ * The key is looked up and its policy checked once for the whole batch. When
+ * the driver allows it, the key schedule is also computed once and reused for
+ * every message, which makes a difference for short messages such as TLS
+ * records, Thread frames or Mesh PDUs. The input of each message and its
+ * additional data are given as lists of buffers, so that fragmented messages
+ * do not have to be copied into a contiguous buffer first.
+ */
+
+#ifndef NRF_AEAD_BATCH_H__
+#define NRF_AEAD_BATCH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <psa/crypto.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief A fragment of the input of a message. */
+struct nrf_aead_iovec {
+	/** Pointer to the fragment. */
+	const uint8_t *base;
+	/** Length of the fragment. */
+	size_t len;
+};
+
+/** @brief One message of a batch. */
+struct nrf_aead_batch_msg {
+	/** Nonce of the message. */
+	const uint8_t *nonce;
+	size_t nonce_length;
+	/** Fragments of the additional data, processed in order. */
+	const struct nrf_aead_iovec *ad;
+	size_t ad_count;
+	/** Fragments of the input, processed in order.
+	 *
+	 * The input is the plaintext when encrypting, and the ciphertext
+	 * followed by the tag when decrypting, as for psa_aead_encrypt() and
+	 * psa_aead_decrypt(). The tag may be split across fragments.
+	 */
+	const struct nrf_aead_iovec *input;
+	size_t input_count;
+	/** Output buffer, the ciphertext followed by the tag when encrypting,
+	 *  or the plaintext when decrypting.
+	 */
+	uint8_t *output;
+	size_t output_size;
+	/** Set to the number of bytes written to @c output. */
+	size_t output_length;
+	/** Set to the result of the operation on this message. */
+	psa_status_t status;
+};
+
+/**
+ * @brief Encrypt and authenticate a batch of messages with the same key.
+ *
+ * All messages are processed, even if some of them fail. The result of each
+ * message is stored in its @c status field, and the output of a failed
+ * message is cleared.
+ *
+ * @param[in] key		Identifier of the key, with the
+ *				#PSA_KEY_USAGE_ENCRYPT usage flag.
+ * @param[in] alg		AEAD algorithm to use.
+ * @param[in,out] msgs		Messages to process.
+ * @param[in] msg_count		Number of messages.
+ *
+ * @retval PSA_SUCCESS If all messages were processed successfully.
+ * @return The status of the first failed message, or an error from the
+ *	   key lookup or the driver setup, in which case no message is
+ *	   processed.
+ */
+psa_status_t nrf_aead_encrypt_batch(mbedtls_svc_key_id_t key, psa_algorithm_t alg,
+				    struct nrf_aead_batch_msg *msgs, size_t msg_count);
+
+/**
+ * @brief Authenticate and decrypt a batch of messages with the same key.
+ *
+ * All messages are processed, even if some of them fail. The result of each
+ * message is stored in its @c status field, #PSA_ERROR_INVALID_SIGNATURE if
+ * the message is not authentic, and the output of a failed message is cleared.
+ *
+ * @param[in] key		Identifier of the key, with the
+ *				#PSA_KEY_USAGE_DECRYPT usage flag.
+ * @param[in] alg		AEAD algorithm to use.
+ * @param[in,out] msgs		Messages to process.
+ * @param[in] msg_count		Number of messages.
+ *
+ * @retval PSA_SUCCESS If all messages were processed successfully.
+ * @return The status of the first failed message, or an error from the
+ *	   key lookup or the driver setup, in which case no message is
+ *	   processed.
+ */
+psa_status_t nrf_aead_decrypt_batch(mbedtls_svc_key_id_t key, psa_algorithm_t alg,
+				    struct nrf_aead_batch_msg *msgs, size_t msg_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_AEAD_BATCH_H__ */
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/** @file nrf_mbedtls_heap.h
+ *
+ * @brief Arena allocator for the mbed TLS heap.
+ *
+ * The heap is split in pages. Allocations up to half a page are served from
+ * pages holding blocks of a single size class, larger allocations take a run
+ * of whole pages. Every page belongs to an arena: the shared arena, or an
+ * arena created for a context such as a TLS connection. Allocations made by a
+ * thread go to the arena that the thread has entered, so that concurrent
+ * handshakes do not interleave their blocks, and everything allocated in an
+ * arena can be released at once.
+ */
+
+#ifndef NRF_MBEDTLS_HEAP_H__
+#define NRF_MBEDTLS_HEAP_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @brief Identifier of the shared arena, used by threads in no other arena. */
+#define NRF_MBEDTLS_HEAP_ARENA_SHARED 0
+
+/** @brief Heap statistics. */
+struct nrf_mbedtls_heap_stats {
+	/** Bytes in live allocations, rounded up to the size class or to pages. */
+	size_t used;
+	/** Highest value of @c used since initialization or the last reset. */
+	size_t peak;
+	/** Size of the largest run of free pages, for the whole heap. */
+	size_t largest_free;
+	/** Number of live allocations. */
+	uint32_t allocs;
+	/** Number of allocations that failed since initialization or the last reset. */
+	uint32_t failures;
+	/** Percentage of the free memory of the whole heap that is not in the
+	 *  largest run of free pages.
+	 */
+	uint8_t fragmentation;
+};
+
+/**
+ * @brief Initialize the heap and install it as the mbed TLS allocator.
+ *
+ * This is done at boot. Calling it again discards all allocations and arenas.
+ *
+ * @param buf  Memory for the heap.
+ * @param size Size of @p buf, at most CONFIG_MBEDTLS_HEAP_SIZE.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if @p size is too small or too large.
+ */
+int nrf_mbedtls_heap_init(void *buf, size_t size);
+
+/**
+ * @brief Create an arena.
+ *
+ * @return Identifier of the arena, or -ENOMEM if all arenas are in use.
+ */
+int nrf_mbedtls_heap_arena_create(void);
+
+/**
+ * @brief Make the calling thread allocate from an arena.
+ *
+ * An arena can be entered by one thread at a time. Memory can be freed by any
+ * thread, whichever arena it has entered.
+ *
+ * @param arena Identifier of the arena.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the arena does not exist.
+ * @retval -EBUSY if another thread is in the arena.
+ */
+int nrf_mbedtls_heap_arena_enter(int arena);
+
+/**
+ * @brief Make the calling thread allocate from the shared arena again.
+ */
+void nrf_mbedtls_heap_arena_exit(void);
+
+/**
+ * @brief Free everything allocated in an arena and delete the arena.
+ *
+ * The released memory is cleared. Nothing allocated in the arena may be used or
+ * freed afterwards, so a TLS context that allocated in the arena must not be
+ * used again, except to initialize it again. This makes it possible to drop a
+ * failed handshake without unwinding it.
+ *
+ * Freeing memory that is not allocated causes a kernel panic. This catches a
+ * later free of memory of the arena, unless the memory was allocated again in
+ * the meantime.
+ *
+ * @param arena Identifier of the arena.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the arena does not exist.
+ */
+int nrf_mbedtls_heap_arena_release(int arena);
+
+/**
+ * @brief Get the statistics of the whole heap.
+ *
+ * @param[out] stats Statistics.
+ */
+void nrf_mbedtls_heap_stats_get(struct nrf_mbedtls_heap_stats *stats);
+
+/**
+ * @brief Get the statistics of an arena.
+ *
+ * The @c largest_free and @c fragmentation fields are those of the whole heap.
+ *
+ * @param arena      Identifier of the arena.
+ * @param[out] stats Statistics.
+ *
+ * @retval 0 on success.
+ * @retval -EINVAL if the arena does not exist.
+ */
+int nrf_mbedtls_heap_arena_stats_get(int arena, struct nrf_mbedtls_heap_stats *stats);
+
+/**
+ * @brief Reset the peak usage to the current usage and clear the failure count,
+ *        for the heap and all arenas.
+ */
+void nrf_mbedtls_heap_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NRF_MBEDTLS_HEAP_H__ */
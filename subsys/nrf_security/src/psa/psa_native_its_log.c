@@ -0,0 +1,853 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+/*
+ * Native ITS backend storing the entries in an append-only log in a flash
+ * partition, with an index of the entries in RAM.
+ *
+ * The partition is split into sectors, used as a ring. Each sector starts with
+ * a header holding a sequence number, followed by records. A record is made of
+ * a header and the data of an entry. Setting an entry appends a record, and
+ * removing an entry appends a record without data. The index maps the uid of
+ * each entry to its latest record and is sorted by uid, so getting the info of
+ * an entry does not access the flash, and getting its data is a single read.
+ *
+ * One sector is always kept erased. When the log needs more space, the records
+ * of the oldest sector that are still in use are copied to the end of the log,
+ * and the oldest sector is erased.
+ */
+#include <stddef.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/init.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/storage/flash_map.h>
+#include <zephyr/sys/crc.h>
+#include <zephyr/sys/util.h>
+
+#include "psa_native_its_backend.h"
+#include "psa_native_its_log.h"
+
+LOG_MODULE_REGISTER(psa_native_its_log, CONFIG_PSA_NATIVE_ITS_BACKEND_LOG_LOG_LEVEL);
+
+#define ITS_PARTITION_ID FIXED_PARTITION_ID(psa_its_storage)
+
+#define SECTOR_MAGIC 0x5354494e
+/* The headers are aligned to this size, larger write blocks are not supported. */
+#define WRITE_BLOCK_MAX_SIZE 8
+#define READ_BUFF_SIZE 64
+
+struct sector_header {
+	uint32_t magic;
+	uint32_t seq;
+};
+
+struct record_header {
+	psa_storage_uid_t uid;
+	/* Size of the data, 0 when the entry is removed. */
+	uint32_t size;
+	psa_storage_create_flags_t flags;
+	/* CRC-32 of the fields above and of the data. */
+	uint32_t crc;
+	uint32_t reserved;
+};
+
+BUILD_ASSERT(sizeof(struct sector_header) % WRITE_BLOCK_MAX_SIZE == 0);
+BUILD_ASSERT(sizeof(struct record_header) % WRITE_BLOCK_MAX_SIZE == 0);
+
+struct index_entry {
+	psa_storage_uid_t uid;
+	/* Offset of the record in the partition. */
+	uint32_t offset;
+	uint32_t size;
+	psa_storage_create_flags_t flags;
+};
+
+static const struct flash_area *fa;
+static uint32_t write_block_size;
+static uint8_t erased_val;
+static uint32_t sector_size;
+static uint32_t sector_count;
+
+/* Oldest sector in use. */
+static uint32_t tail;
+/* Sector where records are appended. */
+static uint32_t head;
+static uint32_t head_seq;
+/* Offset of the next record in the head sector. */
+static uint32_t write_offset;
+
+static struct index_entry entries[CONFIG_PSA_NATIVE_ITS_LOG_MAX_ENTRIES];
+static size_t entry_count;
+
+static bool initialized;
+static K_MUTEX_DEFINE(its_lock);
+
+static int log_load(void);
+
+static uint32_t record_size(uint32_t data_size)
+{
+	return sizeof(struct record_header) + ROUND_UP(data_size, write_block_size);
+}
+
+static uint32_t sector_offset(uint32_t sector)
+{
+	return sector * sector_size;
+}
+
+static uint32_t sector_next(uint32_t sector)
+{
+	return (sector + 1) % sector_count;
+}
+
+static uint32_t sector_prev(uint32_t sector)
+{
+	return (sector + sector_count - 1) % sector_count;
+}
+
+static uint32_t free_sector_count(void)
+{
+	return sector_count - ((head + sector_count - tail) % sector_count + 1);
+}
+
+static struct index_entry *entry_find(psa_storage_uid_t uid, size_t *pos)
+{
+	size_t lo = 0;
+	size_t hi = entry_count;
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (entries[mid].uid < uid) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (pos != NULL) {
+		*pos = lo;
+	}
+
+	if (lo < entry_count && entries[lo].uid == uid) {
+		return &entries[lo];
+	}
+
+	return NULL;
+}
+
+static int entry_update(const struct record_header *hdr, uint32_t offset)
+{
+	size_t pos;
+	struct index_entry *entry = entry_find(hdr->uid, &pos);
+
+	if (hdr->size == 0) {
+		if (entry != NULL) {
+			memmove(&entries[pos], &entries[pos + 1],
+				(entry_count - pos - 1) * sizeof(entries[0]));
+			entry_count--;
+		}
+
+		return 0;
+	}
+
+	if (entry == NULL) {
+		if (entry_count == ARRAY_SIZE(entries)) {
+			return -ENOMEM;
+		}
+
+		memmove(&entries[pos + 1], &entries[pos], (entry_count - pos) * sizeof(entries[0]));
+		entry_count++;
+
+		entry = &entries[pos];
+		entry->uid = hdr->uid;
+	}
+
+	entry->offset = offset;
+	entry->size = hdr->size;
+	entry->flags = hdr->flags;
+
+	return 0;
+}
+
+static uint32_t record_crc(const struct record_header *hdr)
+{
+	return crc32_ieee((const uint8_t *)hdr, offsetof(struct record_header, crc));
+}
+
+static int sector_is_erased(uint32_t sector, bool *erased)
+{
+	int err;
+	uint8_t buff[READ_BUFF_SIZE];
+
+	for (uint32_t offset = 0; offset < sector_size; offset += sizeof(buff)) {
+		size_t len = MIN(sizeof(buff), sector_size - offset);
+
+		err = flash_area_read(fa, sector_offset(sector) + offset, buff, len);
+		if (err) {
+			return err;
+		}
+
+		for (size_t i = 0; i < len; i++) {
+			if (buff[i] != erased_val) {
+				*erased = false;
+				return 0;
+			}
+		}
+	}
+
+	*erased = true;
+
+	return 0;
+}
+
+static int sector_erase(uint32_t sector)
+{
+	return flash_area_erase(fa, sector_offset(sector), sector_size);
+}
+
+static int sector_header_read(uint32_t sector, struct sector_header *hdr, bool *valid)
+{
+	int err;
+
+	err = flash_area_read(fa, sector_offset(sector), hdr, sizeof(*hdr));
+	if (err) {
+		return err;
+	}
+
+	*valid = (hdr->magic == SECTOR_MAGIC);
+
+	return 0;
+}
+
+static int sector_open(uint32_t sector, uint32_t seq)
+{
+	int err;
+	bool erased;
+	struct sector_header hdr = {
+		.magic = SECTOR_MAGIC,
+		.seq = seq,
+	};
+
+	/* An interrupted erase can leave a sector that is not in use but not
+	 * erased either.
+	 */
+	err = sector_is_erased(sector, &erased);
+	if (err) {
+		return err;
+	}
+
+	if (!erased) {
+		err = sector_erase(sector);
+		if (err) {
+			return err;
+		}
+	}
+
+	return flash_area_write(fa, sector_offset(sector), &hdr, sizeof(hdr));
+}
+
+static int head_advance(void)
+{
+	int err;
+	uint32_t next = sector_next(head);
+
+	err = sector_open(next, head_seq + 1);
+	if (err) {
+		return err;
+	}
+
+	head = next;
+	head_seq++;
+	write_offset = sizeof(struct sector_header);
+
+	return 0;
+}
+
+/* Make sure that a record of the given size fits at the end of the log. Only
+ * the compaction may use the last erased sector.
+ */
+static int space_reserve(uint32_t len, bool compaction)
+{
+	if (write_offset + len <= sector_size) {
+		return 0;
+	}
+
+	if (free_sector_count() < (compaction ? 1 : 2)) {
+		return -ENOSPC;
+	}
+
+	return head_advance();
+}
+
+static int record_write(uint32_t offset, const struct record_header *hdr, const void *data)
+{
+	int err;
+	uint32_t aligned_size = ROUND_DOWN(hdr->size, write_block_size);
+	uint8_t last_block[WRITE_BLOCK_MAX_SIZE];
+
+	err = flash_area_write(fa, offset, hdr, sizeof(*hdr));
+	if (err) {
+		return err;
+	}
+
+	offset += sizeof(*hdr);
+
+	if (aligned_size != 0) {
+		err = flash_area_write(fa, offset, data, aligned_size);
+		if (err) {
+			return err;
+		}
+
+		offset += aligned_size;
+	}
+
+	if (hdr->size != aligned_size) {
+		memset(last_block, erased_val, write_block_size);
+		memcpy(last_block, (const uint8_t *)data + aligned_size, hdr->size - aligned_size);
+
+		err = flash_area_write(fa, offset, last_block, write_block_size);
+	}
+
+	return err;
+}
+
+/* Copy a record still in use to the end of the log. */
+static int record_copy(struct index_entry *entry)
+{
+	int err;
+	uint32_t len = record_size(entry->size);
+	uint32_t dst;
+	uint8_t buff[READ_BUFF_SIZE];
+
+	err = space_reserve(len, true);
+	if (err) {
+		return err;
+	}
+
+	dst = sector_offset(head) + write_offset;
+
+	for (uint32_t done = 0; done < len; done += sizeof(buff)) {
+		size_t chunk = MIN(sizeof(buff), len - done);
+
+		err = flash_area_read(fa, entry->offset + done, buff, chunk);
+		if (err) {
+			return err;
+		}
+
+		err = flash_area_write(fa, dst + done, buff, chunk);
+		if (err) {
+			write_offset = sector_size;
+			return err;
+		}
+	}
+
+	write_offset += len;
+	entry->offset = dst;
+
+	return 0;
+}
+
+/* Free the oldest sector, copying the records still in use to the end of the
+ * log first.
+ */
+static int compact(void)
+{
+	int err;
+	uint32_t sector = tail;
+	uint32_t start = sector_offset(sector);
+	struct sector_header hdr = { 0 };
+
+	if (tail == head) {
+		err = head_advance();
+		if (err) {
+			return err;
+		}
+	}
+
+	for (size_t i = 0; i < entry_count; i++) {
+		if (entries[i].offset >= start && entries[i].offset < start + sector_size) {
+			err = record_copy(&entries[i]);
+			if (err) {
+				return err;
+			}
+		}
+	}
+
+	/* Invalidate the sector before erasing it, so that an interrupted erase
+	 * cannot leave a sector that looks valid.
+	 */
+	err = flash_area_write(fa, start, &hdr, sizeof(hdr));
+	if (err) {
+		return err;
+	}
+
+	err = sector_erase(sector);
+	if (err) {
+		return err;
+	}
+
+	tail = sector_next(sector);
+
+	LOG_DBG("Compacted sector %u", sector);
+
+	return 0;
+}
+
+/* Build the index again after a compaction that failed with no erased sector
+ * left. At boot, such a log is taken for an interrupted compaction and its head
+ * sector is dropped, together with any record appended to it afterwards, so it
+ * is dropped right away instead. If this fails, nothing is appended until the
+ * storage is initialized again.
+ */
+static void compact_abort(void)
+{
+	int err;
+
+	LOG_WRN("Compaction failed, reloading the storage");
+
+	entry_count = 0;
+
+	err = log_load();
+	if (err) {
+		LOG_ERR("Failed to reload the storage, err: %d", err);
+		initialized = false;
+	}
+}
+
+static int record_append(const struct record_header *hdr, const void *data)
+{
+	int err;
+	uint32_t len = record_size(hdr->size);
+	uint32_t offset;
+
+	if (len > sector_size - sizeof(struct sector_header)) {
+		return -EFBIG;
+	}
+
+	err = space_reserve(len, false);
+
+	for (uint32_t i = 0; err == -ENOSPC && i < sector_count; i++) {
+		err = compact();
+		if (err) {
+			if (free_sector_count() == 0) {
+				compact_abort();
+			}
+
+			return err;
+		}
+
+		err = space_reserve(len, false);
+	}
+
+	if (err) {
+		return err;
+	}
+
+	offset = sector_offset(head) + write_offset;
+
+	err = record_write(offset, hdr, data);
+	if (err) {
+		/* A partly written header hides the records after it when the
+		 * log is loaded, so the rest of the sector is not used.
+		 */
+		write_offset = sector_size;
+		return err;
+	}
+
+	write_offset += len;
+
+	return entry_update(hdr, offset);
+}
+
+static int record_check(uint32_t offset, const struct record_header *hdr, bool *valid)
+{
+	int err;
+	uint32_t crc = record_crc(hdr);
+	uint8_t buff[READ_BUFF_SIZE];
+
+	offset += sizeof(*hdr);
+
+	for (uint32_t done = 0; done < hdr->size; done += sizeof(buff)) {
+		size_t chunk = MIN(sizeof(buff), hdr->size - done);
+
+		err = flash_area_read(fa, offset + done, buff, chunk);
+		if (err) {
+			return err;
+		}
+
+		crc = crc32_ieee_update(crc, buff, chunk);
+	}
+
+	*valid = (crc == hdr->crc);
+
+	return 0;
+}
+
+static bool record_header_is_erased(const struct record_header *hdr)
+{
+	const uint8_t *p = (const uint8_t *)hdr;
+
+	for (size_t i = 0; i < sizeof(*hdr); i++) {
+		if (p[i] != erased_val) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Add the records of a sector to the index, and return the offset after the
+ * last record.
+ */
+static int sector_scan(uint32_t sector, uint32_t *end)
+{
+	int err;
+	uint32_t start = sector_offset(sector);
+	uint32_t offset = sizeof(struct sector_header);
+	struct record_header hdr;
+	bool valid;
+
+	while (offset + sizeof(hdr) <= sector_size) {
+		err = flash_area_read(fa, start + offset, &hdr, sizeof(hdr));
+		if (err) {
+			return err;
+		}
+
+		if (record_header_is_erased(&hdr)) {
+			break;
+		}
+
+		if (hdr.size > sector_size - offset - sizeof(hdr)) {
+			/* The header was not completely written, the rest of
+			 * the sector cannot be used.
+			 */
+			LOG_WRN("Invalid record in sector %u at 0x%x", sector, offset);
+			offset = sector_size;
+			break;
+		}
+
+		/* A record may be incomplete after a power loss. */
+		err = record_check(start + offset, &hdr, &valid);
+		if (err) {
+			return err;
+		}
+
+		if (valid) {
+			err = entry_update(&hdr, start + offset);
+			if (err) {
+				LOG_ERR("Too many entries, increase CONFIG_PSA_NATIVE_ITS_LOG_MAX_ENTRIES");
+				return err;
+			}
+		} else {
+			LOG_WRN("Skipping corrupted record in sector %u at 0x%x", sector, offset);
+		}
+
+		offset += record_size(hdr.size);
+	}
+
+	*end = offset;
+
+	return 0;
+}
+
+static int log_load(void)
+{
+	int err;
+	struct sector_header hdr;
+	bool valid;
+	bool found = false;
+	uint32_t end;
+
+	for (uint32_t sector = 0; sector < sector_count; sector++) {
+		err = sector_header_read(sector, &hdr, &valid);
+		if (err) {
+			return err;
+		}
+
+		if (valid && (!found || (int32_t)(hdr.seq - head_seq) > 0)) {
+			head = sector;
+			head_seq = hdr.seq;
+			found = true;
+		}
+	}
+
+	if (!found) {
+		LOG_INF("Initializing empty storage");
+
+		head = 0;
+		tail = 0;
+		head_seq = 0;
+		write_offset = sizeof(struct sector_header);
+
+		return sector_open(head, head_seq);
+	}
+
+	/* The sectors in use are the ones before the head with consecutive
+	 * sequence numbers.
+	 */
+	tail = head;
+	for (uint32_t i = 1; i < sector_count; i++) {
+		uint32_t prev = sector_prev(tail);
+
+		err = sector_header_read(prev, &hdr, &valid);
+		if (err) {
+			return err;
+		}
+
+		if (!valid || hdr.seq != head_seq - i) {
+			break;
+		}
+
+		tail = prev;
+	}
+
+	/* Only the compaction can use all sectors. If it was interrupted, the
+	 * head sector only holds copies of records of the tail sector, so it
+	 * is dropped and the compaction is done again when needed.
+	 */
+	if (free_sector_count() == 0) {
+		LOG_WRN("Resuming interrupted compaction");
+
+		err = sector_erase(head);
+		if (err) {
+			return err;
+		}
+
+		head = sector_prev(head);
+		head_seq--;
+	}
+
+	for (uint32_t sector = tail;; sector = sector_next(sector)) {
+		err = sector_scan(sector, &end);
+		if (err) {
+			return err;
+		}
+
+		if (sector == head) {
+			break;
+		}
+	}
+
+	write_offset = end;
+
+	LOG_DBG("Loaded %zu entries from %u sectors", entry_count,
+		(head + sector_count - tail) % sector_count + 1);
+
+	return 0;
+}
+
+int psa_native_its_log_init(void)
+{
+	int err;
+	uint32_t count = 1;
+	struct flash_sector sector;
+
+	k_mutex_lock(&its_lock, K_FOREVER);
+
+	initialized = false;
+	entry_count = 0;
+
+	err = flash_area_open(ITS_PARTITION_ID, &fa);
+	if (err) {
+		LOG_ERR("Failed to open the storage partition, err: %d", err);
+		goto exit;
+	}
+
+	err = flash_area_get_sectors(ITS_PARTITION_ID, &count, &sector);
+	if (err && err != -ENOMEM) {
+		LOG_ERR("Failed to get the storage sectors, err: %d", err);
+		goto exit;
+	}
+
+	write_block_size = flash_area_align(fa);
+	erased_val = flash_area_erased_val(fa);
+	sector_size = sector.fs_size;
+	sector_count = fa->fa_size / sector_size;
+
+	if (sector_count < 2 || write_block_size > WRITE_BLOCK_MAX_SIZE ||
+	    !IS_POWER_OF_TWO(write_block_size)) {
+		LOG_ERR("Unsupported storage partition");
+		err = -EINVAL;
+		goto exit;
+	}
+
+	err = log_load();
+	if (err) {
+		LOG_ERR("Failed to load the storage, err: %d", err);
+		goto exit;
+	}
+
+	initialized = true;
+
+exit:
+	k_mutex_unlock(&its_lock);
+
+	return err;
+}
+
+static psa_status_t to_psa_status(int err)
+{
+	switch (err) {
+	case 0:
+		return PSA_SUCCESS;
+	case -ENOSPC:
+	case -EFBIG:
+		return PSA_ERROR_INSUFFICIENT_STORAGE;
+	default:
+		return PSA_ERROR_STORAGE_FAILURE;
+	}
+}
+
+psa_status_t psa_its_set_backend(psa_storage_uid_t uid, uint32_t data_length, const void *p_data,
+				 psa_storage_create_flags_t create_flags)
+{
+	psa_status_t status;
+	struct index_entry *entry;
+	struct record_header hdr = {
+		.uid = uid,
+		.size = data_length,
+		.flags = create_flags,
+	};
+
+	LOG_DBG("Setting uid: %" PRIx64, uid);
+
+	if (p_data == NULL || data_length == 0) {
+		return PSA_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (create_flags & ~(PSA_STORAGE_FLAG_WRITE_ONCE)) {
+		return PSA_ERROR_NOT_SUPPORTED;
+	}
+
+	hdr.crc = crc32_ieee_update(record_crc(&hdr), p_data, data_length);
+
+	k_mutex_lock(&its_lock, K_FOREVER);
+
+	entry = entry_find(uid, NULL);
+
+	if (!initialized) {
+		status = PSA_ERROR_STORAGE_FAILURE;
+	} else if (entry != NULL && (entry->flags & PSA_STORAGE_FLAG_WRITE_ONCE)) {
+		status = PSA_ERROR_NOT_PERMITTED;
+	} else if (entry == NULL && entry_count == ARRAY_SIZE(entries)) {
+		status = PSA_ERROR_INSUFFICIENT_STORAGE;
+	} else {
+		status = to_psa_status(record_append(&hdr, p_data));
+	}
+
+	k_mutex_unlock(&its_lock);
+
+	return status;
+}
+
+psa_status_t psa_its_get_backend(psa_storage_uid_t uid, uint32_t data_offset, uint32_t data_length,
+				 void *p_data, size_t *p_data_length)
+{
+	psa_status_t status;
+	struct index_entry *entry;
+	uint32_t len;
+
+	LOG_DBG("Getting data for uid: 0x%" PRIx64, uid);
+
+	if (p_data == NULL || p_data_length == NULL || data_length == 0) {
+		return PSA_ERROR_INVALID_ARGUMENT;
+	}
+
+	k_mutex_lock(&its_lock, K_FOREVER);
+
+	entry = entry_find(uid, NULL);
+
+	if (!initialized) {
+		status = PSA_ERROR_STORAGE_FAILURE;
+	} else if (entry == NULL) {
+		status = PSA_ERROR_DOES_NOT_EXIST;
+	} else if (data_offset > entry->size) {
+		status = PSA_ERROR_INVALID_ARGUMENT;
+	} else {
+		len = MIN(data_length, entry->size - data_offset);
+
+		status = to_psa_status(flash_area_read(
+			fa, entry->offset + sizeof(struct record_header) + data_offset, p_data,
+			len));
+		if (status == PSA_SUCCESS) {
+			*p_data_length = len;
+		}
+	}
+
+	k_mutex_unlock(&its_lock);
+
+	return status;
+}
+
+psa_status_t psa_its_get_info_backend(psa_storage_uid_t uid, struct psa_storage_info_t *p_info)
+{
+	psa_status_t status;
+	struct index_entry *entry;
+
+	LOG_DBG("Getting info for uid: 0x%" PRIx64, uid);
+
+	if (p_info == NULL) {
+		return PSA_ERROR_INVALID_ARGUMENT;
+	}
+
+	k_mutex_lock(&its_lock, K_FOREVER);
+
+	entry = entry_find(uid, NULL);
+
+	if (!initialized) {
+		status = PSA_ERROR_STORAGE_FAILURE;
+	} else if (entry == NULL) {
+		status = PSA_ERROR_DOES_NOT_EXIST;
+	} else {
+		p_info->size = entry->size;
+		p_info->flags = entry->flags;
+		status = PSA_SUCCESS;
+	}
+
+	k_mutex_unlock(&its_lock);
+
+	return status;
+}
+
+psa_status_t psa_its_remove_backend(psa_storage_uid_t uid)
+{
+	psa_status_t status;
+	struct index_entry *entry;
+	struct record_header hdr = {
+		.uid = uid,
+	};
+
+	LOG_DBG("Removing data for uid: %" PRIx64, uid);
+
+	hdr.crc = record_crc(&hdr);
+
+	k_mutex_lock(&its_lock, K_FOREVER);
+
+	entry = entry_find(uid, NULL);
+
+	if (!initialized) {
+		status = PSA_ERROR_STORAGE_FAILURE;
+	} else if (entry == NULL) {
+		status = PSA_ERROR_DOES_NOT_EXIST;
+	} else if (entry->flags & PSA_STORAGE_FLAG_WRITE_ONCE) {
+		status = PSA_ERROR_NOT_PERMITTED;
+	} else {
+		status = to_psa_status(record_append(&hdr, NULL));
+	}
+
+	k_mutex_unlock(&its_lock);
+
+	return status;
+}
+
+static int native_its_log_init(void)
+{
+	return psa_native_its_log_init();
+}
+
+SYS_INIT(native_its_log_init, APPLICATION, CONFIG_APPLICATION_INIT_PRIORITY);
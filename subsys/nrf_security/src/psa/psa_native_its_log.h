@@ -0,0 +1,19 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#ifndef PSA_NATIVE_ITS_LOG_H
+#define PSA_NATIVE_ITS_LOG_H
+
+/**
+ * \brief Build the index of the log-structured backend from the flash partition
+ *
+ * This is done at boot. Calling it again discards the index and builds it
+ * again, as after a reboot.
+ *
+ * \return 0 on success, a negative errno code otherwise
+ */
+int psa_native_its_log_init(void);
+
+#endif /* PSA_NATIVE_ITS_LOG_H */
@@ -0,0 +1,285 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+
+#include "common.h"
+#include "psa_crypto_core.h"
+#include "psa_crypto_driver_wrappers.h"
+#include "psa_crypto_aead_batch.h"
+
+#include <nrf_aead_batch.h>
+
+/* Largest tag of the supported AEAD algorithms. */
+#define AEAD_BATCH_TAG_MAX_SIZE 16
+
+struct aead_batch {
+	const psa_key_attributes_t *attributes;
+	const uint8_t *key_buffer;
+	size_t key_buffer_size;
+	psa_algorithm_t alg;
+	size_t tag_length;
+	int is_encrypt;
+	/* Operation set up once and copied for each message, if supported. */
+	psa_aead_operation_t template;
+	int template_valid;
+};
+
+static psa_status_t aead_batch_setup(struct aead_batch *batch, psa_aead_operation_t *operation)
+{
+	if (batch->is_encrypt) {
+		return psa_driver_wrapper_aead_encrypt_setup(operation, batch->attributes,
+							     batch->key_buffer,
+							     batch->key_buffer_size, batch->alg);
+	}
+
+	return psa_driver_wrapper_aead_decrypt_setup(operation, batch->attributes,
+						     batch->key_buffer, batch->key_buffer_size,
+						     batch->alg);
+}
+
+/* Get an operation ready for the next message, reusing the key schedule of
+ * the template operation when the driver allows it.
+ */
+static psa_status_t aead_batch_prepare(struct aead_batch *batch, psa_aead_operation_t *operation)
+{
+	psa_status_t status;
+
+	if (batch->template_valid) {
+		status = psa_driver_wrapper_aead_clone(&batch->template, operation);
+		if (status != PSA_ERROR_NOT_SUPPORTED) {
+			return status;
+		}
+
+		psa_driver_wrapper_aead_abort(&batch->template);
+		batch->template_valid = 0;
+	}
+
+	return aead_batch_setup(batch, operation);
+}
+
+static psa_status_t iovec_total_length(const struct nrf_aead_iovec *iov, size_t count,
+				       size_t *length)
+{
+	*length = 0;
+
+	if (iov == NULL && count != 0) {
+		return PSA_ERROR_INVALID_ARGUMENT;
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		if (iov[i].len > SIZE_MAX - *length) {
+			return PSA_ERROR_INVALID_ARGUMENT;
+		}
+		*length += iov[i].len;
+	}
+
+	return PSA_SUCCESS;
+}
+
+static psa_status_t aead_batch_msg_process(struct aead_batch *batch,
+					   psa_aead_operation_t *operation,
+					   struct nrf_aead_batch_msg *msg)
+{
+	psa_status_t status;
+	size_t ad_length;
+	size_t input_length;
+	size_t payload_length;
+	size_t payload_remaining;
+	size_t output_offset = 0;
+	size_t tag_offset = 0;
+	size_t length;
+	uint8_t tag[AEAD_BATCH_TAG_MAX_SIZE];
+
+	status = iovec_total_length(msg->ad, msg->ad_count, &ad_length);
+	if (status != PSA_SUCCESS) {
+		return status;
+	}
+
+	status = iovec_total_length(msg->input, msg->input_count, &input_length);
+	if (status != PSA_SUCCESS) {
+		return status;
+	}
+
+	if (batch->is_encrypt) {
+		payload_length = input_length;
+		if (msg->output_size < payload_length ||
+		    msg->output_size - payload_length < batch->tag_length) {
+			return PSA_ERROR_BUFFER_TOO_SMALL;
+		}
+	} else {
+		if (input_length < batch->tag_length) {
+			return PSA_ERROR_INVALID_ARGUMENT;
+		}
+		payload_length = input_length - batch->tag_length;
+		if (msg->output_size < payload_length) {
+			return PSA_ERROR_BUFFER_TOO_SMALL;
+		}
+	}
+
+	status = aead_batch_prepare(batch, operation);
+	if (status != PSA_SUCCESS) {
+		return status;
+	}
+
+	/* The lengths must be known before the nonce is set for CCM. */
+	status = psa_driver_wrapper_aead_set_lengths(operation, ad_length, payload_length);
+	if (status != PSA_SUCCESS) {
+		return status;
+	}
+
+	status = psa_driver_wrapper_aead_set_nonce(operation, msg->nonce, msg->nonce_length);
+	if (status != PSA_SUCCESS) {
+		return status;
+	}
+
+	for (size_t i = 0; i < msg->ad_count; i++) {
+		if (msg->ad[i].len == 0) {
+			continue;
+		}
+
+		status = psa_driver_wrapper_aead_update_ad(operation, msg->ad[i].base,
+							   msg->ad[i].len);
+		if (status != PSA_SUCCESS) {
+			return status;
+		}
+	}
+
+	payload_remaining = payload_length;
+
+	for (size_t i = 0; i < msg->input_count; i++) {
+		const uint8_t *input = msg->input[i].base;
+		size_t input_len = msg->input[i].len;
+		size_t update_len = input_len < payload_remaining ? input_len : payload_remaining;
+
+		if (update_len != 0) {
+			status = psa_driver_wrapper_aead_update(operation, input, update_len,
+								msg->output + output_offset,
+								payload_length - output_offset,
+								&length);
+			if (status != PSA_SUCCESS) {
+				return status;
+			}
+
+			output_offset += length;
+			payload_remaining -= update_len;
+		}
+
+		/* When decrypting, the input ends with the tag. */
+		if (update_len != input_len) {
+			memcpy(&tag[tag_offset], input + update_len, input_len - update_len);
+			tag_offset += input_len - update_len;
+		}
+	}
+
+	if (batch->is_encrypt) {
+		size_t tag_length;
+
+		status = psa_driver_wrapper_aead_finish(operation, msg->output + output_offset,
+							payload_length - output_offset, &length,
+							msg->output + payload_length,
+							msg->output_size - payload_length,
+							&tag_length);
+		if (status != PSA_SUCCESS) {
+			return status;
+		}
+
+		msg->output_length = output_offset + length + tag_length;
+	} else {
+		status = psa_driver_wrapper_aead_verify(operation, msg->output + output_offset,
+							msg->output_size - output_offset, &length,
+							tag, tag_offset);
+		if (status != PSA_SUCCESS) {
+			return status;
+		}
+
+		msg->output_length = output_offset + length;
+	}
+
+	return PSA_SUCCESS;
+}
+
+static psa_status_t aead_batch(mbedtls_svc_key_id_t key, psa_algorithm_t alg, int is_encrypt,
+			       struct nrf_aead_batch_msg *msgs, size_t msg_count)
+{
+	psa_status_t status;
+	psa_status_t batch_status = PSA_SUCCESS;
+	psa_key_slot_t *slot;
+	struct aead_batch batch = {
+		.alg = alg,
+		.is_encrypt = is_encrypt,
+		.tag_length = PSA_ALG_AEAD_GET_TAG_LENGTH(alg),
+		.template = PSA_AEAD_OPERATION_INIT,
+	};
+
+	if (!PSA_ALG_IS_AEAD(alg) || PSA_ALG_IS_WILDCARD(alg) ||
+	    batch.tag_length > AEAD_BATCH_TAG_MAX_SIZE || (msgs == NULL && msg_count != 0)) {
+		return PSA_ERROR_INVALID_ARGUMENT;
+	}
+
+	status = psa_get_and_lock_key_slot_with_policy(
+		key, &slot, is_encrypt ? PSA_KEY_USAGE_ENCRYPT : PSA_KEY_USAGE_DECRYPT, alg);
+	if (status != PSA_SUCCESS) {
+		return status;
+	}
+
+	psa_key_attributes_t attributes = {
+		.core = slot->attr
+	};
+
+	batch.attributes = &attributes;
+	batch.key_buffer = slot->key.data;
+	batch.key_buffer_size = slot->key.bytes;
+
+	/* Computes the key schedule once for the whole batch. */
+	status = aead_batch_setup(&batch, &batch.template);
+	if (status != PSA_SUCCESS) {
+		psa_driver_wrapper_aead_abort(&batch.template);
+		psa_unlock_key_slot(slot);
+		return status;
+	}
+	batch.template_valid = 1;
+
+	for (size_t i = 0; i < msg_count; i++) {
+		psa_aead_operation_t operation = PSA_AEAD_OPERATION_INIT;
+		struct nrf_aead_batch_msg *msg = &msgs[i];
+
+		msg->output_length = 0;
+		msg->status = aead_batch_msg_process(&batch, &operation, msg);
+
+		psa_driver_wrapper_aead_abort(&operation);
+
+		if (msg->status != PSA_SUCCESS) {
+			if (msg->output_size != 0) {
+				memset(msg->output, 0, msg->output_size);
+			}
+
+			if (batch_status == PSA_SUCCESS) {
+				batch_status = msg->status;
+			}
+		}
+	}
+
+	if (batch.template_valid) {
+		psa_driver_wrapper_aead_abort(&batch.template);
+	}
+
+	status = psa_unlock_key_slot(slot);
+
+	return batch_status != PSA_SUCCESS ? batch_status : status;
+}
+
+psa_status_t nrf_aead_encrypt_batch(mbedtls_svc_key_id_t key, psa_algorithm_t alg,
+				    struct nrf_aead_batch_msg *msgs, size_t msg_count)
+{
+	return aead_batch(key, alg, 1, msgs, msg_count);
+}
+
+psa_status_t nrf_aead_decrypt_batch(mbedtls_svc_key_id_t key, psa_algorithm_t alg,
+				    struct nrf_aead_batch_msg *msgs, size_t msg_count)
+{
+	return aead_batch(key, alg, 0, msgs, msg_count);
+}
@@ -0,0 +1,27 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PSA_CRYPTO_AEAD_BATCH_H__
+#define PSA_CRYPTO_AEAD_BATCH_H__
+
+#include <psa/crypto.h>
+
+/**
+ * @brief Copy an AEAD operation that has been set up, but not used yet.
+ *
+ * This lets the batched AEAD operations compute the key schedule once and
+ * reuse it for every message.
+ *
+ * @retval PSA_SUCCESS If the operation was copied.
+ * @retval PSA_ERROR_NOT_SUPPORTED If the driver of the operation does not
+ *	   allow its context to be copied, so that the operation must be set up
+ *	   again from the key for each message.
+ * @retval PSA_ERROR_BAD_STATE If the source operation is not set up.
+ */
+psa_status_t psa_driver_wrapper_aead_clone(const psa_aead_operation_t *source_operation,
+					   psa_aead_operation_t *target_operation);
+
+#endif /* PSA_CRYPTO_AEAD_BATCH_H__ */
@@ -0,0 +1,375 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include <zephyr/spinlock.h>
+#include <zephyr/sys/util.h>
+
+#include "common.h"
+#include "mbedtls/platform_util.h"
+#include "psa_crypto_aead_key_cache.h"
+
+/* Entries are wiped when their key is destroyed or purged, see
+ * __wrap_psa_destroy_key().
+ */
+struct aead_key_cache_entry {
+	mbedtls_svc_key_id_t key_id;
+	psa_algorithm_t alg;
+	/* Value of use_count when the entry was last used, for LRU eviction. */
+	uint32_t last_used;
+	bool valid;
+	/* Operation set up for encryption, with no nonce set yet. */
+	oberon_aead_operation_t operation;
+};
+
+static struct aead_key_cache_entry cache[CONFIG_PSA_AEAD_KEY_CACHE_SIZE];
+static uint32_t use_count;
+static struct k_spinlock lock;
+
+static bool is_cacheable(const psa_key_attributes_t *attributes, psa_algorithm_t alg)
+{
+	if (psa_get_key_type(attributes) != PSA_KEY_TYPE_AES ||
+	    mbedtls_svc_key_id_is_null(psa_get_key_id(attributes))) {
+		return false;
+	}
+
+	switch (PSA_ALG_AEAD_WITH_SHORTENED_TAG(alg, 0)) {
+#ifdef PSA_NEED_OBERON_AES_CCM
+	case PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, 0):
+		return true;
+#endif /* PSA_NEED_OBERON_AES_CCM */
+#ifdef PSA_NEED_OBERON_AES_GCM
+	case PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_GCM, 0):
+		return true;
+#endif /* PSA_NEED_OBERON_AES_GCM */
+	default:
+		return false;
+	}
+}
+
+/* Same checks as the single-part functions of the Oberon AEAD driver, which
+ * the multi-part setup does not do.
+ */
+static bool tag_length_is_valid(psa_algorithm_t alg)
+{
+	size_t tag_length = PSA_ALG_AEAD_GET_TAG_LENGTH(alg);
+
+	if (tag_length < 4 || tag_length > 16) {
+		return false;
+	}
+
+	if (PSA_ALG_AEAD_WITH_SHORTENED_TAG(alg, 0) ==
+	    PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, 0)) {
+		return (tag_length & 1) == 0;
+	}
+
+	return true;
+}
+
+static struct aead_key_cache_entry *entry_find(mbedtls_svc_key_id_t key_id, psa_algorithm_t alg)
+{
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].valid && cache[i].alg == alg &&
+		    mbedtls_svc_key_id_equal(cache[i].key_id, key_id)) {
+			return &cache[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void entry_wipe(struct aead_key_cache_entry *entry)
+{
+	mbedtls_platform_zeroize(entry, sizeof(*entry));
+}
+
+static bool entry_get(mbedtls_svc_key_id_t key_id, psa_algorithm_t alg,
+		      oberon_aead_operation_t *operation)
+{
+	struct aead_key_cache_entry *entry;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	entry = entry_find(key_id, alg);
+	if (entry != NULL) {
+		*operation = entry->operation;
+		entry->last_used = ++use_count;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return entry != NULL;
+}
+
+static void entry_put(mbedtls_svc_key_id_t key_id, psa_algorithm_t alg,
+		      const oberon_aead_operation_t *operation)
+{
+	struct aead_key_cache_entry *entry;
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	/* Another thread may have added the same key in the meantime. */
+	entry = entry_find(key_id, alg);
+
+	for (size_t i = 0; entry == NULL && i < ARRAY_SIZE(cache); i++) {
+		if (!cache[i].valid) {
+			entry = &cache[i];
+		}
+	}
+
+	if (entry == NULL) {
+		entry = &cache[0];
+		for (size_t i = 1; i < ARRAY_SIZE(cache); i++) {
+			if ((int32_t)(cache[i].last_used - entry->last_used) < 0) {
+				entry = &cache[i];
+			}
+		}
+	}
+
+	entry->key_id = key_id;
+	entry->alg = alg;
+	entry->last_used = ++use_count;
+	entry->valid = true;
+	entry->operation = *operation;
+
+	k_spin_unlock(&lock, key);
+}
+
+psa_status_t aead_key_cache_setup(oberon_aead_operation_t *operation,
+				  const psa_key_attributes_t *attributes, const uint8_t *key,
+				  size_t key_length, psa_algorithm_t alg, uint8_t decrypt)
+{
+	psa_status_t status;
+	mbedtls_svc_key_id_t key_id = psa_get_key_id(attributes);
+
+	if (!is_cacheable(attributes, alg)) {
+		if (decrypt) {
+			return oberon_aead_decrypt_setup(operation, attributes, key, key_length,
+							 alg);
+		}
+		return oberon_aead_encrypt_setup(operation, attributes, key, key_length, alg);
+	}
+
+	if (!entry_get(key_id, alg, operation)) {
+		status = oberon_aead_encrypt_setup(operation, attributes, key, key_length, alg);
+		if (status != PSA_SUCCESS) {
+			return status;
+		}
+
+		entry_put(key_id, alg, operation);
+	}
+
+	/* The key schedule is the same in both directions, AES-CCM and AES-GCM
+	 * only use the AES encryption.
+	 */
+	operation->decrypt = decrypt;
+
+	return PSA_SUCCESS;
+}
+
+psa_status_t aead_key_cache_encrypt(const psa_key_attributes_t *attributes, const uint8_t *key,
+				    size_t key_length, psa_algorithm_t alg, const uint8_t *nonce,
+				    size_t nonce_length, const uint8_t *additional_data,
+				    size_t additional_data_length, const uint8_t *plaintext,
+				    size_t plaintext_length, uint8_t *ciphertext,
+				    size_t ciphertext_size, size_t *ciphertext_length)
+{
+	psa_status_t status;
+	oberon_aead_operation_t operation;
+	size_t tag_length = PSA_ALG_AEAD_GET_TAG_LENGTH(alg);
+	size_t length;
+
+	if (!is_cacheable(attributes, alg)) {
+		return oberon_aead_encrypt(attributes, key, key_length, alg, nonce, nonce_length,
+					   additional_data, additional_data_length, plaintext,
+					   plaintext_length, ciphertext, ciphertext_size,
+					   ciphertext_length);
+	}
+
+	if (!tag_length_is_valid(alg)) {
+		return PSA_ERROR_INVALID_ARGUMENT;
+	}
+
+	if (plaintext_length > SIZE_MAX - tag_length ||
+	    ciphertext_size < plaintext_length + tag_length) {
+		return PSA_ERROR_BUFFER_TOO_SMALL;
+	}
+
+	status = aead_key_cache_setup(&operation, attributes, key, key_length, alg, 0);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	/* The lengths must be known before the nonce is set for CCM. */
+	status = oberon_aead_set_lengths(&operation, additional_data_length, plaintext_length);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	status = oberon_aead_set_nonce(&operation, nonce, nonce_length);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	if (additional_data_length != 0) {
+		status = oberon_aead_update_ad(&operation, additional_data,
+					       additional_data_length);
+		if (status != PSA_SUCCESS) {
+			goto exit;
+		}
+	}
+
+	if (plaintext_length != 0) {
+		status = oberon_aead_update(&operation, plaintext, plaintext_length, ciphertext,
+					    plaintext_length, &length);
+		if (status != PSA_SUCCESS) {
+			goto exit;
+		}
+	}
+
+	status = oberon_aead_finish(&operation, NULL, 0, &length, ciphertext + plaintext_length,
+				    tag_length, &length);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	*ciphertext_length = plaintext_length + tag_length;
+
+exit:
+	oberon_aead_abort(&operation);
+
+	return status;
+}
+
+psa_status_t aead_key_cache_decrypt(const psa_key_attributes_t *attributes, const uint8_t *key,
+				    size_t key_length, psa_algorithm_t alg, const uint8_t *nonce,
+				    size_t nonce_length, const uint8_t *additional_data,
+				    size_t additional_data_length, const uint8_t *ciphertext,
+				    size_t ciphertext_length, uint8_t *plaintext,
+				    size_t plaintext_size, size_t *plaintext_length)
+{
+	psa_status_t status;
+	oberon_aead_operation_t operation;
+	size_t tag_length = PSA_ALG_AEAD_GET_TAG_LENGTH(alg);
+	size_t pt_length;
+	size_t length;
+
+	if (!is_cacheable(attributes, alg)) {
+		return oberon_aead_decrypt(attributes, key, key_length, alg, nonce, nonce_length,
+					   additional_data, additional_data_length, ciphertext,
+					   ciphertext_length, plaintext, plaintext_size,
+					   plaintext_length);
+	}
+
+	if (!tag_length_is_valid(alg) || ciphertext_length < tag_length) {
+		return PSA_ERROR_INVALID_ARGUMENT;
+	}
+
+	pt_length = ciphertext_length - tag_length;
+	if (plaintext_size < pt_length) {
+		return PSA_ERROR_BUFFER_TOO_SMALL;
+	}
+
+	status = aead_key_cache_setup(&operation, attributes, key, key_length, alg, 1);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	status = oberon_aead_set_lengths(&operation, additional_data_length, pt_length);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	status = oberon_aead_set_nonce(&operation, nonce, nonce_length);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	if (additional_data_length != 0) {
+		status = oberon_aead_update_ad(&operation, additional_data,
+					       additional_data_length);
+		if (status != PSA_SUCCESS) {
+			goto exit;
+		}
+	}
+
+	if (pt_length != 0) {
+		status = oberon_aead_update(&operation, ciphertext, pt_length, plaintext,
+					    plaintext_size, &length);
+		if (status != PSA_SUCCESS) {
+			goto exit;
+		}
+	}
+
+	status = oberon_aead_verify(&operation, NULL, 0, &length, ciphertext + pt_length,
+				    tag_length);
+	if (status != PSA_SUCCESS) {
+		goto exit;
+	}
+
+	*plaintext_length = pt_length;
+
+exit:
+	oberon_aead_abort(&operation);
+
+	return status;
+}
+
+static void entry_invalidate(mbedtls_svc_key_id_t key_id)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		if (cache[i].valid && mbedtls_svc_key_id_equal(cache[i].key_id, key_id)) {
+			entry_wipe(&cache[i]);
+		}
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+/*
+ * The PSA core does not notify the drivers when a key is destroyed or purged,
+ * so psa_destroy_key() and psa_purge_key() are wrapped at link time. The
+ * entries are wiped both before and after the call, so that no key schedule
+ * of the key is left in RAM and a new key that is given the same identifier
+ * does not find it.
+ */
+psa_status_t __real_psa_destroy_key(mbedtls_svc_key_id_t key);
+psa_status_t __real_psa_purge_key(mbedtls_svc_key_id_t key);
+
+psa_status_t __wrap_psa_destroy_key(mbedtls_svc_key_id_t key)
+{
+	psa_status_t status;
+
+	entry_invalidate(key);
+	status = __real_psa_destroy_key(key);
+	entry_invalidate(key);
+
+	return status;
+}
+
+psa_status_t __wrap_psa_purge_key(mbedtls_svc_key_id_t key)
+{
+	psa_status_t status;
+
+	entry_invalidate(key);
+	status = __real_psa_purge_key(key);
+	entry_invalidate(key);
+
+	return status;
+}
+
+void aead_key_cache_clear(void)
+{
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	for (size_t i = 0; i < ARRAY_SIZE(cache); i++) {
+		entry_wipe(&cache[i]);
+	}
+
+	k_spin_unlock(&lock, key);
+}
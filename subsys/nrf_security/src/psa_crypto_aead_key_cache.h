@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#ifndef PSA_CRYPTO_AEAD_KEY_CACHE_H__
+#define PSA_CRYPTO_AEAD_KEY_CACHE_H__
+
+#include <psa/crypto.h>
+
+#include "oberon_aead.h"
+
+/*
+ * Cache of the AES key schedules computed by the Oberon AEAD driver, keyed by
+ * key identifier and algorithm. The entries of a key are wiped when the key is
+ * destroyed or purged. The functions below have the same semantics as the
+ * Oberon AEAD driver functions they replace, but compute the key schedule only
+ * on a cache miss.
+ */
+
+psa_status_t aead_key_cache_setup(oberon_aead_operation_t *operation,
+				  const psa_key_attributes_t *attributes, const uint8_t *key,
+				  size_t key_length, psa_algorithm_t alg, uint8_t decrypt);
+
+psa_status_t aead_key_cache_encrypt(const psa_key_attributes_t *attributes, const uint8_t *key,
+				    size_t key_length, psa_algorithm_t alg, const uint8_t *nonce,
+				    size_t nonce_length, const uint8_t *additional_data,
+				    size_t additional_data_length, const uint8_t *plaintext,
+				    size_t plaintext_length, uint8_t *ciphertext,
+				    size_t ciphertext_size, size_t *ciphertext_length);
+
+psa_status_t aead_key_cache_decrypt(const psa_key_attributes_t *attributes, const uint8_t *key,
+				    size_t key_length, psa_algorithm_t alg, const uint8_t *nonce,
+				    size_t nonce_length, const uint8_t *additional_data,
+				    size_t additional_data_length, const uint8_t *ciphertext,
+				    size_t ciphertext_length, uint8_t *plaintext,
+				    size_t plaintext_size, size_t *plaintext_length);
+
+/* Wipe all cached key schedules. */
+void aead_key_cache_clear(void);
+
+#endif /* PSA_CRYPTO_AEAD_KEY_CACHE_H__ */
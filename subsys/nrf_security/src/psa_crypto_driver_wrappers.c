@@ -17,6 +17,14 @@
 
 #include "mbedtls/platform.h"
 
+#if defined(CONFIG_PSA_AEAD_BATCH)
+#include "psa_crypto_aead_batch.h"
+#endif
+
+#if defined(CONFIG_PSA_AEAD_KEY_CACHE)
+#include "psa_crypto_aead_key_cache.h"
+#endif
+
 #if defined(MBEDTLS_PSA_CRYPTO_C)
 
 #if defined(MBEDTLS_PSA_CRYPTO_DRIVERS)
@@ -164,7 +172,9 @@ psa_status_t psa_driver_wrapper_init(void)
 
 void psa_driver_wrapper_free(void)
 {
-	/* Intentionally left empty */
+#if defined(CONFIG_PSA_AEAD_KEY_CACHE)
+	aead_key_cache_clear();
+#endif
 }
 
 /* Start delegation functions */
@@ -1210,10 +1220,18 @@ psa_status_t psa_driver_wrapper_aead_encrypt(const psa_key_attributes_t *attribu
 		}
 #endif /* PSA_NEED_CC3XX_AEAD_DRIVER */
 #if defined(PSA_NEED_OBERON_AEAD_DRIVER)
+#if defined(CONFIG_PSA_AEAD_KEY_CACHE)
+		status = aead_key_cache_encrypt(attributes, key_buffer, key_buffer_size, alg, nonce,
+						nonce_length, additional_data,
+						additional_data_length, plaintext,
+						plaintext_length, ciphertext, ciphertext_size,
+						ciphertext_length);
+#else
 		status = oberon_aead_encrypt(attributes, key_buffer, key_buffer_size, alg, nonce,
 					     nonce_length, additional_data, additional_data_length,
 					     plaintext, plaintext_length, ciphertext,
 					     ciphertext_size, ciphertext_length);
+#endif /* CONFIG_PSA_AEAD_KEY_CACHE */
 
 		if (status != PSA_ERROR_NOT_SUPPORTED) {
 			return status;
@@ -1272,10 +1290,18 @@ psa_status_t psa_driver_wrapper_aead_decrypt(const psa_key_attributes_t *attribu
 		}
 #endif /* PSA_NEED_CC3XX_AEAD_DRIVER */
 #if defined(PSA_NEED_OBERON_AEAD_DRIVER)
+#if defined(CONFIG_PSA_AEAD_KEY_CACHE)
+		status = aead_key_cache_decrypt(attributes, key_buffer, key_buffer_size, alg, nonce,
+						nonce_length, additional_data,
+						additional_data_length, ciphertext,
+						ciphertext_length, plaintext, plaintext_size,
+						plaintext_length);
+#else
 		status = oberon_aead_decrypt(attributes, key_buffer, key_buffer_size, alg, nonce,
 					     nonce_length, additional_data, additional_data_length,
 					     ciphertext, ciphertext_length, plaintext,
 					     plaintext_size, plaintext_length);
+#endif /* CONFIG_PSA_AEAD_KEY_CACHE */
 
 		if (status != PSA_ERROR_NOT_SUPPORTED) {
 			return status;
@@ -1334,8 +1360,13 @@ psa_status_t psa_driver_wrapper_aead_encrypt_setup(psa_aead_operation_t *operati
 #endif /* PSA_NEED_CC3XX_AEAD_DRIVER */
 #if defined(PSA_NEED_OBERON_AEAD_DRIVER)
 		operation->id = PSA_CRYPTO_OBERON_DRIVER_ID;
+#if defined(CONFIG_PSA_AEAD_KEY_CACHE)
+		status = aead_key_cache_setup(&operation->ctx.oberon_driver_ctx, attributes,
+					      key_buffer, key_buffer_size, alg, 0);
+#else
 		status = oberon_aead_encrypt_setup(&operation->ctx.oberon_driver_ctx, attributes,
 						   key_buffer, key_buffer_size, alg);
+#endif /* CONFIG_PSA_AEAD_KEY_CACHE */
 
 		/* Declared with fallback == true */
 		if (status != PSA_ERROR_NOT_SUPPORTED) {
@@ -1386,8 +1417,13 @@ psa_status_t psa_driver_wrapper_aead_decrypt_setup(psa_aead_operation_t *operati
 #endif /* PSA_NEED_CC3XX_AEAD_DRIVER  */
 #if defined(PSA_NEED_OBERON_AEAD_DRIVER)
 		operation->id = PSA_CRYPTO_OBERON_DRIVER_ID;
+#if defined(CONFIG_PSA_AEAD_KEY_CACHE)
+		status = aead_key_cache_setup(&operation->ctx.oberon_driver_ctx, attributes,
+					      key_buffer, key_buffer_size, alg, 1);
+#else
 		status = oberon_aead_decrypt_setup(&operation->ctx.oberon_driver_ctx, attributes,
 						   key_buffer, key_buffer_size, alg);
+#endif /* CONFIG_PSA_AEAD_KEY_CACHE */
 
 		/* Declared with fallback == true */
 		if (status != PSA_ERROR_NOT_SUPPORTED) {
@@ -1587,6 +1623,33 @@ psa_status_t psa_driver_wrapper_aead_abort(psa_aead_operation_t *operation)
 	}
 }
 
+#if defined(CONFIG_PSA_AEAD_BATCH)
+psa_status_t psa_driver_wrapper_aead_clone(const psa_aead_operation_t *source_operation,
+					   psa_aead_operation_t *target_operation)
+{
+	switch (source_operation->id) {
+#if defined(PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT)
+#if defined(PSA_NEED_CC3XX_AEAD_DRIVER)
+	case PSA_CRYPTO_CC3XX_DRIVER_ID:
+		/* The context may refer to hardware state, set up again instead. */
+		(void)target_operation;
+		return PSA_ERROR_NOT_SUPPORTED;
+#endif /* PSA_NEED_CC3XX_AEAD_DRIVER */
+#if defined(PSA_NEED_OBERON_AEAD_DRIVER)
+	case PSA_CRYPTO_OBERON_DRIVER_ID:
+		/* The context only holds the key schedule until the nonce is set. */
+		target_operation->id = PSA_CRYPTO_OBERON_DRIVER_ID;
+		target_operation->ctx.oberon_driver_ctx = source_operation->ctx.oberon_driver_ctx;
+		return PSA_SUCCESS;
+#endif /* PSA_NEED_OBERON_AEAD_DRIVER */
+#endif /* PSA_CRYPTO_ACCELERATOR_DRIVER_PRESENT */
+	default:
+		(void)target_operation;
+		return PSA_ERROR_BAD_STATE;
+	}
+}
+#endif /* CONFIG_PSA_AEAD_BATCH */
+
 /*
  * MAC functions
  */
@@ -9,11 +9,16 @@
 
 #include "mbedtls/memory_buffer_alloc.h"
 
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+#include "nrf_mbedtls_heap.h"
+#endif
+
 #if !defined(CONFIG_MBEDTLS_HEAP_SIZE) || CONFIG_MBEDTLS_HEAP_SIZE == 0
 #error "CONFIG_MBEDTLS_HEAP_SIZE must be specified and greater than 0"
 #endif
 
-static unsigned char mbedtls_heap[CONFIG_MBEDTLS_HEAP_SIZE];
+/* Aligned so that no memory is lost to the alignment of the arena pages. */
+static unsigned char mbedtls_heap[CONFIG_MBEDTLS_HEAP_SIZE] __aligned(16);
 
 /*
  * Initializes the heap with the compile-time configured size.
@@ -22,7 +27,11 @@ static unsigned char mbedtls_heap[CONFIG_MBEDTLS_HEAP_SIZE];
  */
 void _heap_init(void)
 {
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+	(void)nrf_mbedtls_heap_init(mbedtls_heap, sizeof(mbedtls_heap));
+#else
 	mbedtls_memory_buffer_alloc_init(mbedtls_heap, sizeof(mbedtls_heap));
+#endif
 }
 
 /*
@@ -34,7 +43,11 @@ void _heap_init(void)
  */
 void _heap_free(void)
 {
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+	/* Nothing to free, _heap_init starts the arena allocator over. */
+#else
 	mbedtls_memory_buffer_alloc_free();
+#endif
 }
 
 static int mbedtls_heap_init(void)
@@ -0,0 +1,562 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/sys/util.h>
+
+#include "mbedtls/platform.h"
+#include "mbedtls/platform_util.h"
+#include "nrf_mbedtls_heap.h"
+
+LOG_MODULE_REGISTER(mbedtls_heap_arena, CONFIG_MBEDTLS_HEAP_ARENA_LOG_LEVEL);
+
+#define PAGE_SIZE CONFIG_MBEDTLS_HEAP_ARENA_PAGE_SIZE
+#define PAGE_COUNT_MAX (CONFIG_MBEDTLS_HEAP_SIZE / PAGE_SIZE)
+#define ARENA_COUNT (CONFIG_MBEDTLS_HEAP_ARENA_COUNT + 1)
+
+/* Size classes go from BLOCK_SIZE_MIN up to half a page, in powers of two. */
+#define BLOCK_SIZE_MIN 16
+#define CLASS_COUNT_MAX 8
+
+#define BLOCK_NONE UINT16_MAX
+#define PAGE_NONE UINT16_MAX
+
+BUILD_ASSERT(IS_POWER_OF_TWO(PAGE_SIZE), "The page size must be a power of two");
+BUILD_ASSERT(PAGE_SIZE / 2 <= BLOCK_SIZE_MIN << (CLASS_COUNT_MAX - 1), "Too many size classes");
+BUILD_ASSERT(PAGE_COUNT_MAX > 0 && PAGE_COUNT_MAX < PAGE_NONE,
+	     "The heap must hold between 1 and 65534 pages");
+BUILD_ASSERT(ARENA_COUNT <= UINT8_MAX, "Too many arenas");
+
+enum page_type {
+	PAGE_FREE,
+	/* Blocks of a single size class. */
+	PAGE_SLAB,
+	/* First page of an allocation larger than half a page. */
+	PAGE_RUN,
+	/* Following pages of such an allocation. */
+	PAGE_RUN_TAIL,
+};
+
+struct page {
+	uint8_t type;
+	uint8_t arena;
+	uint8_t size_class;
+	/* PAGE_RUN: number of pages in the run. PAGE_SLAB: number of free blocks. */
+	uint16_t count;
+	/* PAGE_SLAB: index of the first free block, the free blocks are linked
+	 * through their first two bytes.
+	 */
+	uint16_t free_head;
+};
+
+struct usage {
+	size_t used;
+	size_t peak;
+	uint32_t allocs;
+	uint32_t failures;
+};
+
+struct arena {
+	bool in_use;
+	/* Thread that has entered the arena, if any. */
+	k_tid_t thread;
+	struct usage usage;
+	/* Last page allocated from, per size class. */
+	uint16_t hint[CLASS_COUNT_MAX];
+};
+
+static struct page pages[PAGE_COUNT_MAX];
+static struct arena arenas[ARENA_COUNT];
+static struct usage total;
+static uint8_t *heap_base;
+static size_t page_count;
+
+static K_MUTEX_DEFINE(heap_lock);
+
+static size_t block_size(uint8_t size_class)
+{
+	return BLOCK_SIZE_MIN << size_class;
+}
+
+static uint8_t size_class_get(size_t size)
+{
+	uint8_t size_class = 0;
+
+	while (block_size(size_class) < size) {
+		size_class++;
+	}
+
+	return size_class;
+}
+
+static uint8_t *page_addr(size_t index)
+{
+	return heap_base + index * PAGE_SIZE;
+}
+
+static uint16_t block_next_get(uint8_t *block)
+{
+	uint16_t next;
+
+	memcpy(&next, block, sizeof(next));
+
+	return next;
+}
+
+static void block_next_set(uint8_t *block, uint16_t next)
+{
+	memcpy(block, &next, sizeof(next));
+}
+
+static void usage_add(struct usage *usage, size_t size)
+{
+	usage->used += size;
+	usage->allocs++;
+	usage->peak = MAX(usage->peak, usage->used);
+}
+
+static void usage_sub(struct usage *usage, size_t size)
+{
+	usage->used -= size;
+	usage->allocs--;
+}
+
+static void arena_clear(struct arena *arena)
+{
+	memset(arena, 0, sizeof(*arena));
+
+	for (size_t i = 0; i < ARRAY_SIZE(arena->hint); i++) {
+		arena->hint[i] = PAGE_NONE;
+	}
+}
+
+static uint8_t arena_current(void)
+{
+	k_tid_t thread = k_current_get();
+
+	for (uint8_t i = 1; i < ARRAY_SIZE(arenas); i++) {
+		if (arenas[i].in_use && arenas[i].thread == thread) {
+			return i;
+		}
+	}
+
+	return NRF_MBEDTLS_HEAP_ARENA_SHARED;
+}
+
+static bool arena_is_valid(int arena)
+{
+	return arena > NRF_MBEDTLS_HEAP_ARENA_SHARED && arena < ARENA_COUNT &&
+	       arenas[arena].in_use;
+}
+
+static bool slab_has_free(size_t index, uint8_t arena, uint8_t size_class)
+{
+	return index < page_count && pages[index].type == PAGE_SLAB &&
+	       pages[index].arena == arena && pages[index].size_class == size_class &&
+	       pages[index].count > 0;
+}
+
+/* Slabs are taken from the top of the heap and runs from the bottom, so that
+ * long-lived small blocks do not split the space needed by large buffers.
+ */
+static size_t slab_new(uint8_t arena, uint8_t size_class)
+{
+	size_t blocks = PAGE_SIZE / block_size(size_class);
+	size_t index = page_count;
+	uint8_t *addr;
+
+	while (index > 0 && pages[index - 1].type != PAGE_FREE) {
+		index--;
+	}
+
+	if (index == 0) {
+		return PAGE_NONE;
+	}
+	index--;
+
+	addr = page_addr(index);
+	for (size_t i = 0; i < blocks; i++) {
+		block_next_set(addr + i * block_size(size_class),
+			       i + 1 < blocks ? i + 1 : BLOCK_NONE);
+	}
+
+	pages[index].type = PAGE_SLAB;
+	pages[index].arena = arena;
+	pages[index].size_class = size_class;
+	pages[index].count = blocks;
+	pages[index].free_head = 0;
+
+	return index;
+}
+
+static void *slab_alloc(uint8_t arena, uint8_t size_class)
+{
+	uint16_t *hint = &arenas[arena].hint[size_class];
+	size_t index = *hint;
+	struct page *page;
+	uint8_t *block;
+
+	if (!slab_has_free(index, arena, size_class)) {
+		for (index = 0; index < page_count; index++) {
+			if (slab_has_free(index, arena, size_class)) {
+				break;
+			}
+		}
+	}
+
+	if (index == page_count) {
+		index = slab_new(arena, size_class);
+		if (index == PAGE_NONE) {
+			return NULL;
+		}
+	}
+
+	*hint = index;
+	page = &pages[index];
+
+	block = page_addr(index) + page->free_head * block_size(size_class);
+	page->free_head = block_next_get(block);
+	page->count--;
+
+	return block;
+}
+
+static void *run_alloc(uint8_t arena, size_t count)
+{
+	size_t start = 0;
+
+	for (size_t i = 0; i < page_count; i++) {
+		if (pages[i].type != PAGE_FREE) {
+			start = i + 1;
+			continue;
+		}
+
+		if (i + 1 - start == count) {
+			for (size_t j = start; j <= i; j++) {
+				pages[j].type = PAGE_RUN_TAIL;
+				pages[j].arena = arena;
+			}
+
+			pages[start].type = PAGE_RUN;
+			pages[start].count = count;
+
+			return page_addr(start);
+		}
+	}
+
+	return NULL;
+}
+
+static void *heap_calloc(size_t n, size_t size)
+{
+	struct arena *arena;
+	uint8_t arena_id;
+	size_t length;
+	void *ptr;
+
+	if (n == 0 || size == 0 || n > SIZE_MAX / size) {
+		return NULL;
+	}
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	arena_id = arena_current();
+	arena = &arenas[arena_id];
+
+	if (n * size <= PAGE_SIZE / 2) {
+		uint8_t size_class = size_class_get(n * size);
+
+		length = block_size(size_class);
+		ptr = slab_alloc(arena_id, size_class);
+	} else {
+		length = ROUND_UP(n * size, PAGE_SIZE);
+		ptr = run_alloc(arena_id, length / PAGE_SIZE);
+	}
+
+	if (ptr != NULL) {
+		usage_add(&arena->usage, length);
+		usage_add(&total, length);
+	} else {
+		arena->usage.failures++;
+		total.failures++;
+	}
+
+	k_mutex_unlock(&heap_lock);
+
+	if (ptr != NULL) {
+		memset(ptr, 0, length);
+	}
+
+	return ptr;
+}
+
+static bool slab_block_is_free(size_t index, uint16_t block)
+{
+	const struct page *page = &pages[index];
+	uint16_t next = page->free_head;
+
+	for (uint16_t i = 0; i < page->count; i++) {
+		if (next == block) {
+			return true;
+		}
+
+		next = block_next_get(page_addr(index) + next * block_size(page->size_class));
+	}
+
+	return false;
+}
+
+/* Freeing memory that is not allocated, for example after its arena was
+ * released, would corrupt the heap, so it is fatal even without asserts.
+ */
+static void free_invalid(void *ptr)
+{
+	LOG_ERR("Pointer %p not allocated from the mbed TLS heap", ptr);
+	k_panic();
+}
+
+static void heap_free(void *ptr)
+{
+	uintptr_t offset = (uintptr_t)ptr - (uintptr_t)heap_base;
+	size_t index = offset / PAGE_SIZE;
+	struct page *page;
+	size_t length;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	if ((uintptr_t)ptr < (uintptr_t)heap_base || index >= page_count) {
+		free_invalid(ptr);
+		return;
+	}
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	page = &pages[index];
+
+	if (page->type == PAGE_RUN && offset % PAGE_SIZE == 0) {
+		length = page->count * PAGE_SIZE;
+
+		for (size_t i = index; i < index + page->count; i++) {
+			pages[i].type = PAGE_FREE;
+		}
+	} else if (page->type == PAGE_SLAB && offset % block_size(page->size_class) == 0 &&
+		   !slab_block_is_free(index, (offset % PAGE_SIZE) / block_size(page->size_class))) {
+		length = block_size(page->size_class);
+
+		block_next_set(ptr, page->free_head);
+		page->free_head = (offset % PAGE_SIZE) / length;
+		page->count++;
+
+		if (page->count == PAGE_SIZE / length) {
+			page->type = PAGE_FREE;
+		}
+	} else {
+		k_mutex_unlock(&heap_lock);
+		free_invalid(ptr);
+		return;
+	}
+
+	usage_sub(&arenas[page->arena].usage, length);
+	usage_sub(&total, length);
+
+	k_mutex_unlock(&heap_lock);
+}
+
+static size_t largest_free_get(void)
+{
+	size_t largest = 0;
+	size_t run = 0;
+
+	for (size_t i = 0; i < page_count; i++) {
+		run = pages[i].type == PAGE_FREE ? run + 1 : 0;
+		largest = MAX(largest, run);
+	}
+
+	return largest * PAGE_SIZE;
+}
+
+static void stats_fill(const struct usage *usage, struct nrf_mbedtls_heap_stats *stats)
+{
+	size_t free = page_count * PAGE_SIZE - total.used;
+
+	stats->used = usage->used;
+	stats->peak = usage->peak;
+	stats->allocs = usage->allocs;
+	stats->failures = usage->failures;
+	stats->largest_free = largest_free_get();
+	stats->fragmentation = free == 0 ? 0 : 100 - (stats->largest_free * 100) / free;
+}
+
+int nrf_mbedtls_heap_init(void *buf, size_t size)
+{
+	uint8_t *start = (uint8_t *)ROUND_UP((uintptr_t)buf, BLOCK_SIZE_MIN);
+	size_t count;
+
+	if (size < (size_t)(start - (uint8_t *)buf) + PAGE_SIZE) {
+		return -EINVAL;
+	}
+
+	count = (size - (start - (uint8_t *)buf)) / PAGE_SIZE;
+	if (count > PAGE_COUNT_MAX) {
+		return -EINVAL;
+	}
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	heap_base = start;
+	page_count = count;
+	memset(pages, 0, sizeof(pages));
+	memset(&total, 0, sizeof(total));
+
+	for (size_t i = 0; i < ARRAY_SIZE(arenas); i++) {
+		arena_clear(&arenas[i]);
+	}
+	arenas[NRF_MBEDTLS_HEAP_ARENA_SHARED].in_use = true;
+
+	mbedtls_platform_set_calloc_free(heap_calloc, heap_free);
+
+	k_mutex_unlock(&heap_lock);
+
+	return 0;
+}
+
+int nrf_mbedtls_heap_arena_create(void)
+{
+	int arena = -ENOMEM;
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	for (int i = 1; i < ARENA_COUNT; i++) {
+		if (!arenas[i].in_use) {
+			arena_clear(&arenas[i]);
+			arenas[i].in_use = true;
+			arena = i;
+			break;
+		}
+	}
+
+	k_mutex_unlock(&heap_lock);
+
+	return arena;
+}
+
+int nrf_mbedtls_heap_arena_enter(int arena)
+{
+	k_tid_t thread = k_current_get();
+	int err = 0;
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	if (!arena_is_valid(arena)) {
+		err = -EINVAL;
+	} else if (arenas[arena].thread != NULL && arenas[arena].thread != thread) {
+		err = -EBUSY;
+	} else {
+		for (size_t i = 1; i < ARRAY_SIZE(arenas); i++) {
+			if (arenas[i].thread == thread) {
+				arenas[i].thread = NULL;
+			}
+		}
+
+		arenas[arena].thread = thread;
+	}
+
+	k_mutex_unlock(&heap_lock);
+
+	return err;
+}
+
+void nrf_mbedtls_heap_arena_exit(void)
+{
+	k_tid_t thread = k_current_get();
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	for (size_t i = 1; i < ARRAY_SIZE(arenas); i++) {
+		if (arenas[i].thread == thread) {
+			arenas[i].thread = NULL;
+		}
+	}
+
+	k_mutex_unlock(&heap_lock);
+}
+
+int nrf_mbedtls_heap_arena_release(int arena)
+{
+	struct usage *usage;
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	if (!arena_is_valid(arena)) {
+		k_mutex_unlock(&heap_lock);
+		return -EINVAL;
+	}
+
+	for (size_t i = 0; i < page_count; i++) {
+		if (pages[i].type != PAGE_FREE && pages[i].arena == arena) {
+			/* What is left may hold keys that were never freed. */
+			mbedtls_platform_zeroize(page_addr(i), PAGE_SIZE);
+			memset(&pages[i], 0, sizeof(pages[i]));
+		}
+	}
+
+	usage = &arenas[arena].usage;
+	total.used -= usage->used;
+	total.allocs -= usage->allocs;
+
+	arena_clear(&arenas[arena]);
+
+	k_mutex_unlock(&heap_lock);
+
+	return 0;
+}
+
+void nrf_mbedtls_heap_stats_get(struct nrf_mbedtls_heap_stats *stats)
+{
+	k_mutex_lock(&heap_lock, K_FOREVER);
+	stats_fill(&total, stats);
+	k_mutex_unlock(&heap_lock);
+}
+
+int nrf_mbedtls_heap_arena_stats_get(int arena, struct nrf_mbedtls_heap_stats *stats)
+{
+	int err = 0;
+
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	if (arena == NRF_MBEDTLS_HEAP_ARENA_SHARED || arena_is_valid(arena)) {
+		stats_fill(&arenas[arena].usage, stats);
+	} else {
+		err = -EINVAL;
+	}
+
+	k_mutex_unlock(&heap_lock);
+
+	return err;
+}
+
+void nrf_mbedtls_heap_stats_reset(void)
+{
+	k_mutex_lock(&heap_lock, K_FOREVER);
+
+	total.peak = total.used;
+	total.failures = 0;
+
+	for (size_t i = 0; i < ARRAY_SIZE(arenas); i++) {
+		arenas[i].usage.peak = arenas[i].usage.used;
+		arenas[i].usage.failures = 0;
+	}
+
+	k_mutex_unlock(&heap_lock);
+}
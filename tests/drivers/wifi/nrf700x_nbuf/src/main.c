@@ -0,0 +1,282 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/net/buf.h>
+#include <zephyr/net/dummy.h>
+#include <zephyr/net/net_if.h>
+#include <zephyr/net/net_pkt.h>
+
+#include "zephyr_nbuf.h"
+
+#define FRAME_LEN		1500
+#define BENCHMARK_FRAME_CNT	1000
+
+/* Same as RX_BUF_HEADROOM of the FMAC RX path. */
+#define RX_HEADROOM	4
+#define RX_BUF_SIZE	(CONFIG_NRF700X_RX_MAX_DATA_SIZE + RX_HEADROOM)
+
+static struct net_if *iface;
+static uint8_t frame[FRAME_LEN];
+static uint8_t rx_frame[FRAME_LEN];
+
+/* Mocked RPU packet RAM, the frames are looped back through it. */
+static uint8_t pkt_ram[ROUND_UP(CONFIG_NRF700X_TX_MAX_DATA_SIZE, 4)];
+
+/* Single fragment packet data, as provided by stacks with variable size
+ * buffers.
+ */
+NET_BUF_POOL_FIXED_DEFINE(frag_pool, 2, FRAME_LEN + 4, 4, NULL);
+
+static void dummy_iface_init(struct net_if *iface)
+{
+	ARG_UNUSED(iface);
+}
+
+static int dummy_send(const struct device *dev, struct net_pkt *pkt)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(pkt);
+
+	return 0;
+}
+
+static struct dummy_api dummy_api = {
+	.iface_api.init = dummy_iface_init,
+	.send = dummy_send,
+};
+
+NET_DEVICE_INIT(nbuf_test, "nbuf_test", NULL, NULL, NULL, NULL,
+		CONFIG_KERNEL_INIT_PRIORITY_DEFAULT, &dummy_api, DUMMY_L2,
+		NET_L2_GET_CTX_TYPE(DUMMY_L2), FRAME_LEN);
+
+/* Mocked HAL bus transfers. TX frames are written to the packet RAM rounded
+ * up to a multiple of four bytes, as done by nrf_wifi_hal_buf_map_tx().
+ */
+static void bus_tx(void *nwb)
+{
+	unsigned int len = zep_shim_nbuf_data_size(nwb);
+
+	memcpy(pkt_ram, zep_shim_nbuf_data_get(nwb), ROUND_UP(len, 4));
+}
+
+/* RX frames are read from the packet RAM into a buffer allocated in advance
+ * and the headroom is removed, as done by the FMAC RX path.
+ */
+static void *bus_rx(void *nwb, unsigned int len)
+{
+	uint8_t *data = zep_shim_nbuf_data_get(nwb);
+
+	memcpy(data + RX_HEADROOM, pkt_ram, len);
+
+	zep_shim_nbuf_data_put(nwb, len + RX_HEADROOM);
+	zep_shim_nbuf_data_pull(nwb, RX_HEADROOM);
+
+	return nwb;
+}
+
+static struct net_pkt *tx_pkt_alloc(bool single_frag, unsigned int len)
+{
+	struct net_pkt *pkt;
+
+	if (single_frag) {
+		struct net_buf *buf = net_buf_alloc(&frag_pool, K_NO_WAIT);
+
+		zassert_not_null(buf);
+
+		pkt = net_pkt_alloc_on_iface(iface, K_NO_WAIT);
+		zassert_not_null(pkt);
+
+		net_buf_add_mem(buf, frame, len);
+		net_pkt_append_buffer(pkt, buf);
+	} else {
+		pkt = net_pkt_alloc_with_buffer(iface, len, AF_UNSPEC, 0, K_NO_WAIT);
+		zassert_not_null(pkt);
+		zassert_equal(net_pkt_write(pkt, frame, len), 0);
+	}
+
+	net_pkt_cursor_init(pkt);
+
+	return pkt;
+}
+
+static void rx_pkt_check(struct net_pkt *pkt, unsigned int len)
+{
+	zassert_not_null(pkt);
+	zassert_equal(net_pkt_get_len(pkt), len);
+
+	net_pkt_cursor_init(pkt);
+	zassert_equal(net_pkt_read(pkt, rx_frame, len), 0);
+	zassert_mem_equal(rx_frame, frame, len);
+}
+
+/* TX packet through the driver and the bus, received back as RX packet. */
+static struct net_pkt *loopback(struct net_pkt *pkt)
+{
+	unsigned int len = net_pkt_get_len(pkt);
+	void *nwb;
+
+	nwb = net_pkt_to_nbuf(pkt);
+	zassert_not_null(nwb);
+
+	/* Released by the L2 after the send, the driver keeps what it needs. */
+	net_pkt_unref(pkt);
+
+	bus_tx(nwb);
+
+	/* TX done. */
+	zep_shim_nbuf_free(nwb);
+
+	nwb = zep_shim_nbuf_alloc(RX_BUF_SIZE);
+	zassert_not_null(nwb);
+
+	return net_pkt_from_nbuf(iface, bus_rx(nwb, len));
+}
+
+static void *setup(void)
+{
+	iface = net_if_get_first_by_type(&NET_L2_GET_NAME(DUMMY));
+	zassert_not_null(iface);
+
+	for (size_t i = 0; i < sizeof(frame); i++) {
+		frame[i] = i;
+	}
+
+	return NULL;
+}
+
+ZTEST(nrf700x_nbuf, test_tx_zero_copy)
+{
+	struct net_pkt *pkt;
+	uint8_t *frag_data;
+	void *nwb;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_NRF700X_NET_BUF_POOL);
+
+	pkt = tx_pkt_alloc(true, FRAME_LEN);
+	frag_data = pkt->buffer->data;
+
+	nwb = net_pkt_to_nbuf(pkt);
+	zassert_not_null(nwb);
+	zassert_equal_ptr(zep_shim_nbuf_data_get(nwb), frag_data, "Packet data copied");
+	zassert_equal(zep_shim_nbuf_data_size(nwb), FRAME_LEN);
+
+	/* The packet must stay valid until the TX done. */
+	net_pkt_unref(pkt);
+	zassert_equal(atomic_get(&pkt->atomic_ref), 1);
+	zassert_mem_equal(zep_shim_nbuf_data_get(nwb), frame, FRAME_LEN);
+
+	zep_shim_nbuf_free(nwb);
+}
+
+ZTEST(nrf700x_nbuf, test_tx_copy)
+{
+	struct net_pkt *pkt;
+	void *nwb;
+
+	pkt = tx_pkt_alloc(false, FRAME_LEN);
+	zassert_not_null(pkt->buffer->frags, "Expected a fragmented packet");
+
+	nwb = net_pkt_to_nbuf(pkt);
+	zassert_not_null(nwb);
+	net_pkt_unref(pkt);
+
+	zassert_equal(zep_shim_nbuf_data_size(nwb), FRAME_LEN);
+	zassert_mem_equal(zep_shim_nbuf_data_get(nwb), frame, FRAME_LEN);
+
+	zep_shim_nbuf_free(nwb);
+}
+
+ZTEST(nrf700x_nbuf, test_rx_zero_copy)
+{
+	struct net_pkt *pkt;
+	uint8_t *data;
+	void *nwb;
+
+	Z_TEST_SKIP_IFNDEF(CONFIG_NRF700X_NET_BUF_POOL);
+
+	memcpy(pkt_ram, frame, FRAME_LEN);
+
+	nwb = zep_shim_nbuf_alloc(RX_BUF_SIZE);
+	zassert_not_null(nwb);
+
+	bus_rx(nwb, FRAME_LEN);
+	data = zep_shim_nbuf_data_get(nwb);
+
+	pkt = net_pkt_from_nbuf(iface, nwb);
+	rx_pkt_check(pkt, FRAME_LEN);
+	zassert_equal_ptr(pkt->buffer->data, data, "Frame copied");
+	zassert_is_null(pkt->buffer->frags);
+
+	net_pkt_unref(pkt);
+}
+
+ZTEST(nrf700x_nbuf, test_loopback)
+{
+	struct net_pkt *pkt;
+
+	pkt = loopback(tx_pkt_alloc(true, FRAME_LEN));
+	rx_pkt_check(pkt, FRAME_LEN);
+	net_pkt_unref(pkt);
+
+	pkt = loopback(tx_pkt_alloc(false, FRAME_LEN));
+	rx_pkt_check(pkt, FRAME_LEN);
+	net_pkt_unref(pkt);
+
+	/* Length not aligned to the bus transfer size. */
+	pkt = loopback(tx_pkt_alloc(true, FRAME_LEN - 1));
+	rx_pkt_check(pkt, FRAME_LEN - 1);
+	net_pkt_unref(pkt);
+}
+
+ZTEST(nrf700x_nbuf, test_pool_exhausted)
+{
+	void *nwb[CONFIG_NRF700X_NET_BUF_POOL_CNT + 2];
+	struct net_pkt *pkt;
+
+	/* Allocation falls back to the heap. */
+	for (size_t i = 0; i < ARRAY_SIZE(nwb); i++) {
+		nwb[i] = zep_shim_nbuf_alloc(RX_BUF_SIZE);
+		zassert_not_null(nwb[i], "Allocation %zu failed", i);
+	}
+
+	memcpy(pkt_ram, frame, FRAME_LEN);
+	pkt = net_pkt_from_nbuf(iface, bus_rx(nwb[ARRAY_SIZE(nwb) - 1], FRAME_LEN));
+	rx_pkt_check(pkt, FRAME_LEN);
+	net_pkt_unref(pkt);
+
+	for (size_t i = 0; i < (ARRAY_SIZE(nwb) - 1); i++) {
+		zep_shim_nbuf_free(nwb[i]);
+	}
+}
+
+static uint32_t loopback_benchmark(bool single_frag)
+{
+	uint32_t start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCHMARK_FRAME_CNT; i++) {
+		struct net_pkt *pkt = loopback(tx_pkt_alloc(single_frag, FRAME_LEN));
+
+		zassert_not_null(pkt);
+		net_pkt_unref(pkt);
+	}
+
+	return (k_cycle_get_32() - start) / BENCHMARK_FRAME_CNT;
+}
+
+ZTEST(nrf700x_nbuf, test_benchmark)
+{
+	uint32_t single_cycles = loopback_benchmark(true);
+	uint32_t frag_cycles = loopback_benchmark(false);
+
+	printk("%u byte frame loopback, %s: single fragment %u cycles/frame, "
+	       "fragmented %u cycles/frame\n", FRAME_LEN,
+	       IS_ENABLED(CONFIG_NRF700X_NET_BUF_POOL) ? "pool" : "heap",
+	       single_cycles, frag_cycles);
+}
+
+ZTEST_SUITE(nrf700x_nbuf, NULL, setup, NULL, NULL, NULL);
@@ -0,0 +1,374 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/dlist.h>
+
+#include "osal_api.h"
+#include "osal_ops.h"
+#include "queue.h"
+#include "nbuf_queue.h"
+#include "zephyr_nbuf.h"
+
+#define NBUF_CNT		8
+#define NBUF_SIZE		64
+#define BENCHMARK_FRAME_CNT	1000
+
+/* Linked list of the OS layer, as implemented by the Zephyr shim. */
+struct llist {
+	sys_dlist_t head;
+	unsigned int len;
+};
+
+struct llist_node {
+	sys_dnode_t head;
+	void *data;
+};
+
+static struct nrf_wifi_osal_priv *opriv;
+static void *nbufs[NBUF_CNT];
+static unsigned int llist_node_alloc_cnt;
+
+
+static void *mem_zalloc(size_t size)
+{
+	return k_calloc(size, sizeof(char));
+}
+
+static void mem_free(void *buf)
+{
+	k_free(buf);
+}
+
+static int log_err(const char *fmt, va_list args)
+{
+	vprintk(fmt, args);
+
+	return 0;
+}
+
+static void *llist_node_alloc(void)
+{
+	struct llist_node *node = k_calloc(sizeof(*node), sizeof(char));
+
+	if (node) {
+		sys_dnode_init(&node->head);
+		llist_node_alloc_cnt++;
+	}
+
+	return node;
+}
+
+static void llist_node_free(void *node)
+{
+	k_free(node);
+}
+
+static void *llist_node_data_get(void *node)
+{
+	return ((struct llist_node *)node)->data;
+}
+
+static void llist_node_data_set(void *node, void *data)
+{
+	((struct llist_node *)node)->data = data;
+}
+
+static void *llist_alloc(void)
+{
+	return k_calloc(sizeof(struct llist), sizeof(char));
+}
+
+static void llist_free(void *llist)
+{
+	k_free(llist);
+}
+
+static void llist_init(void *llist)
+{
+	sys_dlist_init(&((struct llist *)llist)->head);
+}
+
+static void llist_add_node_tail(void *llist, void *node)
+{
+	sys_dlist_append(&((struct llist *)llist)->head, &((struct llist_node *)node)->head);
+	((struct llist *)llist)->len++;
+}
+
+static void llist_add_node_head(void *llist, void *node)
+{
+	sys_dlist_prepend(&((struct llist *)llist)->head, &((struct llist_node *)node)->head);
+	((struct llist *)llist)->len++;
+}
+
+static void *llist_get_node_head(void *llist)
+{
+	return sys_dlist_peek_head(&((struct llist *)llist)->head);
+}
+
+static void *llist_get_node_nxt(void *llist, void *node)
+{
+	return sys_dlist_peek_next(&((struct llist *)llist)->head,
+				   &((struct llist_node *)node)->head);
+}
+
+static void llist_del_node(void *llist, void *node)
+{
+	sys_dlist_remove(&((struct llist_node *)node)->head);
+	((struct llist *)llist)->len--;
+}
+
+static unsigned int llist_len(void *llist)
+{
+	return ((struct llist *)llist)->len;
+}
+
+static const struct nrf_wifi_osal_ops test_ops = {
+	.mem_zalloc = mem_zalloc,
+	.mem_free = mem_free,
+	.log_err = log_err,
+
+	.llist_node_alloc = llist_node_alloc,
+	.llist_node_free = llist_node_free,
+	.llist_node_data_get = llist_node_data_get,
+	.llist_node_data_set = llist_node_data_set,
+	.llist_alloc = llist_alloc,
+	.llist_free = llist_free,
+	.llist_init = llist_init,
+	.llist_add_node_tail = llist_add_node_tail,
+	.llist_add_node_head = llist_add_node_head,
+	.llist_get_node_head = llist_get_node_head,
+	.llist_get_node_nxt = llist_get_node_nxt,
+	.llist_del_node = llist_del_node,
+	.llist_len = llist_len,
+
+	.nbuf_alloc = zep_shim_nbuf_alloc,
+	.nbuf_free = zep_shim_nbuf_free,
+	.nbuf_data_size = zep_shim_nbuf_data_size,
+	.nbuf_data_put = zep_shim_nbuf_data_put,
+	.nbuf_next_get = zep_shim_nbuf_next_get,
+	.nbuf_next_set = zep_shim_nbuf_next_set,
+};
+
+const struct nrf_wifi_osal_ops *get_os_ops(void)
+{
+	return &test_ops;
+}
+
+static void *setup(void)
+{
+	opriv = nrf_wifi_osal_init();
+	zassert_not_null(opriv);
+
+	for (size_t i = 0; i < ARRAY_SIZE(nbufs); i++) {
+		nbufs[i] = nrf_wifi_osal_nbuf_alloc(opriv, NBUF_SIZE);
+		zassert_not_null(nbufs[i]);
+		nrf_wifi_osal_nbuf_data_put(opriv, nbufs[i], i + 1);
+	}
+
+	return NULL;
+}
+
+static void teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (size_t i = 0; i < ARRAY_SIZE(nbufs); i++) {
+		nrf_wifi_osal_nbuf_free(opriv, nbufs[i]);
+	}
+
+	nrf_wifi_osal_deinit(opriv);
+}
+
+ZTEST(nrf700x_nbuf_queue, test_fifo)
+{
+	struct nrf_wifi_utils_nbuf_q q;
+
+	nrf_wifi_utils_nbuf_q_init(&q);
+	zassert_equal(nrf_wifi_utils_nbuf_q_len(&q), 0);
+	zassert_is_null(nrf_wifi_utils_nbuf_q_peek(&q));
+	zassert_is_null(nrf_wifi_utils_nbuf_q_dequeue(opriv, &q));
+
+	nrf_wifi_utils_nbuf_q_enqueue(opriv, &q, nbufs[1]);
+	nrf_wifi_utils_nbuf_q_enqueue(opriv, &q, nbufs[2]);
+	nrf_wifi_utils_nbuf_q_enqueue_head(opriv, &q, nbufs[0]);
+	zassert_equal(nrf_wifi_utils_nbuf_q_len(&q), 3);
+	zassert_equal_ptr(nrf_wifi_utils_nbuf_q_peek(&q), nbufs[0]);
+
+	for (size_t i = 0; i < 3; i++) {
+		zassert_equal_ptr(nrf_wifi_utils_nbuf_q_dequeue(opriv, &q), nbufs[i]);
+		zassert_is_null(nrf_wifi_osal_nbuf_next_get(opriv, nbufs[i]));
+	}
+
+	zassert_equal(nrf_wifi_utils_nbuf_q_len(&q), 0);
+	zassert_is_null(nrf_wifi_utils_nbuf_q_dequeue(opriv, &q));
+
+	/* The tail is reset once the queue has been emptied. */
+	nrf_wifi_utils_nbuf_q_enqueue_head(opriv, &q, nbufs[3]);
+	nrf_wifi_utils_nbuf_q_enqueue(opriv, &q, nbufs[4]);
+	zassert_equal_ptr(nrf_wifi_utils_nbuf_q_dequeue(opriv, &q), nbufs[3]);
+	zassert_equal_ptr(nrf_wifi_utils_nbuf_q_dequeue(opriv, &q), nbufs[4]);
+	zassert_equal(nrf_wifi_utils_nbuf_q_len(&q), 0);
+}
+
+ZTEST(nrf700x_nbuf_queue, test_move)
+{
+	struct nrf_wifi_utils_nbuf_q pend_q;
+	struct nrf_wifi_utils_nbuf_q txq;
+	void *nbuf;
+
+	nrf_wifi_utils_nbuf_q_init(&pend_q);
+	nrf_wifi_utils_nbuf_q_init(&txq);
+
+	for (size_t i = 0; i < ARRAY_SIZE(nbufs); i++) {
+		nrf_wifi_utils_nbuf_q_enqueue(opriv, &pend_q, nbufs[i]);
+	}
+
+	/* Frames are moved from the pending queue to a TX descriptor queue,
+	 * as done by the FMAC TX path.
+	 */
+	while (nrf_wifi_utils_nbuf_q_len(&txq) < (ARRAY_SIZE(nbufs) / 2)) {
+		nbuf = nrf_wifi_utils_nbuf_q_dequeue(opriv, &pend_q);
+		nrf_wifi_utils_nbuf_q_enqueue(opriv, &txq, nbuf);
+	}
+
+	zassert_equal(nrf_wifi_utils_nbuf_q_len(&pend_q), ARRAY_SIZE(nbufs) / 2);
+	zassert_equal_ptr(nrf_wifi_utils_nbuf_q_peek(&pend_q), nbufs[ARRAY_SIZE(nbufs) / 2]);
+
+	for (size_t i = 0; i < ARRAY_SIZE(nbufs); i++) {
+		struct nrf_wifi_utils_nbuf_q *q = (i < ARRAY_SIZE(nbufs) / 2) ? &txq : &pend_q;
+
+		zassert_equal_ptr(nrf_wifi_utils_nbuf_q_dequeue(opriv, q), nbufs[i]);
+	}
+}
+
+struct traverse_ctx {
+	unsigned int cnt;
+	unsigned int len;
+	void *stop;
+};
+
+static enum nrf_wifi_status traverse_fn(void *callbk_data, void *nbuf)
+{
+	struct traverse_ctx *ctx = callbk_data;
+
+	if (nbuf == ctx->stop) {
+		return NRF_WIFI_STATUS_FAIL;
+	}
+
+	ctx->cnt++;
+	ctx->len += nrf_wifi_osal_nbuf_data_size(opriv, nbuf);
+
+	return NRF_WIFI_STATUS_SUCCESS;
+}
+
+ZTEST(nrf700x_nbuf_queue, test_traverse)
+{
+	struct nrf_wifi_utils_nbuf_q q;
+	struct traverse_ctx ctx = { 0 };
+
+	nrf_wifi_utils_nbuf_q_init(&q);
+
+	for (size_t i = 0; i < 3; i++) {
+		nrf_wifi_utils_nbuf_q_enqueue(opriv, &q, nbufs[i]);
+	}
+
+	zassert_equal(nrf_wifi_utils_nbuf_q_traverse(opriv, &q, &ctx, traverse_fn),
+		      NRF_WIFI_STATUS_SUCCESS);
+	zassert_equal(ctx.cnt, 3);
+	zassert_equal(ctx.len, 1 + 2 + 3);
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.stop = nbufs[1];
+
+	zassert_equal(nrf_wifi_utils_nbuf_q_traverse(opriv, &q, &ctx, traverse_fn),
+		      NRF_WIFI_STATUS_FAIL);
+	zassert_equal(ctx.cnt, 1);
+	zassert_equal(nrf_wifi_utils_nbuf_q_len(&q), 3);
+
+	while (nrf_wifi_utils_nbuf_q_dequeue(opriv, &q)) {
+	}
+}
+
+/* Frames enqueued to a pending queue, moved to a TX descriptor queue and
+ * dequeued on the TX done.
+ */
+static uint32_t list_q_benchmark(void)
+{
+	void *pend_q = nrf_wifi_utils_q_alloc(opriv);
+	void *txq = nrf_wifi_utils_list_alloc(opriv);
+	uint32_t start;
+
+	zassert_not_null(pend_q);
+	zassert_not_null(txq);
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCHMARK_FRAME_CNT; i++) {
+		void *nbuf = nbufs[i % ARRAY_SIZE(nbufs)];
+
+		nrf_wifi_utils_q_enqueue(opriv, pend_q, nbuf);
+		nbuf = nrf_wifi_utils_q_dequeue(opriv, pend_q);
+		nrf_wifi_utils_list_add_tail(opriv, txq, nbuf);
+		zassert_equal_ptr(nrf_wifi_utils_q_dequeue(opriv, txq), nbuf);
+	}
+
+	start = k_cycle_get_32() - start;
+
+	nrf_wifi_utils_q_free(opriv, pend_q);
+	nrf_wifi_utils_list_free(opriv, txq);
+
+	return start / BENCHMARK_FRAME_CNT;
+}
+
+static uint32_t nbuf_q_benchmark(void)
+{
+	struct nrf_wifi_utils_nbuf_q pend_q;
+	struct nrf_wifi_utils_nbuf_q txq;
+	uint32_t start;
+
+	nrf_wifi_utils_nbuf_q_init(&pend_q);
+	nrf_wifi_utils_nbuf_q_init(&txq);
+
+	start = k_cycle_get_32();
+
+	for (uint32_t i = 0; i < BENCHMARK_FRAME_CNT; i++) {
+		void *nbuf = nbufs[i % ARRAY_SIZE(nbufs)];
+
+		nrf_wifi_utils_nbuf_q_enqueue(opriv, &pend_q, nbuf);
+		nbuf = nrf_wifi_utils_nbuf_q_dequeue(opriv, &pend_q);
+		nrf_wifi_utils_nbuf_q_enqueue(opriv, &txq, nbuf);
+		zassert_equal_ptr(nrf_wifi_utils_nbuf_q_dequeue(opriv, &txq), nbuf);
+	}
+
+	return (k_cycle_get_32() - start) / BENCHMARK_FRAME_CNT;
+}
+
+ZTEST(nrf700x_nbuf_queue, test_benchmark)
+{
+	unsigned int list_allocs;
+	unsigned int nbuf_allocs;
+	uint32_t list_cycles;
+	uint32_t nbuf_cycles;
+
+	llist_node_alloc_cnt = 0;
+	list_cycles = list_q_benchmark();
+	list_allocs = llist_node_alloc_cnt;
+
+	llist_node_alloc_cnt = 0;
+	nbuf_cycles = nbuf_q_benchmark();
+	nbuf_allocs = llist_node_alloc_cnt;
+
+	zassert_equal(list_allocs, 2 * BENCHMARK_FRAME_CNT);
+	zassert_equal(nbuf_allocs, 0);
+
+	printk("Frame enqueue/dequeue: list queue %u cycles/frame, %u allocations, "
+	       "network buffer queue %u cycles/frame, %u allocations\n",
+	       list_cycles, list_allocs, nbuf_cycles, nbuf_allocs);
+}
+
+ZTEST_SUITE(nrf700x_nbuf_queue, NULL, setup, NULL, NULL, teardown);
@@ -0,0 +1,598 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include "osal_api.h"
+#include "osal_ops.h"
+#include "hal_api.h"
+#include "hal_mem.h"
+#include "fmac_api.h"
+#include "fmac_cmd.h"
+#include "fmac_tx.h"
+#include "fmac_util.h"
+
+#define TEST_PEER_CNT		4
+#define TEST_FRAME_CNT		(TEST_PEER_CNT * 8)
+#define FRAME_LEN		64
+#define BENCHMARK_ROUND_CNT	1000
+
+/* Not exported by fmac_tx.h. */
+void tx_desc_free(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+		  unsigned int desc,
+		  int queue);
+
+struct test_nbuf {
+	void *next;
+	unsigned int len;
+	unsigned char priority;
+	unsigned char data[FRAME_LEN];
+};
+
+static struct nrf_wifi_osal_priv *opriv;
+static struct nrf_wifi_fmac_priv *fpriv;
+static struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx;
+static struct nrf_wifi_fmac_priv_def *def_priv;
+static struct nrf_wifi_fmac_dev_ctx_def *def_dev_ctx;
+static struct nrf_wifi_fmac_vif_ctx vif_ctx;
+static struct test_nbuf frames[TEST_FRAME_CNT];
+
+/* TX commands passed to the stubbed UMAC, in order. */
+static unsigned int sent_desc[TEST_FRAME_CNT];
+static unsigned int sent_peer[TEST_FRAME_CNT];
+static unsigned int sent_cnt;
+static unsigned int done_cnt;
+static unsigned int freed_cnt;
+
+
+static void *mem_zalloc(size_t size)
+{
+	return k_calloc(size, sizeof(char));
+}
+
+static void mem_free(void *buf)
+{
+	k_free(buf);
+}
+
+static void *mem_cpy(void *dest, const void *src, size_t count)
+{
+	return memcpy(dest, src, count);
+}
+
+static void *mem_set(void *start, int val, size_t size)
+{
+	return memset(start, val, size);
+}
+
+static int log_err(const char *fmt, va_list args)
+{
+	vprintk(fmt, args);
+
+	return 0;
+}
+
+static void *spinlock_alloc(void)
+{
+	return k_calloc(sizeof(struct k_spinlock), sizeof(char));
+}
+
+static void spinlock_free(void *lock)
+{
+	k_free(lock);
+}
+
+static void spinlock_noop(void *lock)
+{
+	ARG_UNUSED(lock);
+}
+
+static void nbuf_free(void *nbuf)
+{
+	ARG_UNUSED(nbuf);
+
+	freed_cnt++;
+}
+
+static unsigned int nbuf_data_size(void *nbuf)
+{
+	return ((struct test_nbuf *)nbuf)->len;
+}
+
+static void *nbuf_data_get(void *nbuf)
+{
+	return ((struct test_nbuf *)nbuf)->data;
+}
+
+static unsigned char nbuf_get_priority(void *nbuf)
+{
+	return ((struct test_nbuf *)nbuf)->priority;
+}
+
+static void *nbuf_next_get(void *nbuf)
+{
+	return ((struct test_nbuf *)nbuf)->next;
+}
+
+static void nbuf_next_set(void *nbuf, void *next)
+{
+	((struct test_nbuf *)nbuf)->next = next;
+}
+
+static void assert_op(int test_val, int val, enum nrf_wifi_assert_op_type op, char *msg)
+{
+	zassert_equal(op, NRF_WIFI_ASSERT_NOT_EQUAL_TO);
+	zassert_not_equal(test_val, val, "%s", msg);
+}
+
+static const struct nrf_wifi_osal_ops test_ops = {
+	.mem_zalloc = mem_zalloc,
+	.mem_free = mem_free,
+	.mem_cpy = mem_cpy,
+	.mem_set = mem_set,
+	.log_err = log_err,
+	.log_dbg = log_err,
+
+	.spinlock_alloc = spinlock_alloc,
+	.spinlock_free = spinlock_free,
+	.spinlock_init = spinlock_noop,
+	.spinlock_take = spinlock_noop,
+	.spinlock_rel = spinlock_noop,
+
+	.nbuf_free = nbuf_free,
+	.nbuf_data_size = nbuf_data_size,
+	.nbuf_data_get = nbuf_data_get,
+	.nbuf_get_priority = nbuf_get_priority,
+	.nbuf_next_get = nbuf_next_get,
+	.nbuf_next_set = nbuf_next_set,
+
+	.assert = assert_op,
+};
+
+const struct nrf_wifi_osal_ops *get_os_ops(void)
+{
+	return &test_ops;
+}
+
+/* Stubbed HAL and UMAC interfaces, the TX commands are only recorded. */
+enum nrf_wifi_status hal_rpu_mem_write(struct nrf_wifi_hal_dev_ctx *hal_ctx,
+				       unsigned int rpu_mem_addr,
+				       void *host_addr,
+				       unsigned int len)
+{
+	return NRF_WIFI_STATUS_SUCCESS;
+}
+
+unsigned long nrf_wifi_hal_buf_map_tx(struct nrf_wifi_hal_dev_ctx *hal_ctx,
+				      unsigned long buf,
+				      unsigned int buf_len,
+				      unsigned int desc_id,
+				      unsigned int token,
+				      unsigned int buf_indx)
+{
+	return buf;
+}
+
+unsigned long nrf_wifi_hal_buf_unmap_tx(struct nrf_wifi_hal_dev_ctx *hal_ctx,
+					unsigned int desc_id)
+{
+	return 1;
+}
+
+enum nrf_wifi_status nrf_wifi_hal_data_cmd_send(struct nrf_wifi_hal_dev_ctx *hal_ctx,
+						enum NRF_WIFI_HAL_MSG_TYPE cmd_type,
+						void *data_cmd,
+						unsigned int data_cmd_size,
+						unsigned int desc_id,
+						unsigned int pool_id)
+{
+	struct nrf_wifi_tx_buff *config = (void *)((struct host_rpu_msg *)data_cmd)->msg;
+
+	zassert_equal(config->tx_desc_num, desc_id);
+
+	if (sent_cnt < ARRAY_SIZE(sent_desc)) {
+		sent_desc[sent_cnt] = desc_id;
+		sent_peer[sent_cnt] = config->mac_hdr_info.dest[5];
+	}
+
+	sent_cnt++;
+
+	return NRF_WIFI_STATUS_SUCCESS;
+}
+
+struct host_rpu_msg *umac_cmd_alloc(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+				    int type,
+				    int len)
+{
+	struct host_rpu_msg *umac_cmd;
+
+	umac_cmd = nrf_wifi_osal_mem_zalloc(fmac_dev_ctx->fpriv->opriv,
+					    sizeof(*umac_cmd) + len);
+	zassert_not_null(umac_cmd);
+
+	umac_cmd->type = type;
+
+	return umac_cmd;
+}
+
+void *wifi_fmac_priv(struct nrf_wifi_fmac_priv *def)
+{
+	return &def->priv;
+}
+
+void *wifi_dev_priv(struct nrf_wifi_fmac_dev_ctx *def)
+{
+	return &def->priv;
+}
+
+/* Frames are addressed to 02:00:00:00:00:<peer ID>. */
+int nrf_wifi_fmac_peer_get_id(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+			      const unsigned char *mac_addr)
+{
+	return mac_addr[5];
+}
+
+bool nrf_wifi_util_is_multicast_addr(const unsigned char *addr)
+{
+	return addr[0] & 0x01;
+}
+
+bool nrf_wifi_util_ether_addr_equal(const unsigned char *addr_1,
+				    const unsigned char *addr_2)
+{
+	return !memcmp(addr_1, addr_2, NRF_WIFI_ETH_ADDR_LEN);
+}
+
+int nrf_wifi_util_get_tid(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+			  void *nwb)
+{
+	return 0;
+}
+
+unsigned char *nrf_wifi_util_get_ra(struct nrf_wifi_fmac_vif_ctx *vif,
+				    void *nwb)
+{
+	return nbuf_data_get(nwb);
+}
+
+unsigned char *nrf_wifi_util_get_dest(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+				      void *nwb)
+{
+	return nbuf_data_get(nwb);
+}
+
+unsigned char *nrf_wifi_util_get_src(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+				     void *nwb)
+{
+	return (unsigned char *)nbuf_data_get(nwb) + NRF_WIFI_ETH_ADDR_LEN;
+}
+
+unsigned short nrf_wifi_util_tx_get_eth_type(struct nrf_wifi_fmac_dev_ctx *fmac_dev_ctx,
+					     void *nwb)
+{
+	return 0;
+}
+
+static void *frame_get(unsigned int idx, unsigned int peer)
+{
+	struct test_nbuf *frame = &frames[idx];
+
+	memset(frame, 0, sizeof(*frame));
+
+	frame->len = FRAME_LEN;
+	frame->data[0] = 0x02;
+	frame->data[5] = peer;
+
+	return frame;
+}
+
+/* Frames of the peers are queued in turn. */
+static void frames_queue(const unsigned int *frame_cnt)
+{
+	unsigned int idx = 0;
+	bool queued = true;
+
+	for (unsigned int round = 0; queued; round++) {
+		queued = false;
+
+		for (unsigned int peer = 0; peer < TEST_PEER_CNT; peer++) {
+			if (frame_cnt[peer] <= round) {
+				continue;
+			}
+
+			zassert_equal(nrf_wifi_fmac_start_xmit(fmac_dev_ctx, 0,
+							       frame_get(idx++, peer)),
+				      NRF_WIFI_STATUS_SUCCESS);
+			queued = true;
+		}
+	}
+}
+
+/* The RPU reports the TX done of the descriptors in submission order. */
+static void tx_done_all(void)
+{
+	struct nrf_wifi_tx_buff_done config = { 0 };
+
+	while (done_cnt < sent_cnt) {
+		config.tx_desc_num = sent_desc[done_cnt++];
+
+		zassert_equal(nrf_wifi_fmac_tx_done_event_process(fmac_dev_ctx, &config),
+			      NRF_WIFI_STATUS_SUCCESS);
+	}
+}
+
+/* Reference round robin: the next peer, starting from the one which has the
+ * opportunity, with pending frames.
+ */
+static unsigned int rr_next(unsigned int *frame_cnt, unsigned int *opp)
+{
+	for (unsigned int i = 0; i < MAX_PEERS; i++) {
+		unsigned int peer = (*opp + i) % MAX_PEERS;
+
+		if ((peer < TEST_PEER_CNT) && frame_cnt[peer]) {
+			frame_cnt[peer]--;
+			*opp = (peer + 1) % MAX_PEERS;
+			return peer;
+		}
+	}
+
+	zassert_unreachable("No pending frames");
+
+	return MAX_PEERS;
+}
+
+static void rr_check(unsigned int start, const unsigned int *frame_cnt)
+{
+	unsigned int pending[TEST_PEER_CNT];
+	unsigned int total = 0;
+	unsigned int opp = 0;
+
+	memcpy(pending, frame_cnt, sizeof(pending));
+
+	for (unsigned int peer = 0; peer < TEST_PEER_CNT; peer++) {
+		total += pending[peer];
+	}
+
+	zassert_equal(sent_cnt, start + total);
+
+	for (unsigned int i = start; i < sent_cnt; i++) {
+		zassert_equal(sent_peer[i], rr_next(pending, &opp),
+			      "Unfair peer selection at frame %u", i);
+	}
+}
+
+static void *setup(void)
+{
+	opriv = nrf_wifi_osal_init();
+	zassert_not_null(opriv);
+
+	return NULL;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	fpriv = nrf_wifi_osal_mem_zalloc(opriv, sizeof(*fpriv) + sizeof(*def_priv));
+	zassert_not_null(fpriv);
+	fpriv->opriv = opriv;
+
+	def_priv = wifi_fmac_priv(fpriv);
+	def_priv->num_tx_tokens = CONFIG_NRF700X_MAX_TX_TOKENS;
+	def_priv->num_tx_tokens_per_ac = def_priv->num_tx_tokens / NRF_WIFI_FMAC_AC_MAX;
+	def_priv->num_tx_tokens_spare = def_priv->num_tx_tokens % NRF_WIFI_FMAC_AC_MAX;
+	/* One frame per TX command, so that every frame is scheduled. */
+	def_priv->data_config.max_tx_aggregation = 1;
+	def_priv->avail_ampdu_len_per_token = 8192;
+
+	fmac_dev_ctx = nrf_wifi_osal_mem_zalloc(opriv,
+						sizeof(*fmac_dev_ctx) + sizeof(*def_dev_ctx));
+	zassert_not_null(fmac_dev_ctx);
+	fmac_dev_ctx->fpriv = fpriv;
+
+	def_dev_ctx = wifi_dev_priv(fmac_dev_ctx);
+	def_dev_ctx->tx_buf_info = nrf_wifi_osal_mem_zalloc(opriv,
+							    sizeof(*def_dev_ctx->tx_buf_info) *
+							    def_priv->num_tx_tokens);
+	zassert_not_null(def_dev_ctx->tx_buf_info);
+
+	memset(&vif_ctx, 0, sizeof(vif_ctx));
+	vif_ctx.if_type = NRF_WIFI_IFTYPE_STATION;
+	def_dev_ctx->vif_ctx[0] = &vif_ctx;
+
+	zassert_equal(tx_init(fmac_dev_ctx), NRF_WIFI_STATUS_SUCCESS);
+
+	for (unsigned int peer = 0; peer < TEST_PEER_CNT; peer++) {
+		def_dev_ctx->tx_config.peers[peer].peer_id = peer;
+		def_dev_ctx->tx_config.peers[peer].if_idx = 0;
+	}
+
+	sent_cnt = 0;
+	done_cnt = 0;
+	freed_cnt = 0;
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	tx_deinit(fmac_dev_ctx);
+
+	nrf_wifi_osal_mem_free(opriv, def_dev_ctx->tx_buf_info);
+	nrf_wifi_osal_mem_free(opriv, fmac_dev_ctx);
+	nrf_wifi_osal_mem_free(opriv, fpriv);
+}
+
+static void teardown(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	nrf_wifi_osal_deinit(opriv);
+}
+
+ZTEST(nrf700x_tx_sched, test_desc_alloc)
+{
+	unsigned int per_ac = def_priv->num_tx_tokens_per_ac;
+	unsigned int ac = NRF_WIFI_FMAC_AC_BE;
+	unsigned int desc;
+	unsigned int cnt;
+
+	/* Reserved descriptors of the AC first. */
+	for (cnt = 0; cnt < per_ac; cnt++) {
+		zassert_equal(tx_desc_get(fmac_dev_ctx, ac), ac + (NRF_WIFI_FMAC_AC_MAX * cnt));
+	}
+
+	/* Then the spare ones, shared by all ACs. */
+	for (desc = per_ac * NRF_WIFI_FMAC_AC_MAX; desc < def_priv->num_tx_tokens; desc++) {
+		zassert_equal(tx_desc_get(fmac_dev_ctx, ac), desc);
+	}
+
+	zassert_equal(tx_desc_get(fmac_dev_ctx, ac), def_priv->num_tx_tokens);
+	zassert_equal(def_dev_ctx->tx_config.outstanding_descs[ac],
+		      per_ac + def_priv->num_tx_tokens_spare);
+
+	/* Other ACs still get their reserved descriptors. */
+	zassert_equal(tx_desc_get(fmac_dev_ctx, NRF_WIFI_FMAC_AC_VO), NRF_WIFI_FMAC_AC_VO);
+	zassert_equal(tx_desc_get(fmac_dev_ctx, NRF_WIFI_FMAC_AC_MC), NRF_WIFI_FMAC_AC_MC);
+
+	/* A released descriptor is found again. */
+	desc = ac + (NRF_WIFI_FMAC_AC_MAX * (per_ac - 1));
+
+	tx_desc_free(fmac_dev_ctx, desc, ac);
+	zassert_equal(tx_desc_get(fmac_dev_ctx, ac), desc);
+
+	if (def_priv->num_tx_tokens_spare) {
+		desc = def_priv->num_tx_tokens - 1;
+
+		tx_desc_free(fmac_dev_ctx, desc, ac);
+		zassert_equal(def_dev_ctx->tx_config.outstanding_descs[ac],
+			      per_ac + def_priv->num_tx_tokens_spare - 1);
+		zassert_equal(tx_desc_get(fmac_dev_ctx, ac), desc);
+	}
+}
+
+ZTEST(nrf700x_tx_sched, test_round_robin)
+{
+	const unsigned int frame_cnt[TEST_PEER_CNT] = { 6, 2, 0, 7 };
+
+	/* Frames are only queued while the RPU is in TWT sleep. */
+	def_dev_ctx->twt_sleep_status = NRF_WIFI_FMAC_TWT_STATE_SLEEP;
+	frames_queue(frame_cnt);
+	zassert_equal(sent_cnt, 0);
+	zassert_equal(def_dev_ctx->tx_config.pend_peer_bmp[NRF_WIFI_FMAC_AC_BE],
+		      BIT(0) | BIT(1) | BIT(3));
+
+	/* On wakeup, all the available descriptors are put to use. */
+	def_dev_ctx->twt_sleep_status = NRF_WIFI_FMAC_TWT_STATE_AWAKE;
+
+	for (unsigned int cnt = 0; cnt < def_priv->num_tx_tokens; cnt++) {
+		unsigned int desc = tx_desc_get(fmac_dev_ctx, NRF_WIFI_FMAC_AC_BE);
+
+		if (desc == def_priv->num_tx_tokens) {
+			break;
+		}
+
+		zassert_equal(tx_pending_process(fmac_dev_ctx, desc, NRF_WIFI_FMAC_AC_BE),
+			      NRF_WIFI_STATUS_SUCCESS);
+	}
+
+	tx_done_all();
+
+	rr_check(0, frame_cnt);
+	zassert_equal(freed_cnt, sent_cnt);
+	zassert_equal(def_dev_ctx->tx_config.pend_peer_bmp[NRF_WIFI_FMAC_AC_BE], 0);
+}
+
+ZTEST(nrf700x_tx_sched, test_power_save)
+{
+	const unsigned int frame_cnt[TEST_PEER_CNT] = { 4, 4, 4, 4 };
+	const unsigned int awake_cnt[TEST_PEER_CNT] = { 4, 0, 4, 4 };
+	struct peers_info *peer = &def_dev_ctx->tx_config.peers[1];
+
+	/* Peer 1 is in power save, its frames are held back. */
+	peer->ps_state = NRF_WIFI_CLIENT_PS_MODE;
+	def_dev_ctx->tx_config.ps_peer_bmp = BIT(1);
+
+	frames_queue(frame_cnt);
+	tx_done_all();
+
+	rr_check(0, awake_cnt);
+	zassert_equal(def_dev_ctx->tx_config.pend_peer_bmp[NRF_WIFI_FMAC_AC_BE], BIT(1));
+
+	/* The peer polls for two frames, which get precedence. */
+	peer->ps_token_count = 2;
+	def_dev_ctx->tx_config.wakeup_peer_bmp = BIT(1);
+
+	zassert_equal(tx_pending_process(fmac_dev_ctx,
+					 tx_desc_get(fmac_dev_ctx, NRF_WIFI_FMAC_AC_BE),
+					 NRF_WIFI_FMAC_AC_BE),
+		      NRF_WIFI_STATUS_SUCCESS);
+	tx_done_all();
+
+	zassert_equal(sent_cnt, 12 + 2);
+	zassert_equal(sent_peer[12], 1);
+	zassert_equal(sent_peer[13], 1);
+	zassert_equal(peer->ps_token_count, 0);
+	zassert_equal(def_dev_ctx->tx_config.wakeup_peer_bmp, 0);
+	zassert_equal(nrf_wifi_utils_nbuf_q_len(
+			&def_dev_ctx->tx_config.data_pending_txq[1][NRF_WIFI_FMAC_AC_BE]), 2);
+}
+
+ZTEST(nrf700x_tx_sched, test_benchmark)
+{
+	unsigned int ac = NRF_WIFI_FMAC_AC_BE;
+	uint32_t desc_cycles;
+	uint32_t sched_cycles;
+	uint32_t start;
+
+	/* Reserved descriptors taken, the spare ones are searched. */
+	for (unsigned int cnt = 0; cnt < def_priv->num_tx_tokens_per_ac; cnt++) {
+		tx_desc_get(fmac_dev_ctx, ac);
+	}
+
+	start = k_cycle_get_32();
+
+	for (unsigned int i = 0; i < BENCHMARK_ROUND_CNT; i++) {
+		unsigned int desc = tx_desc_get(fmac_dev_ctx, ac);
+
+		tx_desc_free(fmac_dev_ctx, desc, ac);
+	}
+
+	desc_cycles = (k_cycle_get_32() - start) / BENCHMARK_ROUND_CNT;
+
+	/* Frame of the last peer, all others have pending frames in power save. */
+	for (unsigned int peer = 0; peer < TEST_PEER_CNT - 1; peer++) {
+		def_dev_ctx->tx_config.peers[peer].ps_state = NRF_WIFI_CLIENT_PS_MODE;
+		def_dev_ctx->tx_config.ps_peer_bmp |= BIT(peer);
+		zassert_equal(nrf_wifi_fmac_start_xmit(fmac_dev_ctx, 0, frame_get(peer, peer)),
+			      NRF_WIFI_STATUS_SUCCESS);
+	}
+
+	start = k_cycle_get_32();
+
+	for (unsigned int i = 0; i < BENCHMARK_ROUND_CNT; i++) {
+		struct nrf_wifi_tx_buff_done config = { 0 };
+
+		zassert_equal(nrf_wifi_fmac_start_xmit(fmac_dev_ctx, 0,
+						       frame_get(TEST_PEER_CNT - 1,
+								 TEST_PEER_CNT - 1)),
+			      NRF_WIFI_STATUS_SUCCESS);
+
+		config.tx_desc_num = sent_desc[0];
+		zassert_equal(nrf_wifi_fmac_tx_done_event_process(fmac_dev_ctx, &config),
+			      NRF_WIFI_STATUS_SUCCESS);
+		sent_cnt = 0;
+	}
+
+	sched_cycles = (k_cycle_get_32() - start) / BENCHMARK_ROUND_CNT;
+
+	printk("TX scheduler, %u tokens: descriptor get/free %u cycles, "
+	       "frame xmit/TX done %u cycles\n", def_priv->num_tx_tokens,
+	       desc_cycles, sched_cycles);
+}
+
+ZTEST_SUITE(nrf700x_tx_sched, NULL, setup, before, after, teardown);
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include "hid_items.h"
+
+/* Large rollover keyboard. */
+#define ITEM_COUNT	32
+#define RANDOM_OP_CNT	2000
+
+struct items {
+	uint8_t item_count_max;
+	uint8_t item_count;
+	struct hid_item item[ITEM_COUNT];
+};
+
+struct key_op {
+	uint16_t usage_id;
+	int16_t value;
+};
+
+static struct items items;
+static struct items ref_items;
+static struct key_op ops[RANDOM_OP_CNT];
+static uint32_t cycles;
+static uint32_t ref_cycles;
+
+
+/* Reference implementation, which sorts the whole array after every change
+ * of the number of items.
+ */
+static void sort_by_usage_id(struct hid_item item[], size_t array_size)
+{
+	for (size_t k = 0; k < array_size; k++) {
+		size_t id = k;
+
+		for (size_t l = k + 1; l < array_size; l++) {
+			if (item[l].usage_id < item[id].usage_id) {
+				id = l;
+			}
+		}
+		if (id != k) {
+			struct hid_item tmp = item[k];
+
+			item[k] = item[id];
+			item[id] = tmp;
+		}
+	}
+}
+
+static struct hid_item *ref_find(struct items *set, uint16_t usage_id)
+{
+	ssize_t lower = 0;
+	ssize_t upper = ARRAY_SIZE(set->item) - 1;
+
+	while (upper >= lower) {
+		ssize_t m = (lower + upper) / 2;
+
+		if (set->item[m].usage_id == usage_id) {
+			return &set->item[m];
+		} else if (usage_id < set->item[m].usage_id) {
+			upper = m - 1;
+		} else {
+			lower = m + 1;
+		}
+	}
+
+	return NULL;
+}
+
+static bool ref_key_value_set(struct items *set, uint16_t usage_id, int16_t value)
+{
+	const uint8_t prev_item_count = set->item_count;
+	struct hid_item *p_item = ref_find(set, usage_id);
+	bool update_needed = false;
+
+	if (p_item) {
+		p_item->value += value;
+		if (p_item->value == 0) {
+			set->item_count -= 1;
+			p_item->usage_id = 0;
+		}
+		update_needed = true;
+	} else if ((value > 0) && (prev_item_count < set->item_count_max)) {
+		size_t const idx = ARRAY_SIZE(set->item) - prev_item_count - 1;
+
+		set->item[idx].usage_id = usage_id;
+		set->item[idx].value = value;
+		set->item_count += 1;
+		update_needed = true;
+	}
+
+	if (prev_item_count != set->item_count) {
+		sort_by_usage_id(set->item, ARRAY_SIZE(set->item));
+	}
+
+	return update_needed;
+}
+
+static void replay(const struct key_op *op, size_t op_cnt, const char *name)
+{
+	memset(&items, 0, sizeof(items));
+	memset(&ref_items, 0, sizeof(ref_items));
+	items.item_count_max = ITEM_COUNT;
+	ref_items.item_count_max = ITEM_COUNT;
+	cycles = 0;
+	ref_cycles = 0;
+
+	for (size_t i = 0; i < op_cnt; i++) {
+		uint32_t start;
+		bool update;
+		bool ref_update;
+
+		start = k_cycle_get_32();
+		update = hid_items_update(items.item, ARRAY_SIZE(items.item), &items.item_count,
+					  items.item_count_max, op[i].usage_id, op[i].value);
+		cycles += k_cycle_get_32() - start;
+
+		start = k_cycle_get_32();
+		ref_update = ref_key_value_set(&ref_items, op[i].usage_id, op[i].value);
+		ref_cycles += k_cycle_get_32() - start;
+
+		zassert_equal(update, ref_update, "%s: op %zu: update mismatch", name, i);
+		zassert_mem_equal(&items, &ref_items, sizeof(items),
+				  "%s: op %zu: item set mismatch", name, i);
+	}
+
+	printk("%s: %zu events, sorted insert %u cycles/event, selection sort %u cycles/event\n",
+	       name, op_cnt, (uint32_t)(cycles / op_cnt), (uint32_t)(ref_cycles / op_cnt));
+}
+
+ZTEST(hid_items, test_typing)
+{
+	size_t cnt = 0;
+
+	/* Fast typing: every key is released after the next one is pressed. */
+	for (uint16_t usage_id = 0x04; usage_id <= 0x27; usage_id++) {
+		ops[cnt++] = (struct key_op){ .usage_id = usage_id, .value = 1 };
+		if (usage_id > 0x04) {
+			ops[cnt++] = (struct key_op){ .usage_id = usage_id - 1, .value = -1 };
+		}
+	}
+	ops[cnt++] = (struct key_op){ .usage_id = 0x27, .value = -1 };
+
+	replay(ops, cnt, "typing");
+	zassert_equal(items.item_count, 0, "Keys left pressed");
+}
+
+ZTEST(hid_items, test_macro_burst)
+{
+	size_t cnt = 0;
+
+	/* Macro: all keys pressed in descending order, which moves the whole
+	 * set on every insert, and released in ascending order.
+	 */
+	for (uint16_t i = 0; i < ITEM_COUNT; i++) {
+		ops[cnt++] = (struct key_op){ .usage_id = 0x04 + ITEM_COUNT - i, .value = 1 };
+	}
+	/* Overflow and unpaired release are ignored. */
+	ops[cnt++] = (struct key_op){ .usage_id = 0x03, .value = 1 };
+	ops[cnt++] = (struct key_op){ .usage_id = 0x03, .value = -1 };
+	for (uint16_t i = 0; i < ITEM_COUNT; i++) {
+		ops[cnt++] = (struct key_op){ .usage_id = 0x05 + i, .value = -1 };
+	}
+
+	replay(ops, cnt, "macro burst");
+	zassert_equal(items.item_count, 0, "Keys left pressed");
+}
+
+ZTEST(hid_items, test_random)
+{
+	uint16_t pressed[ITEM_COUNT];
+	size_t pressed_cnt = 0;
+	uint32_t rand = 0x12345678;
+
+	for (size_t i = 0; i < ARRAY_SIZE(ops); i++) {
+		rand = rand * 1103515245 + 12345;
+
+		if ((pressed_cnt > 0) && ((rand >> 16) % 2)) {
+			size_t idx = (rand >> 8) % pressed_cnt;
+
+			ops[i] = (struct key_op){ .usage_id = pressed[idx], .value = -1 };
+			pressed[idx] = pressed[--pressed_cnt];
+		} else {
+			/* Keys may be reported twice, for example by two
+			 * key IDs mapped to the same usage.
+			 */
+			uint16_t usage_id = 0x04 + (rand >> 8) % 0xA0;
+
+			ops[i] = (struct key_op){ .usage_id = usage_id, .value = 1 };
+			if (pressed_cnt < ARRAY_SIZE(pressed)) {
+				pressed[pressed_cnt++] = usage_id;
+			}
+		}
+	}
+
+	replay(ops, ARRAY_SIZE(ops), "random");
+}
+
+ZTEST_SUITE(hid_items, NULL, NULL, NULL, NULL, NULL);
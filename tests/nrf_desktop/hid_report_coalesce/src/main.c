@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+
+#include "hid_report_coalesce.h"
+
+/* Simulated sensor and transport. */
+#define SENSOR_PERIOD_US	1000
+#define TX_INTERVAL_US		7500
+#define SIM_TIME_US		(1000 * USEC_PER_MSEC)
+#define MAX_ENQUEUED_ITEMS	2
+#define MOTION_PER_SAMPLE	3
+#define CLICK_PERIOD_US		(100 * USEC_PER_MSEC)
+#define CLICK_LEN_US		(20 * USEC_PER_MSEC)
+
+struct sim_report {
+	uint8_t data[REPORT_SIZE_MOUSE];
+	/* Number of sensor samples in the report. */
+	uint32_t samples;
+	/* Sum and minimum of the sample timestamps. */
+	uint64_t time_sum;
+	uint32_t time_min;
+};
+
+struct sim_result {
+	uint32_t generated;
+	uint32_t delivered;
+	int32_t dx_generated;
+	int32_t dx_delivered;
+	uint32_t clicks_generated;
+	uint32_t clicks_delivered;
+	uint64_t latency_sum;
+	uint32_t latency_max;
+};
+
+static struct sim_report queue[MAX_ENQUEUED_ITEMS];
+static size_t queue_len;
+
+
+static void mouse_report_encode(uint8_t *data, uint8_t buttons, int8_t wheel, int16_t x, int16_t y)
+{
+	data[0] = buttons;
+	data[1] = wheel;
+	data[2] = x & 0xff;
+	data[3] = ((y & 0x0f) << 4) | ((x >> 8) & 0x0f);
+	data[4] = (y >> 4) & 0xff;
+}
+
+static void mouse_report_decode(const uint8_t *data, uint8_t *buttons, int8_t *wheel,
+				int16_t *x, int16_t *y)
+{
+	*buttons = data[0];
+	*wheel = data[1];
+	*x = hid_mouse_report_xy_get(data[2] | ((data[3] & 0x0f) << 8));
+	*y = hid_mouse_report_xy_get((data[3] >> 4) | (data[4] << 4));
+}
+
+static void deliver(const struct sim_report *report, uint32_t time, struct sim_result *res,
+		    uint8_t *last_buttons)
+{
+	uint8_t buttons;
+	int8_t wheel;
+	int16_t x, y;
+
+	mouse_report_decode(report->data, &buttons, &wheel, &x, &y);
+
+	res->delivered += report->samples;
+	res->dx_delivered += x;
+	res->latency_sum += (uint64_t)time * report->samples - report->time_sum;
+	res->latency_max = MAX(res->latency_max, time - report->time_min);
+
+	if (buttons && !*last_buttons) {
+		res->clicks_delivered++;
+	}
+	*last_buttons = buttons;
+}
+
+/* Model of the report path of the HID forward module: a report is submitted
+ * right away if the subscriber is not busy, otherwise it is enqueued and the
+ * oldest enqueued report is dropped if the queue is full. The subscriber
+ * becomes ready on every transport interval.
+ */
+static void simulate(bool coalesce, struct sim_result *res)
+{
+	struct sim_report in_flight;
+	bool busy = false;
+	uint8_t last_buttons = 0;
+	uint32_t next_tx = TX_INTERVAL_US;
+
+	memset(res, 0, sizeof(*res));
+	queue_len = 0;
+
+	for (uint32_t t = 0; t < SIM_TIME_US; t += SENSOR_PERIOD_US) {
+		while (next_tx <= t) {
+			/* Transport slot: the report in flight is delivered. */
+			if (busy) {
+				deliver(&in_flight, next_tx, res, &last_buttons);
+			}
+
+			busy = (queue_len > 0);
+			if (busy) {
+				in_flight = queue[0];
+				memmove(&queue[0], &queue[1], --queue_len * sizeof(queue[0]));
+			}
+
+			next_tx += TX_INTERVAL_US;
+		}
+
+		uint8_t buttons = ((t % CLICK_PERIOD_US) < CLICK_LEN_US) ? BIT(0) : 0;
+		struct sim_report report = {
+			.samples = 1,
+			.time_sum = t,
+			.time_min = t,
+		};
+
+		mouse_report_encode(report.data, buttons, 0, MOTION_PER_SAMPLE, 0);
+		res->generated++;
+		res->dx_generated += MOTION_PER_SAMPLE;
+		if (buttons && ((t % CLICK_PERIOD_US) == 0)) {
+			res->clicks_generated++;
+		}
+
+		if (!busy) {
+			in_flight = report;
+			busy = true;
+		} else if (coalesce && (queue_len > 0) &&
+			   hid_mouse_report_merge(queue[queue_len - 1].data, report.data)) {
+			struct sim_report *tail = &queue[queue_len - 1];
+
+			tail->samples += report.samples;
+			tail->time_sum += report.time_sum;
+		} else {
+			if (queue_len == ARRAY_SIZE(queue)) {
+				/* Drop the oldest report. */
+				memmove(&queue[0], &queue[1], --queue_len * sizeof(queue[0]));
+			}
+			queue[queue_len++] = report;
+		}
+	}
+}
+
+static void print_result(const char *name, const struct sim_result *res)
+{
+	printk("%s: delivered %u/%u samples, motion %d/%d, clicks %u/%u, "
+	       "latency mean %u us, max %u us\n",
+	       name, res->delivered, res->generated, res->dx_delivered, res->dx_generated,
+	       res->clicks_delivered, res->clicks_generated,
+	       res->delivered ? (uint32_t)(res->latency_sum / res->delivered) : 0,
+	       res->latency_max);
+}
+
+ZTEST(hid_report_coalesce, test_axis_add)
+{
+	zassert_equal(hid_axis_add(100, -300), -200);
+	zassert_equal(hid_axis_add(INT16_MAX - 1, 10), INT16_MAX);
+	zassert_equal(hid_axis_add(INT16_MIN + 1, -10), INT16_MIN);
+	zassert_equal(hid_axis_add(INT16_MAX, INT16_MIN), -1);
+}
+
+ZTEST(hid_report_coalesce, test_mouse_report_merge)
+{
+	uint8_t dst[REPORT_SIZE_MOUSE];
+	uint8_t src[REPORT_SIZE_MOUSE];
+	uint8_t buttons;
+	int8_t wheel;
+	int16_t x, y;
+
+	mouse_report_encode(dst, BIT(1), -3, -1000, 17);
+	mouse_report_encode(src, BIT(1), 1, 999, -2000);
+	zassert_true(hid_mouse_report_merge(dst, src), "Reports not merged");
+
+	mouse_report_decode(dst, &buttons, &wheel, &x, &y);
+	zassert_equal(buttons, BIT(1));
+	zassert_equal(wheel, -2);
+	zassert_equal(x, -1);
+	zassert_equal(y, -1983);
+
+	/* Button state change. */
+	mouse_report_encode(src, 0, 0, 1, 1);
+	zassert_false(hid_mouse_report_merge(dst, src), "Button change merged");
+
+	/* Motion out of the report range. */
+	mouse_report_encode(dst, 0, 0, 0, MOUSE_REPORT_XY_MIN);
+	mouse_report_encode(src, 0, 0, 0, -1);
+	zassert_false(hid_mouse_report_merge(dst, src), "Overflow merged");
+	mouse_report_decode(dst, &buttons, &wheel, &x, &y);
+	zassert_equal(y, MOUSE_REPORT_XY_MIN, "Report modified");
+}
+
+ZTEST(hid_report_coalesce, test_boot_mouse_report_merge)
+{
+	uint8_t dst[REPORT_SIZE_MOUSE_BOOT] = { 0x01, (uint8_t)-100, 20 };
+	uint8_t src[REPORT_SIZE_MOUSE_BOOT] = { 0x01, 50, (uint8_t)-30 };
+
+	zassert_true(hid_boot_mouse_report_merge(dst, src), "Reports not merged");
+	zassert_equal((int8_t)dst[1], -50);
+	zassert_equal((int8_t)dst[2], -10);
+
+	src[1] = 100;
+	zassert_true(hid_boot_mouse_report_merge(dst, src), "Reports not merged");
+	zassert_false(hid_boot_mouse_report_merge(dst, src), "Overflow merged");
+}
+
+ZTEST(hid_report_coalesce, test_latency)
+{
+	struct sim_result queued;
+	struct sim_result coalesced;
+
+	simulate(false, &queued);
+	simulate(true, &coalesced);
+
+	print_result("enqueue", &queued);
+	print_result("coalesce", &coalesced);
+
+	/* All samples are delivered, apart from the ones that are still
+	 * enqueued or in flight when the simulation ends.
+	 */
+	zassert_true(coalesced.generated - coalesced.delivered <=
+		     2 * TX_INTERVAL_US / SENSOR_PERIOD_US, "Motion dropped");
+	zassert_equal(coalesced.dx_delivered, coalesced.delivered * MOTION_PER_SAMPLE,
+		      "Motion not preserved");
+	zassert_equal(coalesced.clicks_delivered, coalesced.clicks_generated, "Click dropped");
+	zassert_true(coalesced.latency_max <= 3 * TX_INTERVAL_US, "Latency too high");
+	zassert_true(queued.delivered < coalesced.delivered, "Unexpected enqueue result");
+}
+
+ZTEST_SUITE(hid_report_coalesce, NULL, NULL, NULL, NULL, NULL);
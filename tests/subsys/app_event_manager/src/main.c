@@ -9,6 +9,9 @@
 
 #include "sized_events.h"
 #include "test_events.h"
+#include "test_config.h"
+
+#define DISPATCH_TIME_ROUNDS 100
 
 static enum test_id cur_test_id;
 static K_SEM_DEFINE(test_end_sem, 0, 1);
@@ -179,6 +182,58 @@ ZTEST(suite0, test_event_size_disabled)
 	app_event_manager_free(ev_s1);
 }
 
+#if IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS)
+static void check_stats(const struct app_event_manager_stats *stats, uint32_t count)
+{
+	uint32_t hist_count = 0;
+
+	zassert_not_null(stats, "No statistics");
+	zassert_equal(stats->count, count, "Unexpected number of measurements");
+	zassert_true(stats->min <= stats->max, "Minimum larger than maximum");
+	zassert_true(stats->total >= (uint64_t)stats->min * count, "Total too small");
+	zassert_true(stats->total <= (uint64_t)stats->max * count, "Total too large");
+
+	for (size_t i = 0; i < ARRAY_SIZE(stats->histogram); i++) {
+		hist_count += stats->histogram[i];
+	}
+	zassert_equal(hist_count, count, "Histogram does not match the count");
+}
+
+ZTEST(suite0, test_stats)
+{
+	const struct event_type *start_et = APP_EVENT_ID(test_start_event);
+	const struct event_type *end_et = APP_EVENT_ID(test_end_event);
+
+	/* Statistics are cleared before the test start event is processed. */
+	_app_event_manager_stats_reset();
+	test_start(TEST_BASIC);
+
+	check_stats(&_app_event_manager_queue_stats[start_et - _event_type_list_start], 1);
+	check_stats(&_app_event_manager_queue_stats[end_et - _event_type_list_start], 1);
+	/* Test end event is processed only after all test start event
+	 * notifications are measured.
+	 */
+	check_stats(_app_event_manager_subscriber_stats_get(start_et->subs_start), 1);
+}
+#endif /* CONFIG_APP_EVENT_MANAGER_STATS */
+
+ZTEST(suite0, test_dispatch_time)
+{
+	uint32_t start_time = k_cycle_get_32();
+
+	for (size_t i = 0; i < DISPATCH_TIME_ROUNDS; i++) {
+		test_start(TEST_EVENT_ORDER);
+	}
+
+	/* Compare the results with and without CONFIG_APP_EVENT_MANAGER_STATS
+	 * to get the cost of the statistics.
+	 */
+	printk("Dispatched %d rounds of %d events, statistics %s.\n"
+	       "Time per round [us]: %u\n", DISPATCH_TIME_ROUNDS, TEST_EVENT_ORDER_CNT + 2,
+	       IS_ENABLED(CONFIG_APP_EVENT_MANAGER_STATS) ? "enabled" : "disabled",
+	       k_cyc_to_us_near32(k_cycle_get_32() - start_time) / DISPATCH_TIME_ROUNDS);
+}
+
 ZTEST(suite0, test_name_style_events_sorting)
 {
 	test_start(TEST_NAME_STYLE_SORTING);
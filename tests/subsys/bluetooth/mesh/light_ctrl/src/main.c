@@ -11,6 +11,9 @@
 #include <bluetooth/mesh/light_ctrl_srv.h>
 #include <bluetooth/mesh/light_ctrl_reg_spec.h>
 #include "light_ctrl_internal.h"
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+#include "light_ctrl_reg_spec_internal.h"
+#endif
 
 #define FLAGS_CONFIGURATION (BIT(FLAG_STARTED) | BIT(FLAG_OCC_MODE))
 
@@ -642,6 +645,18 @@ ZTEST(light_ctrl_test, test_default_cfg)
 	check_default_cfg();
 }
 
+static void reg_spec_internal_sum_set(float i)
+{
+	struct bt_mesh_light_ctrl_reg_spec *spec_reg =
+		CONTAINER_OF(light_ctrl_srv.reg, struct bt_mesh_light_ctrl_reg_spec, reg);
+
+#if defined(CONFIG_BT_MESH_LIGHT_CTRL_REG_SPEC_FIXED_POINT)
+	spec_reg->i = reg_q_from_float(i);
+#else
+	spec_reg->i = i;
+#endif
+}
+
 /**
  * Verify that PI Regulator keeps internal sum and its output within the range defined in
  * MeshMDLv1.0.1, table 6.53.
@@ -659,8 +674,7 @@ ZTEST(light_ctrl_pi_reg_test, test_pi_regulator_shall_not_wrap_around)
 	start_reg(CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_LUX_ON -
 		  REG_ACCURACY(CONFIG_BT_MESH_LIGHT_CTRL_SRV_REG_LUX_ON) - 1);
 	/* Tweak internal sum of the regulator to avoid long execution time.*/
-	((struct bt_mesh_light_ctrl_reg_spec *)light_ctrl_srv.reg)->i = 65528 *
-		SUMMATION_STEP(light_ctrl_srv.reg->cfg.ki.up);
+	reg_spec_internal_sum_set(65528 * SUMMATION_STEP(light_ctrl_srv.reg->cfg.ki.up));
 	trigger_pi_reg(1, true);
 	/* Expected lightness = 65529 * U * T * Kiu + U * Kpu = 65529 + 5 = 65534. */
 	zassert_equal(pi_reg_test_ctx.lightness, 65534, "Incorrect lightness value: %d",
@@ -687,8 +701,7 @@ ZTEST(light_ctrl_pi_reg_test, test_pi_regulator_shall_not_wrap_around)
 
 	/* Drive lightness value to 0 and check that it stops changing. */
 	/* Tweak internal sum of the regulator to avoid long execution time.*/
-	((struct bt_mesh_light_ctrl_reg_spec *)light_ctrl_srv.reg)->i = 65535 - 65528 *
-		SUMMATION_STEP(light_ctrl_srv.reg->cfg.ki.up);
+	reg_spec_internal_sum_set(65535 - 65528 * SUMMATION_STEP(light_ctrl_srv.reg->cfg.ki.up));
 	trigger_pi_reg(1, true);
 	/* Expected lightness = 65535 - 65529 * U * T * Kid - U * Kpd = 1. */
 	zassert_equal(pi_reg_test_ctx.lightness, 1, "Incorrect lightness value: %d",
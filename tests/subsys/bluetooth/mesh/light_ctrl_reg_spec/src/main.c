@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+/* Private header from the source folder */
+#include "light_ctrl_reg_spec_internal.h"
+
+#define ITERATIONS 1000
+/* Largest accepted difference between the outputs, in lightness levels. */
+#define OUTPUT_TOLERANCE 2.0f
+
+typedef float (*input_fn_t)(int step);
+
+static const struct bt_mesh_light_ctrl_reg_cfg cfgs[] = {
+	/* Default server configuration. */
+	{ .ki = { .up = 250, .down = 25 }, .kp = { .up = 80, .down = 80 }, .accuracy = 2 },
+	/* Largest coefficients allowed by the specification. */
+	{ .ki = { .up = 1000, .down = 1000 }, .kp = { .up = 1000, .down = 1000 }, .accuracy = 0 },
+	/* Coefficients that can't be represented exactly. */
+	{ .ki = { .up = 0.37f, .down = 12.1f }, .kp = { .up = 3.3f, .down = 0.01f }, .accuracy = 7 },
+};
+
+static const float targets[] = { 0.0f, 1.0f, 500.0f, 1234.5f, 167772.0f };
+
+static float step_input(int step)
+{
+	return step < ITERATIONS / 2 ? 0.0f : 800.0f;
+}
+
+static float ramp_up_input(int step)
+{
+	return step * 2.5f;
+}
+
+static float ramp_down_input(int step)
+{
+	return 1000.0f - step * 1.7f;
+}
+
+static void compare(input_fn_t measured_get, const char *name)
+{
+	uint32_t float_cycles = 0;
+	uint32_t q_cycles = 0;
+	uint32_t start;
+
+	for (int c = 0; c < ARRAY_SIZE(cfgs); c++) {
+		struct bt_mesh_light_ctrl_reg_spec_q_cfg cfg_q;
+
+		reg_q_cfg_set(&cfg_q, &cfgs[c]);
+
+		for (int t = 0; t < ARRAY_SIZE(targets); t++) {
+			float i = 0.0f;
+			int64_t i_q = 0;
+			bool neg = false;
+			bool neg_q = false;
+
+			for (int step = 0; step < ITERATIONS; step++) {
+				float measured = measured_get(step);
+				float output, output_q;
+
+				start = k_cycle_get_32();
+				output = reg_iterate(&i, &neg, targets[t], measured, &cfgs[c]);
+				float_cycles += k_cycle_get_32() - start;
+
+				start = k_cycle_get_32();
+				output_q = reg_q_to_float(reg_iterate_q(&i_q, &neg_q,
+									reg_q_from_float(targets[t]),
+									reg_q_from_float(measured),
+									&cfg_q));
+				q_cycles += k_cycle_get_32() - start;
+
+				/* The output is clamped to the lightness range by the server. */
+				output = CLAMP(output, 0, UINT16_MAX);
+				output_q = CLAMP(output_q, 0, UINT16_MAX);
+
+				zassert_within(output_q, output, OUTPUT_TOLERANCE,
+					       "%s cfg %d target %d step %d: %f != %f", name, c,
+					       t, step, (double)output_q, (double)output);
+			}
+		}
+	}
+
+	printk("%s: float %u cycles/iteration, Q16 %u cycles/iteration\n", name,
+	       float_cycles / (ARRAY_SIZE(cfgs) * ARRAY_SIZE(targets) * ITERATIONS),
+	       q_cycles / (ARRAY_SIZE(cfgs) * ARRAY_SIZE(targets) * ITERATIONS));
+}
+
+ZTEST(light_ctrl_reg_spec_test, test_step)
+{
+	compare(step_input, "step");
+}
+
+ZTEST(light_ctrl_reg_spec_test, test_ramp)
+{
+	compare(ramp_up_input, "ramp up");
+	compare(ramp_down_input, "ramp down");
+}
+
+ZTEST(light_ctrl_reg_spec_test, test_conversion)
+{
+	struct bt_mesh_light_ctrl_reg_spec_q_cfg cfg_q;
+
+	zassert_equal(reg_q_from_float(1.0f), REG_Q_ONE);
+	zassert_equal(reg_q_from_float(-0.5f), -REG_Q_ONE / 2);
+	zassert_equal(reg_q_from_float(167772.0f), 167772 * REG_Q_ONE);
+	zassert_equal(reg_q_to_float(UINT16_MAX * REG_Q_ONE), (float)UINT16_MAX);
+
+	reg_q_cfg_set(&cfg_q, &cfgs[0]);
+	zassert_equal(cfg_q.ki_up, 250 * REG_Q_ONE);
+	zassert_equal(cfg_q.ki_down, 25 * REG_Q_ONE);
+	zassert_equal(cfg_q.kp_up, 80 * REG_Q_ONE);
+	zassert_equal(cfg_q.kp_down, 80 * REG_Q_ONE);
+	zassert_equal(cfg_q.accuracy, 2 * REG_Q_ONE);
+}
+
+ZTEST_SUITE(light_ctrl_reg_spec_test, NULL, NULL, NULL, NULL, NULL);
@@ -2437,4 +2437,79 @@ ZTEST(sensor_types_test, test_present_rel_output_ripple_voltage)
 	percentage8_check(sensor_type);
 }
 
+ZTEST(sensor_types_test, test_sensor_type_section_sorted)
+{
+	const struct bt_mesh_sensor_type *prev = NULL;
+
+	/* bt_mesh_sensor_type_get() does a binary search, which requires the
+	 * linker to place the sensor types in ascending property ID order.
+	 */
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		if (prev) {
+			zassert_true(prev->id < type->id,
+				     "Sensor type 0x%04x placed after 0x%04x",
+				     type->id, prev->id);
+		}
+
+		zassert_equal_ptr(bt_mesh_sensor_type_get(type->id), type,
+				  "Lookup failed for 0x%04x", type->id);
+		prev = type;
+	}
+
+	zassert_is_null(bt_mesh_sensor_type_get(BT_MESH_PROP_ID_PROHIBITED));
+	zassert_is_null(bt_mesh_sensor_type_get(0xffff));
+}
+
+#define DECODE_BENCHMARK_ROUNDS 100
+
+ZTEST(sensor_types_test, test_status_decode_throughput)
+{
+	NET_BUF_SIMPLE_DEFINE(status, 1024);
+	struct sensor_value value[CONFIG_BT_MESH_SENSOR_CHANNELS_MAX];
+	uint32_t entries = 0;
+	uint32_t start, cycles;
+
+	/* Build a status stream like the one a gateway receives when
+	 * aggregating sensors of every known type.
+	 */
+	STRUCT_SECTION_FOREACH(bt_mesh_sensor_type, type) {
+		uint8_t len = sensor_value_len(type);
+
+		zassert_ok(sensor_status_id_encode(&status, len, type->id));
+		memset(net_buf_simple_add(&status, len), 0, len);
+		entries++;
+	}
+
+	start = k_cycle_get_32();
+
+	for (int i = 0; i < DECODE_BENCHMARK_ROUNDS; i++) {
+		struct net_buf_simple_state state;
+
+		net_buf_simple_save(&status, &state);
+
+		while (status.len) {
+			const struct bt_mesh_sensor_type *type;
+			struct net_buf_simple entry;
+			uint16_t id;
+			uint8_t len;
+
+			sensor_status_id_decode(&status, &len, &id);
+			type = bt_mesh_sensor_type_get(id);
+			zassert_not_null(type, "Unknown sensor type 0x%04x", id);
+
+			net_buf_simple_init_with_data(&entry, net_buf_simple_pull_mem(&status, len),
+						      len);
+			(void)sensor_value_decode(&entry, type, value);
+		}
+
+		net_buf_simple_restore(&status, &state);
+	}
+
+	cycles = k_cycle_get_32() - start;
+
+	printk("Decoded %u sensor status entries in %u cycles (%u cycles per entry)\n",
+	       entries * DECODE_BENCHMARK_ROUNDS, cycles,
+	       cycles / (entries * DECODE_BENCHMARK_ROUNDS));
+}
+
 ZTEST_SUITE(sensor_types_test, NULL, NULL, NULL, NULL, NULL);
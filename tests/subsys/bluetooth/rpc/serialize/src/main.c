@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <string.h>
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+
+#include "serialize.h"
+
+static const uint8_t payload[] = {
+	0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d
+};
+
+static uint8_t packet[64];
+static size_t packet_len;
+static int decoding_done_cnt;
+
+/* Set by the loopback test, where releasing a packet lets the sender reuse the buffer. */
+static bool loopback;
+static K_SEM_DEFINE(release_sem, 0, 1);
+
+/** Mocks ******************************************/
+
+void nrf_rpc_cbor_decoding_done(const struct nrf_rpc_group *group, struct nrf_rpc_cbor_ctx *ctx)
+{
+	ARG_UNUSED(group);
+	ARG_UNUSED(ctx);
+
+	decoding_done_cnt++;
+
+	if (loopback) {
+		k_sem_give(&release_sem);
+	}
+}
+
+/** End Mocks **************************************/
+
+/* Encodes the packet like the host does for a GATT payload: the scratchpad size,
+ * followed by the buffer.
+ */
+static void packet_encode(const void *data, size_t len)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+
+	zcbor_new_state(ctx.zs, ARRAY_SIZE(ctx.zs), packet, sizeof(packet), 0);
+
+	ser_encode_uint(&ctx, SCRATCHPAD_ALIGN(len));
+	ser_encode_buffer(&ctx, data, len);
+
+	zassert_true(ser_decode_valid(&ctx), "Encoding failed");
+
+	packet_len = ctx.zs->payload - packet;
+}
+
+static void packet_decode_start(struct nrf_rpc_cbor_ctx *ctx, size_t len)
+{
+	zcbor_new_state(ctx->zs, ARRAY_SIZE(ctx->zs), packet, len, 2);
+}
+
+static bool is_in_packet(const void *ptr)
+{
+	return (const uint8_t *)ptr >= packet && (const uint8_t *)ptr < packet + packet_len;
+}
+
+ZTEST(bt_rpc_serialize, test_buffer_ref)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct ser_scratchpad scratchpad;
+	const uint8_t *data;
+	size_t len;
+
+	packet_encode(payload, sizeof(payload));
+	packet_decode_start(&ctx, packet_len);
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, &ctx);
+
+	data = ser_decode_buffer_ref(&scratchpad, &len);
+
+	zassert_true(ser_decoding_check_ref(NULL, &ctx), "Decoding failed");
+	zassert_equal(len, sizeof(payload), "Wrong length");
+	zassert_mem_equal(data, payload, sizeof(payload), "Wrong payload");
+
+	if (IS_ENABLED(CONFIG_BT_RPC_ZERO_COPY)) {
+		zassert_true(is_in_packet(data), "Payload not referenced in the packet");
+		zassert_equal(decoding_done_cnt, 0, "Packet released before ser_decoding_release");
+	} else {
+		zassert_false(is_in_packet(data), "Payload not copied");
+		zassert_equal(decoding_done_cnt, 1, "Packet not released");
+	}
+
+	ser_decoding_release(NULL, &ctx);
+
+	zassert_equal(decoding_done_cnt, 1, "Packet not released once");
+}
+
+ZTEST(bt_rpc_serialize, test_buffer_ref_null)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct ser_scratchpad scratchpad;
+	const uint8_t *data;
+	size_t len;
+
+	packet_encode(NULL, 0);
+	packet_decode_start(&ctx, packet_len);
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, &ctx);
+
+	data = ser_decode_buffer_ref(&scratchpad, &len);
+
+	zassert_true(ser_decoding_check_ref(NULL, &ctx), "Decoding failed");
+	zassert_is_null(data, "Data should be NULL");
+
+	ser_decoding_release(NULL, &ctx);
+
+	zassert_equal(decoding_done_cnt, 1, "Packet not released once");
+}
+
+ZTEST(bt_rpc_serialize, test_buffer_ref_truncated)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct ser_scratchpad scratchpad;
+	size_t len;
+
+	packet_encode(payload, sizeof(payload));
+	packet_decode_start(&ctx, packet_len - 1);
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, &ctx);
+
+	(void)ser_decode_buffer_ref(&scratchpad, &len);
+
+	/* The packet is released right away, the handler does not call ser_decoding_release. */
+	zassert_false(ser_decoding_check_ref(NULL, &ctx), "Decoding should fail");
+	zassert_equal(decoding_done_cnt, 1, "Packet not released");
+}
+
+/* Loopback model of the IPC transport. The sending thread encodes notifications
+ * into one shared buffer and, like nRF RPC, does not reuse it until the receiver
+ * releases the packet.
+ */
+#define LOOPBACK_PAYLOAD_SIZE 244
+#define LOOPBACK_COUNT 1000
+
+static uint8_t shm[LOOPBACK_PAYLOAD_SIZE + 16];
+static size_t shm_len;
+static size_t copied_bytes;
+static uint32_t checksum;
+
+static K_SEM_DEFINE(rx_sem, 0, 1);
+
+K_THREAD_STACK_DEFINE(sender_stack, 1024);
+static struct k_thread sender_thread;
+
+static void sender_fn(void *p1, void *p2, void *p3)
+{
+	static uint8_t data[LOOPBACK_PAYLOAD_SIZE];
+	struct nrf_rpc_cbor_ctx ctx;
+
+	for (size_t i = 0; i < LOOPBACK_COUNT; i++) {
+		memset(data, (uint8_t)i, sizeof(data));
+
+		zcbor_new_state(ctx.zs, ARRAY_SIZE(ctx.zs), shm, sizeof(shm), 0);
+		ser_encode_uint(&ctx, SCRATCHPAD_ALIGN(sizeof(data)));
+		ser_encode_buffer(&ctx, data, sizeof(data));
+		shm_len = ctx.zs->payload - shm;
+		copied_bytes += sizeof(data);
+
+		k_sem_give(&rx_sem);
+		k_sem_take(&release_sem, K_FOREVER);
+	}
+}
+
+/* Decodes one notification like a handler that copies the payload only when
+ * zero-copy is disabled.
+ */
+static void loopback_receive(void)
+{
+	struct nrf_rpc_cbor_ctx ctx;
+	struct ser_scratchpad scratchpad;
+	const uint8_t *data;
+	size_t len;
+
+	zcbor_new_state(ctx.zs, ARRAY_SIZE(ctx.zs), shm, shm_len, 2);
+
+	SER_SCRATCHPAD_DECLARE(&scratchpad, &ctx);
+
+	data = ser_decode_buffer_ref(&scratchpad, &len);
+
+	zassert_true(ser_decoding_check_ref(NULL, &ctx), "Decoding failed");
+	zassert_equal(len, LOOPBACK_PAYLOAD_SIZE, "Wrong length");
+
+	if (!(data >= shm && data < shm + shm_len)) {
+		copied_bytes += len;
+	}
+
+	for (size_t i = 0; i < len; i++) {
+		checksum += data[i];
+	}
+
+	ser_decoding_release(NULL, &ctx);
+}
+
+ZTEST(bt_rpc_serialize, test_loopback_throughput)
+{
+	uint32_t start;
+	uint32_t elapsed_us;
+	size_t copies_per_byte_x100;
+	uint32_t expected_checksum = 0;
+
+	loopback = true;
+	copied_bytes = 0;
+	checksum = 0;
+
+	start = k_cycle_get_32();
+
+	k_thread_create(&sender_thread, sender_stack, K_THREAD_STACK_SIZEOF(sender_stack),
+			sender_fn, NULL, NULL, NULL, K_PRIO_PREEMPT(0), 0, K_NO_WAIT);
+
+	for (size_t i = 0; i < LOOPBACK_COUNT; i++) {
+		k_sem_take(&rx_sem, K_FOREVER);
+		loopback_receive();
+	}
+
+	k_thread_join(&sender_thread, K_FOREVER);
+
+	elapsed_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	copies_per_byte_x100 = copied_bytes * 100 / (LOOPBACK_COUNT * LOOPBACK_PAYLOAD_SIZE);
+
+	loopback = false;
+
+	TC_PRINT("%d notifications of %d bytes in %u us\n", LOOPBACK_COUNT,
+		 LOOPBACK_PAYLOAD_SIZE, elapsed_us);
+	if (elapsed_us > 0) {
+		TC_PRINT("%u notifications per second\n",
+			 (uint32_t)((uint64_t)LOOPBACK_COUNT * USEC_PER_SEC / elapsed_us));
+	}
+	TC_PRINT("%zu.%02zu copies per byte\n", copies_per_byte_x100 / 100,
+		 copies_per_byte_x100 % 100);
+
+	for (size_t i = 0; i < LOOPBACK_COUNT; i++) {
+		expected_checksum += (uint8_t)i * LOOPBACK_PAYLOAD_SIZE;
+	}
+
+	zassert_equal(checksum, expected_checksum, "Wrong payload");
+
+	/* One copy for the encoding, and one more for the decoding only when
+	 * zero-copy is disabled.
+	 */
+	zassert_equal(copies_per_byte_x100, IS_ENABLED(CONFIG_BT_RPC_ZERO_COPY) ? 100 : 200,
+		      "Wrong number of copies per byte");
+}
+
+static void bt_rpc_serialize_before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	decoding_done_cnt = 0;
+	memset(packet, 0, sizeof(packet));
+}
+
+ZTEST_SUITE(bt_rpc_serialize, NULL, NULL, bt_rpc_serialize_before, NULL, NULL);
@@ -209,4 +209,67 @@ ZTEST(bl_crypto_test, test_bl_root_of_trust_verify)
 	zassert_equal(-ESIGINV, retval, "retval was %d", retval);
 }
 
+static uint32_t sha256_chunked_us(const uint8_t *data, uint32_t data_len, uint32_t chunk_len)
+{
+	int rc;
+	uint8_t output[32];
+	bl_sha256_ctx_t ctx;
+	uint32_t start = k_cycle_get_32();
+
+	rc = bl_sha256_init(&ctx);
+	zassert_equal(0, rc, "bl_sha256_init failed retval was: %d", rc);
+
+	for (uint32_t i = 0; i < data_len; i += chunk_len) {
+		rc = bl_sha256_update(&ctx, &data[i], MIN(chunk_len, data_len - i));
+		zassert_equal(0, rc, "bl_sha256_update failed retval was: %d", rc);
+	}
+
+	rc = bl_sha256_finalize(&ctx, output);
+	zassert_equal(0, rc, "bl_sha256_finalize failed retval was: %d", rc);
+
+	uint32_t us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	zassert_mem_equal(output, const_fw_hash, sizeof(output), "Wrong hash");
+
+	return us;
+}
+
+/* Time the steps of the firmware validation done at boot, for the enabled
+ * backend (CC310, or Oberon on devices without CryptoCell).
+ */
+ZTEST(bl_crypto_test, test_validation_benchmark)
+{
+#if CONFIG_FLASH_SIZE > 300
+	const uint32_t chunk_lens[] = {512, 4096, sizeof(const_fw_data)};
+	uint32_t start;
+	uint32_t us;
+	int retval;
+
+	start = k_cycle_get_32();
+	retval = bl_sha256_verify(const_fw_data, sizeof(const_fw_data), const_fw_hash);
+	us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	zassert_equal(0, retval, "retval was %d", retval);
+
+	printk("SHA-256 of %zu bytes in flash: %u us (%u kB/s)\n",
+	       sizeof(const_fw_data), us, (uint32_t)(sizeof(const_fw_data) * 1000 / MAX(us, 1)));
+
+	for (size_t i = 0; i < ARRAY_SIZE(chunk_lens); i++) {
+		us = sha256_chunked_us(const_fw_data, sizeof(const_fw_data), chunk_lens[i]);
+
+		printk("SHA-256 in chunks of %u bytes: %u us\n", chunk_lens[i], us);
+	}
+
+	start = k_cycle_get_32();
+	retval = bl_root_of_trust_verify(const_pk, const_pk_hash, const_sig, const_firmware,
+					 sizeof(const_firmware));
+	us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	zassert_equal(0, retval, "retval was %d", retval);
+
+	printk("Root of trust verification of %zu bytes: %u us\n",
+	       sizeof(const_firmware), us);
+#else
+	ztest_test_skip();
+#endif
+}
+
 ZTEST_SUITE(bl_crypto_test, NULL, NULL, NULL, NULL, NULL);
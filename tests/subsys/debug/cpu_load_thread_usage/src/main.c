@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include <debug/cpu_load.h>
+
+#define FULL_LOAD	100000
+#define HALF_LOAD	50000
+#define SMALL_LOAD	3000
+#define LOAD_TOLERANCE	5000
+
+#define PERIOD_MS	50
+#define BUCKET_CNT	10
+
+#define WORKER_STACK_SIZE 1024
+#define WORKER_PRIORITY	K_LOWEST_APPLICATION_THREAD_PRIO
+
+static K_THREAD_STACK_DEFINE(worker_stack, WORKER_STACK_SIZE);
+static struct k_thread worker;
+static K_SEM_DEFINE(worker_sem, 0, 1);
+
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	zassert_equal(cpu_load_init(), 0);
+	cpu_load_reset();
+}
+
+ZTEST(cpu_load_thread_usage, test_load)
+{
+	uint32_t load;
+
+	k_busy_wait(PERIOD_MS * USEC_PER_MSEC);
+	load = cpu_load_get();
+	zassert_true(load >= (FULL_LOAD - SMALL_LOAD), "Unexpected load (%d)", load);
+
+	cpu_load_reset();
+	k_msleep(PERIOD_MS);
+	load = cpu_load_get();
+	zassert_true(load <= SMALL_LOAD, "Unexpected load (%d)", load);
+
+	cpu_load_reset();
+	k_busy_wait(PERIOD_MS * USEC_PER_MSEC);
+	k_msleep(PERIOD_MS);
+	load = cpu_load_get();
+	zassert_within(load, HALF_LOAD, LOAD_TOLERANCE, "Unexpected load (%d)", load);
+}
+
+static void worker_fn(void *p1, void *p2, void *p3)
+{
+	struct k_sem *sem = p1;
+
+	ARG_UNUSED(p2);
+	ARG_UNUSED(p3);
+
+	if (sem) {
+		k_sem_take(sem, K_FOREVER);
+	}
+
+	k_busy_wait(PERIOD_MS * USEC_PER_MSEC);
+}
+
+static k_tid_t worker_start(bool wait)
+{
+	return k_thread_create(&worker, worker_stack, K_THREAD_STACK_SIZEOF(worker_stack),
+			       worker_fn, wait ? &worker_sem : NULL, NULL, NULL, WORKER_PRIORITY, 0,
+			       K_NO_WAIT);
+}
+
+ZTEST(cpu_load_thread_usage, test_thread_load)
+{
+	k_tid_t tid;
+	uint32_t load;
+
+	/* Thread existing on the reset. */
+	tid = worker_start(true);
+	k_msleep(PERIOD_MS);
+	cpu_load_reset();
+
+	k_sem_give(&worker_sem);
+	k_msleep(2 * PERIOD_MS);
+
+	zassert_equal(cpu_load_thread_get(tid, &load), 0);
+	zassert_within(load, HALF_LOAD, LOAD_TOLERANCE, "Unexpected worker load (%d)", load);
+
+	zassert_equal(cpu_load_thread_get(k_current_get(), &load), 0);
+	zassert_true(load <= SMALL_LOAD, "Unexpected test thread load (%d)", load);
+
+	zassert_equal(k_thread_join(tid, K_FOREVER), 0);
+
+	/* Thread created after the reset. */
+	cpu_load_reset();
+	tid = worker_start(false);
+	k_msleep(2 * PERIOD_MS);
+
+	zassert_equal(cpu_load_thread_get(tid, &load), 0);
+	zassert_within(load, HALF_LOAD, LOAD_TOLERANCE, "Unexpected worker load (%d)", load);
+
+	zassert_equal(k_thread_join(tid, K_FOREVER), 0);
+}
+
+ZTEST(cpu_load_thread_usage, test_histogram)
+{
+	uint32_t buckets[BUCKET_CNT];
+	int64_t end;
+	int cnt;
+
+	zassert_equal(cpu_load_histogram_get(buckets, 0), -EINVAL);
+
+	/* Fill all the windows with idle time. */
+	k_msleep((CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS + 1) * CONFIG_CPU_LOAD_HISTOGRAM_WINDOW);
+
+	cnt = cpu_load_histogram_get(buckets, ARRAY_SIZE(buckets));
+	zassert_equal(cnt, CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS);
+	zassert_true(buckets[0] >= (uint32_t)(cnt - 1), "Unexpected idle windows (%d)",
+		     buckets[0]);
+
+	/* Fill all the windows with busy time. The test thread yields often
+	 * to let the histogram work item run on time.
+	 */
+	end = k_uptime_get() +
+	      (CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS + 2) * CONFIG_CPU_LOAD_HISTOGRAM_WINDOW;
+	while (k_uptime_get() < end) {
+		k_busy_wait(USEC_PER_MSEC);
+		k_yield();
+	}
+
+	cnt = cpu_load_histogram_get(buckets, ARRAY_SIZE(buckets));
+	zassert_equal(cnt, CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS);
+	zassert_true(buckets[BUCKET_CNT - 1] >= (uint32_t)(cnt - 1),
+		     "Unexpected busy windows (%d)", buckets[BUCKET_CNT - 1]);
+
+	/* The histogram is not affected by the reset. */
+	cpu_load_reset();
+	zassert_equal(cpu_load_histogram_get(buckets, 1), CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS);
+	zassert_equal(buckets[0], CONFIG_CPU_LOAD_HISTOGRAM_WINDOWS);
+}
+
+ZTEST_SUITE(cpu_load_thread_usage, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,162 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <zephyr/sys/byteorder.h>
+#include <mbedtls/sha256.h>
+
+#include "dfu_target_mcuboot_hash.h"
+
+#define HDR_SIZE 64
+#define IMG_SIZE 1000
+#define PROT_TLV_SIZE 8
+#define HASH_SIZE 32
+#define SIG_SIZE 72
+#define TLV_SIZE (4 + (4 + HASH_SIZE) + (4 + HASH_SIZE) + (4 + SIG_SIZE))
+#define PADDING_SIZE 20
+#define IMAGE_SIZE (HDR_SIZE + IMG_SIZE + PROT_TLV_SIZE + TLV_SIZE)
+#define SHA256_TLV_OFFSET (HDR_SIZE + IMG_SIZE + PROT_TLV_SIZE + 4 + (4 + HASH_SIZE) + 4)
+
+#define IMAGE_F_ENCRYPTED_AES128 0x00000004
+#define IMAGE_TLV_KEYHASH 0x01
+#define IMAGE_TLV_SHA256 0x10
+#define IMAGE_TLV_ECDSA256 0x22
+
+static uint8_t image[IMAGE_SIZE + PADDING_SIZE];
+
+static uint8_t *put_tlv(uint8_t *p, uint16_t type, uint16_t len, uint8_t fill)
+{
+	sys_put_le16(type, p);
+	sys_put_le16(len, p + 2);
+	memset(p + 4, fill, len);
+
+	return p + 4 + len;
+}
+
+/* Build an image laid out as by imgtool, with a protected TLV area and the
+ * SHA-256 TLV between two other unprotected TLVs.
+ */
+static void image_build(uint32_t flags)
+{
+	uint8_t *p;
+
+	memset(image, 0, sizeof(image));
+
+	sys_put_le32(0x96f3b83d, &image[0]);
+	sys_put_le16(HDR_SIZE, &image[8]);
+	sys_put_le16(PROT_TLV_SIZE, &image[10]);
+	sys_put_le32(IMG_SIZE, &image[12]);
+	sys_put_le32(flags, &image[16]);
+
+	for (size_t i = 0; i < IMG_SIZE; i++) {
+		image[HDR_SIZE + i] = i * 7;
+	}
+
+	p = &image[HDR_SIZE + IMG_SIZE];
+	sys_put_le16(0x6908, p);
+	sys_put_le16(PROT_TLV_SIZE, p + 2);
+	p = put_tlv(p + 4, 0x50, 0, 0);
+
+	sys_put_le16(0x6907, p);
+	sys_put_le16(TLV_SIZE, p + 2);
+	p = put_tlv(p + 4, IMAGE_TLV_KEYHASH, HASH_SIZE, 0xaa);
+	p = put_tlv(p, IMAGE_TLV_SHA256, HASH_SIZE, 0);
+	p = put_tlv(p, IMAGE_TLV_ECDSA256, SIG_SIZE, 0xbb);
+
+	zassert_equal(p - image, IMAGE_SIZE, "Unexpected image size");
+
+	zassert_equal(mbedtls_sha256(image, HDR_SIZE + IMG_SIZE + PROT_TLV_SIZE,
+				     &image[SHA256_TLV_OFFSET], false), 0,
+		      "Unable to compute the image hash");
+
+	/* Padding after the TLVs, which is not part of the image. */
+	memset(&image[IMAGE_SIZE], 0xff, PADDING_SIZE);
+}
+
+static int image_verify(size_t len, size_t chunk_len)
+{
+	int err;
+
+	err = dfu_target_mcuboot_hash_init();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	for (size_t offset = 0; offset < len; offset += chunk_len) {
+		err = dfu_target_mcuboot_hash_update(&image[offset],
+						     MIN(chunk_len, len - offset));
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+
+	return dfu_target_mcuboot_hash_verify();
+}
+
+ZTEST(dfu_target_mcuboot_hash, test_valid_image)
+{
+	const size_t chunk_lens[] = {1, 3, 4, 31, 64, 512, IMAGE_SIZE};
+
+	image_build(0);
+
+	for (size_t i = 0; i < ARRAY_SIZE(chunk_lens); i++) {
+		zassert_equal(image_verify(IMAGE_SIZE, chunk_lens[i]), 0,
+			      "Valid image rejected, chunk length %zu", chunk_lens[i]);
+		zassert_equal(image_verify(sizeof(image), chunk_lens[i]), 0,
+			      "Valid padded image rejected, chunk length %zu",
+			      chunk_lens[i]);
+	}
+}
+
+ZTEST(dfu_target_mcuboot_hash, test_corrupted_image)
+{
+	const size_t corrupt_offsets[] = {
+		0x20, HDR_SIZE, HDR_SIZE + IMG_SIZE - 1, HDR_SIZE + IMG_SIZE + 4,
+		SHA256_TLV_OFFSET + HASH_SIZE - 1
+	};
+
+	for (size_t i = 0; i < ARRAY_SIZE(corrupt_offsets); i++) {
+		image_build(0);
+		image[corrupt_offsets[i]] ^= 0x01;
+
+		zassert_equal(image_verify(IMAGE_SIZE, 100), -EBADMSG,
+			      "Corrupted image accepted, offset %zu", corrupt_offsets[i]);
+	}
+}
+
+ZTEST(dfu_target_mcuboot_hash, test_truncated_image)
+{
+	image_build(0);
+
+	zassert_equal(image_verify(SHA256_TLV_OFFSET + HASH_SIZE - 1, 100), -EBADMSG,
+		      "Truncated image accepted");
+	zassert_equal(image_verify(HDR_SIZE + IMG_SIZE, 100), -EBADMSG,
+		      "Image without TLVs accepted");
+}
+
+ZTEST(dfu_target_mcuboot_hash, test_malformed_image)
+{
+	image_build(0);
+	/* Invalid magic. */
+	image[0] ^= 0x01;
+	zassert_equal(image_verify(IMAGE_SIZE, 100), -EBADMSG, "Invalid header accepted");
+
+	image_build(0);
+	/* SHA-256 TLV replaced by another TLV. */
+	sys_put_le16(0x11, &image[SHA256_TLV_OFFSET - 4]);
+	zassert_equal(image_verify(IMAGE_SIZE, 100), -EBADMSG, "Missing hash accepted");
+
+	image_build(0);
+	/* TLV beyond the end of the TLV area. */
+	sys_put_le16(SIG_SIZE + 1, &image[IMAGE_SIZE - SIG_SIZE - 2]);
+	zassert_equal(image_verify(sizeof(image), 100), -EBADMSG, "Invalid TLV accepted");
+}
+
+ZTEST(dfu_target_mcuboot_hash, test_encrypted_image)
+{
+	image_build(IMAGE_F_ENCRYPTED_AES128);
+
+	zassert_equal(image_verify(IMAGE_SIZE, 100), -ENOTSUP,
+		      "Encrypted image not reported");
+}
+
+ZTEST_SUITE(dfu_target_mcuboot_hash, NULL, NULL, NULL, NULL, NULL);
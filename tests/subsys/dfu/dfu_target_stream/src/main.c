@@ -11,6 +11,13 @@
 #include <zephyr/ztest.h>
 #include <dfu/dfu_target_stream.h>
 
+#ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
+#include <zephyr/settings/settings.h>
+#ifdef CONFIG_SETTINGS_NVS
+#include <zephyr/fs/nvs.h>
+#endif
+#endif
+
 #define FLASH_BASE (64*1024)
 #define FLASH_SIZE DT_REG_SIZE(SOC_NV_FLASH_NODE)
 #define FLASH_AVAILABLE (FLASH_SIZE-FLASH_BASE)
@@ -19,6 +26,7 @@
 #define TEST_ID_2 "test_2"
 
 #define BUF_LEN 14000 /* Note, not page aligned */
+#define FRAGMENT_LEN 100 /* Note, not aligned to the stream buffer */
 
 static const struct device *fdev = DEVICE_DT_GET(DT_CHOSEN(zephyr_flash_controller));
 static uint8_t sbuf[128];
@@ -27,6 +35,7 @@ static uint8_t write_buf[BUF_LEN] = {[0 ... BUF_LEN - 1] = 0xaa};
 
 #ifdef CONFIG_DFU_TARGET_STREAM_SAVE_PROGRESS
 static int page_size;
+static uint8_t image_buf[BUF_LEN];
 #endif
 
 #define DFU_TARGET_STREAM_INIT(id_, fdev_, buf_, len_, offset_, size_, cb_)  \
@@ -246,6 +255,93 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 		      "Expected last erased page offset to be unchanged.");
 }
 
+static ssize_t settings_free_space(void)
+{
+#ifdef CONFIG_SETTINGS_NVS
+	void *storage;
+
+	if (settings_storage_get(&storage) == 0) {
+		return nvs_calc_free_space(storage);
+	}
+#endif
+	return -ENOTSUP;
+}
+
+static void image_write(size_t offset, size_t len)
+{
+	for (size_t i = offset; i < len; i += FRAGMENT_LEN) {
+		int err = dfu_target_stream_write(&image_buf[i],
+						  MIN(FRAGMENT_LEN, len - i));
+
+		zassert_equal(err, 0, "Unexpected failure: %d", err);
+	}
+}
+
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress_checkpoint)
+{
+	int err;
+	size_t offset;
+	size_t image_len = 2 * page_size + page_size / 2;
+	const struct stream_flash_ctx *ctx = NULL;
+	ssize_t free_space;
+	int64_t start;
+
+	if (image_len > sizeof(image_buf)) {
+		ztest_test_skip();
+	}
+
+	for (size_t i = 0; i < sizeof(image_buf); i++) {
+		image_buf[i] = i;
+	}
+
+	/* Reset state to avoid failure when initializing */
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = DFU_TARGET_STREAM_INIT(TEST_ID_1, fdev, sbuf, sizeof(sbuf),
+				     FLASH_BASE, 0, NULL);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	free_space = settings_free_space();
+	start = k_uptime_get();
+
+	image_write(0, image_len);
+
+	start = k_uptime_get() - start;
+	if (free_space >= 0) {
+		free_space -= settings_free_space();
+	}
+
+	printk("Wrote %zu bytes in %zu byte fragments in %lld ms, "
+	       "settings storage used: %zd bytes\n", image_len, (size_t)FRAGMENT_LEN,
+	       (long long)start, free_space);
+
+	/* Reload the progress as after a reboot, the writing resumes from
+	 * the start of the page being written.
+	 */
+	err = settings_load();
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = dfu_target_stream_offset_get(&offset);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_equal(offset, 2 * page_size, "Unexpected checkpoint");
+
+	ctx = dfu_target_stream_get_stream();
+	zassert_not_null(ctx, "Expected non-null ctx.");
+	zassert_equal(ctx->last_erased_page_start_offset, FLASH_BASE + page_size,
+		      "Expected the page being written to be erased again.");
+
+	/* Resume and complete the write */
+	image_write(offset, image_len);
+
+	err = dfu_target_stream_done(true);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+
+	err = flash_read(fdev, FLASH_BASE, read_buf, image_len);
+	zassert_equal(err, 0, "Unexpected failure: %d", err);
+	zassert_mem_equal(read_buf, image_buf, image_len, "Incorrect value");
+}
+
 static size_t get_flash_page_size(const struct device *dev)
 {
 	struct flash_driver_api *api = (struct flash_driver_api *) dev->api;
@@ -274,6 +370,11 @@ ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress)
 	ztest_test_skip();
 }
 
+ZTEST(dfu_target_stream_test, test_dfu_target_stream_save_progress_checkpoint)
+{
+	ztest_test_skip();
+}
+
 #endif
 
 static void *setup(void)
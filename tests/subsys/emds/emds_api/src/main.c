@@ -34,7 +34,12 @@ static enum test_states state[] = {
 	EMDS_TS_CLEAR_FLASH,
 	EMDS_TS_EMPTY_FLASH,
 	EMDS_TS_NO_STORE,
+#if defined(CONFIG_EMDS_INCREMENTAL)
+	/* Prepare keeps the stored data in incremental mode. */
+	EMDS_TS_STORE_DATA,
+#else
 	EMDS_TS_EMPTY_FLASH,
+#endif
 	EMDS_TS_CLEAR_FLASH,
 };
 
@@ -51,6 +56,12 @@ static struct emds_dynamic_entry d_entries[3] = {
 	{{0x1003, &d_data[2][0], 10}},
 };
 
+/* Single word entries, for which the store time is dominated by the fixed
+ * overhead per entry rather than by the flash write time.
+ */
+static uint32_t w_data[12];
+static struct emds_dynamic_entry w_entries[ARRAY_SIZE(w_data)];
+
 static const uint8_t expect_s_data[1024] = { 0xCC };
 static uint8_t s_data[1024];
 
@@ -74,8 +85,12 @@ static char *print_state(enum test_states s)
 	}
 }
 
+static int64_t store_cb_tic;
+
 static void app_store_cb(void)
 {
+	store_cb_tic = k_uptime_ticks();
+
 #if defined(CONFIG_BT) && !defined(CONFIG_BT_LL_SW_SPLIT)
 	(void)bt_enable(NULL);
 #endif
@@ -118,6 +133,16 @@ static void add_d_entries(void)
 		zassert_equal(err, -EINVAL, "Entry duplicated");
 	}
 
+	for (int i = 0; i < ARRAY_SIZE(w_entries); i++) {
+		w_entries[i].entry.id = 0x2001 + i;
+		w_entries[i].entry.data = (uint8_t *)&w_data[i];
+		w_entries[i].entry.len = sizeof(w_data[i]);
+
+		err = emds_entry_add(&w_entries[i]);
+		store_expected += sizeof(w_data[i]) + 8;
+		zassert_equal(err, 0, "Add entry failed");
+	}
+
 	uint32_t store_used = emds_store_size_get();
 
 	zassert_equal(store_used, store_expected, "Wrong storage size");
@@ -152,6 +177,15 @@ static void load_flash(void)
 			  "Data has changed");
 }
 
+static void load_prepared_flash(void)
+{
+	if (IS_ENABLED(CONFIG_EMDS_INCREMENTAL)) {
+		load_flash();
+	} else {
+		load_empty_flash();
+	}
+}
+
 static void prepare(void)
 {
 	zassert_equal(emds_store(), -ECANCELED, "Prepare must be done before store");
@@ -163,19 +197,21 @@ static void prepare(void)
 	zassert_true(emds_is_ready(), "EMDS should be ready");
 }
 
-static void store(void)
+static void store_timed(void)
 {
 	zassert_true(emds_is_ready(), "Store should be ready to execute");
 
-	memcpy(d_data, expect_d_data, sizeof(expect_d_data));
-	memcpy(s_data, expect_s_data, sizeof(expect_s_data));
-
 #if defined(CONFIG_BT) && !defined(CONFIG_BT_LL_SW_SPLIT)
 	/* Disable bluetooth and mpsl scheduler if bluetooth is enabled. */
 	(void) sdc_disable(); // Replace with bt_disable when added.
 	mpsl_uninit();
 #endif
 
+	/* The estimate only covers the entries that still have to be stored. */
+	uint32_t estimate_store_time_us = emds_store_time_get();
+	uint32_t estimate_entries_time_us =
+		estimate_store_time_us - CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US;
+
 	int64_t start_tic = k_uptime_ticks();
 
 	zassert_equal(emds_store(), 0, "Store failed");
@@ -186,12 +222,29 @@ static void store(void)
 	zassert_false(emds_is_ready(), "Store not completed");
 
 	uint64_t store_time_us = k_ticks_to_us_ceil64(store_time_ticks);
-
-	uint32_t estimate_store_time_us = emds_store_time_get();
+	/* The entries are all written when the application callback is called. */
+	uint64_t entries_time_us = k_ticks_to_us_ceil64(store_cb_tic - start_tic);
 
 	zassert_true((store_time_us < estimate_store_time_us), "Store takes to long time");
+	/* Allow for the resolution of the uptime counter. */
+	zassert_true((entries_time_us <= estimate_entries_time_us + k_ticks_to_us_ceil64(1)),
+		     "Storing the entries takes to long time");
 	printf("Store time: Actual %lldus, Worst case:  %dus\n",
 	       store_time_us, estimate_store_time_us);
+	printf("Entries store time: Actual %lldus, Worst case:  %dus\n",
+	       entries_time_us, estimate_entries_time_us);
+}
+
+static void store(void)
+{
+	memcpy(d_data, expect_d_data, sizeof(expect_d_data));
+	memcpy(s_data, expect_s_data, sizeof(expect_s_data));
+
+	for (int i = 0; i < ARRAY_SIZE(w_data); i++) {
+		w_data[i] = i;
+	}
+
+	store_timed();
 }
 
 static void clear(void)
@@ -303,20 +356,52 @@ ZTEST(no_store, test_no_store)
 {
 	load_flash();
 	prepare();
-	load_empty_flash();
+	load_prepared_flash();
 }
 
 ZTEST(several_store, test_several_store)
 {
 	load_flash();
 	prepare();
-	load_empty_flash();
+	load_prepared_flash();
 	store();
 	load_flash();
 	prepare();
-	load_empty_flash();
-	store();
+	load_prepared_flash();
+
+	if (!IS_ENABLED(CONFIG_EMDS_INCREMENTAL)) {
+		store();
+		load_flash();
+		return;
+	}
+
+	/* Nothing has changed since the last store. */
+	uint32_t unchanged_time_us = emds_store_time_get();
+
+	zassert_equal(emds_store_size_get(), 0, "Unchanged entries should not be stored");
+	zassert_true(unchanged_time_us > CONFIG_EMDS_FLASH_TIME_BASE_OVERHEAD_US,
+		     "Comparing the entries takes time");
+
+	/* Change some of the entries, and store with the estimate obtained before the store. */
+	uint32_t expect_w_data[ARRAY_SIZE(w_data)];
+
+	w_data[0]++;
+	w_data[5]++;
+	w_data[11]++;
+	memcpy(expect_w_data, w_data, sizeof(w_data));
+
+	zassert_equal(emds_store_size_get(), 3 * (sizeof(w_data[0]) + 8),
+		      "Only the changed entries should be stored");
+	zassert_equal(emds_store_time_get(),
+		      unchanged_time_us + 3 * (CONFIG_EMDS_FLASH_TIME_ENTRY_OVERHEAD_US +
+					       3 * CONFIG_EMDS_FLASH_TIME_WRITE_ONE_WORD_US),
+		      "Only the changed entries should be written");
+
+	store_timed();
+
+	memset(w_data, 0, sizeof(w_data));
 	load_flash();
+	zassert_mem_equal(w_data, expect_w_data, sizeof(w_data), "Changed entries not stored");
 }
 
 ZTEST_SUITE(_setup, pragma_always, NULL, NULL, NULL, NULL);
@@ -413,6 +413,9 @@ ZTEST(emds_flash_tests, test_invalidate_on_prepare)
 	char data_in[9] = "Deadbeef";
 	char data_out[9] = {0};
 
+	/* Prepare keeps the stored entries in incremental mode. */
+	Z_TEST_SKIP_IFDEF(CONFIG_EMDS_INCREMENTAL);
+
 	flash_clear();
 	device_reset();
 
@@ -618,6 +621,127 @@ ZTEST(emds_flash_tests, test_corrupted_data)
 				     "Should not be able to read");
 }
 
+#if defined(CONFIG_EMDS_FAST_STORE)
+ZTEST(emds_flash_tests, test_slot_write)
+{
+	/* Plans and writes entries through the precomputed slots, and verifies that they are
+	 * stored exactly like regular writes, and can be read both from the RAM index and
+	 * after recovery.
+	 */
+	uint8_t data_in1[8] = { 1, 2, 3, 4, 5, 6, 7, 8 };
+	char data_in2[6] = "Bee12";
+	uint8_t data_out[8];
+	struct emds_flash_slot slots[] = {
+		{ .id = 1, .data = data_in1, .len = sizeof(data_in1) },
+		{ .id = 2, .data = NULL, .len = 0 },
+		{ .id = 3, .data = data_in2, .len = sizeof(data_in2) },
+	};
+
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_equal(emds_flash_slots_plan(&ctx, slots, ARRAY_SIZE(slots)), -EACCES,
+		      "Should not plan before prepare");
+	zassert_false(emds_flash_prepare(&ctx, 2 * ctx.ate_size + sizeof(data_in1) +
+					       align_size(sizeof(data_in2))),
+		      "Prepare failed");
+	zassert_false(emds_flash_slots_plan(&ctx, slots, ARRAY_SIZE(slots)), "Plan failed");
+
+	zassert_equal(slots[0].ate_addr, m_test_fd.ate_idx_start, "Wrong ATE address");
+	zassert_equal(slots[2].ate_addr, m_test_fd.ate_idx_start - sizeof(struct test_ate),
+		      "Wrong ATE address");
+	zassert_equal(slots[2].data_addr, m_test_fd.offset + sizeof(data_in1),
+		      "Wrong data address");
+
+	/* Data may change between planning and writing. */
+	data_in1[0] = 0xaa;
+
+	for (int i = 0; i < ARRAY_SIZE(slots); i++) {
+		zassert_equal(emds_flash_slot_write(&ctx, &slots[i]), slots[i].len,
+			      "Error when write");
+	}
+
+	zassert_equal(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)), sizeof(data_in1),
+		      "Error when read");
+	zassert_false(memcmp(data_out, data_in1, sizeof(data_in1)), "Retrived wrong value");
+	zassert_equal(emds_flash_read(&ctx, 2, data_out, sizeof(data_out)), -ENXIO,
+		      "Empty entry should not be stored");
+
+	/* The entries must be identical to the ones written by emds_flash_write. */
+	flash_clear();
+	zassert_false(entry_write(m_test_fd.ate_idx_start, 1, data_in1, sizeof(data_in1)),
+		      "Error when write");
+	zassert_false(entry_write(m_test_fd.ate_idx_start - sizeof(struct test_ate), 3, data_in2,
+				  sizeof(data_in2)),
+		      "Error when write");
+
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_equal(emds_flash_read(&ctx, 3, data_out, sizeof(data_out)), sizeof(data_in2),
+		      "Error when read");
+	zassert_false(memcmp(data_out, data_in2, sizeof(data_in2)), "Retrived wrong value");
+
+	/* Prepare invalidates the index along with the entries in flash. */
+	if (!IS_ENABLED(CONFIG_EMDS_INCREMENTAL)) {
+		zassert_false(emds_flash_prepare(&ctx, 0), "Prepare failed");
+		zassert_equal(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)), -ENXIO,
+			      "Should not be able to read");
+	}
+}
+#endif
+
+#if defined(CONFIG_EMDS_INCREMENTAL)
+ZTEST(emds_flash_tests, test_incremental)
+{
+	/* Verifies that prepare keeps the stored entries, that the latest copy of each entry is
+	 * read back, and that entries are only reported as stored when identical to the
+	 * latest copy.
+	 */
+	char data_in1[9] = "Deadbeef";
+	char data_in2[9] = "Beafdead";
+	char data_out[9] = {0};
+
+	flash_clear();
+	device_reset();
+
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_entry_is_stored(&ctx, 1, data_in1, sizeof(data_in1)),
+		      "Entry should not be stored");
+
+	zassert_false(emds_flash_prepare(&ctx, 2 * (ctx.ate_size + align_size(sizeof(data_in1)))),
+		      "Prepare failed");
+	zassert_true(emds_flash_write(&ctx, 1, data_in1, sizeof(data_in1)) > 0, "Error when write");
+	zassert_true(emds_flash_write(&ctx, 2, data_in1, sizeof(data_in1)) > 0, "Error when write");
+
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(emds_flash_prepare(&ctx, 2 * (ctx.ate_size + align_size(sizeof(data_in1)))),
+		      "Prepare failed");
+
+	zassert_true(emds_flash_entry_is_stored(&ctx, 1, data_in1, sizeof(data_in1)),
+		     "Entry should be stored");
+	zassert_false(emds_flash_entry_is_stored(&ctx, 1, data_in2, sizeof(data_in2)),
+		      "Changed entry should not be stored");
+	zassert_false(emds_flash_entry_is_stored(&ctx, 1, data_in1, sizeof(data_in1) - 1),
+		      "Entry with different length should not be stored");
+
+	/* Only store the changed entry. */
+	zassert_true(emds_flash_write(&ctx, 2, data_in2, sizeof(data_in2)) > 0, "Error when write");
+
+	device_reset();
+	zassert_false(emds_flash_init(&ctx), "Error when initializing");
+	zassert_false(ctx.force_erase, "Force erase should be false");
+
+	zassert_true(emds_flash_read(&ctx, 1, data_out, sizeof(data_out)) > 0, "Could not read");
+	zassert_false(memcmp(data_out, data_in1, sizeof(data_in1)), "Not same data");
+	zassert_true(emds_flash_read(&ctx, 2, data_out, sizeof(data_out)) > 0, "Could not read");
+	zassert_false(memcmp(data_out, data_in2, sizeof(data_in2)), "Not the latest data");
+	zassert_true(emds_flash_entry_is_stored(&ctx, 2, data_in2, sizeof(data_in2)),
+		     "Latest entry should be stored");
+}
+#endif
+
 ZTEST(emds_flash_tests, test_write_speed)
 {
 	char data_in[4] = "bee";
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+
+#include "esb_fifo.h"
+
+/* Size that is not a power of two, to check the index wrap. */
+#define FIFO_SIZE		5
+#define MAX_PAYLOAD_LENGTH	32
+#define BATCH_SIZE		4
+
+#define ISR_PACKET_CNT		2000
+#define BENCHMARK_PACKET_CNT	10000
+#define BENCHMARK_LENGTH	8
+
+/* Same layout as the ESB payload. */
+struct test_payload {
+	uint8_t length;
+	uint8_t pipe;
+	int8_t rssi;
+	uint8_t noack;
+	uint8_t pid;
+	uint8_t data[MAX_PAYLOAD_LENGTH];
+};
+
+static struct esb_fifo fifo;
+static struct test_payload slots[FIFO_SIZE];
+
+static volatile uint32_t isr_produced;
+static volatile uint32_t isr_dropped;
+
+static void payload_fill(struct test_payload *payload, uint32_t seq, uint8_t length)
+{
+	payload->length = length;
+	payload->pipe = seq % 8;
+	memcpy(payload->data, &seq, sizeof(seq));
+}
+
+static uint32_t payload_seq(const struct test_payload *payload)
+{
+	uint32_t seq;
+
+	memcpy(&seq, payload->data, sizeof(seq));
+
+	return seq;
+}
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	esb_fifo_init(&fifo, FIFO_SIZE);
+	memset(slots, 0, sizeof(slots));
+}
+
+ZTEST(esb_fifo, test_claim_commit)
+{
+	int slot;
+
+	zassert_true(esb_fifo_is_empty(&fifo));
+
+	slot = esb_fifo_claim(&fifo);
+	zassert_true(slot >= 0);
+	zassert_equal(esb_fifo_claim(&fifo), slot, "Claim without commit moved the FIFO");
+	zassert_true(esb_fifo_is_empty(&fifo), "Claimed slot visible to the consumer");
+
+	for (uint32_t i = 0; i < FIFO_SIZE; i++) {
+		slot = esb_fifo_claim(&fifo);
+		zassert_true(slot >= 0);
+		payload_fill(&slots[slot], i, 4);
+		esb_fifo_commit(&fifo, 1);
+	}
+
+	zassert_true(esb_fifo_is_full(&fifo));
+	zassert_equal(esb_fifo_claim(&fifo), -ENOMEM);
+
+	for (uint32_t i = 0; i < FIFO_SIZE; i++) {
+		zassert_equal(payload_seq(&slots[esb_fifo_peek(&fifo, i)]), i);
+	}
+
+	esb_fifo_release(&fifo, 2);
+	zassert_equal(esb_fifo_count(&fifo), FIFO_SIZE - 2);
+	zassert_equal(payload_seq(&slots[esb_fifo_peek(&fifo, 0)]), 2);
+
+	esb_fifo_release(&fifo, FIFO_SIZE - 2);
+	zassert_true(esb_fifo_is_empty(&fifo));
+}
+
+ZTEST(esb_fifo, test_wrap)
+{
+	uint32_t produced = 0;
+	uint32_t consumed = 0;
+
+	/* Commit and release in varying batches, so that the indices wrap at
+	 * every possible position.
+	 */
+	for (uint32_t round = 0; round < 100; round++) {
+		uint32_t cnt = round % (FIFO_SIZE + 1);
+
+		cnt = MIN(cnt, FIFO_SIZE - esb_fifo_count(&fifo));
+		for (uint32_t i = 0; i < cnt; i++) {
+			int slot = esb_fifo_claim(&fifo);
+
+			zassert_true(slot >= 0);
+			payload_fill(&slots[slot], produced++, 4);
+			esb_fifo_commit(&fifo, 1);
+		}
+
+		zassert_equal(esb_fifo_count(&fifo), produced - consumed);
+
+		cnt = MIN((round * 7) % (FIFO_SIZE + 1), esb_fifo_count(&fifo));
+		for (uint32_t i = 0; i < cnt; i++) {
+			zassert_equal(payload_seq(&slots[esb_fifo_peek(&fifo, i)]), consumed + i,
+				      "Wrong order in round %u", round);
+		}
+		esb_fifo_release(&fifo, cnt);
+		consumed += cnt;
+	}
+
+	zassert_true(produced > 100, "Too few elements");
+}
+
+static void producer_timer_handler(struct k_timer *timer)
+{
+	/* Produce a few packets on every call, like a radio interrupt that
+	 * receives packets faster than the application reads them.
+	 */
+	for (uint32_t i = 0; (i < 3) && (isr_produced < ISR_PACKET_CNT); i++) {
+		int slot = esb_fifo_claim(&fifo);
+
+		if (slot < 0) {
+			isr_dropped++;
+			continue;
+		}
+
+		payload_fill(&slots[slot], isr_produced++, 4);
+		esb_fifo_commit(&fifo, 1);
+	}
+
+	if (isr_produced >= ISR_PACKET_CNT) {
+		k_timer_stop(timer);
+	}
+}
+
+K_TIMER_DEFINE(producer_timer, producer_timer_handler, NULL);
+
+ZTEST(esb_fifo, test_isr_producer)
+{
+	uint32_t consumed = 0;
+	uint32_t batches = 0;
+
+	isr_produced = 0;
+	isr_dropped = 0;
+
+	k_timer_start(&producer_timer, K_MSEC(1), K_MSEC(1));
+
+	while ((consumed < isr_produced) || (isr_produced < ISR_PACKET_CNT)) {
+		uint32_t cnt = MIN(esb_fifo_count(&fifo), BATCH_SIZE);
+
+		if (cnt == 0) {
+			k_sleep(K_USEC(500));
+			continue;
+		}
+
+		for (uint32_t i = 0; i < cnt; i++) {
+			zassert_equal(payload_seq(&slots[esb_fifo_peek(&fifo, i)]), consumed + i,
+				      "Packet lost or reordered");
+		}
+
+		esb_fifo_release(&fifo, cnt);
+		consumed += cnt;
+		batches++;
+	}
+
+	k_timer_stop(&producer_timer);
+
+	printk("ISR producer: %u packets, %u dropped, %u batches\n", consumed, isr_dropped,
+	       batches);
+
+	zassert_equal(consumed, ISR_PACKET_CNT, "Packets lost");
+	zassert_true(esb_fifo_is_empty(&fifo));
+}
+
+/* Reference implementation with an element counter protected by a lock, that
+ * copies whole payloads into and out of the FIFO.
+ */
+static struct {
+	uint32_t back;
+	uint32_t front;
+	uint32_t count;
+} ref_fifo;
+
+static bool ref_write(const struct test_payload *payload)
+{
+	bool ret = false;
+	unsigned int key = irq_lock();
+
+	if (ref_fifo.count < FIFO_SIZE) {
+		memcpy(&slots[ref_fifo.back], payload, sizeof(*payload));
+		if (++ref_fifo.back >= FIFO_SIZE) {
+			ref_fifo.back = 0;
+		}
+		ref_fifo.count++;
+		ret = true;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+static bool ref_read(struct test_payload *payload)
+{
+	bool ret = false;
+	unsigned int key = irq_lock();
+
+	if (ref_fifo.count > 0) {
+		const struct test_payload *src = &slots[ref_fifo.front];
+
+		payload->length = src->length;
+		payload->pipe = src->pipe;
+		payload->rssi = src->rssi;
+		payload->pid = src->pid;
+		payload->noack = src->noack;
+		memcpy(payload->data, src->data, src->length);
+		if (++ref_fifo.front >= FIFO_SIZE) {
+			ref_fifo.front = 0;
+		}
+		ref_fifo.count--;
+		ret = true;
+	}
+
+	irq_unlock(key);
+
+	return ret;
+}
+
+ZTEST(esb_fifo, test_benchmark)
+{
+	struct test_payload payload = { 0 };
+	uint32_t sum = 0;
+	uint32_t ref_sum = 0;
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t ref_cycles;
+
+	memset(&ref_fifo, 0, sizeof(ref_fifo));
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_PACKET_CNT; i += BATCH_SIZE) {
+		for (uint32_t j = 0; j < BATCH_SIZE; j++) {
+			payload_fill(&payload, i + j, BENCHMARK_LENGTH);
+			zassert_true(ref_write(&payload));
+		}
+		for (uint32_t j = 0; j < BATCH_SIZE; j++) {
+			zassert_true(ref_read(&payload));
+			ref_sum += payload_seq(&payload);
+		}
+	}
+	ref_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_PACKET_CNT; i += BATCH_SIZE) {
+		for (uint32_t j = 0; j < BATCH_SIZE; j++) {
+			int slot = esb_fifo_claim(&fifo);
+
+			zassert_true(slot >= 0);
+			payload_fill(&slots[slot], i + j, BENCHMARK_LENGTH);
+			esb_fifo_commit(&fifo, 1);
+		}
+
+		uint32_t cnt = esb_fifo_count(&fifo);
+
+		for (uint32_t j = 0; j < cnt; j++) {
+			sum += payload_seq(&slots[esb_fifo_peek(&fifo, j)]);
+		}
+		esb_fifo_release(&fifo, cnt);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	zassert_equal(sum, ref_sum, "Data mismatch");
+
+	printk("%u packets, claim/commit with batched drain %u cycles/packet, "
+	       "copy under lock %u cycles/packet\n", BENCHMARK_PACKET_CNT,
+	       cycles / BENCHMARK_PACKET_CNT, ref_cycles / BENCHMARK_PACKET_CNT);
+}
+
+ZTEST_SUITE(esb_fifo, NULL, NULL, before, NULL, NULL);
@@ -0,0 +1,220 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <nfc/ndef/msg.h>
+#include <nfc/ndef/record.h>
+#include <nfc/t4t/ndef_file.h>
+
+#define NDEF_FILE_SIZE		256
+#define LARGE_PAYLOAD_SIZE	200
+#define SEGMENT_SIZE		100
+#define BENCHMARK_CNT		1000
+
+/* Long record header: flags, type length, 4-byte payload length. */
+#define RECORD_HEADER_SIZE	6
+
+static const uint8_t type[] = {'a', '/', 'b'};
+static const uint8_t header[] = {0x01, 0x02, 0x03};
+static const uint8_t trailer[] = {0xFE, 0xFF};
+static uint8_t large_payload[LARGE_PAYLOAD_SIZE];
+
+static uint8_t ndef_file[NDEF_FILE_SIZE];
+static uint8_t ref_ndef_file[NDEF_FILE_SIZE];
+static uint8_t ref_msg_buf[NDEF_FILE_SIZE];
+static uint8_t ref_payload_buf[NDEF_FILE_SIZE];
+
+
+static void before(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (size_t i = 0; i < sizeof(large_payload); i++) {
+		large_payload[i] = i;
+	}
+
+	memset(ndef_file, 0xAA, sizeof(ndef_file));
+	memset(ref_ndef_file, 0xAA, sizeof(ref_ndef_file));
+}
+
+/* Reference: the payload is assembled in a separate buffer, the message is
+ * encoded into another buffer and then copied into the NDEF File.
+ */
+static int ref_encode(const struct nfc_ndef_bin_payload_desc *segment, size_t segment_cnt,
+		      uint32_t *size)
+{
+	uint32_t payload_len = 0;
+	uint32_t msg_len = sizeof(ref_msg_buf);
+	int err;
+
+	for (size_t i = 0; i < segment_cnt; i++) {
+		memcpy(&ref_payload_buf[payload_len], segment[i].payload,
+		       segment[i].payload_length);
+		payload_len += segment[i].payload_length;
+	}
+
+	NFC_NDEF_RECORD_BIN_DATA_DEF(ref_rec, TNF_MEDIA_TYPE, NULL, 0, type, sizeof(type),
+				     ref_payload_buf, payload_len);
+	NFC_NDEF_MSG_DEF(ref_msg, 1);
+
+	err = nfc_ndef_msg_record_add(&NFC_NDEF_MSG(ref_msg), &NFC_NDEF_RECORD_BIN_DATA(ref_rec));
+	if (err) {
+		return err;
+	}
+
+	err = nfc_ndef_msg_encode(&NFC_NDEF_MSG(ref_msg), ref_msg_buf, &msg_len);
+	if (err) {
+		return err;
+	}
+
+	memcpy(nfc_t4t_ndef_file_msg_get(ref_ndef_file), ref_msg_buf, msg_len);
+
+	*size = msg_len;
+
+	return nfc_t4t_ndef_file_encode(ref_ndef_file, size);
+}
+
+static int sg_encode(const struct nfc_ndef_bin_payload_desc *segment, size_t segment_cnt,
+		     uint32_t *size)
+{
+	NFC_NDEF_RECORD_BIN_DATA_SG_DEF(sg_rec, TNF_MEDIA_TYPE, NULL, 0, type, sizeof(type),
+					segment, segment_cnt);
+	NFC_NDEF_MSG_DEF(sg_msg, 1);
+	int err;
+
+	err = nfc_ndef_msg_record_add(&NFC_NDEF_MSG(sg_msg), &NFC_NDEF_RECORD_BIN_DATA_SG(sg_rec));
+	if (err) {
+		return err;
+	}
+
+	return nfc_t4t_ndef_file_msg_encode(&NFC_NDEF_MSG(sg_msg), ndef_file, size);
+}
+
+ZTEST(nfc_ndef_msg_encode, test_sg_payload)
+{
+	const struct nfc_ndef_bin_payload_desc segment[] = {
+		{ .payload = header, .payload_length = sizeof(header) },
+		{ .payload = NULL, .payload_length = 0 },
+		{ .payload = large_payload, .payload_length = SEGMENT_SIZE },
+		{ .payload = trailer, .payload_length = sizeof(trailer) },
+	};
+	const uint32_t payload_len = sizeof(header) + SEGMENT_SIZE + sizeof(trailer);
+	struct nfc_ndef_bin_payload_sg_desc sg_desc = {
+		.segment = segment,
+		.segment_cnt = ARRAY_SIZE(segment),
+	};
+	uint8_t payload[sizeof(header) + SEGMENT_SIZE + sizeof(trailer)];
+	uint32_t len;
+	int err;
+
+	/* Size calculation. */
+	len = 0;
+	err = nfc_ndef_bin_payload_sg_memcopy(&sg_desc, NULL, &len);
+	zassert_equal(err, 0);
+	zassert_equal(len, payload_len);
+
+	len = sizeof(payload);
+	err = nfc_ndef_bin_payload_sg_memcopy(&sg_desc, payload, &len);
+	zassert_equal(err, 0);
+	zassert_equal(len, payload_len);
+	zassert_mem_equal(payload, header, sizeof(header));
+	zassert_mem_equal(&payload[sizeof(header)], large_payload, SEGMENT_SIZE);
+	zassert_mem_equal(&payload[sizeof(header) + SEGMENT_SIZE], trailer, sizeof(trailer));
+
+	/* Segment does not fit. */
+	len = sizeof(payload) - 1;
+	zassert_equal(nfc_ndef_bin_payload_sg_memcopy(&sg_desc, payload, &len), -ENOSR);
+
+	/* Empty payload. */
+	sg_desc.segment_cnt = 0;
+	len = sizeof(payload);
+	zassert_equal(nfc_ndef_bin_payload_sg_memcopy(&sg_desc, payload, &len), 0);
+	zassert_equal(len, 0);
+}
+
+ZTEST(nfc_ndef_msg_encode, test_ndef_file_in_place)
+{
+	const struct nfc_ndef_bin_payload_desc segment[] = {
+		{ .payload = header, .payload_length = sizeof(header) },
+		{ .payload = large_payload, .payload_length = sizeof(large_payload) },
+		{ .payload = trailer, .payload_length = sizeof(trailer) },
+	};
+	const uint32_t msg_len = RECORD_HEADER_SIZE + sizeof(type) + sizeof(header) +
+				 sizeof(large_payload) + sizeof(trailer);
+	uint32_t size = sizeof(ndef_file);
+	uint32_t ref_size;
+	int err;
+
+	err = ref_encode(segment, ARRAY_SIZE(segment), &ref_size);
+	zassert_equal(err, 0, "Reference encoding failed: %d", err);
+
+	err = sg_encode(segment, ARRAY_SIZE(segment), &size);
+	zassert_equal(err, 0, "Encoding failed: %d", err);
+
+	zassert_equal(size, msg_len + NFC_NDEF_FILE_NLEN_FIELD_SIZE);
+	zassert_equal(size, ref_size);
+	zassert_equal(sys_get_be16(ndef_file), msg_len, "Wrong NLEN");
+	zassert_mem_equal(ndef_file, ref_ndef_file, size, "NDEF File mismatch");
+	zassert_equal(ndef_file[size], 0xAA, "Data written after the message");
+
+	/* NDEF File too small. */
+	size = msg_len + NFC_NDEF_FILE_NLEN_FIELD_SIZE - 1;
+	zassert_equal(sg_encode(segment, ARRAY_SIZE(segment), &size), -ENOSR);
+}
+
+ZTEST(nfc_ndef_msg_encode, test_ndef_file_empty)
+{
+	NFC_NDEF_MSG_DEF(empty_msg, 1);
+	uint32_t size = sizeof(ndef_file);
+
+	zassert_equal(nfc_t4t_ndef_file_msg_encode(NULL, ndef_file, &size), 0);
+	zassert_equal(size, NFC_NDEF_FILE_NLEN_FIELD_SIZE);
+	zassert_equal(sys_get_be16(ndef_file), 0);
+
+	size = sizeof(ndef_file);
+	zassert_equal(nfc_t4t_ndef_file_msg_encode(&NFC_NDEF_MSG(empty_msg), ndef_file, &size), 0);
+	zassert_equal(size, NFC_NDEF_FILE_NLEN_FIELD_SIZE);
+
+	size = NFC_NDEF_FILE_NLEN_FIELD_SIZE - 1;
+	zassert_equal(nfc_t4t_ndef_file_msg_encode(NULL, ndef_file, &size), -EINVAL);
+}
+
+ZTEST(nfc_ndef_msg_encode, test_benchmark)
+{
+	const struct nfc_ndef_bin_payload_desc segment[] = {
+		{ .payload = header, .payload_length = sizeof(header) },
+		{ .payload = large_payload, .payload_length = sizeof(large_payload) },
+		{ .payload = trailer, .payload_length = sizeof(trailer) },
+	};
+	uint32_t size;
+	uint32_t start;
+	uint32_t cycles;
+	uint32_t ref_cycles;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_CNT; i++) {
+		zassert_equal(ref_encode(segment, ARRAY_SIZE(segment), &size), 0);
+	}
+	ref_cycles = k_cycle_get_32() - start;
+
+	start = k_cycle_get_32();
+	for (uint32_t i = 0; i < BENCHMARK_CNT; i++) {
+		size = sizeof(ndef_file);
+		zassert_equal(sg_encode(segment, ARRAY_SIZE(segment), &size), 0);
+	}
+	cycles = k_cycle_get_32() - start;
+
+	zassert_mem_equal(ndef_file, ref_ndef_file, size, "NDEF File mismatch");
+
+	printk("%u byte NDEF File: in place %u cycles, with copies %u cycles, "
+	       "buffers %u bytes less\n", size, cycles / BENCHMARK_CNT,
+	       ref_cycles / BENCHMARK_CNT,
+	       (uint32_t)(sizeof(ref_msg_buf) + sizeof(ref_payload_buf)));
+}
+
+ZTEST_SUITE(nfc_ndef_msg_encode, NULL, NULL, before, NULL, NULL);
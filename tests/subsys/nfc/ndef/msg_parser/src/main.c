@@ -0,0 +1,327 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+
+#include <nfc/ndef/msg_parser.h>
+#include <nfc/ndef/ch_rec_parser.h>
+
+#define MAX_RECORDS		4
+#define AC_REF_DATA_SIZE	16
+#define CH_BUF_SIZE		(sizeof(struct nfc_ndef_ch_rec) + NFC_NDEF_PARSER_REQUIRED_MEM(1))
+
+/* Lone short Text Record. */
+static const uint8_t text_msg[] = {
+	0xD1, 0x01, 0x05, 'T',
+	0x02, 'e', 'n', 'h', 'i'
+};
+
+/* Short URI Record with an ID, long Media-type Record and empty Text Record. */
+static const uint8_t multi_msg[] = {
+	0x99, 0x01, 0x03, 0x02, 'U', 'a', 'b',
+	0x01, 'x', 'y',
+	0x02, 0x03, 0x00, 0x00, 0x00, 0x02, 'a', '/', 'b',
+	0x10, 0x20,
+	0x51, 0x01, 0x00, 'T'
+};
+
+/* Handover Select Record with a nested Alternative Carrier Record. */
+static const uint8_t hs_msg[] = {
+	0xD1, 0x02, 0x0A, 'H', 's',
+	0x12,
+	0xD1, 0x02, 0x04, 'a', 'c',
+	0x01, 0x01, '0', 0x00
+};
+
+/* Second record with the Message Begin flag. */
+static const uint8_t bad_flags_msg[] = {
+	0x91, 0x01, 0x01, 'T', 0x00,
+	0xD1, 0x01, 0x01, 'T', 0x00
+};
+
+/* Message without the Message End flag. */
+static const uint8_t no_end_msg[] = {
+	0x91, 0x01, 0x01, 'T', 0x00,
+	0x11, 0x01, 0x01, 'T', 0x00
+};
+
+/* First record without the Message Begin flag. */
+static const uint8_t no_begin_msg[] = {
+	0x51, 0x01, 0x01, 'T', 0x00
+};
+
+struct visit_ctx {
+	const struct nfc_ndef_msg_desc *msg_desc;
+	uint32_t count;
+	uint32_t stop_at;
+};
+
+
+static const struct nfc_ndef_bin_payload_desc *
+payload_get(const struct nfc_ndef_record_desc *rec_desc)
+{
+	return (const struct nfc_ndef_bin_payload_desc *)rec_desc->payload_descriptor;
+}
+
+static void record_compare(const struct nfc_ndef_record_desc *rec_desc,
+			   const struct nfc_ndef_record_desc *ref_desc, uint32_t index)
+{
+	const struct nfc_ndef_bin_payload_desc *payload = payload_get(rec_desc);
+	const struct nfc_ndef_bin_payload_desc *ref_payload = payload_get(ref_desc);
+
+	zassert_equal(rec_desc->tnf, ref_desc->tnf, "Record %u: TNF mismatch", index);
+	zassert_equal(rec_desc->id_length, ref_desc->id_length,
+		      "Record %u: ID mismatch", index);
+	zassert_equal_ptr(rec_desc->id, ref_desc->id, "Record %u: ID mismatch", index);
+	zassert_equal(rec_desc->type_length, ref_desc->type_length,
+		      "Record %u: type mismatch", index);
+	zassert_equal_ptr(rec_desc->type, ref_desc->type, "Record %u: type mismatch", index);
+	zassert_equal(payload->payload_length, ref_payload->payload_length,
+		      "Record %u: payload mismatch", index);
+	zassert_equal_ptr(payload->payload, ref_payload->payload,
+			  "Record %u: payload mismatch", index);
+}
+
+/* Parse a message with the iterator and with the descriptor arena and check
+ * that the results are the same.
+ */
+static void msg_compare(const uint8_t *data, uint32_t len, uint32_t record_count)
+{
+	uint8_t desc_buf[NFC_NDEF_PARSER_REQUIRED_MEM(MAX_RECORDS)] __aligned(4);
+	uint32_t desc_buf_len = sizeof(desc_buf);
+	uint32_t parsed_len = len;
+	struct nfc_ndef_msg_desc *msg_desc;
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_desc rec_desc;
+	struct nfc_ndef_bin_payload_desc bin_pay_desc;
+	int err;
+
+	err = nfc_ndef_msg_parse(desc_buf, &desc_buf_len, data, &parsed_len);
+	zassert_equal(err, 0, "Reference parser failed: %d", err);
+	zassert_equal(parsed_len, len);
+
+	msg_desc = (struct nfc_ndef_msg_desc *)desc_buf;
+	zassert_equal(msg_desc->record_count, record_count);
+
+	nfc_ndef_msg_iter_init(&iter, data, len);
+
+	for (uint32_t i = 0; i < record_count; i++) {
+		zassert_false(iter.complete, "Message end too early");
+
+		err = nfc_ndef_msg_iter_next(&iter, &rec_desc, &bin_pay_desc);
+		zassert_equal(err, 0, "Record %u: parsing failed: %d", i, err);
+		zassert_equal_ptr(rec_desc.payload_descriptor, &bin_pay_desc);
+
+		record_compare(&rec_desc, msg_desc->record[i], i);
+	}
+
+	zassert_true(iter.complete, "Message end not found");
+	zassert_equal(iter.record_count, record_count);
+	zassert_equal(iter.parsed_len, len);
+	zassert_equal(nfc_ndef_msg_iter_next(&iter, &rec_desc, &bin_pay_desc), -ENOENT);
+}
+
+static int record_visit(const struct nfc_ndef_record_desc *rec_desc, uint32_t index,
+			void *user_data)
+{
+	struct visit_ctx *ctx = user_data;
+
+	zassert_equal(index, ctx->count, "Wrong record index");
+	if (ctx->msg_desc) {
+		record_compare(rec_desc, ctx->msg_desc->record[index], index);
+	}
+
+	ctx->count++;
+
+	return (ctx->count == ctx->stop_at) ? -ECANCELED : 0;
+}
+
+static int msg_iterate(const uint8_t *data, uint32_t len)
+{
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_desc rec_desc;
+	struct nfc_ndef_bin_payload_desc bin_pay_desc;
+	int err;
+
+	nfc_ndef_msg_iter_init(&iter, data, len);
+
+	do {
+		err = nfc_ndef_msg_iter_next(&iter, &rec_desc, &bin_pay_desc);
+	} while (!err);
+
+	return (err == -ENOENT) ? 0 : err;
+}
+
+ZTEST(nfc_ndef_msg_parser, test_iter)
+{
+	msg_compare(text_msg, sizeof(text_msg), 1);
+	msg_compare(multi_msg, sizeof(multi_msg), 3);
+	msg_compare(hs_msg, sizeof(hs_msg), 1);
+}
+
+ZTEST(nfc_ndef_msg_parser, test_iter_trailing_data)
+{
+	uint8_t data[sizeof(text_msg) + 4] = { 0 };
+
+	memcpy(data, text_msg, sizeof(text_msg));
+
+	/* Data after the last record is not parsed. */
+	msg_compare(data, sizeof(data) - 4, 1);
+	zassert_equal(msg_iterate(data, sizeof(data)), 0);
+}
+
+ZTEST(nfc_ndef_msg_parser, test_iter_malformed)
+{
+	uint8_t desc_buf[NFC_NDEF_PARSER_REQUIRED_MEM(MAX_RECORDS)] __aligned(4);
+	uint32_t desc_buf_len;
+	uint32_t len;
+
+	zassert_equal(msg_iterate(multi_msg, sizeof(multi_msg) - 1), -EINVAL);
+	zassert_equal(msg_iterate(multi_msg, 2), -EINVAL);
+	zassert_equal(msg_iterate(bad_flags_msg, sizeof(bad_flags_msg)), -EFAULT);
+	zassert_equal(msg_iterate(no_end_msg, sizeof(no_end_msg)), -EFAULT);
+	zassert_equal(msg_iterate(no_begin_msg, sizeof(no_begin_msg)), -EFAULT);
+	zassert_equal(msg_iterate(text_msg, 0), -EFAULT);
+
+	/* The arena-based parser reports the same errors. */
+	desc_buf_len = sizeof(desc_buf);
+	len = sizeof(no_end_msg);
+	zassert_equal(nfc_ndef_msg_parse(desc_buf, &desc_buf_len, no_end_msg, &len), -EFAULT);
+
+	desc_buf_len = sizeof(desc_buf);
+	len = sizeof(bad_flags_msg);
+	zassert_equal(nfc_ndef_msg_parse(desc_buf, &desc_buf_len, bad_flags_msg, &len),
+		      -EFAULT);
+
+	/* Record limit of the arena-based parser. */
+	desc_buf_len = NFC_NDEF_PARSER_REQUIRED_MEM(2);
+	len = sizeof(multi_msg);
+	zassert_equal(nfc_ndef_msg_parse(desc_buf, &desc_buf_len, multi_msg, &len), -ENOMEM);
+}
+
+ZTEST(nfc_ndef_msg_parser, test_visit)
+{
+	uint8_t desc_buf[NFC_NDEF_PARSER_REQUIRED_MEM(MAX_RECORDS)] __aligned(4);
+	uint32_t desc_buf_len = sizeof(desc_buf);
+	uint32_t len = sizeof(multi_msg);
+	struct visit_ctx ctx = {
+		.msg_desc = (struct nfc_ndef_msg_desc *)desc_buf,
+	};
+	int err;
+
+	err = nfc_ndef_msg_parse(desc_buf, &desc_buf_len, multi_msg, &len);
+	zassert_equal(err, 0);
+
+	len = sizeof(multi_msg);
+	err = nfc_ndef_msg_visit(multi_msg, &len, record_visit, &ctx);
+	zassert_equal(err, 0, "Visit failed: %d", err);
+	zassert_equal(ctx.count, 3);
+	zassert_equal(len, sizeof(multi_msg));
+
+	/* Visitor stops parsing. */
+	ctx.count = 0;
+	ctx.stop_at = 2;
+	len = sizeof(multi_msg);
+	err = nfc_ndef_msg_visit(multi_msg, &len, record_visit, &ctx);
+	zassert_equal(err, -ECANCELED);
+	zassert_equal(ctx.count, 2);
+	zassert_equal(len, sizeof(multi_msg), "Length changed on error");
+
+	/* Error after the first record. */
+	memset(&ctx, 0, sizeof(ctx));
+	len = sizeof(no_end_msg);
+	zassert_equal(nfc_ndef_msg_visit(no_end_msg, &len, record_visit, &ctx), -EFAULT);
+	zassert_equal(ctx.count, 2);
+	zassert_equal(nfc_ndef_msg_visit(multi_msg, &len, NULL, NULL), -EINVAL);
+}
+
+ZTEST(nfc_ndef_msg_parser, test_ch_rec_iter)
+{
+	uint8_t desc_buf[NFC_NDEF_PARSER_REQUIRED_MEM(MAX_RECORDS)] __aligned(4);
+	uint8_t ch_buf[CH_BUF_SIZE] __aligned(4);
+	uint8_t ac_buf[sizeof(struct nfc_ndef_ch_ac_rec) + AC_REF_DATA_SIZE] __aligned(4);
+	uint32_t desc_buf_len = sizeof(desc_buf);
+	uint32_t ch_buf_len = sizeof(ch_buf);
+	uint32_t ac_buf_len = sizeof(ac_buf);
+	uint32_t len = sizeof(hs_msg);
+	const struct nfc_ndef_msg_desc *msg_desc;
+	const struct nfc_ndef_ch_rec *ch_rec;
+	const struct nfc_ndef_ch_ac_rec *ac_rec;
+	struct nfc_ndef_ch_rec_iter ch_iter;
+	struct nfc_ndef_msg_iter iter;
+	struct nfc_ndef_record_desc rec_desc;
+	struct nfc_ndef_bin_payload_desc bin_pay_desc;
+	int err;
+
+	nfc_ndef_msg_iter_init(&iter, hs_msg, sizeof(hs_msg));
+	err = nfc_ndef_msg_iter_next(&iter, &rec_desc, &bin_pay_desc);
+	zassert_equal(err, 0);
+	zassert_equal(nfc_ndef_ch_rec_check(&rec_desc, NFC_NDEF_CH_REC_TYPE_HANDOVER_SELECT),
+		      true);
+
+	/* Reference: Handover Select Record parsed into a buffer. */
+	err = nfc_ndef_msg_parse(desc_buf, &desc_buf_len, hs_msg, &len);
+	zassert_equal(err, 0);
+	msg_desc = (struct nfc_ndef_msg_desc *)desc_buf;
+
+	err = nfc_ndef_ch_rec_parse(msg_desc->record[0], ch_buf, &ch_buf_len);
+	zassert_equal(err, 0, "Handover Select Record parsing failed: %d", err);
+	ch_rec = (struct nfc_ndef_ch_rec *)ch_buf;
+
+	err = nfc_ndef_ch_rec_iter_init(&rec_desc, &ch_iter);
+	zassert_equal(err, 0, "Iterator initialization failed: %d", err);
+	zassert_equal(ch_iter.major_version, 1);
+	zassert_equal(ch_iter.minor_version, 2);
+	zassert_equal(ch_iter.major_version, ch_rec->major_version);
+	zassert_equal(ch_iter.minor_version, ch_rec->minor_version);
+
+	err = nfc_ndef_msg_iter_next(&ch_iter.local_records, &rec_desc, &bin_pay_desc);
+	zassert_equal(err, 0, "Local record parsing failed: %d", err);
+	zassert_equal(ch_rec->local_records->record_count, 1);
+	record_compare(&rec_desc, ch_rec->local_records->record[0], 0);
+
+	zassert_true(nfc_ndef_ch_ac_rec_check(&rec_desc));
+	err = nfc_ndef_ch_ac_rec_parse(&rec_desc, ac_buf, &ac_buf_len);
+	zassert_equal(err, 0, "Alternative Carrier Record parsing failed: %d", err);
+
+	ac_rec = (struct nfc_ndef_ch_ac_rec *)ac_buf;
+	zassert_equal(ac_rec->cps, NFC_AC_CPS_ACTIVE);
+	zassert_equal(ac_rec->carrier_data_ref.length, 1);
+	zassert_equal(ac_rec->carrier_data_ref.data[0], '0');
+	zassert_equal(ac_rec->aux_data_ref_cnt, 0);
+
+	zassert_equal(nfc_ndef_msg_iter_next(&ch_iter.local_records, &rec_desc, &bin_pay_desc),
+		      -ENOENT);
+
+	/* Not a Connection Handover Record. */
+	nfc_ndef_msg_iter_init(&iter, text_msg, sizeof(text_msg));
+	zassert_equal(nfc_ndef_msg_iter_next(&iter, &rec_desc, &bin_pay_desc), 0);
+	zassert_equal(nfc_ndef_ch_rec_iter_init(&rec_desc, &ch_iter), -EINVAL);
+}
+
+ZTEST(nfc_ndef_msg_parser, test_memory)
+{
+	/* Memory needed to access a message with the given number of records.
+	 * The iterator needs the same amount of memory for any message.
+	 */
+	static const uint32_t record_counts[] = { 1, 2, 4, 8, 16 };
+	const uint32_t iter_mem = sizeof(struct nfc_ndef_msg_iter) +
+				  sizeof(struct nfc_ndef_record_desc) +
+				  sizeof(struct nfc_ndef_bin_payload_desc);
+
+	for (size_t i = 0; i < ARRAY_SIZE(record_counts); i++) {
+		uint32_t arena_mem = NFC_NDEF_PARSER_REQUIRED_MEM(record_counts[i]);
+
+		printk("%u records: descriptor buffer %u bytes, iterator %u bytes\n",
+		       record_counts[i], arena_mem, iter_mem);
+
+		if (record_counts[i] > 1) {
+			zassert_true(iter_mem < arena_mem, "No RAM saved");
+		}
+	}
+}
+
+ZTEST_SUITE(nfc_ndef_msg_parser, NULL, NULL, NULL, NULL, NULL);
@@ -0,0 +1,678 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+
+#include <zephyr/ztest.h>
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+
+#include <nfc/t4t/apdu.h>
+#include <nfc/t4t/cc_file.h>
+#include <nfc/t4t/hl_procedure.h>
+#include <nfc/t4t/isodep.h>
+
+#define ISODEP_TX_BUF_SIZE	256
+#define ISODEP_RX_BUF_SIZE	1026
+#define NDEF_FILE_ID		0xE104
+#define NDEF_FILE_MAX_SIZE	4096
+#define NDEF_FILE_NLEN_SIZE	2
+#define CC_MAX_TLV_BLOCKS	2
+
+/* Data in a single I-block from the tag and the READ BINARY response data
+ * aligned to whole I-blocks, with the status word.
+ */
+#define FIRST_READ_LEN		CONFIG_NFC_T4T_HL_PROCEDURE_NDEF_FIRST_READ_SIZE
+#define FRAME_DATA_SIZE		(256 - 3)
+#define SHORT_READ_LEN		(FRAME_DATA_SIZE - 2)
+#define EXTENDED_READ_LEN	((ISODEP_RX_BUF_SIZE / FRAME_DATA_SIZE) * FRAME_DATA_SIZE - 2)
+#define WAIT_TIMEOUT_MS		1000
+
+/* Simulated tag buffers. */
+#define TAG_CAPDU_BUF_SIZE	512
+#define TAG_RAPDU_BUF_SIZE	(NDEF_FILE_MAX_SIZE + 2)
+#define TAG_FRAME_BUF_SIZE	258
+
+/* Timing model of the NFC-A link at 106 kbit/s, in carrier cycles (1/fc).
+ * Every byte takes 8 data bits and a parity bit, every frame has a CRC,
+ * Start of Frame and End of Frame. The tag needs some time to execute each
+ * complete command.
+ */
+#define FC_HZ			13560000ULL
+#define BIT_FC			128
+#define BYTE_FC			(9 * BIT_FC)
+#define FRAME_FC(_len)		(((_len) + 2) * BYTE_FC + 2 * BIT_FC)
+#define LISTEN_FDT_FC		1172
+#define POLL_FDT_FC		6780
+#define TAG_APDU_EXEC_FC	(FC_HZ / 1000)
+
+#define ISODEP_PCB_I_BLOCK	0x02
+#define ISODEP_PCB_R_ACK	0xA2
+#define ISODEP_PCB_DESELECT	0xC2
+#define ISODEP_PCB_CHAINING	BIT(4)
+#define ISODEP_PCB_BLOCK_NUM	BIT(0)
+#define ISODEP_RATS		0xE0
+
+#define APDU_INS_SELECT		0xA4
+#define APDU_INS_READ		0xB0
+#define APDU_INS_UPDATE		0xD6
+#define APDU_SELECT_BY_NAME	0x04
+#define APDU_SW_OK		0x9000
+#define APDU_SW_NOT_FOUND	0x6A82
+#define APDU_SW_WRONG_LEN	0x6700
+
+#define CC_FILE_ID		0xE103
+#define CC_READ_LEN		15
+#define CC_MAP_VERSION_2	0x20
+#define CC_MAP_VERSION_3	0x30
+
+/* Simulated Type 4 Tag. */
+struct tag_profile {
+	const char *name;
+	uint8_t map_version;
+	uint16_t mle;
+	uint16_t mlc;
+	/* FSCI and FWI sent in the ATS. */
+	uint8_t fsci;
+	uint8_t fwi;
+};
+
+struct sim_stats {
+	uint64_t time_fc;
+	uint32_t wait_ms;
+	uint32_t frames;
+	uint32_t read_cmds;
+	uint32_t update_cmds;
+	uint32_t violations;
+};
+
+static const uint8_t ndef_app_name[] = {0xD2, 0x76, 0x00, 0x00, 0x85, 0x01, 0x01};
+static const uint16_t fsc_map[] = {16, 24, 32, 40, 48, 64, 96, 128, 256};
+
+static struct {
+	const struct tag_profile *profile;
+	uint16_t fsd;
+	uint8_t cc[32];
+	uint16_t cc_len;
+	uint8_t ndef[NDEF_FILE_MAX_SIZE];
+	const uint8_t *file;
+	uint8_t *file_wr;
+	size_t file_size;
+	uint8_t capdu[TAG_CAPDU_BUF_SIZE];
+	size_t capdu_len;
+	uint8_t rapdu[TAG_RAPDU_BUF_SIZE];
+	size_t rapdu_len;
+	size_t rapdu_sent;
+} tag;
+
+/* Reader state. */
+static uint8_t isodep_tx_buf[ISODEP_TX_BUF_SIZE];
+static uint8_t isodep_rx_buf[ISODEP_RX_BUF_SIZE];
+static uint8_t reader_frame[ISODEP_TX_BUF_SIZE];
+static size_t reader_frame_len;
+static uint8_t ndef_buf[NDEF_FILE_MAX_SIZE];
+static uint8_t ndef_ref[NDEF_FILE_MAX_SIZE];
+static size_t ndef_read_len;
+static bool done;
+static int procedure_err;
+static struct sim_stats stats;
+
+NFC_T4T_CC_DESC_DEF(t4t_cc, CC_MAX_TLV_BLOCKS);
+
+
+static void tag_init(const struct tag_profile *profile, size_t nlen)
+{
+	uint8_t *cc = tag.cc;
+
+	memset(&tag, 0, sizeof(tag));
+	tag.profile = profile;
+
+	/* CC file with a single NDEF File Control TLV. */
+	cc += 2;
+	*cc++ = profile->map_version;
+	sys_put_be16(profile->mle, cc);
+	cc += 2;
+	sys_put_be16(profile->mlc, cc);
+	cc += 2;
+
+	if (profile->map_version == CC_MAP_VERSION_3) {
+		*cc++ = NFC_T4T_TLV_BLOCK_TYPE_EXTENDED_NDEF_FILE_CONTROL_TLV;
+		*cc++ = 8;
+		sys_put_be16(NDEF_FILE_ID, cc);
+		cc += 2;
+		sys_put_be32(0xFFFF, cc);
+		cc += 4;
+	} else {
+		*cc++ = NFC_T4T_TLV_BLOCK_TYPE_NDEF_FILE_CONTROL_TLV;
+		*cc++ = 6;
+		sys_put_be16(NDEF_FILE_ID, cc);
+		cc += 2;
+		sys_put_be16(NDEF_FILE_MAX_SIZE, cc);
+		cc += 2;
+	}
+
+	/* Read and write access granted. */
+	*cc++ = 0x00;
+	*cc++ = 0x00;
+
+	tag.cc_len = cc - tag.cc;
+	sys_put_be16(tag.cc_len, tag.cc);
+
+	/* NDEF File with the message filled with a pattern. */
+	sys_put_be16(nlen, tag.ndef);
+	for (size_t i = 0; i < nlen; i++) {
+		tag.ndef[NDEF_FILE_NLEN_SIZE + i] = (i * 7) ^ (i >> 8);
+	}
+
+	memcpy(ndef_ref, tag.ndef, sizeof(ndef_ref));
+}
+
+static void rapdu_set(const uint8_t *data, size_t len, uint16_t status)
+{
+	__ASSERT_NO_MSG(len + 2 <= sizeof(tag.rapdu));
+
+	if (len) {
+		memcpy(tag.rapdu, data, len);
+	}
+
+	sys_put_be16(status, &tag.rapdu[len]);
+	tag.rapdu_len = len + 2;
+	tag.rapdu_sent = 0;
+}
+
+static void tag_apdu_execute(void)
+{
+	const uint8_t *apdu = tag.capdu;
+	size_t len = tag.capdu_len;
+	const uint8_t *data = NULL;
+	size_t lc = 0;
+	uint32_t le = 0;
+	bool extended = false;
+	uint16_t offset = sys_get_be16(&apdu[2]);
+
+	zassert_true(len >= 4, "C-APDU too short");
+
+	/* Decode the Lc and Le fields. ISO/IEC 7816-4 5.1. */
+	if (len == 5) {
+		le = apdu[4] ? apdu[4] : 256;
+	} else if ((len == 7) && (apdu[4] == 0)) {
+		extended = true;
+		le = sys_get_be16(&apdu[5]);
+		le = le ? le : 65536;
+	} else if (len > 5) {
+		if (apdu[4] == 0) {
+			extended = true;
+			lc = sys_get_be16(&apdu[5]);
+			data = &apdu[7];
+		} else {
+			lc = apdu[4];
+			data = &apdu[5];
+		}
+
+		zassert_true(len >= (data - apdu) + lc, "Invalid Lc field");
+
+		if (len > (data - apdu) + lc) {
+			le = extended ? sys_get_be16(&data[lc]) : data[lc];
+		}
+	}
+
+	if (extended && (tag.profile->map_version < CC_MAP_VERSION_3)) {
+		stats.violations++;
+	}
+
+	switch (apdu[1]) {
+	case APDU_INS_SELECT:
+		if (apdu[2] == APDU_SELECT_BY_NAME) {
+			zassert_equal(lc, sizeof(ndef_app_name));
+			zassert_mem_equal(data, ndef_app_name, lc);
+			rapdu_set(NULL, 0, APDU_SW_OK);
+		} else if (sys_get_be16(data) == CC_FILE_ID) {
+			tag.file = tag.cc;
+			tag.file_wr = NULL;
+			tag.file_size = tag.cc_len;
+			rapdu_set(NULL, 0, APDU_SW_OK);
+		} else if (sys_get_be16(data) == NDEF_FILE_ID) {
+			tag.file = tag.ndef;
+			tag.file_wr = tag.ndef;
+			tag.file_size = NDEF_FILE_MAX_SIZE;
+			rapdu_set(NULL, 0, APDU_SW_OK);
+		} else {
+			rapdu_set(NULL, 0, APDU_SW_NOT_FOUND);
+		}
+		break;
+
+	case APDU_INS_READ:
+		stats.read_cmds++;
+
+		if (le > tag.profile->mle) {
+			stats.violations++;
+			rapdu_set(NULL, 0, APDU_SW_WRONG_LEN);
+			break;
+		}
+
+		zassert_true(offset <= tag.file_size, "Read out of the file");
+		rapdu_set(&tag.file[offset], MIN(le, tag.file_size - offset), APDU_SW_OK);
+		break;
+
+	case APDU_INS_UPDATE:
+		stats.update_cmds++;
+
+		if (lc > tag.profile->mlc) {
+			stats.violations++;
+			rapdu_set(NULL, 0, APDU_SW_WRONG_LEN);
+			break;
+		}
+
+		zassert_not_null(tag.file_wr, "File not writable");
+		zassert_true(offset + lc <= tag.file_size, "Update out of the file");
+		memcpy(&tag.file_wr[offset], data, lc);
+		rapdu_set(NULL, 0, APDU_SW_OK);
+		break;
+
+	default:
+		zassert_unreachable("Unexpected instruction 0x%02x", apdu[1]);
+	}
+
+	tag.capdu_len = 0;
+}
+
+/* Send the next part of the R-APDU, chained to fit in the reader frame. */
+static size_t tag_rapdu_chunk_get(uint8_t block_num, uint8_t *frame)
+{
+	size_t len = MIN(tag.rapdu_len - tag.rapdu_sent, tag.fsd - 3);
+
+	frame[0] = ISODEP_PCB_I_BLOCK | block_num;
+	memcpy(&frame[1], &tag.rapdu[tag.rapdu_sent], len);
+	tag.rapdu_sent += len;
+
+	if (tag.rapdu_sent < tag.rapdu_len) {
+		frame[0] |= ISODEP_PCB_CHAINING;
+	}
+
+	return len + 1;
+}
+
+/* Handle a frame from the reader and prepare the response frame. */
+static size_t tag_frame_handle(const uint8_t *data, size_t len, uint8_t *frame)
+{
+	const struct tag_profile *profile = tag.profile;
+	uint8_t pcb = data[0];
+	uint8_t block_num = pcb & ISODEP_PCB_BLOCK_NUM;
+
+	if (pcb == ISODEP_RATS) {
+		tag.fsd = fsc_map[data[1] >> 4];
+
+		/* ATS with TA, TB and TC. */
+		frame[0] = 5;
+		frame[1] = 0x70 | profile->fsci;
+		frame[2] = 0x00;
+		frame[3] = profile->fwi << 4;
+		frame[4] = 0x00;
+
+		return 5;
+	}
+
+	if (pcb == ISODEP_PCB_DESELECT) {
+		frame[0] = ISODEP_PCB_DESELECT;
+		return 1;
+	}
+
+	if ((pcb & ~(ISODEP_PCB_CHAINING | ISODEP_PCB_BLOCK_NUM)) == ISODEP_PCB_I_BLOCK) {
+		zassert_true(len <= fsc_map[profile->fsci] - 2, "Frame exceeds FSC");
+		zassert_true(tag.capdu_len + len - 1 <= sizeof(tag.capdu));
+
+		memcpy(&tag.capdu[tag.capdu_len], &data[1], len - 1);
+		tag.capdu_len += len - 1;
+
+		if (pcb & ISODEP_PCB_CHAINING) {
+			frame[0] = ISODEP_PCB_R_ACK | block_num;
+			return 1;
+		}
+
+		tag_apdu_execute();
+		stats.time_fc += TAG_APDU_EXEC_FC;
+
+		return tag_rapdu_chunk_get(block_num, frame);
+	}
+
+	if ((pcb & ~ISODEP_PCB_BLOCK_NUM) == ISODEP_PCB_R_ACK) {
+		zassert_true(tag.rapdu_sent < tag.rapdu_len, "Unexpected R(ACK)");
+
+		return tag_rapdu_chunk_get(block_num, frame);
+	}
+
+	zassert_unreachable("Unexpected frame 0x%02x", pcb);
+
+	return 0;
+}
+
+/* Exchange the frames between the reader and the tag until the procedure
+ * ends, accounting the time spent on the link.
+ */
+static void link_run(void)
+{
+	static uint8_t frame[TAG_FRAME_BUF_SIZE];
+	int64_t start = k_uptime_get();
+
+	while (!done && !procedure_err) {
+		if (reader_frame_len == 0) {
+			int64_t wait_start = k_uptime_get();
+
+			zassert_true(k_uptime_get() - start < WAIT_TIMEOUT_MS, "Procedure stuck");
+
+			/* The reader delays a frame with a timer. */
+			k_sleep(K_MSEC(1));
+			stats.wait_ms += k_uptime_delta(&wait_start);
+			continue;
+		}
+
+		size_t len = reader_frame_len;
+		size_t resp_len;
+
+		reader_frame_len = 0;
+		stats.frames++;
+		stats.time_fc += FRAME_FC(len) + LISTEN_FDT_FC;
+
+		resp_len = tag_frame_handle(reader_frame, len, frame);
+		zassert_true(resp_len <= tag.fsd - 2, "Frame exceeds FSD");
+
+		stats.time_fc += FRAME_FC(resp_len) + POLL_FDT_FC;
+
+		zassert_equal(nfc_t4t_isodep_data_received(frame, resp_len, 0), 0);
+	}
+}
+
+static uint32_t throughput_get(size_t len)
+{
+	uint64_t time_us = (stats.time_fc * USEC_PER_SEC) / FC_HZ +
+			   (uint64_t)stats.wait_ms * USEC_PER_MSEC;
+
+	return (uint32_t)(((uint64_t)len * USEC_PER_SEC) / time_us);
+}
+
+static void isodep_selected(const struct nfc_t4t_isodep_tag *t4t_tag)
+{
+	procedure_err = nfc_t4t_hl_procedure_ndef_tag_app_select();
+}
+
+static void isodep_error(int err)
+{
+	procedure_err = err ? err : -EIO;
+}
+
+static void isodep_ready_to_send(uint8_t *data, size_t data_len, uint32_t ftd)
+{
+	zassert_equal(reader_frame_len, 0, "Previous frame not sent");
+	zassert_true(data_len <= sizeof(reader_frame));
+
+	memcpy(reader_frame, data, data_len);
+	reader_frame_len = data_len;
+}
+
+static void isodep_data_received(const uint8_t *data, size_t data_len)
+{
+	int err = nfc_t4t_hl_procedure_on_data_received(data, data_len);
+
+	if (err) {
+		procedure_err = err;
+	}
+}
+
+static void isodep_deselected(void)
+{
+	done = true;
+}
+
+static const struct nfc_t4t_isodep_cb isodep_cb = {
+	.selected = isodep_selected,
+	.deselected = isodep_deselected,
+	.error = isodep_error,
+	.ready_to_send = isodep_ready_to_send,
+	.data_received = isodep_data_received,
+};
+
+static void hl_selected(enum nfc_t4t_hl_procedure_select type)
+{
+	switch (type) {
+	case NFC_T4T_HL_PROCEDURE_NDEF_APP_SELECT:
+		procedure_err = nfc_t4t_hl_procedure_cc_select();
+		break;
+
+	case NFC_T4T_HL_PROCEDURE_CC_SELECT:
+		procedure_err = nfc_t4t_hl_procedure_cc_read(&NFC_T4T_CC_DESC(t4t_cc));
+		break;
+
+	case NFC_T4T_HL_PROCEDURE_NDEF_FILE_SELECT:
+		procedure_err = nfc_t4t_hl_procedure_ndef_read(&NFC_T4T_CC_DESC(t4t_cc),
+							       ndef_buf, sizeof(ndef_buf));
+		break;
+
+	default:
+		procedure_err = -EINVAL;
+	}
+}
+
+static void hl_cc_read(struct nfc_t4t_cc_file *cc)
+{
+	struct nfc_t4t_tlv_block *tlv_block = nfc_t4t_cc_file_content_get(cc, NDEF_FILE_ID);
+
+	zassert_not_null(tlv_block, "NDEF File Control TLV not found");
+
+	procedure_err = nfc_t4t_hl_procedure_ndef_file_select(NDEF_FILE_ID);
+}
+
+static void hl_ndef_read(uint16_t file_id, const uint8_t *data, size_t len)
+{
+	zassert_equal(file_id, NDEF_FILE_ID);
+
+	ndef_read_len = len;
+	done = true;
+}
+
+static void hl_ndef_updated(uint16_t file_id)
+{
+	zassert_equal(file_id, NDEF_FILE_ID);
+
+	done = true;
+}
+
+static const struct nfc_t4t_hl_procedure_cb hl_cb = {
+	.selected = hl_selected,
+	.cc_read = hl_cc_read,
+	.ndef_read = hl_ndef_read,
+	.ndef_updated = hl_ndef_updated,
+};
+
+static void *setup(void)
+{
+	zassert_equal(nfc_t4t_isodep_init(isodep_tx_buf, sizeof(isodep_tx_buf),
+					  isodep_rx_buf, sizeof(isodep_rx_buf), &isodep_cb), 0);
+	zassert_equal(nfc_t4t_hl_procedure_cb_register(&hl_cb), 0);
+
+	return NULL;
+}
+
+static void after(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	/* Deselect the tag, so that the next test starts with RATS. */
+	done = false;
+	procedure_err = 0;
+
+	if (nfc_t4t_isodep_tag_deselect() == 0) {
+		link_run();
+	}
+}
+
+/* Read the NDEF message from the simulated tag. */
+static void ndef_read(const struct tag_profile *profile, size_t nlen)
+{
+	tag_init(profile, nlen);
+
+	memset(&stats, 0, sizeof(stats));
+	memset(ndef_buf, 0, sizeof(ndef_buf));
+	ndef_read_len = 0;
+	reader_frame_len = 0;
+	done = false;
+	procedure_err = 0;
+
+	zassert_equal(nfc_t4t_isodep_rats_send(NFC_T4T_ISODEP_FSD_256, 0), 0);
+
+	link_run();
+
+	zassert_equal(procedure_err, 0, "Procedure failed: %d", procedure_err);
+	zassert_equal(ndef_read_len, nlen + NDEF_FILE_NLEN_SIZE);
+	zassert_mem_equal(ndef_buf, ndef_ref, ndef_read_len, "NDEF File mismatch");
+	zassert_equal(stats.violations, 0, "Tag limits exceeded");
+}
+
+static const struct tag_profile tag_v2_short = {
+	.name = "2.0, MLe 255, FSC 64",
+	.map_version = CC_MAP_VERSION_2,
+	.mle = 0x00FF,
+	.mlc = 0x00FF,
+	.fsci = 5,
+	.fwi = 4,
+};
+
+static const struct tag_profile tag_v2 = {
+	.name = "2.0, MLe 65535, FSC 256",
+	.map_version = CC_MAP_VERSION_2,
+	.mle = 0xFFFF,
+	.mlc = 0xFFFF,
+	.fsci = 8,
+	.fwi = 7,
+};
+
+static const struct tag_profile tag_v3 = {
+	.name = "3.0, MLe 65535, FSC 256",
+	.map_version = CC_MAP_VERSION_3,
+	.mle = 0xFFFF,
+	.mlc = 0xFFFF,
+	.fsci = 8,
+	.fwi = 7,
+};
+
+ZTEST(nfc_t4t_hl_procedure, test_apdu_extended_len)
+{
+	const uint8_t read_short[] = {0x00, APDU_INS_READ, 0x00, 0x02, 0x00};
+	const uint8_t read_extended[] = {0x00, APDU_INS_READ, 0x00, 0x02, 0x00, 0x04, 0x00};
+	const uint8_t update_extended[] = {0x00, APDU_INS_UPDATE, 0x00, 0x00,
+					   0x00, 0x00, 0x02, 0xAB, 0xCD, 0x01, 0x01};
+	const uint8_t data[] = {0xAB, 0xCD};
+	struct nfc_t4t_apdu_comm comm;
+	uint8_t buf[16];
+	uint16_t len;
+
+	nfc_t4t_apdu_comm_clear(&comm);
+	comm.instruction = APDU_INS_READ;
+	comm.parameter = 2;
+	comm.resp_len = 256;
+
+	len = sizeof(buf);
+	zassert_equal(nfc_t4t_apdu_comm_encode(&comm, buf, &len), 0);
+	zassert_equal(len, sizeof(read_short));
+	zassert_mem_equal(buf, read_short, len);
+
+	/* Le field without Lc field. */
+	comm.resp_len = 0x400;
+	len = sizeof(buf);
+	zassert_equal(nfc_t4t_apdu_comm_encode(&comm, buf, &len), 0);
+	zassert_equal(len, sizeof(read_extended));
+	zassert_mem_equal(buf, read_extended, len);
+
+	/* Long Le field forces long Lc field. */
+	nfc_t4t_apdu_comm_clear(&comm);
+	comm.instruction = APDU_INS_UPDATE;
+	comm.data.buff = (uint8_t *)data;
+	comm.data.len = sizeof(data);
+	comm.resp_len = 0x101;
+
+	len = sizeof(buf);
+	zassert_equal(nfc_t4t_apdu_comm_encode(&comm, buf, &len), 0);
+	zassert_equal(len, sizeof(update_extended));
+	zassert_mem_equal(buf, update_extended, len);
+
+	len = sizeof(update_extended) - 1;
+	zassert_equal(nfc_t4t_apdu_comm_encode(&comm, buf, &len), -ENOMEM);
+}
+
+ZTEST(nfc_t4t_hl_procedure, test_ndef_read)
+{
+	const size_t nlen = 1000;
+	uint32_t short_reads = 1 + DIV_ROUND_UP(nlen + NDEF_FILE_NLEN_SIZE - FIRST_READ_LEN,
+						SHORT_READ_LEN);
+
+	/* The NLEN field is read together with the message, every response
+	 * fits in a single frame.
+	 */
+	ndef_read(&tag_v2_short, nlen);
+	zassert_equal(stats.read_cmds, DIV_ROUND_UP(tag.cc_len, CC_READ_LEN) + short_reads);
+	zassert_equal(stats.frames, 4 + DIV_ROUND_UP(tag.cc_len, CC_READ_LEN) + short_reads);
+
+	/* Short Le field for a tag without extended-length support. */
+	ndef_read(&tag_v2, nlen);
+	zassert_equal(stats.read_cmds, DIV_ROUND_UP(tag.cc_len, CC_READ_LEN) + short_reads);
+
+	/* Extended Le field after the first response, limited by the ISO-DEP
+	 * RX buffer.
+	 */
+	ndef_read(&tag_v3, nlen);
+	zassert_equal(stats.read_cmds, DIV_ROUND_UP(tag.cc_len, CC_READ_LEN) + 1 +
+		      DIV_ROUND_UP(nlen + NDEF_FILE_NLEN_SIZE - FIRST_READ_LEN,
+				   EXTENDED_READ_LEN));
+
+	/* Empty NDEF message and message that ends in the first response. */
+	ndef_read(&tag_v2, 0);
+	zassert_equal(stats.read_cmds, DIV_ROUND_UP(tag.cc_len, CC_READ_LEN) + 1);
+
+	ndef_read(&tag_v2, FIRST_READ_LEN - NDEF_FILE_NLEN_SIZE);
+	zassert_equal(stats.read_cmds, DIV_ROUND_UP(tag.cc_len, CC_READ_LEN) + 1);
+}
+
+ZTEST(nfc_t4t_hl_procedure, test_ndef_update)
+{
+	const size_t nlen = 600;
+	const struct tag_profile *profiles[] = {&tag_v2_short, &tag_v3};
+
+	for (size_t i = 0; i < ARRAY_SIZE(profiles); i++) {
+		ndef_read(profiles[i], 0);
+
+		/* The NDEF File is written in chunks that fit in the APDU buffer. */
+		for (size_t j = 0; j < nlen; j++) {
+			ndef_buf[NDEF_FILE_NLEN_SIZE + j] = j;
+		}
+		sys_put_be16(nlen, ndef_buf);
+
+		done = false;
+		zassert_equal(nfc_t4t_hl_procedure_ndef_update(&NFC_T4T_CC_DESC(t4t_cc), ndef_buf,
+							       nlen + NDEF_FILE_NLEN_SIZE), 0);
+		link_run();
+
+		zassert_equal(procedure_err, 0, "Update failed: %d", procedure_err);
+		zassert_equal(stats.violations, 0, "Tag limits exceeded");
+		zassert_mem_equal(tag.ndef, ndef_buf, nlen + NDEF_FILE_NLEN_SIZE,
+				  "NDEF File not updated");
+	}
+}
+
+ZTEST(nfc_t4t_hl_procedure, test_throughput)
+{
+	const size_t nlen[] = {64, 256, 1024, 4000};
+	const struct tag_profile *profiles[] = {&tag_v2_short, &tag_v2, &tag_v3};
+
+	for (size_t i = 0; i < ARRAY_SIZE(profiles); i++) {
+		for (size_t j = 0; j < ARRAY_SIZE(nlen); j++) {
+			ndef_read(profiles[i], nlen[j]);
+
+			printk("Tag %s, %u byte NDEF message: %u READ BINARY, %u frames, "
+			       "%u ms waiting, %u bytes/s\n", profiles[i]->name,
+			       (uint32_t)nlen[j], stats.read_cmds, stats.frames, stats.wait_ms,
+			       throughput_get(nlen[j]));
+		}
+	}
+}
+
+ZTEST_SUITE(nfc_t4t_hl_procedure, NULL, setup, NULL, after, NULL);
@@ -0,0 +1,141 @@
+#
+# Copyright (c) 2023 Nordic Semiconductor ASA
+#
+# SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+
+import csv
+import subprocess
+import sys
+from io import StringIO
+from pathlib import Path
+
+sys.path.insert(0, str(Path(__file__).resolve().parents[4] / 'scripts' / 'nrf_profiler'))
+
+from events import EventType
+from stream import CompactCodec, CompactDecoder
+
+PROFILED_EVENTS_NB = 100
+U_VALUE_START = 0
+S_VALUE_START = -50
+EXAMPLE_STRING = 'example string'
+RUN_TIMEOUT = 60 # In seconds.
+
+RAW_SIZES = {
+    'u8': (1, False),
+    's8': (1, True),
+    'u16': (2, False),
+    's16': (2, True),
+    'u32': (4, False),
+    's32': (4, True),
+    't': (4, False),
+}
+
+
+def event_types_read(info):
+    event_types = {}
+    for row in csv.reader(StringIO(info), delimiter=','):
+        # Empty field is sent after last event description
+        if len(row) == 0:
+            break
+        event_types[int(row[1])] = EventType(row[0], row[2:len(row) // 2 + 1],
+                                             row[len(row) // 2 + 1:])
+    return event_types
+
+
+def event_type_id(event_types, name):
+    return next(i for i, et in event_types.items() if et.name == name)
+
+
+def raw_events_parse(buf, event_types):
+    # Splits the events in the default format to (type ID, timestamp, values).
+    events = []
+    pos = 0
+    while pos < len(buf):
+        type_id = buf[pos]
+        timestamp = int.from_bytes(buf[pos + 1:pos + 5], byteorder='little')
+        pos += 5
+        values = []
+        for data_type in event_types[type_id].data_types:
+            if data_type == 's':
+                values.append(buf[pos + 1:pos + 1 + buf[pos]].decode())
+                pos += 1 + buf[pos]
+            else:
+                size, signed = RAW_SIZES[data_type]
+                values.append(int.from_bytes(buf[pos:pos + size], byteorder='little',
+                                             signed=signed))
+                pos += size
+        events.append((type_id, timestamp, values))
+    return events
+
+
+def test_compact_decode(request, tmp_path):
+    # The data is encoded by the nRF Profiler on the native board, as described
+    # in the README.txt file of the test, and decoded by the host scripts.
+    build_dir = Path(request.config.getoption('--build-dir'))
+    run = subprocess.run([str(build_dir / 'zephyr' / 'zephyr.exe')], cwd=tmp_path,
+                         stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                         timeout=RUN_TIMEOUT, check=False)
+    assert b'PROJECT EXECUTION SUCCESSFUL' in run.stdout
+
+    event_types = event_types_read((tmp_path / 'nrf_profiler_info.txt').read_text())
+    decoder = CompactDecoder(event_types)
+    decoded = decoder.decode((tmp_path / 'nrf_profiler_data.bin').read_bytes())
+    assert len(decoder.pending) == 0, "Incomplete event at the end of the data"
+
+    no_data_id = event_type_id(event_types, 'no data event')
+    data_id = event_type_id(event_types, 'data event')
+    big_id = event_type_id(event_types, 'big event')
+    events = raw_events_parse(decoded, event_types)
+    assert len(events) >= 3 * PROFILED_EVENTS_NB
+
+    prev_timestamp = events[0][1]
+    for _, timestamp, _ in events:
+        assert (timestamp - prev_timestamp) & CompactCodec.VALUE_MASK < 2**31, \
+            "Timestamps not in order"
+        prev_timestamp = timestamp
+
+    for i in range(PROFILED_EVENTS_NB):
+        assert events[i][0] == no_data_id
+        assert events[i][2] == []
+
+        assert events[PROFILED_EVENTS_NB + i][0] == data_id
+        assert events[PROFILED_EVENTS_NB + i][2] == [U_VALUE_START + i]
+
+        u_value = U_VALUE_START + i
+        s_value = S_VALUE_START + i
+        assert events[2 * PROFILED_EVENTS_NB + i][0] == big_id
+        assert events[2 * PROFILED_EVENTS_NB + i][2] == [u_value, s_value, u_value, s_value,
+                                                         u_value, s_value, EXAMPLE_STRING]
+
+    # Events of the ring buffer overflow test continue the data event values,
+    # with gaps for the dropped events.
+    prev_value = U_VALUE_START + PROFILED_EVENTS_NB - 1
+    for type_id, _, values in events[3 * PROFILED_EVENTS_NB:]:
+        if type_id == data_id:
+            assert values[0] > prev_value
+            prev_value = values[0]
+
+
+def test_compact_sync():
+    # A decoder that starts in the middle of the stream gets in sync after
+    # the _nrf_profiler_compact_encoding_ event.
+    event_types = {
+        0: EventType('data event', ['u32', 's32'], ['value1', 'value2']),
+        1: EventType(CompactCodec.EVENT_NAME, [], []),
+    }
+    events = [(0, 1000 * i, [i, -i]) for i in range(10)]
+    events.insert(5, (1, 4500, []))
+    raw = []
+    for type_id, timestamp, values in events:
+        buf = bytearray([type_id]) + timestamp.to_bytes(4, byteorder='little')
+        for data_type, value in zip(event_types[type_id].data_types, values):
+            buf += value.to_bytes(4, byteorder='little', signed=(data_type == 's32'))
+        raw.append(bytes(buf))
+
+    encoder = CompactCodec(event_types)
+    encoded = [encoder.encode(r) for r in raw]
+
+    decoder = CompactDecoder(event_types)
+    decoded = decoder.decode(b''.join(encoded[3:]))
+    expected = b''.join(raw[6:])
+    assert decoded[-len(expected):] == expected
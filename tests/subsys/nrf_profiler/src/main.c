@@ -11,6 +11,11 @@
 #define U_VALUE_START 0
 #define S_VALUE_START -50
 #define EXAMPLE_STRING "example string"
+/* Ring buffer record of the data event: 4-byte header, event ID, timestamp and value1. */
+#define DATA_EVENT_RECORD_SIZE 12
+#define RING_DATA_EVENTS_MAX \
+	(CONFIG_NRF_PROFILER_NORDIC_RING_BUFFER_SIZE / DATA_EVENT_RECORD_SIZE)
+#define OVERFLOW_EVENTS_NB (2 * RING_DATA_EVENTS_MAX)
 
 static uint16_t no_data_event_id;
 static uint16_t data_event_id;
@@ -120,4 +125,44 @@ ZTEST(suite_nrf_profiler, test_performance_03)
 	       "Elapsed time [us]: %d\n", PROFILED_EVENTS_NB, elapsed_time_us);
 }
 
+ZTEST(suite_nrf_profiler, test_ring_buffer_overflow)
+{
+	uint32_t dropped_start;
+	uint32_t dropped;
+
+	/* Give the nRF Profiler thread time to empty the ring buffer. */
+	k_sleep(K_MSEC(100));
+	dropped_start = nrf_profiler_dropped_count_get();
+
+	/* Prevent the nRF Profiler thread from emptying the ring buffer. */
+	k_sched_lock();
+	for (size_t i = 0; i < OVERFLOW_EVENTS_NB; i++) {
+		struct log_event_buf buf;
+
+		nrf_profiler_log_start(&buf);
+		profile_data_event(&buf);
+		nrf_profiler_log_send(&buf, data_event_id);
+	}
+	k_sched_unlock();
+
+	dropped = nrf_profiler_dropped_count_get() - dropped_start;
+	printk("Logged %d events with 4-byte data, %u dropped.\n", OVERFLOW_EVENTS_NB, dropped);
+
+	zassert_true(dropped > 0, "Events should be dropped");
+	zassert_true(OVERFLOW_EVENTS_NB - dropped <= RING_DATA_EVENTS_MAX,
+		     "More events stored than fit in the ring buffer");
+
+	if (!IS_ENABLED(CONFIG_NRF_PROFILER_NORDIC_BACKEND_FILE)) {
+		/* Other backends empty the ring buffer only if the host reads the data. */
+		return;
+	}
+
+	/* Profiling continues after the ring buffer is emptied. */
+	k_sleep(K_MSEC(100));
+	dropped_start = nrf_profiler_dropped_count_get();
+	test_performance_core(profile_data_event, data_event_id);
+	zassert_equal(nrf_profiler_dropped_count_get(), dropped_start,
+		      "Events dropped after the ring buffer is emptied");
+}
+
 ZTEST_SUITE(suite_nrf_profiler, NULL, test_init, NULL, NULL, NULL);
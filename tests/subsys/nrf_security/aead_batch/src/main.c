@@ -0,0 +1,299 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <psa/crypto.h>
+#include <nrf_aead_batch.h>
+
+#define MSG_COUNT 8
+#define MSG_MAX_SIZE 128
+#define AD_SIZE 13
+#define NONCE_SIZE 12
+#define TAG_SIZE 16
+#define BENCHMARK_MSG_COUNT 64
+
+static const uint8_t key_data[16] = {
+	0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47,
+	0x48, 0x49, 0x4a, 0x4b, 0x4c, 0x4d, 0x4e, 0x4f
+};
+
+static const psa_algorithm_t algs[] = {PSA_ALG_CCM, PSA_ALG_GCM};
+
+static uint8_t plaintext[MSG_MAX_SIZE];
+static uint8_t ad[AD_SIZE];
+static uint8_t nonces[BENCHMARK_MSG_COUNT][NONCE_SIZE];
+static uint8_t expected[MSG_COUNT][MSG_MAX_SIZE + TAG_SIZE];
+static uint8_t output[BENCHMARK_MSG_COUNT][MSG_MAX_SIZE + TAG_SIZE];
+static struct nrf_aead_batch_msg msgs[BENCHMARK_MSG_COUNT];
+
+static psa_key_id_t key_import(psa_algorithm_t alg)
+{
+	psa_status_t status;
+	psa_key_id_t key_id;
+	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+
+	psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT);
+	psa_set_key_lifetime(&attributes, PSA_KEY_LIFETIME_VOLATILE);
+	psa_set_key_algorithm(&attributes, alg);
+	psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+	psa_set_key_bits(&attributes, 128);
+
+	status = psa_import_key(&attributes, key_data, sizeof(key_data), &key_id);
+	zassert_equal(status, PSA_SUCCESS, "psa_import_key failed: %d", status);
+
+	return key_id;
+}
+
+/* Message i has a payload of i * 17 bytes and its own nonce. */
+static size_t msg_len(size_t i)
+{
+	return MIN(i * 17, MSG_MAX_SIZE);
+}
+
+static void expected_compute(psa_key_id_t key_id, psa_algorithm_t alg)
+{
+	psa_status_t status;
+	size_t len;
+
+	for (size_t i = 0; i < MSG_COUNT; i++) {
+		status = psa_aead_encrypt(key_id, alg, nonces[i], NONCE_SIZE, ad, sizeof(ad),
+					  plaintext, msg_len(i), expected[i],
+					  sizeof(expected[i]), &len);
+		zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d", status);
+		zassert_equal(len, msg_len(i) + TAG_SIZE, "Unexpected length %zu", len);
+	}
+}
+
+static void msg_set(size_t i, const struct nrf_aead_iovec *ad_iov, size_t ad_count,
+		    const struct nrf_aead_iovec *input_iov, size_t input_count)
+{
+	msgs[i] = (struct nrf_aead_batch_msg) {
+		.nonce = nonces[i],
+		.nonce_length = NONCE_SIZE,
+		.ad = ad_iov,
+		.ad_count = ad_count,
+		.input = input_iov,
+		.input_count = input_count,
+		.output = output[i],
+		.output_size = sizeof(output[i]),
+	};
+}
+
+static void *aead_batch_setup(void)
+{
+	psa_status_t status;
+
+	status = psa_crypto_init();
+	zassert_equal(status, PSA_SUCCESS, "psa_crypto_init failed: %d", status);
+
+	for (size_t i = 0; i < sizeof(plaintext); i++) {
+		plaintext[i] = i;
+	}
+
+	for (size_t i = 0; i < sizeof(ad); i++) {
+		ad[i] = 0xa0 + i;
+	}
+
+	for (size_t i = 0; i < ARRAY_SIZE(nonces); i++) {
+		memset(nonces[i], 0, NONCE_SIZE);
+		nonces[i][NONCE_SIZE - 1] = i;
+	}
+
+	return NULL;
+}
+
+ZTEST(aead_batch, test_encrypt_decrypt)
+{
+	static struct nrf_aead_iovec ad_iov = {ad, sizeof(ad)};
+	static struct nrf_aead_iovec input_iov[MSG_COUNT];
+	psa_status_t status;
+
+	for (size_t a = 0; a < ARRAY_SIZE(algs); a++) {
+		psa_key_id_t key_id = key_import(algs[a]);
+
+		expected_compute(key_id, algs[a]);
+
+		for (size_t i = 0; i < MSG_COUNT; i++) {
+			input_iov[i] = (struct nrf_aead_iovec) {plaintext, msg_len(i)};
+			msg_set(i, &ad_iov, 1, &input_iov[i], 1);
+		}
+
+		status = nrf_aead_encrypt_batch(key_id, algs[a], msgs, MSG_COUNT);
+		zassert_equal(status, PSA_SUCCESS, "nrf_aead_encrypt_batch failed: %d", status);
+
+		for (size_t i = 0; i < MSG_COUNT; i++) {
+			zassert_equal(msgs[i].status, PSA_SUCCESS, "Message %zu failed", i);
+			zassert_equal(msgs[i].output_length, msg_len(i) + TAG_SIZE,
+				      "Unexpected length for message %zu", i);
+			zassert_mem_equal(output[i], expected[i], msgs[i].output_length,
+					  "Unexpected ciphertext for message %zu", i);
+		}
+
+		for (size_t i = 0; i < MSG_COUNT; i++) {
+			input_iov[i] = (struct nrf_aead_iovec) {expected[i], msg_len(i) + TAG_SIZE};
+			msg_set(i, &ad_iov, 1, &input_iov[i], 1);
+		}
+
+		status = nrf_aead_decrypt_batch(key_id, algs[a], msgs, MSG_COUNT);
+		zassert_equal(status, PSA_SUCCESS, "nrf_aead_decrypt_batch failed: %d", status);
+
+		for (size_t i = 0; i < MSG_COUNT; i++) {
+			zassert_equal(msgs[i].output_length, msg_len(i),
+				      "Unexpected length for message %zu", i);
+			zassert_mem_equal(output[i], plaintext, msg_len(i),
+					  "Unexpected plaintext for message %zu", i);
+		}
+
+		psa_destroy_key(key_id);
+	}
+}
+
+ZTEST(aead_batch, test_scatter_gather)
+{
+	/* Fragments of all sizes, including empty ones, and a tag split in two. */
+	static const size_t splits[] = {0, 1, 17, 17, 60, 120, 130};
+	static struct nrf_aead_iovec ad_iov[3];
+	static struct nrf_aead_iovec input_iov[ARRAY_SIZE(splits) + 1];
+	const size_t len = msg_len(MSG_COUNT - 1);
+	psa_status_t status;
+
+	for (size_t a = 0; a < ARRAY_SIZE(algs); a++) {
+		psa_key_id_t key_id = key_import(algs[a]);
+
+		expected_compute(key_id, algs[a]);
+
+		ad_iov[0] = (struct nrf_aead_iovec) {ad, 5};
+		ad_iov[1] = (struct nrf_aead_iovec) {NULL, 0};
+		ad_iov[2] = (struct nrf_aead_iovec) {ad + 5, sizeof(ad) - 5};
+
+		for (size_t i = 0; i <= ARRAY_SIZE(splits); i++) {
+			size_t start = i == 0 ? 0 : MIN(splits[i - 1], len);
+			size_t end = i == ARRAY_SIZE(splits) ? len : MIN(splits[i], len);
+
+			input_iov[i] = (struct nrf_aead_iovec) {plaintext + start, end - start};
+		}
+
+		msg_set(MSG_COUNT - 1, ad_iov, ARRAY_SIZE(ad_iov), input_iov,
+			ARRAY_SIZE(input_iov));
+
+		status = nrf_aead_encrypt_batch(key_id, algs[a], &msgs[MSG_COUNT - 1], 1);
+		zassert_equal(status, PSA_SUCCESS, "nrf_aead_encrypt_batch failed: %d", status);
+		zassert_mem_equal(output[MSG_COUNT - 1], expected[MSG_COUNT - 1], len + TAG_SIZE,
+				  "Unexpected ciphertext");
+
+		for (size_t i = 0; i <= ARRAY_SIZE(splits); i++) {
+			size_t start = i == 0 ? 0 : splits[i - 1];
+			size_t end = i == ARRAY_SIZE(splits) ? len + TAG_SIZE : splits[i];
+
+			input_iov[i] = (struct nrf_aead_iovec) {expected[MSG_COUNT - 1] + start,
+								end - start};
+		}
+
+		msg_set(MSG_COUNT - 1, ad_iov, ARRAY_SIZE(ad_iov), input_iov,
+			ARRAY_SIZE(input_iov));
+
+		status = nrf_aead_decrypt_batch(key_id, algs[a], &msgs[MSG_COUNT - 1], 1);
+		zassert_equal(status, PSA_SUCCESS, "nrf_aead_decrypt_batch failed: %d", status);
+		zassert_mem_equal(output[MSG_COUNT - 1], plaintext, len, "Unexpected plaintext");
+
+		psa_destroy_key(key_id);
+	}
+}
+
+ZTEST(aead_batch, test_invalid_messages)
+{
+	static struct nrf_aead_iovec ad_iov = {ad, sizeof(ad)};
+	static struct nrf_aead_iovec input_iov[3];
+	psa_key_id_t key_id = key_import(PSA_ALG_CCM);
+	psa_status_t status;
+
+	expected_compute(key_id, PSA_ALG_CCM);
+
+	for (size_t i = 0; i < ARRAY_SIZE(input_iov); i++) {
+		input_iov[i] = (struct nrf_aead_iovec) {expected[i], msg_len(i) + TAG_SIZE};
+		msg_set(i, &ad_iov, 1, &input_iov[i], 1);
+	}
+
+	/* Only the second message is not authentic. */
+	expected[1][msg_len(1) + TAG_SIZE - 1] ^= 0x01;
+
+	status = nrf_aead_decrypt_batch(key_id, PSA_ALG_CCM, msgs, ARRAY_SIZE(input_iov));
+	zassert_equal(status, PSA_ERROR_INVALID_SIGNATURE, "Unexpected status %d", status);
+	zassert_equal(msgs[0].status, PSA_SUCCESS, "First message rejected");
+	zassert_equal(msgs[1].status, PSA_ERROR_INVALID_SIGNATURE, "Invalid message accepted");
+	zassert_equal(msgs[1].output_length, 0, "Output of invalid message not cleared");
+	zassert_equal(msgs[2].status, PSA_SUCCESS, "Message after invalid one rejected");
+
+	/* Input shorter than the tag. */
+	input_iov[0].len = TAG_SIZE - 1;
+	msg_set(0, &ad_iov, 1, &input_iov[0], 1);
+	status = nrf_aead_decrypt_batch(key_id, PSA_ALG_CCM, msgs, 1);
+	zassert_equal(status, PSA_ERROR_INVALID_ARGUMENT, "Unexpected status %d", status);
+
+	/* Output buffer too small for the tag. */
+	input_iov[0] = (struct nrf_aead_iovec) {plaintext, 16};
+	msg_set(0, &ad_iov, 1, &input_iov[0], 1);
+	msgs[0].output_size = 16 + TAG_SIZE - 1;
+	status = nrf_aead_encrypt_batch(key_id, PSA_ALG_CCM, msgs, 1);
+	zassert_equal(status, PSA_ERROR_BUFFER_TOO_SMALL, "Unexpected status %d", status);
+
+	/* Algorithm not permitted by the key policy. */
+	status = nrf_aead_encrypt_batch(key_id, PSA_ALG_GCM, msgs, 1);
+	zassert_equal(status, PSA_ERROR_NOT_PERMITTED, "Unexpected status %d", status);
+
+	psa_destroy_key(key_id);
+}
+
+/* Compare the throughput of one psa_aead_encrypt() call per message with a
+ * single batch, for payloads of 16 to 128 bytes.
+ */
+ZTEST(aead_batch, test_benchmark)
+{
+	static struct nrf_aead_iovec ad_iov = {ad, sizeof(ad)};
+	static struct nrf_aead_iovec input_iov;
+	psa_status_t status;
+	uint32_t start;
+	uint32_t single_us;
+	uint32_t batch_us;
+	size_t len;
+
+	for (size_t a = 0; a < ARRAY_SIZE(algs); a++) {
+		psa_key_id_t key_id = key_import(algs[a]);
+
+		for (size_t payload = 16; payload <= MSG_MAX_SIZE; payload *= 2) {
+			start = k_cycle_get_32();
+			for (size_t i = 0; i < BENCHMARK_MSG_COUNT; i++) {
+				status = psa_aead_encrypt(key_id, algs[a], nonces[i], NONCE_SIZE,
+							  ad, sizeof(ad), plaintext, payload,
+							  output[i], sizeof(output[i]), &len);
+				zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d",
+					      status);
+			}
+			single_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+			input_iov = (struct nrf_aead_iovec) {plaintext, payload};
+			for (size_t i = 0; i < BENCHMARK_MSG_COUNT; i++) {
+				msg_set(i, &ad_iov, 1, &input_iov, 1);
+			}
+
+			start = k_cycle_get_32();
+			status = nrf_aead_encrypt_batch(key_id, algs[a], msgs,
+							BENCHMARK_MSG_COUNT);
+			batch_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+			zassert_equal(status, PSA_SUCCESS, "nrf_aead_encrypt_batch failed: %d",
+				      status);
+
+			printk("%s, %zu byte payloads: %u messages/s single, %u messages/s batch\n",
+			       algs[a] == PSA_ALG_CCM ? "AES-CCM" : "AES-GCM", payload,
+			       (uint32_t)(BENCHMARK_MSG_COUNT * 1000000ULL / MAX(single_us, 1)),
+			       (uint32_t)(BENCHMARK_MSG_COUNT * 1000000ULL / MAX(batch_us, 1)));
+		}
+
+		psa_destroy_key(key_id);
+	}
+}
+
+ZTEST_SUITE(aead_batch, NULL, aead_batch_setup, NULL, NULL, NULL);
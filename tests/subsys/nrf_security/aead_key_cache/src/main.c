@@ -0,0 +1,240 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <psa/crypto.h>
+
+#define KEY_COUNT 4
+#define TAG_SIZE 8
+#define FRAME_MAX_SIZE 64
+#define BENCHMARK_FRAME_COUNT 256
+
+#define CCM_ALG PSA_ALG_AEAD_WITH_SHORTENED_TAG(PSA_ALG_CCM, TAG_SIZE)
+
+/* RFC 3610, packet vector #1 */
+static const uint8_t key_data[16] = {
+	0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7,
+	0xc8, 0xc9, 0xca, 0xcb, 0xcc, 0xcd, 0xce, 0xcf
+};
+
+static const uint8_t nonce[13] = {
+	0x00, 0x00, 0x00, 0x03, 0x02, 0x01, 0x00, 0xa0,
+	0xa1, 0xa2, 0xa3, 0xa4, 0xa5
+};
+
+static const uint8_t ad[8] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07
+};
+
+static const uint8_t plaintext[23] = {
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+	0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17,
+	0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e
+};
+
+static const uint8_t ciphertext[23 + TAG_SIZE] = {
+	0x58, 0x8c, 0x97, 0x9a, 0x61, 0xc6, 0x63, 0xd2,
+	0xf0, 0x66, 0xd0, 0xc2, 0xc0, 0xf9, 0x89, 0x80,
+	0x6d, 0x5f, 0x6b, 0x61, 0xda, 0xc3, 0x84, 0x17,
+	0xe8, 0xd1, 0x2c, 0xfd, 0xf9, 0x26, 0xe0
+};
+
+static uint8_t frame[FRAME_MAX_SIZE];
+static uint8_t output[FRAME_MAX_SIZE + TAG_SIZE];
+static uint8_t decrypted[FRAME_MAX_SIZE];
+
+static psa_key_id_t key_import(const uint8_t *data)
+{
+	psa_status_t status;
+	psa_key_id_t key_id;
+	psa_key_attributes_t attributes = PSA_KEY_ATTRIBUTES_INIT;
+
+	psa_set_key_usage_flags(&attributes, PSA_KEY_USAGE_ENCRYPT | PSA_KEY_USAGE_DECRYPT);
+	psa_set_key_lifetime(&attributes, PSA_KEY_LIFETIME_VOLATILE);
+	psa_set_key_algorithm(&attributes, CCM_ALG);
+	psa_set_key_type(&attributes, PSA_KEY_TYPE_AES);
+	psa_set_key_bits(&attributes, 128);
+
+	status = psa_import_key(&attributes, data, sizeof(key_data), &key_id);
+	zassert_equal(status, PSA_SUCCESS, "psa_import_key failed: %d", status);
+
+	return key_id;
+}
+
+static void *aead_key_cache_setup(void)
+{
+	psa_status_t status;
+
+	status = psa_crypto_init();
+	zassert_equal(status, PSA_SUCCESS, "psa_crypto_init failed: %d", status);
+
+	for (size_t i = 0; i < sizeof(frame); i++) {
+		frame[i] = i;
+	}
+
+	return NULL;
+}
+
+ZTEST(aead_key_cache, test_repeated)
+{
+	psa_status_t status;
+	psa_key_id_t key_id = key_import(key_data);
+	size_t len;
+
+	/* The first call fills the cache, the following ones use it. */
+	for (size_t i = 0; i < 3; i++) {
+		status = psa_aead_encrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad, sizeof(ad),
+					  plaintext, sizeof(plaintext), output, sizeof(output),
+					  &len);
+		zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d", status);
+		zassert_equal(len, sizeof(ciphertext), "Unexpected length %zu", len);
+		zassert_mem_equal(output, ciphertext, sizeof(ciphertext), "Wrong ciphertext");
+
+		status = psa_aead_decrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad, sizeof(ad),
+					  ciphertext, sizeof(ciphertext), decrypted,
+					  sizeof(decrypted), &len);
+		zassert_equal(status, PSA_SUCCESS, "psa_aead_decrypt failed: %d", status);
+		zassert_equal(len, sizeof(plaintext), "Unexpected length %zu", len);
+		zassert_mem_equal(decrypted, plaintext, sizeof(plaintext), "Wrong plaintext");
+	}
+
+	memcpy(output, ciphertext, sizeof(ciphertext));
+	output[sizeof(ciphertext) - 1] ^= 1;
+	status = psa_aead_decrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad, sizeof(ad), output,
+				  sizeof(ciphertext), decrypted, sizeof(decrypted), &len);
+	zassert_equal(status, PSA_ERROR_INVALID_SIGNATURE, "Modified tag accepted: %d", status);
+
+	status = psa_aead_encrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad, sizeof(ad),
+				  plaintext, sizeof(plaintext), output, sizeof(ciphertext) - 1,
+				  &len);
+	zassert_equal(status, PSA_ERROR_BUFFER_TOO_SMALL, "Short buffer accepted: %d", status);
+
+	psa_destroy_key(key_id);
+}
+
+ZTEST(aead_key_cache, test_destroy)
+{
+	psa_status_t status;
+	psa_key_id_t key_id = key_import(key_data);
+	psa_key_id_t ref_key_id;
+	uint8_t other_key_data[sizeof(key_data)];
+	uint8_t ref_output[sizeof(ciphertext)];
+	size_t len;
+
+	status = psa_aead_encrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad, sizeof(ad),
+				  plaintext, sizeof(plaintext), output, sizeof(output), &len);
+	zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d", status);
+
+	psa_destroy_key(key_id);
+
+	/* The identifier of the destroyed key is usually given to the next
+	 * key, which must not use the key schedule of the destroyed key.
+	 */
+	memcpy(other_key_data, key_data, sizeof(key_data));
+	other_key_data[0] ^= 0xff;
+	key_id = key_import(other_key_data);
+
+	status = psa_aead_encrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad, sizeof(ad),
+				  plaintext, sizeof(plaintext), output, sizeof(output), &len);
+	zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d", status);
+	zassert_true(memcmp(output, ciphertext, sizeof(ciphertext)) != 0,
+		     "Key schedule of the destroyed key used");
+
+	/* The same key material under a new identifier gives the reference. */
+	ref_key_id = key_import(other_key_data);
+	zassert_not_equal(ref_key_id, key_id, "Same key identifier");
+
+	status = psa_aead_encrypt(ref_key_id, CCM_ALG, nonce, sizeof(nonce), ad, sizeof(ad),
+				  plaintext, sizeof(plaintext), ref_output, sizeof(ref_output),
+				  &len);
+	zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d", status);
+	zassert_mem_equal(output, ref_output, sizeof(ref_output), "Wrong ciphertext");
+
+	psa_destroy_key(ref_key_id);
+	psa_destroy_key(key_id);
+}
+
+ZTEST(aead_key_cache, test_eviction)
+{
+	psa_status_t status;
+	psa_key_id_t key_ids[KEY_COUNT];
+	uint8_t outputs[KEY_COUNT][sizeof(ciphertext)];
+	uint8_t data[sizeof(key_data)];
+	size_t len;
+
+	for (size_t i = 0; i < KEY_COUNT; i++) {
+		memcpy(data, key_data, sizeof(key_data));
+		data[0] ^= i;
+		key_ids[i] = key_import(data);
+	}
+
+	/* More keys than cache entries, so that entries are evicted. */
+	for (size_t round = 0; round < 2; round++) {
+		for (size_t i = 0; i < KEY_COUNT; i++) {
+			status = psa_aead_encrypt(key_ids[i], CCM_ALG, nonce, sizeof(nonce), ad,
+						  sizeof(ad), plaintext, sizeof(plaintext),
+						  output, sizeof(output), &len);
+			zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d", status);
+
+			if (round == 0) {
+				memcpy(outputs[i], output, sizeof(outputs[i]));
+			} else {
+				zassert_mem_equal(output, outputs[i], sizeof(outputs[i]),
+						  "Wrong ciphertext for key %zu", i);
+			}
+		}
+	}
+
+	zassert_mem_equal(outputs[0], ciphertext, sizeof(ciphertext), "Wrong ciphertext");
+	for (size_t i = 1; i < KEY_COUNT; i++) {
+		zassert_true(memcmp(outputs[i], outputs[0], sizeof(ciphertext)) != 0,
+			     "Same ciphertext for keys 0 and %zu", i);
+	}
+
+	for (size_t i = 0; i < KEY_COUNT; i++) {
+		psa_destroy_key(key_ids[i]);
+	}
+}
+
+ZTEST(aead_key_cache, test_benchmark)
+{
+	psa_status_t status;
+	psa_key_id_t key_id = key_import(key_data);
+	uint32_t start;
+	uint32_t encrypt_us;
+	uint32_t decrypt_us;
+	size_t len;
+
+	for (size_t payload = 16; payload <= FRAME_MAX_SIZE; payload *= 2) {
+		start = k_cycle_get_32();
+		for (size_t i = 0; i < BENCHMARK_FRAME_COUNT; i++) {
+			status = psa_aead_encrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad,
+						  sizeof(ad), frame, payload, output,
+						  sizeof(output), &len);
+			zassert_equal(status, PSA_SUCCESS, "psa_aead_encrypt failed: %d", status);
+		}
+		encrypt_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		start = k_cycle_get_32();
+		for (size_t i = 0; i < BENCHMARK_FRAME_COUNT; i++) {
+			status = psa_aead_decrypt(key_id, CCM_ALG, nonce, sizeof(nonce), ad,
+						  sizeof(ad), output, payload + TAG_SIZE,
+						  decrypted, sizeof(decrypted), &len);
+			zassert_equal(status, PSA_SUCCESS, "psa_aead_decrypt failed: %d", status);
+		}
+		decrypt_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+		printk("AES-CCM, %zu byte frames, key cache %s: %u ns/frame encrypt, "
+		       "%u ns/frame decrypt\n",
+		       payload, IS_ENABLED(CONFIG_PSA_AEAD_KEY_CACHE) ? "enabled" : "disabled",
+		       (uint32_t)(encrypt_us * 1000ULL / BENCHMARK_FRAME_COUNT),
+		       (uint32_t)(decrypt_us * 1000ULL / BENCHMARK_FRAME_COUNT));
+	}
+
+	psa_destroy_key(key_id);
+}
+
+ZTEST_SUITE(aead_key_cache, NULL, aead_key_cache_setup, NULL, NULL, NULL);
@@ -0,0 +1,382 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <zephyr/random/rand32.h>
+#include <string.h>
+#include <mbedtls/platform.h>
+#include <mbedtls/ssl.h>
+
+#if defined(CONFIG_MBEDTLS_PSA_CRYPTO_C)
+#include <psa/crypto.h>
+#endif
+
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+#include <ztest_error_hook.h>
+#include "nrf_mbedtls_heap.h"
+#endif
+
+#define PAIR_COUNT 3
+#define ROUND_COUNT 20
+#define STEP_MAX 100
+#define PIPE_SIZE 4096
+
+/* One direction of the connection between a client and a server. */
+struct pipe {
+	uint8_t buf[PIPE_SIZE];
+	size_t len;
+};
+
+struct peer {
+	mbedtls_ssl_context ssl;
+	struct pipe *tx;
+	struct pipe *rx;
+	int arena;
+	/* Last return value of the handshake, 0 when it is done. */
+	int ret;
+};
+
+struct pair {
+	struct peer client;
+	struct peer server;
+	struct pipe to_server;
+	struct pipe to_client;
+};
+
+static const uint8_t psk[16] = {
+	0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+	0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f
+};
+
+static const char psk_identity[] = "mbedtls_heap_arena";
+static const uint8_t message[] = "ping";
+
+static mbedtls_ssl_config client_conf;
+static mbedtls_ssl_config server_conf;
+static struct pair pairs[PAIR_COUNT];
+
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+#if !defined(CONFIG_NRF_SECURITY)
+/* With nrf_security, the allocator is installed on its heap at boot. */
+static uint8_t heap[CONFIG_MBEDTLS_HEAP_SIZE] __aligned(16);
+#endif
+
+static void peer_arena_create(struct peer *peer)
+{
+	peer->arena = nrf_mbedtls_heap_arena_create();
+	zassert_true(peer->arena > 0, "nrf_mbedtls_heap_arena_create failed: %d", peer->arena);
+}
+
+static void peer_arena_enter(struct peer *peer)
+{
+	int err = nrf_mbedtls_heap_arena_enter(peer->arena);
+
+	zassert_equal(err, 0, "nrf_mbedtls_heap_arena_enter failed: %d", err);
+}
+
+static void peer_arena_exit(void)
+{
+	nrf_mbedtls_heap_arena_exit();
+}
+
+static void peer_arena_release(struct peer *peer)
+{
+	int err = nrf_mbedtls_heap_arena_release(peer->arena);
+
+	zassert_equal(err, 0, "nrf_mbedtls_heap_arena_release failed: %d", err);
+}
+#else
+static void peer_arena_create(struct peer *peer)
+{
+	ARG_UNUSED(peer);
+}
+
+static void peer_arena_enter(struct peer *peer)
+{
+	ARG_UNUSED(peer);
+}
+
+static void peer_arena_exit(void)
+{
+}
+
+static void peer_arena_release(struct peer *peer)
+{
+	ARG_UNUSED(peer);
+}
+#endif /* CONFIG_MBEDTLS_HEAP_ARENA */
+
+static int rng(void *ctx, unsigned char *buf, size_t len)
+{
+	ARG_UNUSED(ctx);
+
+	sys_rand_get(buf, len);
+
+	return 0;
+}
+
+static int peer_send(void *ctx, const unsigned char *buf, size_t len)
+{
+	struct pipe *pipe = ((struct peer *)ctx)->tx;
+
+	len = MIN(len, sizeof(pipe->buf) - pipe->len);
+	if (len == 0) {
+		return MBEDTLS_ERR_SSL_WANT_WRITE;
+	}
+
+	memcpy(pipe->buf + pipe->len, buf, len);
+	pipe->len += len;
+
+	return len;
+}
+
+static int peer_recv(void *ctx, unsigned char *buf, size_t len)
+{
+	struct pipe *pipe = ((struct peer *)ctx)->rx;
+
+	len = MIN(len, pipe->len);
+	if (len == 0) {
+		return MBEDTLS_ERR_SSL_WANT_READ;
+	}
+
+	memcpy(buf, pipe->buf, len);
+	memmove(pipe->buf, pipe->buf + len, pipe->len - len);
+	pipe->len -= len;
+
+	return len;
+}
+
+static void conf_setup(mbedtls_ssl_config *conf, int endpoint)
+{
+	int ret;
+
+	mbedtls_ssl_config_init(conf);
+
+	ret = mbedtls_ssl_config_defaults(conf, endpoint, MBEDTLS_SSL_TRANSPORT_STREAM,
+					  MBEDTLS_SSL_PRESET_DEFAULT);
+	zassert_equal(ret, 0, "mbedtls_ssl_config_defaults failed: %d", ret);
+
+	mbedtls_ssl_conf_rng(conf, rng, NULL);
+
+	ret = mbedtls_ssl_conf_psk(conf, psk, sizeof(psk), (const unsigned char *)psk_identity,
+				   strlen(psk_identity));
+	zassert_equal(ret, 0, "mbedtls_ssl_conf_psk failed: %d", ret);
+}
+
+static void peer_setup(struct peer *peer, const mbedtls_ssl_config *conf, struct pipe *tx,
+		       struct pipe *rx)
+{
+	peer->tx = tx;
+	peer->rx = rx;
+	tx->len = 0;
+
+	peer_arena_create(peer);
+	peer_arena_enter(peer);
+
+	mbedtls_ssl_init(&peer->ssl);
+	peer->ret = mbedtls_ssl_setup(&peer->ssl, conf);
+	if (peer->ret == 0) {
+		mbedtls_ssl_set_bio(&peer->ssl, peer, peer_send, peer_recv, NULL);
+		peer->ret = MBEDTLS_ERR_SSL_WANT_READ;
+	}
+
+	peer_arena_exit();
+}
+
+static bool peer_is_pending(const struct peer *peer)
+{
+	return peer->ret == MBEDTLS_ERR_SSL_WANT_READ || peer->ret == MBEDTLS_ERR_SSL_WANT_WRITE;
+}
+
+static bool peer_step(struct peer *peer)
+{
+	if (!peer_is_pending(peer)) {
+		return false;
+	}
+
+	peer_arena_enter(peer);
+	peer->ret = mbedtls_ssl_handshake(&peer->ssl);
+	peer_arena_exit();
+
+	return peer_is_pending(peer);
+}
+
+/* Runs the handshakes of all pairs side by side, as concurrent connections
+ * would, and returns the number of pairs that did not complete.
+ */
+static uint32_t handshakes_run(size_t steps)
+{
+	uint32_t failures = 0;
+	bool pending = true;
+
+	for (size_t i = 0; i < PAIR_COUNT; i++) {
+		peer_setup(&pairs[i].client, &client_conf, &pairs[i].to_server,
+			   &pairs[i].to_client);
+		peer_setup(&pairs[i].server, &server_conf, &pairs[i].to_client,
+			   &pairs[i].to_server);
+	}
+
+	for (size_t step = 0; pending && step < steps; step++) {
+		pending = false;
+
+		for (size_t i = 0; i < PAIR_COUNT; i++) {
+			pending |= peer_step(&pairs[i].client);
+			pending |= peer_step(&pairs[i].server);
+		}
+	}
+
+	for (size_t i = 0; i < PAIR_COUNT; i++) {
+		if (pairs[i].client.ret != 0 || pairs[i].server.ret != 0) {
+			failures++;
+		}
+	}
+
+	return failures;
+}
+
+static void pair_check(struct pair *pair)
+{
+	uint8_t buf[sizeof(message)];
+	int ret;
+
+	peer_arena_enter(&pair->client);
+	ret = mbedtls_ssl_write(&pair->client.ssl, message, sizeof(message));
+	peer_arena_exit();
+	zassert_equal(ret, sizeof(message), "mbedtls_ssl_write failed: %d", ret);
+
+	peer_arena_enter(&pair->server);
+	ret = mbedtls_ssl_read(&pair->server.ssl, buf, sizeof(buf));
+	peer_arena_exit();
+	zassert_equal(ret, sizeof(message), "mbedtls_ssl_read failed: %d", ret);
+	zassert_mem_equal(buf, message, sizeof(message), "Wrong message");
+}
+
+static void peer_free(struct peer *peer)
+{
+	mbedtls_ssl_free(&peer->ssl);
+
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+	struct nrf_mbedtls_heap_stats stats;
+	int err = nrf_mbedtls_heap_arena_stats_get(peer->arena, &stats);
+
+	zassert_equal(err, 0, "nrf_mbedtls_heap_arena_stats_get failed: %d", err);
+	zassert_equal(stats.used, 0, "%zu bytes leaked", stats.used);
+#endif
+
+	peer_arena_release(peer);
+}
+
+static void *mbedtls_heap_arena_setup(void)
+{
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA) && !defined(CONFIG_NRF_SECURITY)
+	int err = nrf_mbedtls_heap_init(heap, sizeof(heap));
+
+	zassert_equal(err, 0, "nrf_mbedtls_heap_init failed: %d", err);
+#endif
+
+#if defined(CONFIG_MBEDTLS_PSA_CRYPTO_C)
+	psa_status_t status = psa_crypto_init();
+
+	zassert_equal(status, PSA_SUCCESS, "psa_crypto_init failed: %d", status);
+#endif
+
+	conf_setup(&client_conf, MBEDTLS_SSL_IS_CLIENT);
+	conf_setup(&server_conf, MBEDTLS_SSL_IS_SERVER);
+
+	return NULL;
+}
+
+ZTEST(mbedtls_heap_arena, test_handshakes)
+{
+	uint32_t failures = 0;
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+	struct nrf_mbedtls_heap_stats stats;
+	uint8_t fragmentation = 0;
+#endif
+
+	for (size_t round = 0; round < ROUND_COUNT; round++) {
+		failures += handshakes_run(STEP_MAX);
+
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+		/* Measured while the connections are open. */
+		nrf_mbedtls_heap_stats_get(&stats);
+		fragmentation = MAX(fragmentation, stats.fragmentation);
+#endif
+
+		for (size_t i = 0; i < PAIR_COUNT; i++) {
+			if (pairs[i].client.ret == 0 && pairs[i].server.ret == 0) {
+				pair_check(&pairs[i]);
+			}
+
+			peer_free(&pairs[i].client);
+			peer_free(&pairs[i].server);
+		}
+	}
+
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+	nrf_mbedtls_heap_stats_get(&stats);
+
+	printk("%u rounds of %u concurrent handshakes, %u failed: heap peak %zu of %u bytes, "
+	       "%u allocation failures, up to %u%% fragmentation\n",
+	       ROUND_COUNT, PAIR_COUNT, failures, stats.peak, CONFIG_MBEDTLS_HEAP_SIZE,
+	       stats.failures, fragmentation);
+
+	zassert_equal(failures, 0, "%u handshakes failed", failures);
+	zassert_equal(stats.failures, 0, "%u allocations failed", stats.failures);
+#else
+	/* Only reported, as the reference for the arena allocator. */
+	printk("%u rounds of %u concurrent handshakes, %u failed\n", ROUND_COUNT, PAIR_COUNT,
+	       failures);
+#endif
+}
+
+#if defined(CONFIG_MBEDTLS_HEAP_ARENA)
+ZTEST(mbedtls_heap_arena, test_release)
+{
+	struct nrf_mbedtls_heap_stats before;
+	struct nrf_mbedtls_heap_stats after;
+
+	nrf_mbedtls_heap_stats_get(&before);
+
+	/* Stop the handshakes after the first flights and drop them without
+	 * freeing the contexts.
+	 */
+	zassert_equal(handshakes_run(1), PAIR_COUNT, "Handshakes not interrupted");
+
+	for (size_t i = 0; i < PAIR_COUNT; i++) {
+		peer_arena_release(&pairs[i].client);
+		peer_arena_release(&pairs[i].server);
+		mbedtls_ssl_init(&pairs[i].client.ssl);
+		mbedtls_ssl_init(&pairs[i].server.ssl);
+	}
+
+	nrf_mbedtls_heap_stats_get(&after);
+	zassert_equal(after.used, before.used, "%zu bytes left", after.used - before.used);
+	zassert_equal(after.allocs, before.allocs, "%u allocations left",
+		      after.allocs - before.allocs);
+}
+
+ZTEST(mbedtls_heap_arena, test_stale_free)
+{
+	struct peer peer;
+	void *ptr;
+
+	peer_arena_create(&peer);
+	peer_arena_enter(&peer);
+	ptr = mbedtls_calloc(1, 32);
+	peer_arena_exit();
+	zassert_not_null(ptr, "mbedtls_calloc failed");
+
+	peer_arena_release(&peer);
+
+	/* The block is no longer allocated, freeing it must not go unnoticed. */
+	ztest_set_fault_valid(true);
+	mbedtls_free(ptr);
+
+	ztest_test_fail();
+}
+#endif /* CONFIG_MBEDTLS_HEAP_ARENA */
+
+ZTEST_SUITE(mbedtls_heap_arena, NULL, mbedtls_heap_arena_setup, NULL, NULL, NULL);
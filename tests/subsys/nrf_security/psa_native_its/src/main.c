@@ -0,0 +1,410 @@
+/*
+ * Copyright (c) 2023 Nordic Semiconductor ASA
+ *
+ * SPDX-License-Identifier: LicenseRef-Nordic-5-Clause
+ */
+#include <zephyr/ztest.h>
+#include <string.h>
+#include <psa/internal_trusted_storage.h>
+
+#if defined(CONFIG_PSA_NATIVE_ITS_BACKEND_LOG)
+#include <zephyr/storage/flash_map.h>
+#include "psa_native_its_log.h"
+#endif
+
+#define UID_BASE 0x1000
+#define UID_WRITE_ONCE 0x0fff
+#define DATA_MAX_SIZE 64
+#define BENCHMARK_ENTRY_COUNT 200
+#define BENCHMARK_DATA_SIZE 32
+
+static uint8_t data[DATA_MAX_SIZE];
+static uint8_t buff[DATA_MAX_SIZE];
+
+static void data_fill(psa_storage_uid_t uid, uint32_t round, size_t size)
+{
+	for (size_t i = 0; i < size; i++) {
+		data[i] = (uint8_t)(uid * 7 + round * 13 + i);
+	}
+}
+
+static size_t data_size(psa_storage_uid_t uid, uint32_t round)
+{
+	return 1 + (uid + round) % DATA_MAX_SIZE;
+}
+
+static void entry_set(psa_storage_uid_t uid, uint32_t round)
+{
+	psa_status_t status;
+
+	data_fill(uid, round, data_size(uid, round));
+
+	status = psa_its_set(uid, data_size(uid, round), data, PSA_STORAGE_FLAG_NONE);
+	zassert_equal(status, PSA_SUCCESS, "psa_its_set failed: %d", status);
+}
+
+static void entry_check(psa_storage_uid_t uid, uint32_t round)
+{
+	psa_status_t status;
+	struct psa_storage_info_t info;
+	size_t size = data_size(uid, round);
+	size_t len;
+
+	status = psa_its_get_info(uid, &info);
+	zassert_equal(status, PSA_SUCCESS, "psa_its_get_info failed: %d", status);
+	zassert_equal(info.size, size, "Wrong size %u for uid %u", info.size, (uint32_t)uid);
+	zassert_equal(info.flags, PSA_STORAGE_FLAG_NONE, "Wrong flags");
+
+	status = psa_its_get(uid, 0, size, buff, &len);
+	zassert_equal(status, PSA_SUCCESS, "psa_its_get failed: %d", status);
+
+	data_fill(uid, round, size);
+	zassert_mem_equal(buff, data, size, "Wrong data for uid %u", (uint32_t)uid);
+}
+
+static void entry_remove(psa_storage_uid_t uid)
+{
+	psa_status_t status = psa_its_remove(uid);
+
+	zassert_true(status == PSA_SUCCESS || status == PSA_ERROR_DOES_NOT_EXIST,
+		     "psa_its_remove failed: %d", status);
+}
+
+static void entries_remove(void *fixture)
+{
+	ARG_UNUSED(fixture);
+
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + BENCHMARK_ENTRY_COUNT; uid++) {
+		entry_remove(uid);
+	}
+}
+
+ZTEST(psa_native_its, test_set_get_remove)
+{
+	psa_status_t status;
+	struct psa_storage_info_t info;
+
+	for (uint32_t round = 0; round < 3; round++) {
+		for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 8; uid++) {
+			entry_set(uid, round);
+		}
+
+		for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 8; uid++) {
+			entry_check(uid, round);
+		}
+	}
+
+	status = psa_its_remove(UID_BASE);
+	zassert_equal(status, PSA_SUCCESS, "psa_its_remove failed: %d", status);
+
+	status = psa_its_get_info(UID_BASE, &info);
+	zassert_equal(status, PSA_ERROR_DOES_NOT_EXIST, "Removed entry found: %d", status);
+
+	status = psa_its_remove(UID_BASE);
+	zassert_equal(status, PSA_ERROR_DOES_NOT_EXIST, "Removed entry removed: %d", status);
+
+	entry_check(UID_BASE + 1, 2);
+}
+
+ZTEST(psa_native_its, test_write_once)
+{
+	psa_status_t status;
+	struct psa_storage_info_t info;
+
+	data_fill(UID_WRITE_ONCE, 0, 16);
+
+	/* The entry may be left from a previous run on a device. */
+	status = psa_its_set(UID_WRITE_ONCE, 16, data, PSA_STORAGE_FLAG_WRITE_ONCE);
+	zassert_true(status == PSA_SUCCESS || status == PSA_ERROR_NOT_PERMITTED,
+		     "psa_its_set failed: %d", status);
+
+	status = psa_its_get_info(UID_WRITE_ONCE, &info);
+	zassert_equal(status, PSA_SUCCESS, "psa_its_get_info failed: %d", status);
+	zassert_equal(info.flags, PSA_STORAGE_FLAG_WRITE_ONCE, "Wrong flags");
+
+	status = psa_its_set(UID_WRITE_ONCE, 16, data, PSA_STORAGE_FLAG_NONE);
+	zassert_equal(status, PSA_ERROR_NOT_PERMITTED, "Write-once entry modified: %d", status);
+
+	status = psa_its_remove(UID_WRITE_ONCE);
+	zassert_equal(status, PSA_ERROR_NOT_PERMITTED, "Write-once entry removed: %d", status);
+}
+
+#if defined(CONFIG_PSA_NATIVE_ITS_BACKEND_LOG)
+/* Layout of the log, see psa_native_its_log.c. */
+#define SECTOR_MAGIC 0x5354494e
+#define RECORD_HEADER_SIZE 24
+
+struct sector_header {
+	uint32_t magic;
+	uint32_t seq;
+};
+
+static const struct flash_area *fa;
+static uint32_t sector_size;
+static uint32_t sector_count;
+
+static void storage_read(uint32_t offset, void *dst, size_t len)
+{
+	int err = flash_area_read(fa, offset, dst, len);
+
+	zassert_equal(err, 0, "flash_area_read failed: %d", err);
+}
+
+static void storage_write(uint32_t offset, const void *src, size_t len)
+{
+	int err = flash_area_write(fa, offset, src, len);
+
+	zassert_equal(err, 0, "flash_area_write failed: %d", err);
+}
+
+static void storage_reload(void)
+{
+	int err = psa_native_its_log_init();
+
+	zassert_equal(err, 0, "psa_native_its_log_init failed: %d", err);
+}
+
+/* Start from an empty log, so that the records are at known offsets. */
+static void storage_clear(void)
+{
+	int err;
+	uint32_t count = 1;
+	struct flash_sector sector;
+
+	err = flash_area_open(FIXED_PARTITION_ID(psa_its_storage), &fa);
+	zassert_equal(err, 0, "flash_area_open failed: %d", err);
+
+	err = flash_area_get_sectors(FIXED_PARTITION_ID(psa_its_storage), &count, &sector);
+	zassert_true(err == 0 || err == -ENOMEM, "flash_area_get_sectors failed: %d", err);
+
+	sector_size = sector.fs_size;
+	sector_count = fa->fa_size / sector_size;
+
+	err = flash_area_erase(fa, 0, fa->fa_size);
+	zassert_equal(err, 0, "flash_area_erase failed: %d", err);
+
+	storage_reload();
+}
+
+static uint32_t record_len(psa_storage_uid_t uid, uint32_t round)
+{
+	return RECORD_HEADER_SIZE + ROUND_UP(data_size(uid, round), flash_area_align(fa));
+}
+
+ZTEST(psa_native_its, test_reload)
+{
+	int err;
+	psa_status_t status;
+	struct psa_storage_info_t info;
+
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid++) {
+		entry_set(uid, 0);
+	}
+
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid += 2) {
+		entry_set(uid, 1);
+	}
+
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid += 4) {
+		entry_remove(uid);
+	}
+
+	err = psa_native_its_log_init();
+	zassert_equal(err, 0, "psa_native_its_log_init failed: %d", err);
+
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid++) {
+		if ((uid - UID_BASE) % 4 == 0) {
+			status = psa_its_get_info(uid, &info);
+			zassert_equal(status, PSA_ERROR_DOES_NOT_EXIST, "Removed entry found");
+		} else {
+			entry_check(uid, (uid - UID_BASE) % 2 == 0 ? 1 : 0);
+		}
+	}
+}
+
+ZTEST(psa_native_its, test_compaction)
+{
+	int err;
+
+	/* Rewrite the entries many times, so that the log wraps around the
+	 * partition several times.
+	 */
+	for (uint32_t round = 0; round < 100; round++) {
+		for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid++) {
+			entry_set(uid, round);
+		}
+	}
+
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid++) {
+		entry_check(uid, 99);
+	}
+
+	err = psa_native_its_log_init();
+	zassert_equal(err, 0, "psa_native_its_log_init failed: %d", err);
+
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid++) {
+		entry_check(uid, 99);
+	}
+}
+
+ZTEST(psa_native_its, test_torn_record)
+{
+	uint8_t hdr[RECORD_HEADER_SIZE];
+	uint32_t offset = sizeof(struct sector_header);
+
+	storage_clear();
+
+	entry_set(UID_BASE, 0);
+
+	/* A record of which only the header was written before a power loss. */
+	storage_read(offset, hdr, sizeof(hdr));
+	offset += record_len(UID_BASE, 0);
+	storage_write(offset, hdr, sizeof(hdr));
+
+	storage_reload();
+	entry_check(UID_BASE, 0);
+
+	/* The records appended after the torn one are kept. */
+	entry_set(UID_BASE + 1, 0);
+	entry_set(UID_BASE, 1);
+
+	storage_reload();
+	entry_check(UID_BASE, 1);
+	entry_check(UID_BASE + 1, 0);
+}
+
+ZTEST(psa_native_its, test_interrupted_compaction)
+{
+	uint8_t record[RECORD_HEADER_SIZE + DATA_MAX_SIZE];
+	uint32_t len = record_len(UID_BASE, 0);
+	uint32_t head;
+	struct sector_header hdr = {
+		.magic = SECTOR_MAGIC,
+	};
+
+	storage_clear();
+
+	entry_set(UID_BASE, 0);
+	entry_set(UID_BASE + 1, 0);
+
+	/* All sectors in use, the last one holding the copy of a record of the
+	 * first one, as left by a compaction interrupted by a power loss.
+	 */
+	for (uint32_t sector = 1; sector < sector_count; sector++) {
+		hdr.seq = sector;
+		storage_write(sector * sector_size, &hdr, sizeof(hdr));
+	}
+
+	head = (sector_count - 1) * sector_size;
+	storage_read(sizeof(hdr), record, len);
+	storage_write(head + sizeof(hdr), record, len);
+
+	storage_reload();
+	entry_check(UID_BASE, 0);
+	entry_check(UID_BASE + 1, 0);
+
+	/* The copies were dropped. */
+	storage_read(head, &hdr, sizeof(hdr));
+	zassert_not_equal(hdr.magic, SECTOR_MAGIC, "Interrupted compaction not dropped");
+
+	/* The compaction is done again when needed. */
+	for (uint32_t round = 0; round < 20; round++) {
+		for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid++) {
+			entry_set(uid, round);
+		}
+	}
+
+	storage_reload();
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 32; uid++) {
+		entry_check(uid, 19);
+	}
+}
+
+ZTEST(psa_native_its, test_partly_erased_sector)
+{
+	uint32_t rounds;
+	struct sector_header hdr = { 0 };
+
+	storage_clear();
+
+	entry_set(UID_BASE, 0);
+
+	/* The next sector after an interrupted erase: the header was
+	 * invalidated and some records are left.
+	 */
+	memset(data, 0x5a, sizeof(data));
+	storage_write(sector_size, &hdr, sizeof(hdr));
+	storage_write(sector_size + sector_size / 2, data, sizeof(data));
+
+	storage_reload();
+	entry_check(UID_BASE, 0);
+
+	/* Write more than two sectors of records, so that the log moves past the
+	 * partly erased sector.
+	 */
+	rounds = 2 * sector_size / (8 * RECORD_HEADER_SIZE) + 1;
+
+	for (uint32_t round = 1; round <= rounds; round++) {
+		for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 8; uid++) {
+			entry_set(uid, round);
+		}
+	}
+
+	storage_reload();
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + 8; uid++) {
+		entry_check(uid, rounds);
+	}
+}
+#endif /* CONFIG_PSA_NATIVE_ITS_BACKEND_LOG */
+
+ZTEST(psa_native_its, test_benchmark)
+{
+	psa_status_t status;
+	struct psa_storage_info_t info;
+	uint32_t start;
+	uint32_t set_us;
+	uint32_t info_us;
+	uint32_t get_us;
+	size_t len;
+
+	memset(data, 0x5a, BENCHMARK_DATA_SIZE);
+
+	start = k_cycle_get_32();
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + BENCHMARK_ENTRY_COUNT; uid++) {
+		status = psa_its_set(uid, BENCHMARK_DATA_SIZE, data, PSA_STORAGE_FLAG_NONE);
+		zassert_equal(status, PSA_SUCCESS, "psa_its_set failed: %d", status);
+	}
+	set_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+#if defined(CONFIG_PSA_NATIVE_ITS_BACKEND_LOG)
+	uint32_t init_us;
+	int err;
+
+	start = k_cycle_get_32();
+	err = psa_native_its_log_init();
+	init_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+	zassert_equal(err, 0, "psa_native_its_log_init failed: %d", err);
+
+	printk("Index built from %u entries in %u us\n", BENCHMARK_ENTRY_COUNT, init_us);
+#endif
+
+	start = k_cycle_get_32();
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + BENCHMARK_ENTRY_COUNT; uid++) {
+		status = psa_its_get_info(uid, &info);
+		zassert_equal(status, PSA_SUCCESS, "psa_its_get_info failed: %d", status);
+	}
+	info_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	start = k_cycle_get_32();
+	for (psa_storage_uid_t uid = UID_BASE; uid < UID_BASE + BENCHMARK_ENTRY_COUNT; uid++) {
+		status = psa_its_get(uid, 0, BENCHMARK_DATA_SIZE, buff, &len);
+		zassert_equal(status, PSA_SUCCESS, "psa_its_get failed: %d", status);
+	}
+	get_us = k_cyc_to_us_floor32(k_cycle_get_32() - start);
+
+	printk("%u entries of %u bytes: %u us/set, %u us/get_info, %u us/get\n",
+	       BENCHMARK_ENTRY_COUNT, BENCHMARK_DATA_SIZE, set_us / BENCHMARK_ENTRY_COUNT,
+	       info_us / BENCHMARK_ENTRY_COUNT, get_us / BENCHMARK_ENTRY_COUNT);
+}
+
+ZTEST_SUITE(psa_native_its, NULL, NULL, NULL, entries_remove, NULL);